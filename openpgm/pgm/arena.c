@@ -0,0 +1,439 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * Huge page backed storage for window skbuffs and pointer arrays.
+ *
+ * A window of a gigabyte holds hundreds of thousands of skbuffs, scattered
+ * across the heap each costs its own TLB entry during retransmit scans and
+ * eviction.  An arena reserves one mapping of 2 MB pages at bind time sized
+ * from the window parameters and carves fixed size skbuff slots from it.
+ * Exhausted arenas fall back to the heap, so sizing only affects locality.
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#include <errno.h>
+#ifndef _WIN32
+#	include <sys/mman.h>
+#endif
+#ifdef __linux__
+#	include <unistd.h>
+#	include <sys/syscall.h>
+#endif
+#include <impl/i18n.h>
+#include <impl/framework.h>
+
+
+//#define ARENA_DEBUG
+
+#ifndef ARENA_DEBUG
+#	define PGM_DISABLE_ASSERT
+#endif
+
+#ifndef MPOL_PREFERRED
+#	define MPOL_PREFERRED		1
+#endif
+
+#define PGM_ARENA_NODEMASK_BITS		(sizeof (unsigned long) * 8)
+#define PGM_ARENA_NODEMASK_LONGS	(PGM_ARENA_MAX_NUMA_NODE / PGM_ARENA_NODEMASK_BITS + 1)
+
+struct pgm_arena_t {
+	char*			base;
+	size_t			length;			/* mapped bytes */
+	size_t			slot_size;
+	unsigned		slots;
+	unsigned		next_slot;		/* slots never yet allocated start here */
+	uint16_t		max_tpdu;		/* payload capacity of a slot */
+	int			numa_node;		/* -1 for no placement */
+	bool			use_mlock;
+	bool			is_huge;		/* MAP_HUGETLB, otherwise THP advised */
+
+	pgm_spinlock_t		lock;
+	struct pgm_sk_buff_t*	free_list;		/* linked by link_.next */
+	unsigned		outstanding;		/* skbuffs not yet returned */
+	unsigned		exhausted;		/* heap fallbacks */
+	bool			is_destroyed;
+};
+
+/* header before each pointer array recording how it was allocated, one cache
+ * line to keep the array aligned.
+ */
+struct pgm_arena_block_t {
+	size_t			length;			/* mapped bytes, 0 for heap */
+	unsigned		is_huge;
+	char			__padding[PGM_SKB_CACHELINE - sizeof(size_t) - sizeof(unsigned)];
+};
+
+PGM_STATIC_ASSERT(sizeof(struct pgm_arena_block_t) == PGM_SKB_CACHELINE);
+
+
+/* map length bytes, rounded up to whole huge pages, on numa_node and locked
+ * when use_mlock.  tries explicit huge pages then advises transparent huge
+ * pages.
+ *
+ * returns start of mapping on success, or NULL on error and sets error appropriately.
+ */
+
+static
+void*
+_pgm_arena_map (
+	size_t*	      restrict length,
+	const int		numa_node,
+	const bool		use_mlock,
+	bool*	      restrict	is_huge,
+	pgm_error_t** restrict	error
+	)
+{
+	void* p;
+	char errbuf[1024];
+
+	*length = (*length + PGM_ARENA_HUGE_PAGE_SIZE - 1) & ~((size_t)PGM_ARENA_HUGE_PAGE_SIZE - 1);
+
+#ifndef _WIN32
+#	ifdef MAP_HUGETLB
+	p = mmap (NULL, *length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	*is_huge = (MAP_FAILED != p);
+	if (!*is_huge)
+#	else
+	*is_huge = FALSE;
+#	endif
+	{
+		p = mmap (NULL, *length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (MAP_FAILED == p) {
+			const int save_errno = errno;
+			pgm_set_error (error,
+				     PGM_ERROR_DOMAIN_SOCKET,
+				     pgm_error_from_errno (save_errno),
+				     _("Mapping %" PRIzu " bytes of arena memory: %s"),
+				     *length,
+				     pgm_strerror_s (errbuf, sizeof (errbuf), save_errno));
+			return NULL;
+		}
+#	ifdef MADV_HUGEPAGE
+		madvise (p, *length, MADV_HUGEPAGE);
+#	endif
+	}
+
+/* placement must precede the first touch of each page */
+	if (numa_node >= 0) {
+#	if defined(__linux__) && defined(SYS_mbind)
+/* the kernel reads maxnode - 1 bits of the mask */
+		unsigned long nodemask[ PGM_ARENA_NODEMASK_LONGS ];
+		memset (nodemask, 0, sizeof (nodemask));
+		nodemask[ numa_node / PGM_ARENA_NODEMASK_BITS ] = 1UL << (numa_node % PGM_ARENA_NODEMASK_BITS);
+		if (0 != syscall (SYS_mbind, p, *length, MPOL_PREFERRED, nodemask, sizeof (nodemask) * 8 + 1, 0)) {
+			const int save_errno = errno;
+			pgm_set_error (error,
+				     PGM_ERROR_DOMAIN_SOCKET,
+				     pgm_error_from_errno (save_errno),
+				     _("Binding arena memory to NUMA node %d: %s"),
+				     numa_node,
+				     pgm_strerror_s (errbuf, sizeof (errbuf), save_errno));
+			munmap (p, *length);
+			return NULL;
+		}
+#	else
+		pgm_trace (PGM_LOG_ROLE_MEMORY,_("NUMA placement not supported on this platform."));
+#	endif
+	}
+
+	if (use_mlock && 0 != mlock (p, *length)) {
+		const int save_errno = errno;
+		pgm_set_error (error,
+			     PGM_ERROR_DOMAIN_SOCKET,
+			     pgm_error_from_errno (save_errno),
+			     _("Locking %" PRIzu " bytes of arena memory: %s"),
+			     *length,
+			     pgm_strerror_s (errbuf, sizeof (errbuf), save_errno));
+		munmap (p, *length);
+		return NULL;
+	}
+#else /* _WIN32 */
+	const DWORD type = MEM_RESERVE | MEM_COMMIT;
+	if (numa_node >= 0) {
+		p = VirtualAllocExNuma (GetCurrentProcess(), NULL, *length, type | MEM_LARGE_PAGES, PAGE_READWRITE, numa_node);
+		*is_huge = (NULL != p);
+		if (!*is_huge)
+			p = VirtualAllocExNuma (GetCurrentProcess(), NULL, *length, type, PAGE_READWRITE, numa_node);
+	} else {
+		p = VirtualAlloc (NULL, *length, type | MEM_LARGE_PAGES, PAGE_READWRITE);
+		*is_huge = (NULL != p);
+		if (!*is_huge)
+			p = VirtualAlloc (NULL, *length, type, PAGE_READWRITE);
+	}
+	if (NULL == p) {
+		const int save_errno = GetLastError();
+		pgm_set_error (error,
+			     PGM_ERROR_DOMAIN_SOCKET,
+			     pgm_error_from_win_errno (save_errno),
+			     _("Mapping %" PRIzu " bytes of arena memory: %s"),
+			     *length,
+			     pgm_win_strerror (errbuf, sizeof (errbuf), save_errno));
+		return NULL;
+	}
+/* large pages are always resident */
+	if (use_mlock && !*is_huge && !VirtualLock (p, *length)) {
+		const int save_errno = GetLastError();
+		pgm_set_error (error,
+			     PGM_ERROR_DOMAIN_SOCKET,
+			     pgm_error_from_win_errno (save_errno),
+			     _("Locking %" PRIzu " bytes of arena memory: %s"),
+			     *length,
+			     pgm_win_strerror (errbuf, sizeof (errbuf), save_errno));
+		VirtualFree (p, 0, MEM_RELEASE);
+		return NULL;
+	}
+#endif /* _WIN32 */
+	return p;
+}
+
+static
+void
+_pgm_arena_unmap (
+	void*			p,
+	const size_t		length
+	)
+{
+#ifndef _WIN32
+	munmap (p, length);
+#else
+	(void)length;
+	VirtualFree (p, 0, MEM_RELEASE);
+#endif
+}
+
+/* create an arena of slots skbuffs each holding max_tpdu bytes of payload.
+ *
+ * returns pointer to arena on success, or NULL on error and sets error appropriately.
+ */
+
+PGM_GNUC_INTERNAL
+pgm_arena_t*
+pgm_arena_create (
+	const uint16_t		max_tpdu,
+	const unsigned		slots,
+	const int		numa_node,	/* -1 = none */
+	const bool		use_mlock,
+	pgm_error_t**		error
+	)
+{
+	pgm_arena_t* arena;
+
+/* pre-conditions */
+	pgm_assert_cmpuint (max_tpdu, >, 0);
+	pgm_assert_cmpuint (slots, >, 0);
+	pgm_assert_cmpint (numa_node, >=, -1);
+	pgm_assert_cmpint (numa_node, <=, PGM_ARENA_MAX_NUMA_NODE);
+
+	pgm_debug ("pgm_arena_create (max-tpdu:%u slots:%u numa-node:%d use-mlock:%s error:%p)",
+		(unsigned)max_tpdu, slots, numa_node, use_mlock ? "TRUE" : "FALSE", (void*)error);
+
+	arena = pgm_new0 (pgm_arena_t, 1);
+	arena->slot_size = (sizeof(struct pgm_sk_buff_t) + max_tpdu + PGM_SKB_CACHELINE - 1) & ~((size_t)PGM_SKB_CACHELINE - 1);
+	arena->length	 = arena->slot_size * slots;
+	arena->base = _pgm_arena_map (&arena->length, numa_node, use_mlock, &arena->is_huge, error);
+	if (NULL == arena->base) {
+		pgm_free (arena);
+		return NULL;
+	}
+/* rounding to whole pages leaves room for more slots */
+	arena->slots	 = (unsigned)(arena->length / arena->slot_size);
+	arena->max_tpdu	 = max_tpdu;
+	arena->numa_node = numa_node;
+	arena->use_mlock = use_mlock;
+	pgm_spinlock_init (&arena->lock);
+	pgm_trace (PGM_LOG_ROLE_MEMORY,_("Arena of %u x %" PRIzu " byte slots in %" PRIzu " bytes of %s pages."),
+		arena->slots, arena->slot_size, arena->length,
+		arena->is_huge ? "huge" : "advised");
+	return arena;
+}
+
+static
+void
+_pgm_arena_release (
+	pgm_arena_t*const	arena
+	)
+{
+	_pgm_arena_unmap (arena->base, arena->length);
+	pgm_spinlock_free (&arena->lock);
+	pgm_free (arena);
+}
+
+/* skbuffs may outlive the owner, for example held by a peer reference, the
+ * mapping is released with the last skbuff.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_arena_destroy (
+	pgm_arena_t*const	arena
+	)
+{
+	bool is_last;
+
+/* pre-conditions */
+	pgm_assert (NULL != arena);
+	pgm_assert (!arena->is_destroyed);
+
+	pgm_spinlock_lock (&arena->lock);
+	arena->is_destroyed = TRUE;
+	is_last = (0 == arena->outstanding);
+	pgm_spinlock_unlock (&arena->lock);
+	if (arena->exhausted > 0)
+		pgm_trace (PGM_LOG_ROLE_MEMORY,_("Arena exhausted %u times."), arena->exhausted);
+	if (is_last)
+		_pgm_arena_release (arena);
+}
+
+/* allocate an skbuff with size bytes of payload, from the heap when arena is
+ * NULL, exhausted, or size exceeds a slot.
+ *
+ * returns pointer to skbuff.
+ */
+
+PGM_GNUC_INTERNAL
+struct pgm_sk_buff_t*
+pgm_arena_alloc_skb (
+	pgm_arena_t*const	arena,
+	const uint16_t		size
+	)
+{
+	struct pgm_sk_buff_t* skb;
+
+	if (NULL == arena || size > arena->max_tpdu)
+		return pgm_alloc_skb (size);
+
+	pgm_spinlock_lock (&arena->lock);
+	skb = arena->free_list;
+	if (PGM_LIKELY(NULL != skb))
+		arena->free_list = (struct pgm_sk_buff_t*)skb->link_.next;
+	else if (arena->next_slot < arena->slots)
+		skb = (struct pgm_sk_buff_t*)(arena->base + (size_t)arena->next_slot++ * arena->slot_size);
+	else {
+		arena->exhausted++;
+		pgm_spinlock_unlock (&arena->lock);
+		return pgm_alloc_skb (size);
+	}
+	arena->outstanding++;
+	pgm_spinlock_unlock (&arena->lock);
+
+	_pgm_skb_init (skb, size);
+	skb->arena = arena;
+	return skb;
+}
+
+/* return an skbuff to its arena, called by pgm_free_skb() with the last reference.
+ */
+
+void
+pgm_arena_free_skb (
+	struct pgm_sk_buff_t*const skb
+	)
+{
+	pgm_arena_t*const arena = skb->arena;
+	bool is_last;
+
+/* pre-conditions */
+	pgm_assert (NULL != arena);
+	pgm_assert ((char*)skb >= arena->base);
+	pgm_assert ((char*)skb < arena->base + arena->length);
+
+	pgm_spinlock_lock (&arena->lock);
+	skb->link_.next = (pgm_list_t*)arena->free_list;
+	arena->free_list = skb;
+	is_last = (0 == --arena->outstanding && arena->is_destroyed);
+	pgm_spinlock_unlock (&arena->lock);
+	if (is_last)
+		_pgm_arena_release (arena);
+}
+
+/* allocate a zeroed pointer array of length bytes.  arrays of at least one
+ * huge page are mapped under the placement and locking policy of arena, all
+ * others come from heap.
+ *
+ * returns pointer to array.
+ */
+
+PGM_GNUC_INTERNAL
+void*
+pgm_arena_alloc_array (
+	const pgm_arena_t*const	arena,		/* maybe NULL */
+	pgm_heap_t*const	heap,		/* maybe NULL */
+	const size_t		length
+	)
+{
+	struct pgm_arena_block_t* block = NULL;
+	const size_t block_length = sizeof(struct pgm_arena_block_t) + length;
+
+	if (NULL != arena && block_length >= PGM_ARENA_HUGE_PAGE_SIZE)
+	{
+		size_t map_length = block_length;
+		bool is_huge;
+		pgm_error_t* err = NULL;
+		block = _pgm_arena_map (&map_length, arena->numa_node, arena->use_mlock, &is_huge, &err);
+		if (NULL != block) {
+			block->length  = map_length;
+			block->is_huge = is_huge;
+		} else {
+			pgm_trace (PGM_LOG_ROLE_MEMORY,_("Array falling back to heap: %s"),
+				(err && err->message) ? err->message : "(null)");
+			pgm_error_free (err);
+		}
+	}
+	if (NULL == block) {
+		block = pgm_heap_alloc0 (heap, block_length);
+	}
+	return block + 1;
+}
+
+PGM_GNUC_INTERNAL
+void
+pgm_arena_free_array (
+	pgm_heap_t*const	heap,
+	void*			array
+	)
+{
+	struct pgm_arena_block_t* block;
+
+/* pre-conditions */
+	pgm_assert (NULL != array);
+
+	block = (struct pgm_arena_block_t*)array - 1;
+	if (block->length)
+		_pgm_arena_unmap (block, block->length);
+	else
+		pgm_heap_free (heap, block);
+}
+
+/* returns count of skbuff allocations served by the heap as arena was exhausted.
+ */
+
+PGM_GNUC_INTERNAL
+unsigned
+pgm_arena_exhausted (
+	const pgm_arena_t*const	arena
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != arena);
+
+	return arena->exhausted;
+}
+
+/* eof */
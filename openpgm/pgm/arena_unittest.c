@@ -0,0 +1,347 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for huge page backed arenas.
+ *
+ * Copyright (c) 2009-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <glib.h>
+#include <check.h>
+
+#ifdef _WIN32
+#	define PGM_CHECK_NOFORK		1
+#endif
+
+
+/* mock state */
+
+#ifndef _WIN32
+long mock_syscall (long, ...);
+#	define syscall		mock_syscall
+#endif
+
+#define ARENA_DEBUG
+#include "arena.c"
+
+#if defined(__linux__) && defined(SYS_mbind)
+static int mock_mbind_errno = 0;
+static int mock_mbind_mode = -1;
+static unsigned long mock_mbind_nodemask[ PGM_ARENA_NODEMASK_LONGS ];
+static unsigned long mock_mbind_maxnode = 0;
+#endif
+
+
+/* mock functions for external references */
+
+size_t
+pgm_pkt_offset (
+        const bool                      can_fragment,
+        const sa_family_t		pgmcc_family	/* 0 = disable */
+        )
+{
+        return 0;
+}
+
+/* kernel NUMA support and node topology vary by host */
+#ifndef _WIN32
+long
+mock_syscall (
+	long		number,
+	...
+	)
+{
+#	if defined(__linux__) && defined(SYS_mbind)
+	va_list args;
+	g_assert (SYS_mbind == number);
+	va_start (args, number);
+	(void)va_arg (args, void*);
+	(void)va_arg (args, unsigned long);
+	mock_mbind_mode = va_arg (args, int);
+	const unsigned long* nodemask = va_arg (args, const unsigned long*);
+	mock_mbind_maxnode = va_arg (args, unsigned long);
+	va_end (args);
+	memcpy (mock_mbind_nodemask, nodemask, sizeof (mock_mbind_nodemask));
+	if (mock_mbind_errno) {
+		errno = mock_mbind_errno;
+		return -1;
+	}
+	return 0;
+#	else
+	g_assert_not_reached ();
+	return -1;
+#	endif
+}
+#endif
+
+
+/* target:
+ *	pgm_arena_t*
+ *	pgm_arena_create (
+ *		const uint16_t		max_tpdu,
+ *		const unsigned		slots,
+ *		const int		numa_node,
+ *		const bool		use_mlock,
+ *		pgm_error_t**		error
+ *	)
+ */
+
+START_TEST (test_create_pass_001)
+{
+	pgm_error_t* err = NULL;
+	pgm_arena_t* arena = pgm_arena_create (1500, 100, -1, FALSE, &err);
+	fail_if (NULL == arena, "create failed");
+	fail_unless (NULL == err, "error set");
+/* rounded up to whole huge pages */
+	fail_unless (0 == arena->length % PGM_ARENA_HUGE_PAGE_SIZE, "length not rounded");
+	fail_unless (arena->slots >= 100, "slots failed");
+	fail_unless (0 == arena->slot_size % PGM_SKB_CACHELINE, "slot not aligned");
+	pgm_arena_destroy (arena);
+}
+END_TEST
+
+#if defined(__linux__) && defined(SYS_mbind)
+/* preferred NUMA node */
+START_TEST (test_create_pass_002)
+{
+	pgm_error_t* err = NULL;
+	mock_mbind_errno = 0;
+	pgm_arena_t* arena = pgm_arena_create (1500, 100, 0, FALSE, &err);
+	fail_if (NULL == arena, "create failed");
+	fail_unless (NULL == err, "error set");
+	fail_unless (0 == arena->numa_node, "numa node failed");
+	fail_unless (MPOL_PREFERRED == mock_mbind_mode, "mode failed");
+	fail_unless (1UL == mock_mbind_nodemask[0], "nodemask failed");
+	pgm_arena_destroy (arena);
+}
+END_TEST
+
+/* highest node must reach the kernel rather than an empty mask, a kernel
+ * refusal fails the create.
+ */
+START_TEST (test_create_pass_003)
+{
+	pgm_error_t* err = NULL;
+	mock_mbind_errno = EINVAL;
+	pgm_arena_t* arena = pgm_arena_create (1500, 100, PGM_ARENA_MAX_NUMA_NODE, FALSE, &err);
+	fail_unless (NULL == arena, "refused node accepted");
+	fail_if (NULL == err, "error not set");
+	fail_unless (mock_mbind_maxnode > PGM_ARENA_MAX_NUMA_NODE + 1, "maxnode failed");
+	fail_unless (0 != (mock_mbind_nodemask[ PGM_ARENA_MAX_NUMA_NODE / PGM_ARENA_NODEMASK_BITS ] & (1UL << (PGM_ARENA_MAX_NUMA_NODE % PGM_ARENA_NODEMASK_BITS))), "nodemask failed");
+	pgm_error_free (err);
+}
+END_TEST
+#endif
+
+/* zero slots */
+START_TEST (test_create_fail_001)
+{
+	pgm_arena_t* arena = pgm_arena_create (1500, 0, -1, FALSE, NULL);
+	fail ("reached");
+}
+END_TEST
+
+/* NUMA node out of range */
+START_TEST (test_create_fail_002)
+{
+	pgm_arena_t* arena = pgm_arena_create (1500, 100, PGM_ARENA_MAX_NUMA_NODE + 1, FALSE, NULL);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	struct pgm_sk_buff_t*
+ *	pgm_arena_alloc_skb (
+ *		pgm_arena_t*const	arena,
+ *		const uint16_t		size
+ *	)
+ */
+
+START_TEST (test_alloc_skb_pass_001)
+{
+	pgm_arena_t* arena = pgm_arena_create (1500, 100, -1, FALSE, NULL);
+	fail_if (NULL == arena, "create failed");
+	struct pgm_sk_buff_t* skb = pgm_arena_alloc_skb (arena, 1500);
+	fail_if (NULL == skb, "alloc_skb failed");
+	fail_unless (arena == skb->arena, "arena not set");
+	fail_unless (0 == ((uintptr_t)skb % PGM_SKB_CACHELINE), "skb not aligned");
+	fail_unless (1 == skb->users, "users failed");
+	fail_unless (skb->end == (char*)skb->head + 1500, "end failed");
+	fail_unless (1 == arena->outstanding, "outstanding failed");
+/* freed slots are reused first */
+	pgm_free_skb (skb);
+	fail_unless (0 == arena->outstanding, "outstanding failed");
+	struct pgm_sk_buff_t* skb2 = pgm_arena_alloc_skb (arena, 1500);
+	fail_unless (skb == skb2, "slot not reused");
+	pgm_free_skb (skb2);
+	pgm_arena_destroy (arena);
+}
+END_TEST
+
+/* NULL arena and oversized requests are served by the heap */
+START_TEST (test_alloc_skb_pass_002)
+{
+	struct pgm_sk_buff_t* skb = pgm_arena_alloc_skb (NULL, 1500);
+	fail_if (NULL == skb, "alloc_skb failed");
+	fail_unless (NULL == skb->arena, "arena set");
+	pgm_free_skb (skb);
+	pgm_arena_t* arena = pgm_arena_create (100, 1, -1, FALSE, NULL);
+	fail_if (NULL == arena, "create failed");
+	skb = pgm_arena_alloc_skb (arena, 1500);
+	fail_unless (NULL == skb->arena, "arena set");
+	pgm_free_skb (skb);
+	pgm_arena_destroy (arena);
+}
+END_TEST
+
+/* exhausted arena falls back to the heap */
+START_TEST (test_alloc_skb_pass_003)
+{
+	pgm_arena_t* arena = pgm_arena_create (1500, 1, -1, FALSE, NULL);
+	fail_if (NULL == arena, "create failed");
+	const unsigned slots = arena->slots;
+	struct pgm_sk_buff_t** skbs = g_new0 (struct pgm_sk_buff_t*, slots + 1);
+	for (unsigned i = 0; i < slots; i++) {
+		skbs[i] = pgm_arena_alloc_skb (arena, 1500);
+		fail_unless (arena == skbs[i]->arena, "arena not set");
+	}
+	fail_unless (0 == pgm_arena_exhausted (arena), "exhausted failed");
+	skbs[slots] = pgm_arena_alloc_skb (arena, 1500);
+	fail_unless (NULL == skbs[slots]->arena, "arena set");
+	fail_unless (1 == pgm_arena_exhausted (arena), "exhausted failed");
+	for (unsigned i = 0; i <= slots; i++)
+		pgm_free_skb (skbs[i]);
+	g_free (skbs);
+	pgm_arena_destroy (arena);
+}
+END_TEST
+
+/* skbuffs outlive the arena owner */
+START_TEST (test_alloc_skb_pass_004)
+{
+	pgm_arena_t* arena = pgm_arena_create (1500, 100, -1, FALSE, NULL);
+	fail_if (NULL == arena, "create failed");
+	struct pgm_sk_buff_t* skb = pgm_arena_alloc_skb (arena, 1500);
+	fail_if (NULL == skb, "alloc_skb failed");
+	pgm_arena_destroy (arena);
+	memset (skb->head, 0xaa, 1500);
+	pgm_free_skb (skb);
+}
+END_TEST
+
+/* target:
+ *	void*
+ *	pgm_arena_alloc_array (
+ *		const pgm_arena_t*const	arena,
+ *		pgm_heap_t*const	heap,
+ *		const size_t		length
+ *	)
+ */
+
+START_TEST (test_alloc_array_pass_001)
+{
+	pgm_arena_t* arena = pgm_arena_create (1500, 100, -1, FALSE, NULL);
+	fail_if (NULL == arena, "create failed");
+/* small arrays from the heap */
+	char* array = pgm_arena_alloc_array (arena, NULL, 1024);
+	fail_if (NULL == array, "alloc_array failed");
+	fail_unless (0 == ((struct pgm_arena_block_t*)array - 1)->length, "not heap");
+	pgm_arena_free_array (NULL, array);
+/* large arrays mapped and zeroed */
+	const size_t length = 4 * PGM_ARENA_HUGE_PAGE_SIZE;
+	array = pgm_arena_alloc_array (arena, NULL, length);
+	fail_if (NULL == array, "alloc_array failed");
+	fail_unless (((struct pgm_arena_block_t*)array - 1)->length >= length, "not mapped");
+	fail_unless (0 == ((uintptr_t)array % PGM_SKB_CACHELINE), "array not aligned");
+	fail_unless (0 == array[0] && 0 == array[length - 1], "not zeroed");
+	pgm_arena_free_array (NULL, array);
+	pgm_arena_destroy (arena);
+}
+END_TEST
+
+/* NULL arena always from the heap */
+START_TEST (test_alloc_array_pass_002)
+{
+	const size_t length = 4 * PGM_ARENA_HUGE_PAGE_SIZE;
+	char* array = pgm_arena_alloc_array (NULL, NULL, length);
+	fail_if (NULL == array, "alloc_array failed");
+	fail_unless (0 == ((struct pgm_arena_block_t*)array - 1)->length, "not heap");
+	pgm_arena_free_array (NULL, array);
+}
+END_TEST
+
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_create = tcase_create ("create");
+	suite_add_tcase (s, tc_create);
+	tcase_add_test (tc_create, test_create_pass_001);
+#if defined(__linux__) && defined(SYS_mbind)
+	tcase_add_test (tc_create, test_create_pass_002);
+	tcase_add_test (tc_create, test_create_pass_003);
+#endif
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_create, test_create_fail_001, SIGABRT);
+	tcase_add_test_raise_signal (tc_create, test_create_fail_002, SIGABRT);
+#endif
+
+	TCase* tc_alloc_skb = tcase_create ("alloc-skb");
+	suite_add_tcase (s, tc_alloc_skb);
+	tcase_add_test (tc_alloc_skb, test_alloc_skb_pass_001);
+	tcase_add_test (tc_alloc_skb, test_alloc_skb_pass_002);
+	tcase_add_test (tc_alloc_skb, test_alloc_skb_pass_003);
+	tcase_add_test (tc_alloc_skb, test_alloc_skb_pass_004);
+
+	TCase* tc_alloc_array = tcase_create ("alloc-array");
+	suite_add_tcase (s, tc_alloc_array);
+	tcase_add_test (tc_alloc_array, test_alloc_array_pass_001);
+	tcase_add_test (tc_alloc_array, test_alloc_array_pass_002);
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
@@ -115,6 +115,36 @@ START_TEST (test_int32_set_pass_001)
 }
 END_TEST
 
+/* target:
+ *	uint32_t
+ *	pgm_atomic_read32_acquire (
+ *		const volatile uint32_t*	atomic
+ *	)
+ */
+
+START_TEST (test_int32_get_acquire_pass_001)
+{
+	volatile uint32_t atomic = (uint32_t)-20;
+	fail_unless ((uint32_t)-20 == pgm_atomic_read32_acquire (&atomic), "read failed");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_atomic_write32_release (
+ *		volatile uint32_t*	atomic,
+ *		const uint32_t		val
+ *	)
+ */
+
+START_TEST (test_int32_set_release_pass_001)
+{
+	volatile uint32_t atomic = (uint32_t)-20;
+	pgm_atomic_write32_release (&atomic, 5);
+	fail_unless (5 == atomic, "write failed");
+}
+END_TEST
+
 
 static
 Suite*
@@ -136,10 +166,12 @@ make_test_suite (void)
 	TCase* tc_get = tcase_create ("get");
 	suite_add_tcase (s, tc_get);
 	tcase_add_test (tc_get, test_int32_get_pass_001);
+	tcase_add_test (tc_get, test_int32_get_acquire_pass_001);
 
 	TCase* tc_set = tcase_create ("set");
 	suite_add_tcase (s, tc_set);
 	tcase_add_test (tc_set, test_int32_set_pass_001);
+	tcase_add_test (tc_set, test_int32_set_release_pass_001);
 
 	return s;
 }
@@ -11,8 +11,6 @@
  * IPoIB by multi-precision add-carry instruction extensions:
  * https://lkml.org/lkml/2013/10/11/534
  *
- * TBD: AVX-512 acceleration.
- *
  * TBD: Checksum HCA acceleration via IB_DEVICE_RAW_IP_CSUM and similar.
  *
  * Reminder: MSVC does not support inline assembler with Win64.
@@ -46,6 +44,38 @@
 #endif
 
 
+/* SIMD kernels are compiled with per-function target attributes and picked
+ * at runtime by pgm_checksum_init() from the CPUID feature flags, such that a
+ * build for baseline x86-64 still runs the widest kernel the host supports.
+ * Without function target support only instruction sets enabled at build
+ * time are available.
+ */
+#if (defined(__amd64) || defined(__x86_64__)) && (defined(__clang__) || (__GNUC__ >= 5))
+#	define CHECKSUM_DISPATCH
+#	define PGM_TARGET(isa)		__attribute__((target(isa)))
+#else
+#	define PGM_TARGET(isa)
+#endif
+
+#if defined(__MMX__) || defined(_M_AMD64) || defined(_M_X64)
+#	define CHECKSUM_HAVE_MMX
+#endif
+#if defined(__SSE2__) || defined(CHECKSUM_DISPATCH) || defined(_M_AMD64) || defined(_M_X64)
+#	define CHECKSUM_HAVE_SSE2
+#endif
+#if defined(__SSE3__) || defined(CHECKSUM_DISPATCH) || defined(_M_AMD64) || defined(_M_X64)
+#	define CHECKSUM_HAVE_SSE3
+#endif
+#if defined(__SSE4_1__) || defined(CHECKSUM_DISPATCH) || defined(_M_AMD64) || defined(_M_X64)
+#	define CHECKSUM_HAVE_SSE41
+#endif
+#if defined(__AVX2__) || defined(CHECKSUM_DISPATCH) || defined(_M_AMD64) || defined(_M_X64)
+#	define CHECKSUM_HAVE_AVX2
+#endif
+#if defined(__AVX512BW__) || defined(CHECKSUM_DISPATCH)
+#	define CHECKSUM_HAVE_AVX512
+#endif
+
 /* locals */
 
 static uint16_t do_csum_8bit (const void*, uint16_t, uint32_t) PGM_GNUC_PURE;
@@ -56,39 +86,42 @@ static uint16_t do_csum_64bit (const void*, uint16_t, uint32_t) PGM_GNUC_PURE;
 static uint16_t do_csum_vector (const void*, uint16_t, uint32_t) PGM_GNUC_PURE;
 #endif
 /* MMX - First generation SIMD instructions, MMX registers are shared with x87 FPU. */
-#if defined(__MMX__) || defined(_M_AMD64) || defined(_M_X64)
-static uint16_t do_csum_mmx (const void*, uint16_t, uint32_t) PGM_GNUC_PURE;
+#ifdef CHECKSUM_HAVE_MMX
+static uint16_t do_csum_mmx (const void*, uint16_t, uint32_t) PGM_TARGET("mmx") PGM_GNUC_PURE;
 #endif
 /* 3DNow! - AMD's twist on MMX, abandoned except for PREFETCH & PREFETCHW. */
 /* SSE - Integer math support only extends the set of 64-bit operations. */
 /* SSE2 - Adds integer instructions on __m128 types. */
-#if defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64)
-static uint16_t do_csum_sse2 (const void*, uint16_t, uint32_t) PGM_GNUC_PURE;
+#ifdef CHECKSUM_HAVE_SSE2
+static uint16_t do_csum_sse2 (const void*, uint16_t, uint32_t) PGM_TARGET("sse2") PGM_GNUC_PURE;
 #endif
 /* SSE3 - Adds unalighed load instruction LDDQU (_mm_lddqu_si128), but no store. */
-#if defined(__SSE3__) || defined(_M_AMD64) || defined(_M_X64)
-static uint16_t do_csum_sse3 (const void*, uint16_t, uint32_t) PGM_GNUC_PURE;
+#ifdef CHECKSUM_HAVE_SSE3
+static uint16_t do_csum_sse3 (const void*, uint16_t, uint32_t) PGM_TARGET("sse3") PGM_GNUC_PURE;
 #endif
 /* SSSE3 - Introduces more packed integer operations. */
 /* SSE4.1 - Adds packed zero extension to wider types. */
-#if defined(__SSE4_1__) || defined(_M_AMD64) || defined(_M_X64)
-static uint16_t do_csum_sse41 (const void*, uint16_t, uint32_t) PGM_GNUC_PURE;
+#ifdef CHECKSUM_HAVE_SSE41
+static uint16_t do_csum_sse41 (const void*, uint16_t, uint32_t) PGM_TARGET("sse4.1") PGM_GNUC_PURE;
 #endif
 /* SSE4.2 - Adds STTN and CRC32 operations. */
 /* POPCNT & LZNCT */
 /* SSE4a - Streaming store and combined mask-shift operation. */
 /* AVX - New three operand instructions. */
 /* AVX2 - Expands existing instructions to 256-bit operands. */
-#if defined(__AVX2__) || defined(_M_AMD64) || defined(_M_X64)
-static uint16_t do_csum_avx2 (const void*, uint16_t, uint32_t) PGM_GNUC_PURE;
+#ifdef CHECKSUM_HAVE_AVX2
+static uint16_t do_csum_avx2 (const void*, uint16_t, uint32_t) PGM_TARGET("avx2") PGM_GNUC_PURE;
 #endif
 /* F16C (SSE5) - Floating point conversion. */
 /* XOP - Extended operations. including integer FMA. horizontal arithmetic. */
 /* FMA - Fused multiply-add. */
-/* AVX-512 - Adds 512-bit operands. */
+/* AVX-512 - Adds 512-bit operands, BW adds 8 and 16-bit operations and byte masks. */
+#ifdef CHECKSUM_HAVE_AVX512
+static uint16_t do_csum_avx512 (const void*, uint16_t, uint32_t) PGM_TARGET("avx512f,avx512bw") PGM_GNUC_PURE;
+#endif
 
 static uint16_t (*do_csum) (const void*, uint16_t, uint32_t) = NULL;
-static uint32_t (*do_csumcpy) (const void* restrict src, void* restrict dst, uint16_t len, uint32_t csum) = NULL;
+static uint16_t (*do_csumcpy) (const void* restrict src, void* restrict dst, uint16_t len, uint32_t csum) = NULL;
 
 /* Explicitly protecting against alignment issues, so hush compiler. */
 #if (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6) || defined(__clang__)
@@ -841,8 +874,9 @@ do_csumcpy_vector (
 }
 #endif
 
-#if defined(__MMX__) || defined(_M_AMD64) || defined(_M_X64)
+#ifdef CHECKSUM_HAVE_MMX
 static
+PGM_TARGET("mmx")
 uint16_t
 do_csum_mmx (
 	const void*	addr,
@@ -908,6 +942,7 @@ do_csum_mmx (
 }
 
 static
+PGM_TARGET("mmx")
 uint16_t
 do_csumcpy_mmx (
 	const void* restrict srcaddr,
@@ -980,10 +1015,11 @@ do_csumcpy_mmx (
 }
 #endif
 
-#if defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64)
+#ifdef CHECKSUM_HAVE_SSE2
 /* The __SSEn__ macros are not defined under MSVC.
  */
 static
+PGM_TARGET("sse2")
 uint16_t
 do_csum_sse2 (
 	const void*	addr,
@@ -1056,6 +1092,7 @@ do_csum_sse2 (
 }
 
 static
+PGM_TARGET("sse2")
 uint16_t
 do_csumcpy_sse2 (
 	const void* restrict srcaddr,
@@ -1141,10 +1178,11 @@ do_csumcpy_sse2 (
 }
 #endif
 
-#if defined(__SSE3__) || defined(_M_AMD64) || defined(_M_X64)
+#ifdef CHECKSUM_HAVE_SSE3
 /* The __SSEn__ macros are not defined under MSVC.
  */
 static
+PGM_TARGET("sse3")
 uint16_t
 do_csum_sse3 (
 	const void*	addr,
@@ -1210,8 +1248,9 @@ do_csum_sse3 (
 }
 #endif
 
-#if defined(__SSE4_1__) || defined(_M_AMD64) || defined(_M_X64)
+#ifdef CHECKSUM_HAVE_SSE41
 static
+PGM_TARGET("sse4.1")
 uint16_t
 do_csum_sse41 (
 	const void*	addr,
@@ -1281,8 +1320,9 @@ do_csum_sse41 (
 }
 #endif
 
-#if defined(__AVX2__) || defined(_M_AMD64) || defined(_M_X64)
+#ifdef CHECKSUM_HAVE_AVX2
 static
+PGM_TARGET("avx2")
 uint16_t
 do_csum_avx2 (
 	const void*	addr,
@@ -1354,6 +1394,7 @@ do_csum_avx2 (
 }
 
 static
+PGM_TARGET("avx2")
 uint16_t
 do_csumcpy_avx2 (
 	const void* restrict srcaddr,
@@ -1447,16 +1488,163 @@ do_csumcpy_avx2 (
 }
 #endif
 
-/* TBD: AVX-512 for Skylake and newer architectures.
- *
- *	_mm512_setzero_si512()
- *	_mm512_load_si512()		- 64-byte alignment
- *	_mm512_unpacklo_epi16()
- *	_mm512_unpackhi_epi16()
- *	_mm512_add_epi32()
- *	_mm512_srli_si512()
- *	_mm512_extract_epi32()
+#ifdef CHECKSUM_HAVE_AVX512
+/* add all 32-bit components together, lanes cannot overflow as at most
+ * 2×1025 16-bit words are summed into each.
+ */
+static inline
+PGM_TARGET("avx512f,avx512bw")
+uint32_t
+do_hadd_avx512 (
+	__m512i		sum
+	)
+{
+	__m256i sum256 = _mm256_add_epi32 (_mm512_castsi512_si256 (sum), _mm512_extracti64x4_epi64 (sum, 1));
+	__m128i sum128 = _mm_add_epi32 (_mm256_castsi256_si128 (sum256), _mm256_extracti128_si256 (sum256, 1));
+	sum128 = _mm_add_epi32 (sum128, _mm_srli_si128 (sum128, 8));
+	sum128 = _mm_add_epi32 (sum128, _mm_srli_si128 (sum128, 4));
+	return (uint32_t)_mm_cvtsi128_si32 (sum128);
+}
+
+/* Unaligned loads carry no penalty within a cache line on Skylake-SP and
+ * newer, the byte-granular mask load replaces the final 63-byte drain: a
+ * trailing odd byte lands in the low half of a zero extended 16-bit word
+ * matching the scalar remainder.
+ */
+static
+PGM_TARGET("avx512f,avx512bw")
+uint16_t
+do_csum_avx512 (
+	const void*	addr,
+	uint16_t	len,
+	uint32_t	csum
+	)
+{
+	uint_fast64_t acc = csum;		/* fixed size for asm */
+	const uint8_t* buf = (const uint8_t*)addr;
+	uint16_t remainder = 0;			/* fixed size for endian swap */
+	uint_fast16_t count64;
+	bool is_odd;
+
+	if (PGM_UNLIKELY(len == 0))
+		return (uint16_t)acc;
+/* align first byte */
+	is_odd = ((uintptr_t)buf & 1);
+	if (PGM_UNLIKELY(is_odd)) {
+		((uint8_t*)&remainder)[1] = *buf++;
+		len--;
+	}
+/* 512-bit, 64-byte stride */
+	count64 = len >> 6;
+	const __m512i zero = _mm512_setzero_si512();
+	__m512i sum = zero;
+	while (count64--) {
+		__m512i tmp = _mm512_loadu_si512((const void*)buf);			// load 512-bit blob
+
+		__m512i lo = _mm512_unpacklo_epi16 (tmp, zero);
+		__m512i hi = _mm512_unpackhi_epi16 (tmp, zero);
+
+		sum = _mm512_add_epi32 (sum, lo);
+		sum = _mm512_add_epi32 (sum, hi);
+		buf += 64;
+	}
+	len %= 64;
+/* final 63 bytes */
+	if (len > 0) {
+		const __mmask64 mask = (__mmask64)((UINT64_C(1) << len) - 1);
+		__m512i tmp = _mm512_maskz_loadu_epi8 (mask, (const void*)buf);
+
+		__m512i lo = _mm512_unpacklo_epi16 (tmp, zero);
+		__m512i hi = _mm512_unpackhi_epi16 (tmp, zero);
+
+		sum = _mm512_add_epi32 (sum, lo);
+		sum = _mm512_add_epi32 (sum, hi);
+	}
+	acc += do_hadd_avx512 (sum);
+	acc += remainder;
+	acc  = (acc >> 32) + (acc & 0xffffffff);
+	acc  = (acc >> 16) + (acc & 0xffff);
+	acc  = (acc >> 16) + (acc & 0xffff);
+	acc += (acc >> 16);
+	if (PGM_UNLIKELY(is_odd))
+		acc = ((acc & 0xff) << 8) | ((acc & 0xff00) >> 8);
+	return (uint16_t)acc;
+}
+
+static
+PGM_TARGET("avx512f,avx512bw")
+uint16_t
+do_csumcpy_avx512 (
+	const void* restrict srcaddr,
+	void* restrict	     dstaddr,
+	uint16_t	     len,
+	uint32_t	     csum
+	)
+{
+	uint64_t acc;			/* fixed size for asm */
+	const uint8_t*restrict srcbuf;
+	uint8_t*restrict dstbuf;
+	uint16_t remainder;		/* fixed size for endian swap */
+	uint_fast16_t count64;
+	bool is_odd;
+
+	acc = csum;
+	srcbuf = (const uint8_t*restrict)srcaddr;
+	dstbuf = (uint8_t*restrict)dstaddr;
+	remainder = 0;
+
+	if (PGM_UNLIKELY(len == 0))
+		return (uint16_t)acc;
+/* fill cache line with source buffer, invalidate destination buffer,
+ * perversly for testing high temporal locality is better than no locality,
+ * whilst in production no locality may be preferred depending on skb re-use.
  */
+	pgm_prefetch (srcbuf);
+	pgm_prefetchw (dstbuf);
+/* align first byte */
+	is_odd = ((uintptr_t)srcbuf & 1);
+	if (PGM_UNLIKELY(is_odd)) {
+		((uint8_t*restrict)&remainder)[1] = *dstbuf++ = *srcbuf++;
+		len--;
+	}
+/* 512-bit, 64-byte stride */
+	count64 = len >> 6;
+	const __m512i zero = _mm512_setzero_si512();
+	__m512i sum = zero;
+	while (count64--) {
+		__m512i tmp = _mm512_loadu_si512((const void*)srcbuf);			// load 512-bit blob
+		__m512i lo = _mm512_unpacklo_epi16 (tmp, zero);
+		__m512i hi = _mm512_unpackhi_epi16 (tmp, zero);
+
+		sum = _mm512_add_epi32 (sum, lo);
+		sum = _mm512_add_epi32 (sum, hi);
+		_mm512_storeu_si512((void*)dstbuf, tmp);
+		srcbuf = &srcbuf[ 64 ];
+		dstbuf = &dstbuf[ 64 ];
+	}
+	len %= 64;
+/* final 63 bytes */
+	if (len > 0) {
+		const __mmask64 mask = (__mmask64)((UINT64_C(1) << len) - 1);
+		__m512i tmp = _mm512_maskz_loadu_epi8 (mask, (const void*)srcbuf);
+		__m512i lo = _mm512_unpacklo_epi16 (tmp, zero);
+		__m512i hi = _mm512_unpackhi_epi16 (tmp, zero);
+
+		sum = _mm512_add_epi32 (sum, lo);
+		sum = _mm512_add_epi32 (sum, hi);
+		_mm512_mask_storeu_epi8 ((void*)dstbuf, mask, tmp);
+	}
+	acc += do_hadd_avx512 (sum);
+	acc += remainder;
+	acc  = (acc >> 32) + (acc & 0xffffffff);
+	acc  = (acc >> 16) + (acc & 0xffff);
+	acc  = (acc >> 16) + (acc & 0xffff);
+	acc += (acc >> 16);
+	if (PGM_UNLIKELY(is_odd))
+		acc = ((acc & 0xff) << 8) | ((acc & 0xff00) >> 8);
+	return (uint16_t)acc;
+}
+#endif
 
 static
 uint16_t
@@ -1475,7 +1663,15 @@ PGM_GNUC_INTERNAL
 void
 pgm_checksum_init (const pgm_cpu_t* cpu)
 {
-#if defined(__AVX2__) || defined(_M_AMD64) || defined(_M_X64)
+#ifdef CHECKSUM_HAVE_AVX512
+	if (cpu->has_avx512bw) {
+		pgm_minor (_("Using AVX-512 instructions for checksum."));
+		do_csum = do_csum_avx512;
+		do_csumcpy = do_csumcpy_avx512;
+		return;
+	}
+#endif
+#ifdef CHECKSUM_HAVE_AVX2
 	if (cpu->has_avx2) {
 		pgm_minor (_("Using AVX2 instructions for checksum."));
 		do_csum = do_csum_avx2;
@@ -1483,7 +1679,7 @@ pgm_checksum_init (const pgm_cpu_t* cpu)
 		return;
 	}
 #endif
-#if defined(__SSE4_1_) || defined(_M_AMD64) || defined(_M_X64)
+#ifdef CHECKSUM_HAVE_SSE41
 	if (cpu->has_sse41) {
 		pgm_minor (_("Using SSE4.1 instructions for checksum."));
 		do_csum = do_csum_sse41;
@@ -1491,7 +1687,7 @@ pgm_checksum_init (const pgm_cpu_t* cpu)
 		return;
 	}
 #endif
-#if defined(__SSE3__) || defined(_M_AMD64) || defined(_M_X64)
+#ifdef CHECKSUM_HAVE_SSE3
 	if (cpu->has_sse3) {
 		pgm_minor (_("Using SSE3 instructions for checksum."));
 		do_csum = do_csum_sse3;
@@ -1499,7 +1695,7 @@ pgm_checksum_init (const pgm_cpu_t* cpu)
 		return;
 	}
 #endif
-#if defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64)
+#ifdef CHECKSUM_HAVE_SSE2
 	if (cpu->has_sse2) {
 		pgm_minor (_("Using SSE2 instructions for checksum."));
 		do_csum = do_csum_sse2;
@@ -1507,7 +1703,7 @@ pgm_checksum_init (const pgm_cpu_t* cpu)
 		return;
 	}
 #endif
-#if defined(__MMX__) || defined(_M_AMD64) || defined(_M_X64)
+#ifdef CHECKSUM_HAVE_MMX
 	if (cpu->has_mmx) {
 		pgm_minor (_("Using MMX instructions for checksum."));
 		do_csum = do_csum_mmx;
@@ -88,6 +88,8 @@ pgm_transport_pkt_offset2 (
 #define CHECKSUM_DEBUG
 #include "checksum.c"
 
+static pgm_cpu_t perf_cpu;
+
 PGM_GNUC_INTERNAL
 int
 pgm_get_nprocs (void)
@@ -572,7 +574,7 @@ START_TEST (test_vector_csumcpy)
 END_TEST
 #endif
 
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
 START_TEST (test_mmx)
 {
 	const unsigned iterations = 1000;
@@ -664,7 +666,7 @@ START_TEST (test_mmx_csumcpy)
 END_TEST
 #endif
 
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
 START_TEST (test_sse2)
 {
 	const unsigned iterations = 1000;
@@ -756,7 +758,7 @@ START_TEST (test_sse2_csumcpy)
 END_TEST
 #endif
 
-#ifdef __SSE3__
+#ifdef CHECKSUM_HAVE_SSE3
 START_TEST (test_sse3)
 {
 	const unsigned iterations = 1000;
@@ -818,7 +820,7 @@ START_TEST (test_sse3_memcpy)
 END_TEST
 #endif
 
-#ifdef __SSE4_1__
+#ifdef CHECKSUM_HAVE_SSE41
 START_TEST (test_sse41)
 {
 	const unsigned iterations = 1000;
@@ -880,7 +882,7 @@ START_TEST (test_sse41_memcpy)
 END_TEST
 #endif
 
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
 START_TEST (test_avx2)
 {
 	const unsigned iterations = 1000;
@@ -972,6 +974,98 @@ START_TEST (test_avx2_csumcpy)
 END_TEST
 #endif
 
+#ifdef CHECKSUM_HAVE_AVX512
+START_TEST (test_avx512)
+{
+	const unsigned iterations = 1000;
+	char* source = alloca (perf_testsize);
+	for (unsigned i = 0, j = 0; i < perf_testsize; i++) {
+		j = j * 1103515245 + 12345;
+		source[i] = j;
+	}
+	const guint16 answer = perf_answer;		/* network order */
+
+	guint16 csum;
+	pgm_time_t start, check;
+
+	start = pgm_time_update_now();
+	for (unsigned i = iterations; i; i--) {
+		csum = ~do_csum_avx512 (source, perf_testsize, 0);
+/* function calculates answer in host order */
+		csum = g_htons (csum);
+		fail_unless (answer == csum, "checksum mismatch 0x%04x (0x%04x)", csum, answer);
+	}
+
+	check = pgm_time_update_now();
+	g_message ("avx512/%u: elapsed time %" PGM_TIME_FORMAT " us, unit time %" PGM_TIME_FORMAT " us",
+		perf_testsize,
+		(guint64)(check - start),
+		(guint64)((check - start) / iterations));
+}
+END_TEST
+
+START_TEST (test_avx512_memcpy)
+{
+	const unsigned iterations = 1000;
+	char* source = alloca (perf_testsize);
+	char* target = alloca (perf_testsize);
+	for (unsigned i = 0, j = 0; i < perf_testsize; i++) {
+		j = j * 1103515245 + 12345;
+		source[i] = j;
+	}
+	const guint16 answer = perf_answer;		/* network order */
+
+	guint16 csum;
+	pgm_time_t start, check;
+
+	start = pgm_time_update_now();
+	for (unsigned i = iterations; i; i--) {
+		memcpy (target, source, perf_testsize);
+		csum = ~do_csum_avx512 (target, perf_testsize, 0);
+/* function calculates answer in host order */
+		csum = g_htons (csum);
+		fail_unless (answer == csum, "checksum mismatch 0x%04x (0x%04x)", csum, answer);
+	}
+
+	check = pgm_time_update_now();
+	g_message ("avx512/%u: elapsed time %" PGM_TIME_FORMAT " us, unit time %" PGM_TIME_FORMAT " us",
+		perf_testsize,
+		(guint64)(check - start),
+		(guint64)((check - start) / iterations));
+}
+END_TEST
+
+START_TEST (test_avx512_csumcpy)
+{
+	const unsigned iterations = 1000;
+	char* source = alloca (perf_testsize);
+	char* target = alloca (perf_testsize);
+	for (unsigned i = 0, j = 0; i < perf_testsize; i++) {
+		j = j * 1103515245 + 12345;
+		source[i] = j;
+	}
+	const guint16 answer = perf_answer;		/* network order */
+
+	guint16 csum;
+	pgm_time_t start, check;
+
+	start = pgm_time_update_now();
+	for (unsigned i = iterations; i; i--) {
+		csum = ~do_csumcpy_avx512 (source, target, perf_testsize, 0);
+/* function calculates answer in host order */
+		csum = g_htons (csum);
+		fail_unless (answer == csum, "checksum mismatch 0x%04x (0x%04x)", csum, answer);
+	}
+
+	check = pgm_time_update_now();
+	g_message ("avx512/%u: elapsed time %" PGM_TIME_FORMAT " us, unit time %" PGM_TIME_FORMAT " us",
+		perf_testsize,
+		(guint64)(check - start),
+		(guint64)((check - start) / iterations));
+}
+END_TEST
+#endif
+
 static
 Suite*
 make_csum_performance_suite (void)
@@ -991,21 +1085,30 @@ make_csum_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_100b, test_vector);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_100b, test_mmx);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_100b, test_sse2);
 #endif
-#ifdef __SSE3__
+#ifdef CHECKSUM_HAVE_SSE3
+	if (perf_cpu.has_sse3)
 	tcase_add_test (tc_100b, test_sse3);
 #endif
-#ifdef __SSE4_1__
+#ifdef CHECKSUM_HAVE_SSE41
+	if (perf_cpu.has_sse41)
 	tcase_add_test (tc_100b, test_sse41);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_100b, test_avx2);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_100b, test_avx512);
+#endif
 
 	TCase* tc_200b = tcase_create ("200b");
 	suite_add_tcase (s, tc_200b);
@@ -1018,21 +1121,30 @@ make_csum_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_200b, test_vector);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_200b, test_mmx);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_200b, test_sse2);
 #endif
-#ifdef __SSE3__
+#ifdef CHECKSUM_HAVE_SSE3
+	if (perf_cpu.has_sse3)
 	tcase_add_test (tc_200b, test_sse3);
 #endif
-#ifdef __SSE4_1__
+#ifdef CHECKSUM_HAVE_SSE41
+	if (perf_cpu.has_sse41)
 	tcase_add_test (tc_200b, test_sse41);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_200b, test_avx2);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_200b, test_avx512);
+#endif
 
 	TCase* tc_1500b = tcase_create ("1500b");
 	suite_add_tcase (s, tc_1500b);
@@ -1045,21 +1157,30 @@ make_csum_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_1500b, test_vector);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_1500b, test_mmx);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_1500b, test_sse2);
 #endif
-#ifdef __SSE3__
+#ifdef CHECKSUM_HAVE_SSE3
+	if (perf_cpu.has_sse3)
 	tcase_add_test (tc_1500b, test_sse3);
 #endif
-#ifdef __SSE4_1__
+#ifdef CHECKSUM_HAVE_SSE41
+	if (perf_cpu.has_sse41)
 	tcase_add_test (tc_1500b, test_sse41);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_1500b, test_avx2);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_1500b, test_avx512);
+#endif
 
 	TCase* tc_9kb = tcase_create ("9KB");
 	suite_add_tcase (s, tc_9kb);
@@ -1072,21 +1193,30 @@ make_csum_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_9kb, test_vector);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_9kb, test_mmx);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_9kb, test_sse2);
 #endif
-#ifdef __SSE3__
+#ifdef CHECKSUM_HAVE_SSE3
+	if (perf_cpu.has_sse3)
 	tcase_add_test (tc_9kb, test_sse3);
 #endif
-#ifdef __SSE4_1__
+#ifdef CHECKSUM_HAVE_SSE41
+	if (perf_cpu.has_sse41)
 	tcase_add_test (tc_9kb, test_sse41);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_9kb, test_avx2);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_9kb, test_avx512);
+#endif
 
 	TCase* tc_64kb = tcase_create ("64KB");
 	suite_add_tcase (s, tc_64kb);
@@ -1099,21 +1229,30 @@ make_csum_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_64kb, test_vector);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_64kb, test_mmx);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_64kb, test_sse2);
 #endif
-#ifdef __SSE3__
+#ifdef CHECKSUM_HAVE_SSE3
+	if (perf_cpu.has_sse3)
 	tcase_add_test (tc_64kb, test_sse3);
 #endif
-#ifdef __SSE4_1__
+#ifdef CHECKSUM_HAVE_SSE41
+	if (perf_cpu.has_sse41)
 	tcase_add_test (tc_64kb, test_sse41);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_64kb, test_avx2);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_64kb, test_avx512);
+#endif
 
 	return s;
 }
@@ -1137,21 +1276,30 @@ make_csum_memcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_100b, test_vector_memcpy);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_100b, test_mmx);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_100b, test_sse2_memcpy);
 #endif
-#ifdef __SSE3__
+#ifdef CHECKSUM_HAVE_SSE3
+	if (perf_cpu.has_sse3)
 	tcase_add_test (tc_100b, test_sse3_memcpy);
 #endif
-#ifdef __SSE4_1__
+#ifdef CHECKSUM_HAVE_SSE41
+	if (perf_cpu.has_sse41)
 	tcase_add_test (tc_100b, test_sse41_memcpy);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_100b, test_avx2_memcpy);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_100b, test_avx512_memcpy);
+#endif
 
 	TCase* tc_200b = tcase_create ("200b");
 	suite_add_tcase (s, tc_200b);
@@ -1164,21 +1312,30 @@ make_csum_memcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_200b, test_vector_memcpy);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_200b, test_mmx);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_200b, test_sse2_memcpy);
 #endif
-#ifdef __SSE3__
+#ifdef CHECKSUM_HAVE_SSE3
+	if (perf_cpu.has_sse3)
 	tcase_add_test (tc_200b, test_sse3_memcpy);
 #endif
-#ifdef __SSE4_1__
+#ifdef CHECKSUM_HAVE_SSE41
+	if (perf_cpu.has_sse41)
 	tcase_add_test (tc_200b, test_sse41_memcpy);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_200b, test_avx2_memcpy);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_200b, test_avx512_memcpy);
+#endif
 
 	TCase* tc_1500b = tcase_create ("1500b");
 	suite_add_tcase (s, tc_1500b);
@@ -1191,21 +1348,30 @@ make_csum_memcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_1500b, test_vector_memcpy);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_1500b, test_mmx);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_1500b, test_sse2_memcpy);
 #endif
-#ifdef __SSE3__
+#ifdef CHECKSUM_HAVE_SSE3
+	if (perf_cpu.has_sse3)
 	tcase_add_test (tc_1500b, test_sse3_memcpy);
 #endif
-#ifdef __SSE4_1__
+#ifdef CHECKSUM_HAVE_SSE41
+	if (perf_cpu.has_sse41)
 	tcase_add_test (tc_1500b, test_sse41_memcpy);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_1500b, test_avx2_memcpy);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_1500b, test_avx512_memcpy);
+#endif
 
 	TCase* tc_9kb = tcase_create ("9KB");
 	suite_add_tcase (s, tc_9kb);
@@ -1218,21 +1384,30 @@ make_csum_memcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_9kb, test_vector_memcpy);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_9kb, test_mmx);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_9kb, test_sse2_memcpy);
 #endif
-#ifdef __SSE3__
+#ifdef CHECKSUM_HAVE_SSE3
+	if (perf_cpu.has_sse3)
 	tcase_add_test (tc_9kb, test_sse3_memcpy);
 #endif
-#ifdef __SSE4_1__
+#ifdef CHECKSUM_HAVE_SSE41
+	if (perf_cpu.has_sse41)
 	tcase_add_test (tc_9kb, test_sse41_memcpy);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_9kb, test_avx2_memcpy);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_9kb, test_avx512_memcpy);
+#endif
 
 	TCase* tc_64kb = tcase_create ("64KB");
 	suite_add_tcase (s, tc_64kb);
@@ -1245,21 +1420,30 @@ make_csum_memcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_64kb, test_vector_memcpy);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_64kb, test_mmx);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_64kb, test_sse2_memcpy);
 #endif
-#ifdef __SSE3__
+#ifdef CHECKSUM_HAVE_SSE3
+	if (perf_cpu.has_sse3)
 	tcase_add_test (tc_64kb, test_sse3_memcpy);
 #endif
-#ifdef __SSE4_1__
+#ifdef CHECKSUM_HAVE_SSE41
+	if (perf_cpu.has_sse41)
 	tcase_add_test (tc_64kb, test_sse41_memcpy);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_64kb, test_avx2_memcpy);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_64kb, test_avx512_memcpy);
+#endif
 
 	return s;
 }
@@ -1283,15 +1467,22 @@ make_csumcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_100b, test_vector_csumcpy);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_100b, test_mmx_csumcpy);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_100b, test_sse2_csumcpy);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_100b, test_avx2_csumcpy);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_100b, test_avx512_csumcpy);
+#endif
 
 	TCase* tc_200b = tcase_create ("200b");
 	suite_add_tcase (s, tc_200b);
@@ -1304,15 +1495,22 @@ make_csumcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_200b, test_vector_csumcpy);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_200b, test_mmx_csumcpy);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_200b, test_sse2_csumcpy);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_200b, test_avx2_csumcpy);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_200b, test_avx512_csumcpy);
+#endif
 
 	TCase* tc_1500b = tcase_create ("1500b");
 	suite_add_tcase (s, tc_1500b);
@@ -1325,15 +1523,22 @@ make_csumcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_1500b, test_vector_csumcpy);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_1500b, test_mmx_csumcpy);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_1500b, test_sse2_csumcpy);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_1500b, test_avx2_csumcpy);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_1500b, test_avx512_csumcpy);
+#endif
 
 	TCase* tc_9kb = tcase_create ("9KB");
 	suite_add_tcase (s, tc_9kb);
@@ -1346,15 +1551,22 @@ make_csumcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_9kb, test_vector_csumcpy);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_9kb, test_mmx_csumcpy);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_9kb, test_sse2_csumcpy);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_9kb, test_avx2_csumcpy);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_9kb, test_avx512_csumcpy);
+#endif
 
 	TCase* tc_64kb = tcase_create ("64KB");
 	suite_add_tcase (s, tc_64kb);
@@ -1367,15 +1579,22 @@ make_csumcpy_performance_suite (void)
 #if defined(__amd64) || defined(__x86_64__) || defined(_WIN64)
 	tcase_add_test (tc_64kb, test_vector_csumcpy);
 #endif
-#ifdef __MMX__
+#ifdef CHECKSUM_HAVE_MMX
+	if (perf_cpu.has_mmx)
 	tcase_add_test (tc_64kb, test_mmx_csumcpy);
 #endif
-#ifdef __SSE2__
+#ifdef CHECKSUM_HAVE_SSE2
+	if (perf_cpu.has_sse2)
 	tcase_add_test (tc_64kb, test_sse2_csumcpy);
 #endif
-#ifdef __AVX2__
+#ifdef CHECKSUM_HAVE_AVX2
+	if (perf_cpu.has_avx2)
 	tcase_add_test (tc_64kb, test_avx2_csumcpy);
 #endif
+#ifdef CHECKSUM_HAVE_AVX512
+	if (perf_cpu.has_avx512bw)
+	tcase_add_test (tc_64kb, test_avx512_csumcpy);
+#endif
 
 	return s;
 }
@@ -1392,6 +1611,7 @@ make_master_suite (void)
 int
 main (void)
 {
+	pgm_cpuid (&perf_cpu);
 	SRunner* sr = srunner_create (make_master_suite ());
 	srunner_add_suite (sr, make_csum_performance_suite ());
 	srunner_add_suite (sr, make_csum_memcpy_performance_suite ());
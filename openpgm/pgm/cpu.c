@@ -37,10 +37,17 @@
 static
 void
 __cpuidex (int cpu_info[4], int function_id, int subfunction_id) {
+/* preserve all of RBX, 32-bit moves would clear the upper half on x86-64 */
   __asm__ volatile (
+#  if defined(__x86_64__)
+    "mov %%rbx, %%rdi\n"
+    "cpuid\n"
+    "xchg %%rdi, %%rbx\n"
+#  else
     "mov %%ebx, %%edi\n"
     "cpuid\n"
     "xchg %%edi, %%ebx\n"
+#  endif
     : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
     : "a"(function_id), "c"(subfunction_id)
   );
@@ -92,6 +99,41 @@ pgm_cpuid (pgm_cpu_t* cpu)
 			(cpu_info[2] & 0x08000000) != 0 /* OSXSAVE */ &&
 			(_xgetbv(0) & 6) == 6 /* XSAVE enabled by kernel */;
 	cpu->has_avx2 = cpu->has_avx && (cpu_info7[1] & 0x00000020) != 0;
+/* AVX-512 additionally requires the kernel to save opmask and ZMM state */
+	cpu->has_avx512f = cpu->has_avx &&
+			(cpu_info7[1] & 0x00010000) != 0 &&
+			(_xgetbv(0) & 0xe0) == 0xe0;
+	cpu->has_avx512bw = cpu->has_avx512f && (cpu_info7[1] & 0x40000000) != 0;
+
+/* TSC frequency: leaf 0x15 gives the TSC to core crystal ratio and, when
+ * enumerated, the crystal frequency.
+ */
+	if (num_ids >= 0x15) {
+		int cpu_info15[4] = {0};
+		__cpuidex (cpu_info15, 0x15, 0x0);
+		if (cpu_info15[0] && cpu_info15[1] && cpu_info15[2])
+			cpu->tsc_khz = (uint32_t)(((uint64_t)(uint32_t)cpu_info15[2] * (uint32_t)cpu_info15[1]) /
+						  ((uint64_t)(uint32_t)cpu_info15[0] * 1000));
+	}
+	if (num_ids >= 0x16) {
+		int cpu_info16[4] = {0};
+		__cpuidex (cpu_info16, 0x16, 0x0);
+		cpu->base_mhz = cpu_info16[0] & 0xffff;
+	}
+/* hypervisor timing leaf as exposed by VMware and KVM */
+	if (0 == cpu->tsc_khz && (cpu_info[2] & 0x80000000) != 0) {
+		int cpu_infohv[4] = {0};
+		__cpuidex (cpu_infohv, 0x40000000, 0x0);
+		if ((uint32_t)cpu_infohv[0] >= 0x40000010) {
+			__cpuidex (cpu_infohv, 0x40000010, 0x0);
+			cpu->tsc_khz = (uint32_t)cpu_infohv[0];
+		}
+	}
+	__cpuidex (cpu_info, 0x80000000, 0x0);
+	if ((uint32_t)cpu_info[0] >= 0x80000007) {
+		__cpuidex (cpu_info, 0x80000007, 0x0);
+		cpu->has_invariant_tsc = (cpu_info[3] & 0x00000100) != 0;
+	}
 }
 
 /* eof */
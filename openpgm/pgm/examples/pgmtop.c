@@ -755,7 +755,7 @@ on_io_data (
 	g_packets++;
 
 	GError* err = NULL;
-	gboolean is_valid = pgm_parse_raw (skb, (struct sockaddr*)&dst, &err);
+	gboolean is_valid = pgm_parse_raw (skb, (struct sockaddr*)&dst, 0, &err);
 	if (!is_valid && err && PGM_PACKET_ERROR_CKSUM == err->code)
 	{
 /* corrupt packet */
@@ -0,0 +1,496 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * Worker pool for off-loading parity reconstruction of transmission groups.
+ *
+ * Reed-Solomon decoding of a transmission group is a pure function of the
+ * received data and parity payloads, so only gathering the inputs and
+ * committing the recovered skbuffs need to occur inside the receive window
+ * lock.  Completed jobs are queued for the receiving thread which inserts
+ * the recovered packets in sequence order.
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#include <errno.h>
+#ifdef _WIN32
+#	include <process.h>
+#endif
+#include <impl/i18n.h>
+#include <impl/framework.h>
+
+
+//#define FEC_POOL_DEBUG
+
+#ifndef FEC_POOL_DEBUG
+#	define PGM_DISABLE_ASSERT
+#endif
+
+struct pgm_fec_worker_t {
+	pgm_fec_pool_t*		pool;
+#ifndef _WIN32
+	pthread_t		thread;
+#else
+	HANDLE			thread;
+#endif
+	pgm_fec_job_t*		job;			/* in progress */
+	pgm_rs_t		rs;			/* private decode matrices */
+	bool			is_running;
+};
+
+struct pgm_fec_pool_t {
+	pgm_mutex_t		mutex;
+	pgm_cond_t		work_cond;		/* new job or shutdown */
+	pgm_cond_t		idle_cond;		/* job finished */
+	pgm_queue_t		incoming;
+	pgm_queue_t		completed;
+	volatile uint32_t	completed_count;	/* atomic */
+	bool			is_shutdown;
+
+	pgm_fec_pool_notify_func notify_func;
+	void*			notify_data;
+
+	unsigned		n_workers;
+	struct pgm_fec_worker_t	workers[];
+};
+
+#ifndef _WIN32
+static void* pgm_fec_worker_routine (void*);
+#else
+static unsigned __stdcall pgm_fec_worker_routine (void*);
+#endif
+
+
+/* create a pool of worker threads for transmission group decoding.  notify_func
+ * is called from the worker thread each time a job completes.
+ *
+ * returns pointer to new pool on success, returns NULL on error and sets error
+ * appropriately.
+ */
+
+PGM_GNUC_INTERNAL
+pgm_fec_pool_t*
+pgm_fec_pool_create (
+	const unsigned			 n_workers,
+	pgm_fec_pool_notify_func	 notify_func,
+	void*				 notify_data,
+	pgm_error_t**	        restrict error
+	)
+{
+	pgm_fec_pool_t* pool;
+
+/* pre-conditions */
+	pgm_assert_cmpuint (n_workers, >, 0);
+	pgm_assert_cmpuint (n_workers, <=, PGM_FEC_POOL_MAX_WORKERS);
+
+	pgm_debug ("pgm_fec_pool_create (n-workers:%u notify-func:%p notify-data:%p error:%p)",
+		n_workers, (void*)notify_func, notify_data, (void*)error);
+
+	pool = pgm_malloc0 (sizeof(pgm_fec_pool_t) + ( n_workers * sizeof(struct pgm_fec_worker_t) ));
+	pgm_mutex_init (&pool->mutex);
+	pgm_cond_init (&pool->work_cond);
+	pgm_cond_init (&pool->idle_cond);
+	pool->notify_func = notify_func;
+	pool->notify_data = notify_data;
+
+	for (unsigned i = 0; i < n_workers; i++)
+	{
+		struct pgm_fec_worker_t* worker = &pool->workers[ i ];
+		worker->pool = pool;
+#ifndef _WIN32
+		const int status = pthread_create (&worker->thread, NULL, &pgm_fec_worker_routine, worker);
+		if (0 != status) {
+			const int save_errno = status;
+#else
+		worker->thread = (HANDLE)_beginthreadex (NULL, 0, &pgm_fec_worker_routine, worker, 0, NULL);
+		if (0 == worker->thread) {
+			const int save_errno = errno;
+#endif
+			char errbuf[1024];
+			pgm_set_error (error,
+				     PGM_ERROR_DOMAIN_SOCKET,
+				     pgm_error_from_errno (save_errno),
+				     _("Creating FEC worker thread: %s"),
+				     pgm_strerror_s (errbuf, sizeof (errbuf), save_errno));
+			pgm_fec_pool_destroy (pool);
+			return NULL;
+		}
+		worker->is_running = TRUE;
+		pool->n_workers++;
+	}
+	return pool;
+}
+
+/* stop all workers, discarding outstanding jobs.  all receive windows should
+ * already be destroyed.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_fec_pool_destroy (
+	pgm_fec_pool_t*		pool
+	)
+{
+	pgm_list_t* link_;
+
+/* pre-conditions */
+	pgm_assert (NULL != pool);
+
+	pgm_debug ("pgm_fec_pool_destroy (pool:%p)", (void*)pool);
+
+	pgm_mutex_lock (&pool->mutex);
+	pool->is_shutdown = TRUE;
+	pgm_cond_broadcast (&pool->work_cond);
+	pgm_mutex_unlock (&pool->mutex);
+
+	for (unsigned i = 0; i < pool->n_workers; i++)
+	{
+		struct pgm_fec_worker_t* worker = &pool->workers[ i ];
+		if (!worker->is_running)
+			continue;
+#ifndef _WIN32
+		pthread_join (worker->thread, NULL);
+#else
+		WaitForSingleObject (worker->thread, INFINITE);
+		CloseHandle (worker->thread);
+#endif
+		if (worker->rs.k)
+			pgm_rs_destroy (&worker->rs);
+	}
+
+	while ((link_ = pgm_queue_pop_tail_link (&pool->incoming)))
+		pgm_fec_job_free ((pgm_fec_job_t*)link_);
+	while ((link_ = pgm_queue_pop_tail_link (&pool->completed)))
+		pgm_fec_job_free ((pgm_fec_job_t*)link_);
+
+	pgm_cond_free (&pool->idle_cond);
+	pgm_cond_free (&pool->work_cond);
+	pgm_mutex_free (&pool->mutex);
+	pgm_free (pool);
+}
+
+/* allocate a decode job for RS(n, k) with a single allocation covering the
+ * skbuff, payload and offset vectors.
+ */
+
+PGM_GNUC_INTERNAL
+pgm_fec_job_t*
+pgm_fec_job_new (
+	const uint8_t		rs_n,
+	const uint8_t		rs_k
+	)
+{
+	pgm_fec_job_t* job;
+	char* p;
+
+/* pre-conditions */
+	pgm_assert_cmpuint (rs_k, >, 1);
+	pgm_assert_cmpuint (rs_n, >, rs_k);
+
+	job = pgm_malloc0 (sizeof(pgm_fec_job_t) +
+			   ( rs_n * sizeof(struct pgm_sk_buff_t*) ) +
+			   ( rs_n * sizeof(pgm_gf8_t*) ) +
+			   ( rs_n * sizeof(pgm_gf8_t*) ) +
+			   ( rs_k * sizeof(uint8_t) ));
+	job->rs_n = rs_n;
+	job->rs_k = rs_k;
+	p = (char*)(job + 1);
+	job->tg_skbs = (struct pgm_sk_buff_t**)p;	p += rs_n * sizeof(struct pgm_sk_buff_t*);
+	job->tg_data = (pgm_gf8_t**)p;			p += rs_n * sizeof(pgm_gf8_t*);
+	job->tg_opts = (pgm_gf8_t**)p;			p += rs_n * sizeof(pgm_gf8_t*);
+	job->offsets = (uint8_t*)p;
+	return job;
+}
+
+/* release every skbuff reference remaining in the job.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_fec_job_free (
+	pgm_fec_job_t*		job
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != job);
+
+	for (unsigned i = 0; i < job->rs_n; i++)
+		if (job->tg_skbs[ i ])
+			pgm_free_skb (job->tg_skbs[ i ]);
+	pgm_free (job);
+}
+
+/* queue a job for decoding by the next available worker.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_fec_pool_push (
+	pgm_fec_pool_t* const restrict pool,
+	pgm_fec_job_t*  const restrict job
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != pool);
+	pgm_assert (NULL != job);
+
+	pgm_mutex_lock (&pool->mutex);
+	pgm_queue_push_head_link (&pool->incoming, &job->link_);
+	pgm_cond_signal (&pool->work_cond);
+	pgm_mutex_unlock (&pool->mutex);
+}
+
+/* returns TRUE if decoded jobs are waiting to be committed, safe to call without lock.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_fec_pool_has_completed (
+	const pgm_fec_pool_t* const pool
+	)
+{
+	pgm_assert (NULL != pool);
+	return (0 != pgm_atomic_read32 (&pool->completed_count));
+}
+
+/* returns the oldest decoded job, or NULL if none are waiting.  caller owns the
+ * returned job.
+ */
+
+PGM_GNUC_INTERNAL
+pgm_fec_job_t*
+pgm_fec_pool_pop_completed (
+	pgm_fec_pool_t* const	pool
+	)
+{
+	pgm_list_t* link_;
+
+/* pre-conditions */
+	pgm_assert (NULL != pool);
+
+	if (!pgm_fec_pool_has_completed (pool))
+		return NULL;
+
+	pgm_mutex_lock (&pool->mutex);
+	link_ = pgm_queue_pop_tail_link (&pool->completed);
+	if (link_)
+		pgm_atomic_dec32 (&pool->completed_count);
+	pgm_mutex_unlock (&pool->mutex);
+	return (pgm_fec_job_t*)link_;
+}
+
+static
+bool
+_pgm_fec_queue_contains (
+	const pgm_queue_t* const queue,
+	const void*	   const window,
+	const uint32_t		 tg_sqn
+	)
+{
+	for (const pgm_list_t* it = queue->head; it; it = it->next)
+	{
+		const pgm_fec_job_t* job = (const pgm_fec_job_t*)it;
+		if (job->window == window && job->tg_sqn == tg_sqn)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+/* returns TRUE if the transmission group is queued, being decoded, or decoded
+ * and waiting to be committed.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_fec_pool_is_pending (
+	pgm_fec_pool_t* const	pool,
+	const void*	const	window,
+	const uint32_t		tg_sqn
+	)
+{
+	bool is_pending;
+
+/* pre-conditions */
+	pgm_assert (NULL != pool);
+	pgm_assert (NULL != window);
+
+	pgm_mutex_lock (&pool->mutex);
+	is_pending = _pgm_fec_queue_contains (&pool->incoming, window, tg_sqn) ||
+		     _pgm_fec_queue_contains (&pool->completed, window, tg_sqn);
+	for (unsigned i = 0; !is_pending && i < pool->n_workers; i++)
+	{
+		const pgm_fec_job_t* job = pool->workers[ i ].job;
+		if (job && job->window == window && job->tg_sqn == tg_sqn)
+			is_pending = TRUE;
+	}
+	pgm_mutex_unlock (&pool->mutex);
+	return is_pending;
+}
+
+static
+void
+_pgm_fec_queue_cancel (
+	pgm_queue_t* const	queue,
+	const void*  const	window
+	)
+{
+	pgm_list_t* it = queue->head;
+	while (it)
+	{
+		pgm_list_t* next = it->next;
+		if (((pgm_fec_job_t*)it)->window == window) {
+			pgm_queue_unlink (queue, it);
+			pgm_fec_job_free ((pgm_fec_job_t*)it);
+		}
+		it = next;
+	}
+}
+
+/* discard all jobs for a receive window, blocking until any in progress decode
+ * for the window has finished.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_fec_pool_cancel (
+	pgm_fec_pool_t* const	pool,
+	const void*	const	window
+	)
+{
+	bool is_busy;
+
+/* pre-conditions */
+	pgm_assert (NULL != pool);
+	pgm_assert (NULL != window);
+
+	pgm_debug ("pgm_fec_pool_cancel (pool:%p window:%p)", (void*)pool, window);
+
+	pgm_mutex_lock (&pool->mutex);
+	_pgm_fec_queue_cancel (&pool->incoming, window);
+	do {
+		is_busy = FALSE;
+		for (unsigned i = 0; i < pool->n_workers; i++)
+		{
+			const pgm_fec_job_t* job = pool->workers[ i ].job;
+			if (job && job->window == window) {
+				is_busy = TRUE;
+				break;
+			}
+		}
+		if (is_busy)
+#ifndef _WIN32
+			pgm_cond_wait (&pool->idle_cond, &pool->mutex.pthread_mutex);
+#else
+			pgm_cond_wait (&pool->idle_cond, &pool->mutex.win32_crit);
+#endif
+	} while (is_busy);
+	const unsigned completed_length = pool->completed.length;
+	_pgm_fec_queue_cancel (&pool->completed, window);
+	for (unsigned i = pool->completed.length; i < completed_length; i++)
+		pgm_atomic_dec32 (&pool->completed_count);
+	pgm_mutex_unlock (&pool->mutex);
+}
+
+/* decode one transmission group with the workers private RS matrices, the
+ * decoding matrix is rebuilt in place and cannot be shared between threads.
+ */
+
+static
+void
+_pgm_fec_worker_decode (
+	struct pgm_fec_worker_t* const restrict worker,
+	pgm_fec_job_t*		 const restrict job
+	)
+{
+	if (worker->rs.k != job->rs_k || worker->rs.n != job->rs_n) {
+		if (worker->rs.k)
+			pgm_rs_destroy (&worker->rs);
+		pgm_rs_create (&worker->rs, job->rs_n, job->rs_k);
+	}
+
+	pgm_rs_decode_parity_appended (&worker->rs,
+				       job->tg_data,
+				       job->offsets,
+				       job->parity_length);
+	if (job->is_op_encoded)
+		pgm_rs_decode_parity_appended (&worker->rs,
+					       job->tg_opts,
+					       job->offsets,
+					       sizeof(struct pgm_opt_fragment));
+}
+
+static
+#ifndef _WIN32
+void*
+#else
+unsigned
+__stdcall
+#endif
+pgm_fec_worker_routine (
+	void*		arg
+	)
+{
+	struct pgm_fec_worker_t* worker = arg;
+	pgm_fec_pool_t* pool = worker->pool;
+
+	pgm_mutex_lock (&pool->mutex);
+	for (;;)
+	{
+		pgm_list_t* link_;
+
+		while (!pool->is_shutdown &&
+		       NULL == (link_ = pgm_queue_pop_tail_link (&pool->incoming)))
+		{
+#ifndef _WIN32
+			pgm_cond_wait (&pool->work_cond, &pool->mutex.pthread_mutex);
+#else
+			pgm_cond_wait (&pool->work_cond, &pool->mutex.win32_crit);
+#endif
+		}
+		if (pool->is_shutdown)
+			break;
+
+		worker->job = (pgm_fec_job_t*)link_;
+		pgm_mutex_unlock (&pool->mutex);
+
+		_pgm_fec_worker_decode (worker, worker->job);
+
+		pgm_mutex_lock (&pool->mutex);
+		pgm_queue_push_head_link (&pool->completed, &worker->job->link_);
+		pgm_atomic_inc32 (&pool->completed_count);
+		worker->job = NULL;
+		pgm_cond_broadcast (&pool->idle_cond);
+		pgm_mutex_unlock (&pool->mutex);
+
+/* wake receiving thread outside of pool lock */
+		if (pool->notify_func)
+			pool->notify_func (pool->notify_data);
+		pgm_mutex_lock (&pool->mutex);
+	}
+	pgm_mutex_unlock (&pool->mutex);
+
+/* returning ends a _beginthreadex() thread cleanly */
+#ifndef _WIN32
+	return NULL;
+#else
+	return 0;
+#endif
+}
+
+/* eof */
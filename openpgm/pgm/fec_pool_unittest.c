@@ -0,0 +1,303 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for the FEC worker pool.
+ *
+ * Copyright (c) 2009 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#ifndef _WIN32
+#	include <unistd.h>
+#endif
+#include <glib.h>
+#include <check.h>
+
+#ifdef _WIN32
+#	define PGM_CHECK_NOFORK		1
+#	define usleep(us)		Sleep ((us) / 1000)
+#endif
+
+
+/* mock state */
+
+#define FEC_POOL_DEBUG
+#include "fec_pool.c"
+
+static volatile uint32_t mock_notify_count = 0;
+
+
+/* mock functions for external references */
+
+size_t
+pgm_pkt_offset (
+        const bool                      can_fragment,
+        const sa_family_t		pgmcc_family	/* 0 = disable */
+        )
+{
+        return 0;
+}
+
+static
+void
+mock_notify (
+	void*		user_data
+	)
+{
+	pgm_atomic_inc32 (&mock_notify_count);
+}
+
+/* wait up to a second for the workers */
+static
+pgm_fec_job_t*
+wait_for_completed (
+	pgm_fec_pool_t*	pool
+	)
+{
+	for (unsigned i = 0; i < 1000; i++) {
+		pgm_fec_job_t* job = pgm_fec_pool_pop_completed (pool);
+		if (NULL != job)
+			return job;
+		usleep (1000);
+	}
+	return NULL;
+}
+
+/* RS(8, 4) group with data packet #1 erased and the parity for it appended.
+ */
+
+#define TEST_RS_N	8
+#define TEST_RS_K	4
+#define TEST_LEN	64
+
+static
+pgm_fec_job_t*
+generate_job (
+	const void*	window,
+	pgm_gf8_t	packets[TEST_RS_K + 1][TEST_LEN]
+	)
+{
+	pgm_rs_t rs;
+	const pgm_gf8_t* src[TEST_RS_K];
+	pgm_fec_job_t* job = pgm_fec_job_new (TEST_RS_N, TEST_RS_K);
+	job->window = window;
+	job->tg_sqn = 0;
+	job->parity_length = TEST_LEN;
+	for (unsigned i = 0; i < TEST_RS_K; i++) {
+		memset (packets[ i ], 'a' + i, TEST_LEN);
+		src[ i ] = packets[ i ];
+	}
+	pgm_rs_create (&rs, TEST_RS_N, TEST_RS_K);
+	pgm_rs_encode (&rs, src, TEST_RS_K, packets[ TEST_RS_K ], TEST_LEN);
+	pgm_rs_destroy (&rs);
+	memset (packets[ 1 ], 0, TEST_LEN);
+	for (unsigned i = 0; i <= TEST_RS_K; i++)
+		job->tg_data[ i ] = packets[ i ];
+	for (unsigned i = 0; i < TEST_RS_K; i++)
+		job->offsets[ i ] = i;
+	job->offsets[ 1 ] = TEST_RS_K;
+	return job;
+}
+
+/* target:
+ *	pgm_fec_pool_t*
+ *	pgm_fec_pool_create (
+ *		const unsigned			n_workers,
+ *		pgm_fec_pool_notify_func	notify_func,
+ *		void*				notify_data,
+ *		pgm_error_t**			error
+ *	)
+ */
+
+START_TEST (test_create_pass_001)
+{
+	pgm_error_t* err = NULL;
+	pgm_fec_pool_t* pool = pgm_fec_pool_create (2, NULL, NULL, &err);
+	fail_if (NULL == pool, "create failed");
+	fail_unless (NULL == err, "error set");
+	fail_unless (2 == pool->n_workers, "n_workers failed");
+	fail_unless (FALSE == pgm_fec_pool_has_completed (pool), "has_completed failed");
+	pgm_fec_pool_destroy (pool);
+}
+END_TEST
+
+/* zero workers */
+START_TEST (test_create_fail_001)
+{
+	pgm_fec_pool_t* pool = pgm_fec_pool_create (0, NULL, NULL, NULL);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	pgm_fec_job_t*
+ *	pgm_fec_job_new (
+ *		const uint8_t		rs_n,
+ *		const uint8_t		rs_k
+ *	)
+ */
+
+START_TEST (test_job_new_pass_001)
+{
+	pgm_fec_job_t* job = pgm_fec_job_new (255, 64);
+	fail_if (NULL == job, "job_new failed");
+	fail_unless (255 == job->rs_n, "rs_n failed");
+	fail_unless (64 == job->rs_k, "rs_k failed");
+/* vectors follow the job in a single allocation */
+	fail_unless ((char*)job->tg_skbs == (char*)(job + 1), "tg_skbs failed");
+	fail_unless ((char*)job->tg_data == (char*)job->tg_skbs + 255 * sizeof(struct pgm_sk_buff_t*), "tg_data failed");
+	fail_unless ((char*)job->tg_opts == (char*)job->tg_data + 255 * sizeof(pgm_gf8_t*), "tg_opts failed");
+	fail_unless ((char*)job->offsets == (char*)job->tg_opts + 255 * sizeof(pgm_gf8_t*), "offsets failed");
+	for (unsigned i = 0; i < 255; i++)
+		fail_unless (NULL == job->tg_skbs[ i ], "tg_skbs not zeroed");
+	pgm_fec_job_free (job);
+}
+END_TEST
+
+/* parity must follow data */
+START_TEST (test_job_new_fail_001)
+{
+	pgm_fec_job_t* job = pgm_fec_job_new (4, 4);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_fec_pool_push (
+ *		pgm_fec_pool_t*		pool,
+ *		pgm_fec_job_t*		job
+ *	)
+ */
+
+START_TEST (test_push_pass_001)
+{
+	pgm_gf8_t packets[TEST_RS_K + 1][TEST_LEN];
+	const int window = 0;
+	pgm_fec_pool_t* pool = pgm_fec_pool_create (2, mock_notify, NULL, NULL);
+	fail_if (NULL == pool, "create failed");
+	mock_notify_count = 0;
+	pgm_fec_job_t* job = generate_job (&window, packets);
+	pgm_fec_pool_push (pool, job);
+	pgm_fec_job_t* completed = wait_for_completed (pool);
+	fail_unless (job == completed, "pop_completed failed");
+	fail_unless (1 == pgm_atomic_read32 (&mock_notify_count), "notify failed");
+	fail_unless (FALSE == pgm_fec_pool_is_pending (pool, &window, 0), "is_pending failed");
+/* erased packet rebuilt in place from the appended parity */
+	for (unsigned i = 0; i < TEST_LEN; i++)
+		fail_unless ('b' == packets[ 1 ][ i ], "decode failed");
+	pgm_fec_job_free (completed);
+	pgm_fec_pool_destroy (pool);
+}
+END_TEST
+
+START_TEST (test_push_fail_001)
+{
+	pgm_fec_pool_push (NULL, NULL);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_fec_pool_cancel (
+ *		pgm_fec_pool_t*		pool,
+ *		const void*		window
+ *	)
+ */
+
+START_TEST (test_cancel_pass_001)
+{
+	pgm_gf8_t packets_a[TEST_RS_K + 1][TEST_LEN], packets_b[TEST_RS_K + 1][TEST_LEN];
+	const int window_a = 0, window_b = 0;
+	pgm_fec_pool_t* pool = pgm_fec_pool_create (1, NULL, NULL, NULL);
+	fail_if (NULL == pool, "create failed");
+	pgm_fec_job_t* job_a = generate_job (&window_a, packets_a);
+	pgm_fec_job_t* job_b = generate_job (&window_b, packets_b);
+	pgm_fec_pool_push (pool, job_a);
+	pgm_fec_pool_push (pool, job_b);
+/* queued or completed jobs of the window are released */
+	pgm_fec_pool_cancel (pool, &window_a);
+	fail_unless (FALSE == pgm_fec_pool_is_pending (pool, &window_a, 0), "is_pending failed");
+	pgm_fec_job_t* completed = wait_for_completed (pool);
+	fail_unless (job_b == completed, "pop_completed failed");
+	fail_unless (NULL == pgm_fec_pool_pop_completed (pool), "cancelled job completed");
+	pgm_fec_job_free (completed);
+	pgm_fec_pool_destroy (pool);
+}
+END_TEST
+
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_create = tcase_create ("create");
+	suite_add_tcase (s, tc_create);
+	tcase_add_test (tc_create, test_create_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_create, test_create_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_job_new = tcase_create ("job-new");
+	suite_add_tcase (s, tc_job_new);
+	tcase_add_test (tc_job_new, test_job_new_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_job_new, test_job_new_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_push = tcase_create ("push");
+	suite_add_tcase (s, tc_push);
+	tcase_add_test (tc_push, test_push_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_push, test_push_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_cancel = tcase_create ("cancel");
+	suite_add_tcase (s, tc_cancel);
+	tcase_add_test (tc_cancel, test_cancel_pass_001);
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
@@ -0,0 +1,564 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * Receive side source filtering: allow and deny lists of sources and a
+ * classic BPF program over downstream packets, evaluated before any peer or
+ * window state is created and pushed down to the kernel where possible.
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#include <stddef.h>
+#include <string.h>
+#ifdef __linux__
+#	include <linux/filter.h>
+#endif
+#include <impl/i18n.h>
+#include <impl/framework.h>
+#include <impl/socket.h>
+
+
+//#define FILTER_DEBUG
+
+#ifndef FILTER_DEBUG
+#	define PGM_DISABLE_ASSERT
+#endif
+
+/* instruction classes */
+#define PGM_BPF_LD		0x00
+#define PGM_BPF_LDX		0x01
+#define PGM_BPF_ST		0x02
+#define PGM_BPF_STX		0x03
+#define PGM_BPF_ALU		0x04
+#define PGM_BPF_JMP		0x05
+#define PGM_BPF_RET		0x06
+#define PGM_BPF_MISC		0x07
+
+/* load size */
+#define PGM_BPF_W		0x00
+#define PGM_BPF_H		0x08
+#define PGM_BPF_B		0x10
+
+/* load mode */
+#define PGM_BPF_IMM		0x00
+#define PGM_BPF_ABS		0x20
+#define PGM_BPF_IND		0x40
+#define PGM_BPF_MEM		0x60
+#define PGM_BPF_LEN		0x80
+#define PGM_BPF_MSH		0xa0
+
+/* alu and jump operations */
+#define PGM_BPF_ADD		0x00
+#define PGM_BPF_SUB		0x10
+#define PGM_BPF_MUL		0x20
+#define PGM_BPF_DIV		0x30
+#define PGM_BPF_OR		0x40
+#define PGM_BPF_AND		0x50
+#define PGM_BPF_LSH		0x60
+#define PGM_BPF_RSH		0x70
+#define PGM_BPF_NEG		0x80
+#define PGM_BPF_MOD		0x90
+#define PGM_BPF_XOR		0xa0
+
+#define PGM_BPF_JA		0x00
+#define PGM_BPF_JEQ		0x10
+#define PGM_BPF_JGT		0x20
+#define PGM_BPF_JGE		0x30
+#define PGM_BPF_JSET		0x40
+
+/* operand source */
+#define PGM_BPF_K		0x00
+#define PGM_BPF_X		0x08
+#define PGM_BPF_A		0x10	/* return value only */
+
+#define PGM_BPF_TAX		0x00
+#define PGM_BPF_TXA		0x80
+
+#define PGM_BPF_CLASS(code)	((code) & 0x07)
+#define PGM_BPF_MODE(code)	((code) & 0xe0)
+
+#ifdef __linux__
+PGM_STATIC_ASSERT(sizeof(struct pgm_filter_insn_t) == sizeof(struct sock_filter));
+#endif
+
+
+/* check a program before it is stored, the interpreter relies upon every
+ * jump landing inside the program and every path ending in a return.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_filter_validate (
+	const struct pgm_filter_insn_t* const	insns,
+	const unsigned				len
+	)
+{
+	if (PGM_UNLIKELY(NULL == insns || 0 == len || len > PGM_FILTER_MAX_INSNS))
+		return FALSE;
+
+	for (unsigned i = 0; i < len; i++)
+	{
+		const struct pgm_filter_insn_t* insn = &insns[ i ];
+		const unsigned remaining = len - i - 1;
+
+		switch (insn->code) {
+		case PGM_BPF_LD|PGM_BPF_W|PGM_BPF_ABS:
+		case PGM_BPF_LD|PGM_BPF_H|PGM_BPF_ABS:
+		case PGM_BPF_LD|PGM_BPF_B|PGM_BPF_ABS:
+		case PGM_BPF_LD|PGM_BPF_W|PGM_BPF_IND:
+		case PGM_BPF_LD|PGM_BPF_H|PGM_BPF_IND:
+		case PGM_BPF_LD|PGM_BPF_B|PGM_BPF_IND:
+		case PGM_BPF_LD|PGM_BPF_W|PGM_BPF_LEN:
+		case PGM_BPF_LD|PGM_BPF_IMM:
+		case PGM_BPF_LDX|PGM_BPF_W|PGM_BPF_LEN:
+		case PGM_BPF_LDX|PGM_BPF_IMM:
+		case PGM_BPF_LDX|PGM_BPF_B|PGM_BPF_MSH:
+		case PGM_BPF_ALU|PGM_BPF_ADD|PGM_BPF_K:
+		case PGM_BPF_ALU|PGM_BPF_ADD|PGM_BPF_X:
+		case PGM_BPF_ALU|PGM_BPF_SUB|PGM_BPF_K:
+		case PGM_BPF_ALU|PGM_BPF_SUB|PGM_BPF_X:
+		case PGM_BPF_ALU|PGM_BPF_MUL|PGM_BPF_K:
+		case PGM_BPF_ALU|PGM_BPF_MUL|PGM_BPF_X:
+		case PGM_BPF_ALU|PGM_BPF_DIV|PGM_BPF_X:
+		case PGM_BPF_ALU|PGM_BPF_MOD|PGM_BPF_X:
+		case PGM_BPF_ALU|PGM_BPF_OR|PGM_BPF_K:
+		case PGM_BPF_ALU|PGM_BPF_OR|PGM_BPF_X:
+		case PGM_BPF_ALU|PGM_BPF_AND|PGM_BPF_K:
+		case PGM_BPF_ALU|PGM_BPF_AND|PGM_BPF_X:
+		case PGM_BPF_ALU|PGM_BPF_XOR|PGM_BPF_K:
+		case PGM_BPF_ALU|PGM_BPF_XOR|PGM_BPF_X:
+		case PGM_BPF_ALU|PGM_BPF_LSH|PGM_BPF_K:
+		case PGM_BPF_ALU|PGM_BPF_LSH|PGM_BPF_X:
+		case PGM_BPF_ALU|PGM_BPF_RSH|PGM_BPF_K:
+		case PGM_BPF_ALU|PGM_BPF_RSH|PGM_BPF_X:
+		case PGM_BPF_ALU|PGM_BPF_NEG:
+		case PGM_BPF_RET|PGM_BPF_K:
+		case PGM_BPF_RET|PGM_BPF_A:
+		case PGM_BPF_MISC|PGM_BPF_TAX:
+		case PGM_BPF_MISC|PGM_BPF_TXA:
+			break;
+
+/* constant division by zero */
+		case PGM_BPF_ALU|PGM_BPF_DIV|PGM_BPF_K:
+		case PGM_BPF_ALU|PGM_BPF_MOD|PGM_BPF_K:
+			if (PGM_UNLIKELY(0 == insn->k))
+				return FALSE;
+			break;
+
+		case PGM_BPF_LD|PGM_BPF_W|PGM_BPF_MEM:
+		case PGM_BPF_LDX|PGM_BPF_W|PGM_BPF_MEM:
+		case PGM_BPF_ST:
+		case PGM_BPF_STX:
+			if (PGM_UNLIKELY(insn->k >= PGM_FILTER_MEMWORDS))
+				return FALSE;
+			break;
+
+/* forward only, within the program */
+		case PGM_BPF_JMP|PGM_BPF_JA:
+			if (PGM_UNLIKELY(insn->k >= remaining))
+				return FALSE;
+			break;
+
+		case PGM_BPF_JMP|PGM_BPF_JEQ|PGM_BPF_K:
+		case PGM_BPF_JMP|PGM_BPF_JEQ|PGM_BPF_X:
+		case PGM_BPF_JMP|PGM_BPF_JGT|PGM_BPF_K:
+		case PGM_BPF_JMP|PGM_BPF_JGT|PGM_BPF_X:
+		case PGM_BPF_JMP|PGM_BPF_JGE|PGM_BPF_K:
+		case PGM_BPF_JMP|PGM_BPF_JGE|PGM_BPF_X:
+		case PGM_BPF_JMP|PGM_BPF_JSET|PGM_BPF_K:
+		case PGM_BPF_JMP|PGM_BPF_JSET|PGM_BPF_X:
+			if (PGM_UNLIKELY(insn->jt >= remaining || insn->jf >= remaining))
+				return FALSE;
+			break;
+
+		default:
+			return FALSE;
+		}
+	}
+
+	return (PGM_BPF_RET == PGM_BPF_CLASS(insns[ len - 1 ].code));
+}
+
+/* read size bytes in network order at offset, FALSE if outside the packet.
+ */
+
+static inline
+bool
+_pgm_filter_load (
+	const uint8_t*	 const restrict packet,
+	const uint32_t			len,
+	const uint32_t			offset,
+	const unsigned			size,
+	uint32_t*	 const restrict value
+	)
+{
+	if (PGM_UNLIKELY(offset > len || size > len - offset))
+		return FALSE;
+	const uint8_t* p = packet + offset;
+	switch (size) {
+	case 4:  *value = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3]; break;
+	case 2:  *value = ((uint32_t)p[0] << 8) | p[1]; break;
+	default: *value = p[0]; break;
+	}
+	return TRUE;
+}
+
+/* run a validated program, returns 0 to drop the packet.  loads outside the
+ * packet drop as per the Linux socket filter.
+ */
+
+PGM_GNUC_INTERNAL
+uint32_t
+pgm_filter_run (
+	const struct pgm_filter_insn_t* const restrict insns,
+	const uint8_t*			const restrict packet,
+	const uint32_t				       len
+	)
+{
+	uint32_t A = 0, X = 0;
+	uint32_t mem[ PGM_FILTER_MEMWORDS ];
+
+/* pre-conditions */
+	pgm_assert (NULL != insns);
+	pgm_assert (NULL != packet);
+
+	memset (mem, 0, sizeof(mem));
+	for (const struct pgm_filter_insn_t* pc = insns;; pc++)
+	{
+		const uint32_t k = pc->k;
+		switch (pc->code) {
+		case PGM_BPF_LD|PGM_BPF_W|PGM_BPF_ABS:
+			if (!_pgm_filter_load (packet, len, k, 4, &A)) return 0;
+			break;
+		case PGM_BPF_LD|PGM_BPF_H|PGM_BPF_ABS:
+			if (!_pgm_filter_load (packet, len, k, 2, &A)) return 0;
+			break;
+		case PGM_BPF_LD|PGM_BPF_B|PGM_BPF_ABS:
+			if (!_pgm_filter_load (packet, len, k, 1, &A)) return 0;
+			break;
+		case PGM_BPF_LD|PGM_BPF_W|PGM_BPF_IND:
+			if (X + k < X || !_pgm_filter_load (packet, len, X + k, 4, &A)) return 0;
+			break;
+		case PGM_BPF_LD|PGM_BPF_H|PGM_BPF_IND:
+			if (X + k < X || !_pgm_filter_load (packet, len, X + k, 2, &A)) return 0;
+			break;
+		case PGM_BPF_LD|PGM_BPF_B|PGM_BPF_IND:
+			if (X + k < X || !_pgm_filter_load (packet, len, X + k, 1, &A)) return 0;
+			break;
+		case PGM_BPF_LD|PGM_BPF_W|PGM_BPF_LEN:	A = len; break;
+		case PGM_BPF_LD|PGM_BPF_IMM:		A = k; break;
+		case PGM_BPF_LD|PGM_BPF_W|PGM_BPF_MEM:	A = mem[ k ]; break;
+		case PGM_BPF_LDX|PGM_BPF_W|PGM_BPF_LEN:	X = len; break;
+		case PGM_BPF_LDX|PGM_BPF_IMM:		X = k; break;
+		case PGM_BPF_LDX|PGM_BPF_W|PGM_BPF_MEM:	X = mem[ k ]; break;
+		case PGM_BPF_LDX|PGM_BPF_B|PGM_BPF_MSH:
+			if (!_pgm_filter_load (packet, len, k, 1, &X)) return 0;
+			X = (X & 0xf) << 2;
+			break;
+		case PGM_BPF_ST:			mem[ k ] = A; break;
+		case PGM_BPF_STX:			mem[ k ] = X; break;
+
+		case PGM_BPF_ALU|PGM_BPF_ADD|PGM_BPF_K:	A += k; break;
+		case PGM_BPF_ALU|PGM_BPF_ADD|PGM_BPF_X:	A += X; break;
+		case PGM_BPF_ALU|PGM_BPF_SUB|PGM_BPF_K:	A -= k; break;
+		case PGM_BPF_ALU|PGM_BPF_SUB|PGM_BPF_X:	A -= X; break;
+		case PGM_BPF_ALU|PGM_BPF_MUL|PGM_BPF_K:	A *= k; break;
+		case PGM_BPF_ALU|PGM_BPF_MUL|PGM_BPF_X:	A *= X; break;
+		case PGM_BPF_ALU|PGM_BPF_DIV|PGM_BPF_K:	A /= k; break;
+		case PGM_BPF_ALU|PGM_BPF_DIV|PGM_BPF_X:
+			if (0 == X) return 0;
+			A /= X;
+			break;
+		case PGM_BPF_ALU|PGM_BPF_MOD|PGM_BPF_K:	A %= k; break;
+		case PGM_BPF_ALU|PGM_BPF_MOD|PGM_BPF_X:
+			if (0 == X) return 0;
+			A %= X;
+			break;
+		case PGM_BPF_ALU|PGM_BPF_OR|PGM_BPF_K:	A |= k; break;
+		case PGM_BPF_ALU|PGM_BPF_OR|PGM_BPF_X:	A |= X; break;
+		case PGM_BPF_ALU|PGM_BPF_AND|PGM_BPF_K:	A &= k; break;
+		case PGM_BPF_ALU|PGM_BPF_AND|PGM_BPF_X:	A &= X; break;
+		case PGM_BPF_ALU|PGM_BPF_XOR|PGM_BPF_K:	A ^= k; break;
+		case PGM_BPF_ALU|PGM_BPF_XOR|PGM_BPF_X:	A ^= X; break;
+		case PGM_BPF_ALU|PGM_BPF_LSH|PGM_BPF_K:	A = k < 32 ? A << k : 0; break;
+		case PGM_BPF_ALU|PGM_BPF_LSH|PGM_BPF_X:	A = X < 32 ? A << X : 0; break;
+		case PGM_BPF_ALU|PGM_BPF_RSH|PGM_BPF_K:	A = k < 32 ? A >> k : 0; break;
+		case PGM_BPF_ALU|PGM_BPF_RSH|PGM_BPF_X:	A = X < 32 ? A >> X : 0; break;
+		case PGM_BPF_ALU|PGM_BPF_NEG:		A = -A; break;
+
+		case PGM_BPF_JMP|PGM_BPF_JA:		pc += k; break;
+		case PGM_BPF_JMP|PGM_BPF_JEQ|PGM_BPF_K:	pc += (A == k) ? pc->jt : pc->jf; break;
+		case PGM_BPF_JMP|PGM_BPF_JEQ|PGM_BPF_X:	pc += (A == X) ? pc->jt : pc->jf; break;
+		case PGM_BPF_JMP|PGM_BPF_JGT|PGM_BPF_K:	pc += (A > k) ? pc->jt : pc->jf; break;
+		case PGM_BPF_JMP|PGM_BPF_JGT|PGM_BPF_X:	pc += (A > X) ? pc->jt : pc->jf; break;
+		case PGM_BPF_JMP|PGM_BPF_JGE|PGM_BPF_K:	pc += (A >= k) ? pc->jt : pc->jf; break;
+		case PGM_BPF_JMP|PGM_BPF_JGE|PGM_BPF_X:	pc += (A >= X) ? pc->jt : pc->jf; break;
+		case PGM_BPF_JMP|PGM_BPF_JSET|PGM_BPF_K:pc += (A & k) ? pc->jt : pc->jf; break;
+		case PGM_BPF_JMP|PGM_BPF_JSET|PGM_BPF_X:pc += (A & X) ? pc->jt : pc->jf; break;
+
+		case PGM_BPF_RET|PGM_BPF_K:		return k;
+		case PGM_BPF_RET|PGM_BPF_A:		return A;
+
+		case PGM_BPF_MISC|PGM_BPF_TAX:		X = A; break;
+		case PGM_BPF_MISC|PGM_BPF_TXA:		A = X; break;
+
+		default:
+			pgm_assert_not_reached();
+			return 0;
+		}
+	}
+}
+
+/* zero source port matches every session of the GSI.
+ */
+
+static inline
+bool
+_pgm_filter_match_source (
+	const pgm_slist_t*	     list,
+	const pgm_tsi_t*    restrict tsi
+	)
+{
+	for (; list; list = list->next) {
+		const pgm_tsi_t* entry = list->data;
+		if (pgm_gsi_equal (&entry->gsi, &tsi->gsi) &&
+		    (0 == entry->sport || entry->sport == tsi->sport))
+			return TRUE;
+	}
+	return FALSE;
+}
+
+/* returns TRUE to continue processing the parsed packet.  only downstream
+ * packets are filtered, NAKs, SPMRs and ACKs address this socket's own sessions.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_filter_accept (
+	const pgm_sock_t*	    const restrict sock,
+	const struct pgm_sk_buff_t* const restrict skb
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (NULL != skb);
+	pgm_assert (NULL != skb->pgm_header);
+
+	if (!PGM_IS_DOWNSTREAM (skb->pgm_header->pgm_type))
+		return TRUE;
+	if (sock->deny_sources && _pgm_filter_match_source (sock->deny_sources, &skb->tsi))
+		return FALSE;
+	if (sock->allow_sources && !_pgm_filter_match_source (sock->allow_sources, &skb->tsi))
+		return FALSE;
+	if (sock->filter && 0 == pgm_filter_run (sock->filter, skb->data, skb->len))
+		return FALSE;
+	return TRUE;
+}
+
+#ifdef SO_ATTACH_FILTER
+/* returns TRUE if the instruction may read outside the PGM header and payload
+ * or return a value that cannot be rebased onto a UDP datagram.
+ */
+
+static inline
+bool
+_pgm_filter_is_packet_relative (
+	const struct pgm_filter_insn_t*	insn
+	)
+{
+	switch (insn->code) {
+	case PGM_BPF_LD|PGM_BPF_W|PGM_BPF_LEN:
+	case PGM_BPF_LDX|PGM_BPF_W|PGM_BPF_LEN:
+	case PGM_BPF_LDX|PGM_BPF_B|PGM_BPF_MSH:
+	case PGM_BPF_RET|PGM_BPF_A:
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+static inline
+void
+_pgm_filter_emit (
+	struct pgm_filter_insn_t* restrict prog,
+	unsigned*		  restrict n,
+	const uint16_t			   code,
+	const uint8_t			   jt,
+	const uint8_t			   jf,
+	const uint32_t			   k
+	)
+{
+	prog[ *n ].code = code;
+	prog[ *n ].jt   = jt;
+	prog[ *n ].jf   = jf;
+	prog[ *n ].k    = k;
+	(*n)++;
+}
+
+/* match one source, falls through to the instruction after the block when
+ * the source differs, returns index of the final placeholder instruction.
+ */
+
+static
+unsigned
+_pgm_filter_emit_source (
+	struct pgm_filter_insn_t* restrict prog,
+	unsigned*		  restrict n,
+	const unsigned			   offset,
+	const pgm_tsi_t*	  restrict tsi
+	)
+{
+	const uint8_t* gsi = (const uint8_t*)&tsi->gsi;
+	const uint32_t gsi_high = ((uint32_t)gsi[0] << 24) | ((uint32_t)gsi[1] << 16) | ((uint32_t)gsi[2] << 8) | gsi[3];
+	const uint32_t gsi_low  = ((uint32_t)gsi[4] << 8) | gsi[5];
+	const uint8_t block_len = tsi->sport ? 7 : 5;
+
+	_pgm_filter_emit (prog, n, PGM_BPF_LD|PGM_BPF_W|PGM_BPF_ABS, 0, 0, offset + offsetof(struct pgm_header, pgm_gsi));
+	_pgm_filter_emit (prog, n, PGM_BPF_JMP|PGM_BPF_JEQ|PGM_BPF_K, 0, block_len - 2, gsi_high);
+	_pgm_filter_emit (prog, n, PGM_BPF_LD|PGM_BPF_H|PGM_BPF_ABS, 0, 0, offset + offsetof(struct pgm_header, pgm_gsi) + 4);
+	_pgm_filter_emit (prog, n, PGM_BPF_JMP|PGM_BPF_JEQ|PGM_BPF_K, 0, block_len - 4, gsi_low);
+	if (tsi->sport) {
+		_pgm_filter_emit (prog, n, PGM_BPF_LD|PGM_BPF_H|PGM_BPF_ABS, 0, 0, offset + offsetof(struct pgm_header, pgm_sport));
+		_pgm_filter_emit (prog, n, PGM_BPF_JMP|PGM_BPF_JEQ|PGM_BPF_K, 0, 1, ntohs (tsi->sport));
+	}
+	_pgm_filter_emit (prog, n, PGM_BPF_RET|PGM_BPF_K, 0, 0, 0);
+	return *n - 1;
+}
+
+/* translate the source lists and program into a socket filter over datagrams
+ * with the PGM header at offset, NULL if nothing can be pushed down.
+ */
+
+static
+struct pgm_filter_insn_t*
+_pgm_filter_compile (
+	const pgm_sock_t* const restrict sock,
+	const unsigned			 offset,
+	unsigned*	  const restrict len
+	)
+{
+	static const uint8_t downstream[] = { PGM_SPM, PGM_POLL, PGM_ODATA, PGM_RDATA, PGM_NCF };
+	const unsigned n_deny  = pgm_slist_length (sock->deny_sources);
+	const unsigned n_allow = pgm_slist_length (sock->allow_sources);
+	bool can_push_program = (NULL != sock->filter);
+	unsigned n = 0;
+
+	for (unsigned i = 0; can_push_program && i < sock->filter_len; i++)
+	{
+		const struct pgm_filter_insn_t* insn = &sock->filter[ i ];
+		if (_pgm_filter_is_packet_relative (insn) ||
+		    ((PGM_BPF_ABS == PGM_BPF_MODE(insn->code) || PGM_BPF_IND == PGM_BPF_MODE(insn->code)) &&
+		     PGM_BPF_LD == PGM_BPF_CLASS(insn->code) && insn->k > (uint32_t)INT32_MAX - offset))
+			can_push_program = FALSE;
+	}
+	if (0 == n_deny && 0 == n_allow && !can_push_program)
+		return NULL;
+
+	const unsigned max_len = PGM_N_ELEMENTS(downstream) + 2 + ((n_deny + n_allow) * 7) + 1 + (can_push_program ? sock->filter_len : 1);
+	if (max_len > PGM_FILTER_MAX_INSNS)
+		return NULL;
+	struct pgm_filter_insn_t* prog = pgm_new (struct pgm_filter_insn_t, max_len);
+	unsigned* allow_jumps = pgm_newa (unsigned, n_allow + 1);
+
+/* pass upstream and peer packets without further inspection */
+	_pgm_filter_emit (prog, &n, PGM_BPF_LD|PGM_BPF_B|PGM_BPF_ABS, 0, 0, offset + offsetof(struct pgm_header, pgm_type));
+	for (unsigned i = 0; i < PGM_N_ELEMENTS(downstream); i++)
+		_pgm_filter_emit (prog, &n, PGM_BPF_JMP|PGM_BPF_JEQ|PGM_BPF_K, PGM_N_ELEMENTS(downstream) - i, 0, downstream[ i ]);
+	_pgm_filter_emit (prog, &n, PGM_BPF_RET|PGM_BPF_K, 0, 0, UINT32_MAX);
+
+	for (const pgm_slist_t* list = sock->deny_sources; list; list = list->next)
+		_pgm_filter_emit_source (prog, &n, offset, list->data);
+
+	if (n_allow) {
+		unsigned i = 0;
+		for (const pgm_slist_t* list = sock->allow_sources; list; list = list->next)
+			allow_jumps[ i++ ] = _pgm_filter_emit_source (prog, &n, offset, list->data);
+		_pgm_filter_emit (prog, &n, PGM_BPF_RET|PGM_BPF_K, 0, 0, 0);
+/* matching sources continue with the program */
+		for (i = 0; i < n_allow; i++) {
+			prog[ allow_jumps[ i ] ].code = PGM_BPF_JMP|PGM_BPF_JA;
+			prog[ allow_jumps[ i ] ].k    = n - allow_jumps[ i ] - 1;
+		}
+	}
+
+	if (can_push_program) {
+		for (unsigned i = 0; i < sock->filter_len; i++) {
+			prog[ n ] = sock->filter[ i ];
+			if (PGM_BPF_LD == PGM_BPF_CLASS(prog[ n ].code) &&
+			    (PGM_BPF_ABS == PGM_BPF_MODE(prog[ n ].code) || PGM_BPF_IND == PGM_BPF_MODE(prog[ n ].code)))
+				prog[ n ].k += offset;
+/* the kernel truncates to the returned length */
+			else if ((PGM_BPF_RET|PGM_BPF_K) == prog[ n ].code && prog[ n ].k)
+				prog[ n ].k = UINT32_MAX;
+			n++;
+		}
+	} else
+		_pgm_filter_emit (prog, &n, PGM_BPF_RET|PGM_BPF_K, 0, 0, UINT32_MAX);
+
+	pgm_assert (pgm_filter_validate (prog, n));
+	*len = n;
+	return prog;
+}
+#endif /* SO_ATTACH_FILTER */
+
+/* push the filter down to the receive socket so the kernel drops unwanted
+ * sources, only UDP encapsulation has a fixed offset to the PGM header.  the
+ * library filter remains in place for raw sockets and anything the kernel
+ * cannot express.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_filter_attach (
+	pgm_sock_t* const	sock
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+
+	if (!sock->is_filtering || !sock->udp_encap_ucast_port)
+		return FALSE;
+
+#ifdef SO_ATTACH_FILTER
+	struct sock_fprog fprog;
+	unsigned len;
+	struct pgm_filter_insn_t* prog = _pgm_filter_compile (sock, sizeof(struct pgm_udphdr), &len);
+	if (NULL == prog)
+		return FALSE;
+	fprog.len    = (unsigned short)len;
+	fprog.filter = (struct sock_filter*)prog;
+	if (SOCKET_ERROR == setsockopt (sock->recv_sock, SOL_SOCKET, SO_ATTACH_FILTER, (const char*)&fprog, sizeof(fprog)))
+	{
+		const int save_errno = pgm_get_last_sock_error();
+		char errbuf[1024];
+		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Attaching source filter to receive socket: %s"),
+			   pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno));
+		pgm_free (prog);
+		return FALSE;
+	}
+	pgm_trace (PGM_LOG_ROLE_NETWORK,_("Attached %u instruction source filter to receive socket."), len);
+	pgm_free (prog);
+	sock->is_filter_attached = TRUE;
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
+/* eof */
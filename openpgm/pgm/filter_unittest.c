@@ -0,0 +1,427 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for receive side source filtering.
+ *
+ * Copyright (c) 2009-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <glib.h>
+#include <check.h>
+
+#ifdef _WIN32
+#	define PGM_CHECK_NOFORK		1
+#endif
+
+
+#define pgm_gsi_equal		mock_pgm_gsi_equal
+
+#define FILTER_DEBUG
+#include "filter.c"
+
+
+/* mock functions for external references */
+
+size_t
+pgm_pkt_offset (
+        const bool                      can_fragment,
+        const sa_family_t		pgmcc_family	/* 0 = disable */
+        )
+{
+        return 0;
+}
+
+bool
+mock_pgm_gsi_equal (
+	const void* restrict	gsi1,
+	const void* restrict	gsi2
+	)
+{
+	return 0 == memcmp (gsi1, gsi2, sizeof(pgm_gsi_t));
+}
+
+
+#define STMT(code, k)		{ (code), 0, 0, (k) }
+#define JUMP(code, k, jt, jf)	{ (code), (jt), (jf), (k) }
+
+static
+struct pgm_sock_t*
+generate_sock (void)
+{
+	struct pgm_sock_t* sock = g_malloc0 (sizeof(struct pgm_sock_t));
+	return sock;
+}
+
+/* PGM header only, offset bytes of zeroed encapsulation in front.
+ */
+
+static
+struct pgm_sk_buff_t*
+generate_skb (
+	const uint8_t		type,
+	const uint8_t		gsi_tail,
+	const uint16_t		sport,
+	const unsigned		offset
+	)
+{
+	const pgm_gsi_t gsi = { { 1, 2, 3, 4, 5, gsi_tail } };
+	struct pgm_sk_buff_t* skb = pgm_alloc_skb (100);
+	memset (pgm_skb_put (skb, offset), 0, offset);
+	skb->pgm_header = pgm_skb_put (skb, sizeof(struct pgm_header));
+	memset (skb->pgm_header, 0, sizeof(struct pgm_header));
+	skb->pgm_header->pgm_sport = htons (sport);
+	skb->pgm_header->pgm_type  = type;
+	memcpy (skb->pgm_header->pgm_gsi, &gsi, sizeof(pgm_gsi_t));
+	memcpy (&skb->tsi.gsi, &gsi, sizeof(pgm_gsi_t));
+	skb->tsi.sport = skb->pgm_header->pgm_sport;
+	pgm_skb_pull (skb, offset);
+	return skb;
+}
+
+static
+void
+add_source (
+	pgm_slist_t**		list,
+	const uint8_t		gsi_tail,
+	const uint16_t		sport
+	)
+{
+	const pgm_gsi_t gsi = { { 1, 2, 3, 4, 5, gsi_tail } };
+	pgm_tsi_t* tsi = g_malloc0 (sizeof(pgm_tsi_t));
+	memcpy (&tsi->gsi, &gsi, sizeof(pgm_gsi_t));
+	tsi->sport = htons (sport);
+	*list = pgm_slist_prepend (*list, tsi);
+}
+
+/* accept ODATA only */
+static struct pgm_filter_insn_t odata_only[] = {
+	STMT(PGM_BPF_LD|PGM_BPF_B|PGM_BPF_ABS, 4),
+	JUMP(PGM_BPF_JMP|PGM_BPF_JEQ|PGM_BPF_K, PGM_ODATA, 0, 1),
+	STMT(PGM_BPF_RET|PGM_BPF_K, 1),
+	STMT(PGM_BPF_RET|PGM_BPF_K, 0)
+};
+
+/* target:
+ *	bool
+ *	pgm_filter_validate (
+ *		const struct pgm_filter_insn_t* const	insns,
+ *		const unsigned				len
+ *		)
+ */
+
+START_TEST (test_validate_pass_001)
+{
+	const struct pgm_filter_insn_t accept[] = {
+		STMT(PGM_BPF_RET|PGM_BPF_K, UINT32_MAX)
+	};
+	const struct pgm_filter_insn_t arith[] = {
+		STMT(PGM_BPF_LDX|PGM_BPF_B|PGM_BPF_MSH, 0),
+		STMT(PGM_BPF_LD|PGM_BPF_W|PGM_BPF_MEM, 15),
+		STMT(PGM_BPF_ALU|PGM_BPF_DIV|PGM_BPF_X, 0),
+		STMT(PGM_BPF_ST, 0),
+		STMT(PGM_BPF_JMP|PGM_BPF_JA, 1),
+		STMT(PGM_BPF_RET|PGM_BPF_K, 0),
+		STMT(PGM_BPF_RET|PGM_BPF_A, 0)
+	};
+	fail_unless (pgm_filter_validate (accept, G_N_ELEMENTS(accept)), "validate failed");
+	fail_unless (pgm_filter_validate (arith, G_N_ELEMENTS(arith)), "validate failed");
+	fail_unless (pgm_filter_validate (odata_only, G_N_ELEMENTS(odata_only)), "validate failed");
+}
+END_TEST
+
+START_TEST (test_validate_fail_001)
+{
+/* jump beyond end */
+	const struct pgm_filter_insn_t jump[] = {
+		JUMP(PGM_BPF_JMP|PGM_BPF_JEQ|PGM_BPF_K, 0, 1, 0),
+		STMT(PGM_BPF_RET|PGM_BPF_K, 0)
+	};
+	const struct pgm_filter_insn_t ja[] = {
+		STMT(PGM_BPF_JMP|PGM_BPF_JA, 1),
+		STMT(PGM_BPF_RET|PGM_BPF_K, 0)
+	};
+/* falls off the end */
+	const struct pgm_filter_insn_t no_ret[] = {
+		STMT(PGM_BPF_LD|PGM_BPF_IMM, 0)
+	};
+	const struct pgm_filter_insn_t div_zero[] = {
+		STMT(PGM_BPF_ALU|PGM_BPF_DIV|PGM_BPF_K, 0),
+		STMT(PGM_BPF_RET|PGM_BPF_K, 0)
+	};
+	const struct pgm_filter_insn_t mem[] = {
+		STMT(PGM_BPF_ST, PGM_FILTER_MEMWORDS),
+		STMT(PGM_BPF_RET|PGM_BPF_K, 0)
+	};
+	const struct pgm_filter_insn_t opcode[] = {
+		STMT(0xffff, 0),
+		STMT(PGM_BPF_RET|PGM_BPF_K, 0)
+	};
+	fail_if (pgm_filter_validate (NULL, 1), "validate failed");
+	fail_if (pgm_filter_validate (odata_only, 0), "validate failed");
+	fail_if (pgm_filter_validate (odata_only, PGM_FILTER_MAX_INSNS + 1), "validate failed");
+	fail_if (pgm_filter_validate (jump, G_N_ELEMENTS(jump)), "validate failed");
+	fail_if (pgm_filter_validate (ja, G_N_ELEMENTS(ja)), "validate failed");
+	fail_if (pgm_filter_validate (no_ret, G_N_ELEMENTS(no_ret)), "validate failed");
+	fail_if (pgm_filter_validate (div_zero, G_N_ELEMENTS(div_zero)), "validate failed");
+	fail_if (pgm_filter_validate (mem, G_N_ELEMENTS(mem)), "validate failed");
+	fail_if (pgm_filter_validate (opcode, G_N_ELEMENTS(opcode)), "validate failed");
+}
+END_TEST
+
+/* target:
+ *	uint32_t
+ *	pgm_filter_run (
+ *		const struct pgm_filter_insn_t* const	insns,
+ *		const uint8_t* const			packet,
+ *		const uint32_t				len
+ *		)
+ */
+
+START_TEST (test_run_pass_001)
+{
+	struct pgm_sk_buff_t* odata = generate_skb (PGM_ODATA, 6, 1000, 0);
+	struct pgm_sk_buff_t* spm = generate_skb (PGM_SPM, 6, 1000, 0);
+	fail_unless (1 == pgm_filter_run (odata_only, odata->data, odata->len), "run failed");
+	fail_unless (0 == pgm_filter_run (odata_only, spm->data, spm->len), "run failed");
+/* short packet */
+	fail_unless (0 == pgm_filter_run (odata_only, odata->data, 4), "run failed");
+	pgm_free_skb (odata);
+	pgm_free_skb (spm);
+}
+END_TEST
+
+/* indirect loads, scratch memory and arithmetic */
+START_TEST (test_run_pass_002)
+{
+	const uint8_t packet[] = { 0x45, 0x00, 0x12, 0x34, 0xff };
+	const struct pgm_filter_insn_t prog[] = {
+		STMT(PGM_BPF_LDX|PGM_BPF_B|PGM_BPF_MSH, 0),		/* X = 20 */
+		STMT(PGM_BPF_LD|PGM_BPF_H|PGM_BPF_ABS, 2),		/* A = 0x1234 */
+		STMT(PGM_BPF_ALU|PGM_BPF_ADD|PGM_BPF_X, 0),		/* A = 0x1248 */
+		STMT(PGM_BPF_ST, 3),
+		STMT(PGM_BPF_LDX|PGM_BPF_IMM, 2),
+		STMT(PGM_BPF_LD|PGM_BPF_B|PGM_BPF_IND, 2),		/* A = 0xff */
+		STMT(PGM_BPF_MISC|PGM_BPF_TAX, 0),
+		STMT(PGM_BPF_LD|PGM_BPF_W|PGM_BPF_MEM, 3),
+		STMT(PGM_BPF_ALU|PGM_BPF_SUB|PGM_BPF_X, 0),		/* A = 0x1149 */
+		JUMP(PGM_BPF_JMP|PGM_BPF_JGT|PGM_BPF_K, 0x1000, 0, 1),
+		STMT(PGM_BPF_RET|PGM_BPF_A, 0),
+		STMT(PGM_BPF_RET|PGM_BPF_K, 0)
+	};
+	fail_unless (pgm_filter_validate (prog, G_N_ELEMENTS(prog)), "validate failed");
+	fail_unless (0x1149 == pgm_filter_run (prog, packet, sizeof(packet)), "run failed");
+/* indirect load beyond end */
+	fail_unless (0 == pgm_filter_run (prog, packet, 4), "run failed");
+}
+END_TEST
+
+START_TEST (test_run_fail_001)
+{
+	const uint8_t packet[] = { 0 };
+	pgm_filter_run (NULL, packet, sizeof(packet));
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_filter_accept (
+ *		const pgm_sock_t* const			sock,
+ *		const struct pgm_sk_buff_t* const	skb
+ *		)
+ */
+
+/* deny a GSI, upstream packets are never filtered */
+START_TEST (test_accept_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	struct pgm_sk_buff_t* denied = generate_skb (PGM_ODATA, 6, 1000, 0);
+	struct pgm_sk_buff_t* nak = generate_skb (PGM_NAK, 6, 1000, 0);
+	struct pgm_sk_buff_t* other = generate_skb (PGM_ODATA, 7, 1000, 0);
+	add_source (&sock->deny_sources, 6, 0);
+	sock->is_filtering = TRUE;
+	fail_if (pgm_filter_accept (sock, denied), "accept failed");
+	fail_unless (pgm_filter_accept (sock, nak), "accept failed");
+	fail_unless (pgm_filter_accept (sock, other), "accept failed");
+}
+END_TEST
+
+/* allow one session of a GSI, then filter by program */
+START_TEST (test_accept_pass_002)
+{
+	pgm_sock_t* sock = generate_sock ();
+	struct pgm_sk_buff_t* allowed = generate_skb (PGM_ODATA, 6, 1000, 0);
+	struct pgm_sk_buff_t* spm = generate_skb (PGM_SPM, 6, 1000, 0);
+	struct pgm_sk_buff_t* session = generate_skb (PGM_ODATA, 6, 1001, 0);
+	struct pgm_sk_buff_t* other = generate_skb (PGM_ODATA, 7, 1000, 0);
+	add_source (&sock->allow_sources, 6, 1000);
+	sock->is_filtering = TRUE;
+	fail_unless (pgm_filter_accept (sock, allowed), "accept failed");
+	fail_unless (pgm_filter_accept (sock, spm), "accept failed");
+	fail_if (pgm_filter_accept (sock, session), "accept failed");
+	fail_if (pgm_filter_accept (sock, other), "accept failed");
+	sock->filter = odata_only;
+	sock->filter_len = G_N_ELEMENTS(odata_only);
+	fail_unless (pgm_filter_accept (sock, allowed), "accept failed");
+	fail_if (pgm_filter_accept (sock, spm), "accept failed");
+}
+END_TEST
+
+START_TEST (test_accept_fail_001)
+{
+	struct pgm_sk_buff_t* skb = generate_skb (PGM_ODATA, 6, 1000, 0);
+	gboolean is_accepted = pgm_filter_accept (NULL, skb);
+	fail ("reached");
+}
+END_TEST
+
+#ifdef SO_ATTACH_FILTER
+/* target:
+ *	struct pgm_filter_insn_t*
+ *	_pgm_filter_compile (
+ *		const pgm_sock_t* const	sock,
+ *		const unsigned		offset,
+ *		unsigned*		len
+ *		)
+ */
+
+/* kernel program over UDP datagrams agrees with the library filter */
+START_TEST (test_compile_pass_001)
+{
+	const unsigned offset = sizeof(struct pgm_udphdr);
+	const struct {
+		uint8_t		type;
+		uint8_t		gsi_tail;
+		uint16_t	sport;
+	} cases[] = {
+		{ PGM_ODATA, 6, 1000 },		/* allowed */
+		{ PGM_SPM,   6, 1000 },		/* allowed, dropped by program */
+		{ PGM_ODATA, 6, 1001 },		/* other session */
+		{ PGM_RDATA, 7, 1000 },		/* denied */
+		{ PGM_NAK,   7, 1000 },		/* upstream */
+		{ PGM_ODATA, 8, 1000 }		/* not allowed */
+	};
+	pgm_sock_t* sock = generate_sock ();
+	unsigned len;
+	add_source (&sock->deny_sources, 7, 0);
+	add_source (&sock->allow_sources, 6, 1000);
+	add_source (&sock->allow_sources, 7, 0);
+	sock->is_filtering = TRUE;
+	for (unsigned pass = 0; pass < 2; pass++)
+	{
+		if (pass) {
+			sock->filter = odata_only;
+			sock->filter_len = G_N_ELEMENTS(odata_only);
+		}
+		struct pgm_filter_insn_t* prog = _pgm_filter_compile (sock, offset, &len);
+		fail_if (NULL == prog, "compile failed");
+		fail_unless (pgm_filter_validate (prog, len), "validate failed");
+		for (unsigned i = 0; i < G_N_ELEMENTS(cases); i++)
+		{
+			struct pgm_sk_buff_t* skb = generate_skb (cases[i].type, cases[i].gsi_tail, cases[i].sport, offset);
+			const bool is_accepted = pgm_filter_accept (sock, skb);
+			const uint32_t snaplen = pgm_filter_run (prog, (const uint8_t*)skb->data - offset, skb->len + offset);
+			fail_unless (is_accepted == (0 != snaplen), "compile failed on case %u pass %u", i, pass);
+			fail_unless (0 == snaplen || UINT32_MAX == snaplen, "snaplen failed");
+			pgm_free_skb (skb);
+		}
+		pgm_free (prog);
+	}
+}
+END_TEST
+
+/* programs depending on packet length stay in the library */
+START_TEST (test_compile_pass_002)
+{
+	const struct pgm_filter_insn_t length[] = {
+		STMT(PGM_BPF_LD|PGM_BPF_W|PGM_BPF_LEN, 0),
+		STMT(PGM_BPF_RET|PGM_BPF_A, 0)
+	};
+	pgm_sock_t* sock = generate_sock ();
+	unsigned len;
+	sock->filter = (struct pgm_filter_insn_t*)length;
+	sock->filter_len = G_N_ELEMENTS(length);
+	sock->is_filtering = TRUE;
+	fail_unless (NULL == _pgm_filter_compile (sock, sizeof(struct pgm_udphdr), &len), "compile failed");
+}
+END_TEST
+#endif /* SO_ATTACH_FILTER */
+
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_validate = tcase_create ("validate");
+	suite_add_tcase (s, tc_validate);
+	tcase_add_test (tc_validate, test_validate_pass_001);
+	tcase_add_test (tc_validate, test_validate_fail_001);
+
+	TCase* tc_run = tcase_create ("run");
+	suite_add_tcase (s, tc_run);
+	tcase_add_test (tc_run, test_run_pass_001);
+	tcase_add_test (tc_run, test_run_pass_002);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_run, test_run_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_accept = tcase_create ("accept");
+	suite_add_tcase (s, tc_accept);
+	tcase_add_test (tc_accept, test_accept_pass_001);
+	tcase_add_test (tc_accept, test_accept_pass_002);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_accept, test_accept_fail_001, SIGABRT);
+#endif
+
+#ifdef SO_ATTACH_FILTER
+	TCase* tc_compile = tcase_create ("compile");
+	suite_add_tcase (s, tc_compile);
+	tcase_add_test (tc_compile, test_compile_pass_001);
+	tcase_add_test (tc_compile, test_compile_pass_002);
+#endif
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
@@ -79,7 +79,7 @@ _pgm_compat_setnetent (void)
 				  pgm_win_strerror (winstr, sizeof (winstr), save_errno));
 /* fall through on original string */
 		} else {
-			free (netdb);
+			pgm_free (netdb);
 			netdb = pgm_strdup (expanded);
 		}
 	}
@@ -92,7 +92,7 @@ _pgm_compat_setnetent (void)
 				  pgm_strerror_s (errbuf, sizeof (errbuf), err));
 		}
 
-		free (netdb);
+		pgm_free (netdb);
 
 	} else {
 		rewind (netfh);
@@ -284,7 +284,7 @@ pgm_getnetbyname (
 	errno_t err;
 
 	err = pgm_dupenv_s (&netdb, &envlen, "PGM_NETDB");
-	free (netdb);
+	pgm_free (netdb);
 	if (0 != err || 0 == envlen) {
 /* default use native implementation */
 		return _pgm_native_getnetbyname (name);
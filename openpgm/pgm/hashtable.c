@@ -47,6 +47,7 @@ struct pgm_hashtable_t
 	pgm_hashnode_t**	nodes;
 	pgm_hashfunc_t		hash_func;
 	pgm_equalfunc_t		key_equal_func;
+	pgm_heap_t*		heap;			/* maybe NULL */
 };
 
 #define PGM_HASHTABLE_RESIZE(hash_table) \
@@ -60,9 +61,9 @@ struct pgm_hashtable_t
 
 static void pgm_hashtable_resize (pgm_hashtable_t*);
 static pgm_hashnode_t** pgm_hashtable_lookup_node (const pgm_hashtable_t*restrict, const void*restrict, pgm_hash_t*restrict) PGM_GNUC_PURE;
-static pgm_hashnode_t* pgm_hash_node_new (const void*restrict, void*restrict, const pgm_hash_t);
-static void pgm_hash_node_destroy (pgm_hashnode_t*);
-static void pgm_hash_nodes_destroy (pgm_hashnode_t*);
+static pgm_hashnode_t* pgm_hash_node_new (pgm_heap_t*const, const void*restrict, void*restrict, const pgm_hash_t);
+static void pgm_hash_node_destroy (pgm_heap_t*const, pgm_hashnode_t*);
+static void pgm_hash_nodes_destroy (pgm_heap_t*const, pgm_hashnode_t*);
 
 PGM_GNUC_INTERNAL
 pgm_hashtable_t*
@@ -70,18 +71,33 @@ pgm_hashtable_new (
 	pgm_hashfunc_t	hash_func,
 	pgm_equalfunc_t	key_equal_func
 	)
+{
+	return pgm_hashtable_new_full (hash_func, key_equal_func, NULL);
+}
+
+/* table and nodes are allocated from heap.
+ */
+
+PGM_GNUC_INTERNAL
+pgm_hashtable_t*
+pgm_hashtable_new_full (
+	pgm_hashfunc_t	hash_func,
+	pgm_equalfunc_t	key_equal_func,
+	pgm_heap_t*	heap		/* maybe NULL */
+	)
 {
 	pgm_return_val_if_fail (NULL != hash_func, NULL);
 	pgm_return_val_if_fail (NULL != key_equal_func, NULL);
 
 	pgm_hashtable_t *hash_table;
   
-	hash_table = pgm_new (pgm_hashtable_t, 1);
+	hash_table = pgm_heap_new0 (heap, pgm_hashtable_t, 1);
 	hash_table->size               = HASHTABLE_MIN_SIZE;
 	hash_table->nnodes             = 0;
 	hash_table->hash_func          = hash_func;
 	hash_table->key_equal_func     = key_equal_func;
-	hash_table->nodes              = pgm_new0 (pgm_hashnode_t*, hash_table->size);
+	hash_table->heap               = heap;
+	hash_table->nodes              = pgm_heap_new0 (heap, pgm_hashnode_t*, hash_table->size);
   
 	return hash_table;
 }
@@ -94,10 +110,11 @@ pgm_hashtable_unref (
 {
 	pgm_return_if_fail (hash_table != NULL);
 
+	pgm_heap_t* heap = hash_table->heap;
 	for (unsigned i = 0; i < hash_table->size; i++)
-		pgm_hash_nodes_destroy (hash_table->nodes[i]);
-	pgm_free (hash_table->nodes);
-	pgm_free (hash_table);
+		pgm_hash_nodes_destroy (heap, hash_table->nodes[i]);
+	pgm_heap_free (heap, hash_table->nodes);
+	pgm_heap_free (heap, hash_table);
 }
 
 PGM_GNUC_INTERNAL
@@ -178,7 +195,7 @@ pgm_hashtable_insert (
 	node = pgm_hashtable_lookup_node (hash_table, key, &key_hash);
 	pgm_return_if_fail (NULL == *node); 
 
-	*node = pgm_hash_node_new (key, value, key_hash);
+	*node = pgm_hash_node_new (hash_table->heap, key, value, key_hash);
 	hash_table->nnodes++;
 	PGM_HASHTABLE_RESIZE (hash_table);
 }
@@ -199,7 +216,7 @@ pgm_hashtable_remove (
 	{
 		dest = *node;
 		(*node) = dest->next;
-		pgm_hash_node_destroy (dest);
+		pgm_hash_node_destroy (hash_table->heap, dest);
 		hash_table->nnodes--;
 		PGM_HASHTABLE_RESIZE (hash_table);
 		return TRUE;
@@ -217,7 +234,7 @@ pgm_hashtable_remove_all (
 
 	for (unsigned i = 0; i < hash_table->size; i++)
 	{
-		pgm_hash_nodes_destroy (hash_table->nodes[i]);
+		pgm_hash_nodes_destroy (hash_table->heap, hash_table->nodes[i]);
 		hash_table->nodes[i] = NULL;
 	}
 	hash_table->nnodes = 0;
@@ -232,7 +249,7 @@ pgm_hashtable_resize (
 {
 	const unsigned new_size = CLAMP (pgm_spaced_primes_closest (hash_table->nnodes),
 					 HASHTABLE_MIN_SIZE, HASHTABLE_MAX_SIZE);
-	pgm_hashnode_t** new_nodes = pgm_new0 (pgm_hashnode_t*, new_size);
+	pgm_hashnode_t** new_nodes = pgm_heap_new0 (hash_table->heap, pgm_hashnode_t*, new_size);
   
 	for (unsigned i = 0; i < hash_table->size; i++)
 		for (pgm_hashnode_t *node = hash_table->nodes[i], *next; node; node = next)
@@ -243,7 +260,7 @@ pgm_hashtable_resize (
 			new_nodes[hash_val] = node;
 		}
   
-	pgm_free (hash_table->nodes);
+	pgm_heap_free (hash_table->heap, hash_table->nodes);
 	hash_table->nodes = new_nodes;
 	hash_table->size = new_size;
 }
@@ -251,12 +268,13 @@ pgm_hashtable_resize (
 static
 pgm_hashnode_t*
 pgm_hash_node_new (
+	pgm_heap_t* const    heap,
 	const void* restrict key,
 	void* 	    restrict value,
 	const pgm_hash_t     key_hash
 	)
 {
-	pgm_hashnode_t *hash_node = pgm_new (pgm_hashnode_t, 1);
+	pgm_hashnode_t *hash_node = pgm_heap_new0 (heap, pgm_hashnode_t, 1);
 	hash_node->key = key;
 	hash_node->value = value;
 	hash_node->key_hash = key_hash;
@@ -267,21 +285,23 @@ pgm_hash_node_new (
 static
 void
 pgm_hash_node_destroy (
+	pgm_heap_t* const heap,
 	pgm_hashnode_t*	hash_node
 	)
 {
-	pgm_free (hash_node);
+	pgm_heap_free (heap, hash_node);
 }
 
 static
 void
 pgm_hash_nodes_destroy (
+	pgm_heap_t* const heap,
 	pgm_hashnode_t*	hash_node
 	)
 {
 	while (hash_node) {
 		pgm_hashnode_t *next = hash_node->next;
-		pgm_free (hash_node);
+		pgm_heap_free (heap, hash_node);
 		hash_node = next;
 	}
 }
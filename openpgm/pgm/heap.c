@@ -0,0 +1,285 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * Per-socket object heap with optional size-class arena.
+ *
+ * Objects whose lifetime matches the socket, peers, windows and hash table
+ * nodes, are allocated through the heap of the socket so they can be routed
+ * to an application allocator and accounted per session.  With the arena
+ * enabled small blocks are bump allocated from 64 KB chunks and recycled
+ * through per size-class free lists, chunks return to the allocator when
+ * the heap is destroyed.
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#include <string.h>
+#include <impl/framework.h>
+
+
+//#define HEAP_DEBUG
+
+#ifndef HEAP_DEBUG
+#	define PGM_DISABLE_ASSERT
+#endif
+
+#define PGM_HEAP_CLASSES	(PGM_HEAP_MAX_SMALL / PGM_HEAP_ALIGN)
+
+/* header before each block, keeps the block PGM_HEAP_ALIGN aligned.
+ */
+struct pgm_heap_block_t {
+	size_t			length;			/* requested bytes */
+	unsigned		size_class;		/* 0 for direct allocation */
+	char			__padding[PGM_HEAP_ALIGN - sizeof(size_t) - sizeof(unsigned)];
+};
+
+PGM_STATIC_ASSERT(sizeof(struct pgm_heap_block_t) == PGM_HEAP_ALIGN);
+
+struct pgm_heap_t {
+	pgm_allocator_t		allocator;		/* NULL malloc for pgm_malloc */
+	bool			use_arena;
+
+	pgm_spinlock_t		lock;
+	char*			chunks;			/* linked by first word */
+	char*			bump;			/* next free byte of current chunk */
+	char*			bump_end;
+	struct pgm_heap_block_t* free_lists[PGM_HEAP_CLASSES];	/* linked by first word after header */
+	unsigned		outstanding;		/* blocks not yet returned */
+	bool			is_destroyed;
+
+	struct pgm_mem_stats_t	stats;
+};
+
+
+static inline
+void*
+_pgm_heap_malloc (
+	const pgm_heap_t*const	heap,
+	const size_t		n_bytes
+	)
+{
+	void* mem;
+
+	if (NULL == heap->allocator.malloc)
+		return pgm_malloc (n_bytes);
+	mem = heap->allocator.malloc (n_bytes, heap->allocator.user_data);
+	if (PGM_UNLIKELY(NULL == mem)) {
+		pgm_fatal ("file %s: line %d: failed to allocate %" PRIzu " bytes",
+			__FILE__, __LINE__,
+			n_bytes);
+		abort ();
+	}
+	return mem;
+}
+
+static inline
+void
+_pgm_heap_mfree (
+	const pgm_heap_t*const	heap,
+	void*			mem
+	)
+{
+	if (NULL == heap->allocator.malloc)
+		pgm_free (mem);
+	else
+		heap->allocator.free (mem, heap->allocator.user_data);
+}
+
+/* create a heap using allocator, or pgm_malloc() when NULL, optionally
+ * carving small blocks from arena chunks.
+ *
+ * returns pointer to heap.
+ */
+
+PGM_GNUC_INTERNAL
+pgm_heap_t*
+pgm_heap_create (
+	const pgm_allocator_t*const allocator,		/* maybe NULL */
+	const bool		use_arena
+	)
+{
+	pgm_heap_t* heap;
+
+	pgm_debug ("pgm_heap_create (allocator:%p use-arena:%s)",
+		(const void*)allocator, use_arena ? "TRUE" : "FALSE");
+
+	heap = pgm_new0 (pgm_heap_t, 1);
+	if (NULL != allocator)
+		heap->allocator = *allocator;
+	heap->use_arena = use_arena;
+	pgm_spinlock_init (&heap->lock);
+	return heap;
+}
+
+static
+void
+_pgm_heap_release (
+	pgm_heap_t*const	heap
+	)
+{
+	while (heap->chunks) {
+		char* next = *(char**)heap->chunks;
+		_pgm_heap_mfree (heap, heap->chunks);
+		heap->chunks = next;
+	}
+	pgm_spinlock_free (&heap->lock);
+	pgm_free (heap);
+}
+
+/* objects may outlive the socket, for example a peer held by a reference,
+ * arena chunks are released with the last block.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_heap_destroy (
+	pgm_heap_t*const	heap
+	)
+{
+	bool is_last;
+
+/* pre-conditions */
+	pgm_assert (NULL != heap);
+	pgm_assert (!heap->is_destroyed);
+
+	pgm_spinlock_lock (&heap->lock);
+	heap->is_destroyed = TRUE;
+	is_last = (0 == heap->outstanding);
+	pgm_spinlock_unlock (&heap->lock);
+	if (is_last)
+		_pgm_heap_release (heap);
+}
+
+/* allocate n_bytes of zeroed memory, from pgm_malloc0() when heap is NULL.
+ *
+ * returns pointer to memory, or NULL for zero n_bytes.
+ */
+
+PGM_GNUC_INTERNAL
+void*
+pgm_heap_alloc0 (
+	pgm_heap_t*const	heap,		/* maybe NULL */
+	const size_t		n_bytes
+	)
+{
+	struct pgm_heap_block_t* block;
+	const size_t block_length = sizeof(struct pgm_heap_block_t) + n_bytes;
+	unsigned size_class = 0;
+
+	if (NULL == heap)
+		return pgm_malloc0 (n_bytes);
+	if (PGM_UNLIKELY(0 == n_bytes))
+		return NULL;
+
+	pgm_spinlock_lock (&heap->lock);
+	if (heap->use_arena && block_length <= PGM_HEAP_MAX_SMALL)
+	{
+		const size_t class_length = (block_length + PGM_HEAP_ALIGN - 1) & ~((size_t)PGM_HEAP_ALIGN - 1);
+		size_class = (unsigned)(class_length / PGM_HEAP_ALIGN);
+		block = heap->free_lists[ size_class - 1 ];
+		if (PGM_LIKELY(NULL != block))
+			heap->free_lists[ size_class - 1 ] = *(struct pgm_heap_block_t**)(block + 1);
+		else {
+			if (PGM_UNLIKELY((size_t)(heap->bump_end - heap->bump) < class_length)) {
+/* remainder of the current chunk is abandoned */
+				char* chunk = _pgm_heap_malloc (heap, PGM_HEAP_CHUNK_SIZE);
+				*(char**)chunk = heap->chunks;
+				heap->chunks = chunk;
+				heap->bump = chunk + PGM_HEAP_ALIGN;
+				heap->bump_end = chunk + PGM_HEAP_CHUNK_SIZE;
+				heap->stats.bytes_reserved += PGM_HEAP_CHUNK_SIZE;
+			}
+			block = (struct pgm_heap_block_t*)heap->bump;
+			heap->bump += class_length;
+		}
+	}
+	else
+	{
+		pgm_spinlock_unlock (&heap->lock);
+		block = _pgm_heap_malloc (heap, block_length);
+		pgm_spinlock_lock (&heap->lock);
+	}
+	heap->outstanding++;
+	heap->stats.allocations++;
+	heap->stats.bytes_allocated += n_bytes;
+	if (heap->stats.bytes_allocated > heap->stats.bytes_peak)
+		heap->stats.bytes_peak = heap->stats.bytes_allocated;
+	pgm_spinlock_unlock (&heap->lock);
+
+	block->length	  = n_bytes;
+	block->size_class = size_class;
+	memset (block + 1, 0, n_bytes);
+	return block + 1;
+}
+
+PGM_GNUC_INTERNAL
+void
+pgm_heap_free (
+	pgm_heap_t*const	heap,		/* maybe NULL */
+	void*			mem
+	)
+{
+	struct pgm_heap_block_t* block;
+	bool is_last;
+
+	if (NULL == heap) {
+		pgm_free (mem);
+		return;
+	}
+	if (PGM_UNLIKELY(NULL == mem))
+		return;
+
+	block = (struct pgm_heap_block_t*)mem - 1;
+	pgm_spinlock_lock (&heap->lock);
+	heap->stats.frees++;
+	heap->stats.bytes_allocated -= block->length;
+	if (block->size_class) {
+		pgm_assert_cmpuint (block->size_class, <=, PGM_HEAP_CLASSES);
+		*(struct pgm_heap_block_t**)(block + 1) = heap->free_lists[ block->size_class - 1 ];
+		heap->free_lists[ block->size_class - 1 ] = block;
+		block = NULL;
+	}
+	is_last = (0 == --heap->outstanding && heap->is_destroyed);
+	pgm_spinlock_unlock (&heap->lock);
+	if (NULL != block)
+		_pgm_heap_mfree (heap, block);
+	if (is_last)
+		_pgm_heap_release (heap);
+}
+
+/* copy heap counters into stats.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_heap_stats (
+	pgm_heap_t*const		heap,
+	struct pgm_mem_stats_t*const	stats
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != heap);
+	pgm_assert (NULL != stats);
+
+	pgm_spinlock_lock (&heap->lock);
+	memcpy (stats, &heap->stats, sizeof (struct pgm_mem_stats_t));
+	pgm_spinlock_unlock (&heap->lock);
+}
+
+/* eof */
@@ -0,0 +1,245 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for the per-socket object heap.
+ *
+ * Copyright (c) 2009-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <glib.h>
+#include <check.h>
+
+#ifdef _WIN32
+#	define PGM_CHECK_NOFORK		1
+#endif
+
+
+/* mock state */
+
+static unsigned mock_mallocs = 0;
+static unsigned mock_frees = 0;
+
+#define HEAP_DEBUG
+#include "heap.c"
+
+
+/* mock functions for external references */
+
+size_t
+pgm_pkt_offset (
+        const bool                      can_fragment,
+        const sa_family_t		pgmcc_family	/* 0 = disable */
+        )
+{
+        return 0;
+}
+
+static
+void*
+mock_malloc (
+	size_t		n_bytes,
+	void*		user_data
+	)
+{
+	fail_unless (&mock_mallocs == user_data, "user_data failed");
+	mock_mallocs++;
+	return malloc (n_bytes);
+}
+
+static
+void*
+mock_realloc (
+	void*		mem,
+	size_t		n_bytes,
+	void*		user_data
+	)
+{
+	return realloc (mem, n_bytes);
+}
+
+static
+void
+mock_free (
+	void*		mem,
+	void*		user_data
+	)
+{
+	mock_frees++;
+	free (mem);
+}
+
+static const pgm_allocator_t mock_allocator = {
+	.malloc		= mock_malloc,
+	.realloc	= mock_realloc,
+	.free		= mock_free,
+	.user_data	= &mock_mallocs
+};
+
+
+/* target:
+ *	void*
+ *	pgm_heap_alloc0 (
+ *		pgm_heap_t*const	heap,
+ *		const size_t		n_bytes
+ *	)
+ */
+
+/* direct allocation through the application allocator */
+START_TEST (test_alloc0_pass_001)
+{
+	struct pgm_mem_stats_t stats;
+	mock_mallocs = mock_frees = 0;
+	pgm_heap_t* heap = pgm_heap_create (&mock_allocator, FALSE);
+	fail_if (NULL == heap, "create failed");
+	char* mem = pgm_heap_alloc0 (heap, 100);
+	fail_if (NULL == mem, "alloc0 failed");
+	fail_unless (0 == ((uintptr_t)mem % PGM_HEAP_ALIGN), "not aligned");
+	fail_unless (0 == mem[0] && 0 == mem[99], "not zeroed");
+	fail_unless (1 == mock_mallocs, "allocator not called");
+	pgm_heap_stats (heap, &stats);
+	fail_unless (100 == stats.bytes_allocated, "bytes_allocated failed");
+	fail_unless (1 == stats.allocations, "allocations failed");
+	pgm_heap_free (heap, mem);
+	fail_unless (1 == mock_frees, "allocator not called");
+	pgm_heap_stats (heap, &stats);
+	fail_unless (0 == stats.bytes_allocated, "bytes_allocated failed");
+	fail_unless (100 == stats.bytes_peak, "bytes_peak failed");
+	fail_unless (1 == stats.frees, "frees failed");
+	pgm_heap_destroy (heap);
+}
+END_TEST
+
+/* small blocks bump allocated and recycled by size class */
+START_TEST (test_alloc0_pass_002)
+{
+	struct pgm_mem_stats_t stats;
+	mock_mallocs = mock_frees = 0;
+	pgm_heap_t* heap = pgm_heap_create (&mock_allocator, TRUE);
+	fail_if (NULL == heap, "create failed");
+	char* mem1 = pgm_heap_alloc0 (heap, 100);
+	char* mem2 = pgm_heap_alloc0 (heap, 100);
+	fail_unless (1 == mock_mallocs, "chunk not shared");
+	fail_unless (0 == ((uintptr_t)mem2 % PGM_HEAP_ALIGN), "not aligned");
+	memset (mem1, 0xaa, 100);
+	pgm_heap_free (heap, mem1);
+	fail_unless (0 == mock_frees, "block returned to allocator");
+	char* mem3 = pgm_heap_alloc0 (heap, 97);
+	fail_unless (mem1 == mem3, "block not reused");
+	fail_unless (0 == mem3[0] && 0 == mem3[96], "not zeroed");
+	pgm_heap_stats (heap, &stats);
+	fail_unless (PGM_HEAP_CHUNK_SIZE == stats.bytes_reserved, "bytes_reserved failed");
+	fail_unless (197 == stats.bytes_allocated, "bytes_allocated failed");
+/* large blocks bypass the arena */
+	char* mem4 = pgm_heap_alloc0 (heap, PGM_HEAP_MAX_SMALL);
+	fail_unless (2 == mock_mallocs, "large block from arena");
+	pgm_heap_free (heap, mem4);
+	fail_unless (1 == mock_frees, "large block not returned");
+	pgm_heap_free (heap, mem2);
+	pgm_heap_free (heap, mem3);
+	pgm_heap_destroy (heap);
+	fail_unless (2 == mock_frees, "chunk not returned");
+}
+END_TEST
+
+/* NULL heap passes through to the library allocator */
+START_TEST (test_alloc0_pass_003)
+{
+	char* mem = pgm_heap_alloc0 (NULL, 100);
+	fail_if (NULL == mem, "alloc0 failed");
+	fail_unless (0 == mem[0] && 0 == mem[99], "not zeroed");
+	pgm_heap_free (NULL, mem);
+}
+END_TEST
+
+/* blocks outlive the heap owner */
+START_TEST (test_alloc0_pass_004)
+{
+	mock_mallocs = mock_frees = 0;
+	pgm_heap_t* heap = pgm_heap_create (&mock_allocator, TRUE);
+	fail_if (NULL == heap, "create failed");
+	char* mem = pgm_heap_alloc0 (heap, 100);
+	pgm_heap_destroy (heap);
+	fail_unless (0 == mock_frees, "chunk released early");
+	memset (mem, 0xaa, 100);
+	pgm_heap_free (heap, mem);
+	fail_unless (1 == mock_frees, "chunk not returned");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_heap_destroy (
+ *		pgm_heap_t*const	heap
+ *	)
+ */
+
+START_TEST (test_destroy_fail_001)
+{
+	pgm_heap_destroy (NULL);
+	fail ("reached");
+}
+END_TEST
+
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_alloc0 = tcase_create ("alloc0");
+	suite_add_tcase (s, tc_alloc0);
+	tcase_add_test (tc_alloc0, test_alloc0_pass_001);
+	tcase_add_test (tc_alloc0, test_alloc0_pass_002);
+	tcase_add_test (tc_alloc0, test_alloc0_pass_003);
+	tcase_add_test (tc_alloc0, test_alloc0_pass_004);
+
+	TCase* tc_destroy = tcase_create ("destroy");
+	suite_add_tcase (s, tc_destroy);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_destroy, test_destroy_fail_001, SIGABRT);
+#endif
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
@@ -1323,25 +1323,31 @@ http_tsi_response (
 							"<th>NNAKs received</th><td>%" GROUP_FORMAT PRIu32 "</td>"
 						"</tr><tr>"
 							"<th>Malformed NNAKs</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+						"</tr><tr>"
+							"<th>Pro-active parity packets</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+						"</tr><tr>"
+							"<th>Pro-active parity changes</th><td>%" GROUP_FORMAT PRIu32 "</td>"
 						"</tr>"
 						"</table>\n",
-						sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT],
-						sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT],
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_DATA_BYTES_SENT),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_DATA_MSGS_SENT),
 						window ? (uint32_t)pgm_txw_size (window) : 0,	/* minus IP & any UDP header */
 						window ? (uint32_t)pgm_txw_length (window) : 0,
-						sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT],
-						sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED],
-						sock->cumulative_stats[PGM_PC_SOURCE_CKSUM_ERRORS],
-						sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS],
-						sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED],
-						sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED],
-						sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED],
-						sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED],
-						sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED],
-						sock->cumulative_stats[PGM_PC_SOURCE_TRANSMISSION_CURRENT_RATE],
-						sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED],
-						sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED],
-						sock->cumulative_stats[PGM_PC_SOURCE_NNAK_ERRORS]);
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_BYTES_SENT),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_CKSUM_ERRORS),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_MALFORMED_NAKS),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_PACKETS_DISCARDED),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_TRANSMISSION_CURRENT_RATE),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_NNAK_ERRORS),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_PROACTIVE_PARITY_PACKETS),
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_PROACTIVE_PARITY_CHANGES));
 
 	pgm_rwlock_reader_unlock (&pgm_sock_list_lock);
 	http_finalize_response (connection, response);
@@ -1583,12 +1589,28 @@ http_receiver_response (
 							"<th>Malformed NCFs</th><td>%" GROUP_FORMAT PRIu32 "</td>"
 						"</tr><tr>"
 							"<th>Packets discarded</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+						"</tr><tr>"
+							"<th>Socket overflow drops</th><td>%" GROUP_FORMAT PRIu32 "</td>"	/* socket wide */
+						"</tr><tr>"
+							"<th>Packets filtered</th><td>%" GROUP_FORMAT PRIu32 "</td>"
 						"</tr><tr>"
 							"<th>Losses</th><td>%" GROUP_FORMAT PRIu32 "</td>"	/* detected missed packets */
 						"</tr><tr>"
 							"<th>Bytes delivered to app</th><td>%" GROUP_FORMAT PRIu32 "</td>"
 						"</tr><tr>"
 							"<th>Packets delivered to app</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+						"</tr><tr>"
+							"<th>Buffers detached by app</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+						"</tr><tr>"
+							"<th>Bytes detached by app</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+						"</tr><tr>"
+							"<th>Delivery weight</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+						"</tr><tr>"
+							"<th>Delivery latency mean</th><td>%" GROUP_FORMAT PRIu32 " μs</td>"
+						"</tr><tr>"
+							"<th>Delivery latency 99th percentile</th><td>%" GROUP_FORMAT PRIu32 " μs</td>"
+						"</tr><tr>"
+							"<th>Delivery latency max</th><td>%" GROUP_FORMAT PRIu32 " μs</td>"
 						"</tr><tr>"
 							"<th>Duplicate SPMs</th><td>%" GROUP_FORMAT PRIu32 "</td>"
 						"</tr><tr>"
@@ -1641,15 +1663,23 @@ http_receiver_response (
 						peer->cumulative_stats[PGM_PC_RECEIVER_DATA_MSGS_RECEIVED],
 						peer->cumulative_stats[PGM_PC_RECEIVER_NAK_FAILURES],
 						peer->cumulative_stats[PGM_PC_RECEIVER_BYTES_RECEIVED],
-						sock->cumulative_stats[PGM_PC_SOURCE_CKSUM_ERRORS],
+						pgm_stats_read (&sock->stats, PGM_PC_SOURCE_CKSUM_ERRORS) + ((const pgm_rxw_t*)peer->window)->cumulative_csum_errors,
 						peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_SPMS],
 						peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_ODATA],
 						peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_RDATA],
 						peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_NCFS],
 						peer->cumulative_stats[PGM_PC_RECEIVER_PACKETS_DISCARDED],
+						sock->rxq_overflow_drops,
+						sock->filtered_packets,
 						window->cumulative_losses,
 						window->bytes_delivered,
 						window->msgs_delivered,
+						pgm_atomic_read32 (&window->detached_count),
+						pgm_atomic_read32 (&window->detached_size),
+						peer->weight,
+						peer->latency_count ? (uint32_t)(peer->latency_sum / peer->latency_count) : 0,
+						pgm_peer_latency_percentile (peer, 99),
+						peer->latency_max,
 						peer->cumulative_stats[PGM_PC_RECEIVER_DUP_SPMS],
 						peer->cumulative_stats[PGM_PC_RECEIVER_DUP_DATAS],
 						peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAK_PACKETS_SENT],
@@ -0,0 +1,55 @@
+/* vim:ts=8:sts=4:sw=4:noai:noexpandtab
+ *
+ * Huge page backed storage for window skbuffs and pointer arrays.
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if !defined (__PGM_IMPL_FRAMEWORK_H_INSIDE__) && !defined (PGM_COMPILATION)
+#	error "Only <framework.h> can be included directly."
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_ARENA_H__
+#define __PGM_IMPL_ARENA_H__
+
+typedef struct pgm_arena_t pgm_arena_t;
+
+#include <pgm/types.h>
+#include <pgm/error.h>
+#include <pgm/skbuff.h>
+#include <impl/heap.h>
+
+PGM_BEGIN_DECLS
+
+#define PGM_ARENA_HUGE_PAGE_SIZE	(2 * 1024 * 1024)
+
+/* highest NUMA node accepted for placement */
+#define PGM_ARENA_MAX_NUMA_NODE		63
+
+PGM_GNUC_INTERNAL pgm_arena_t* pgm_arena_create (const uint16_t, const unsigned, const int, const bool, pgm_error_t**) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_arena_destroy (pgm_arena_t*const);
+PGM_GNUC_INTERNAL struct pgm_sk_buff_t* pgm_arena_alloc_skb (pgm_arena_t*const, const uint16_t) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void* pgm_arena_alloc_array (const pgm_arena_t*const, pgm_heap_t*const, const size_t) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_arena_free_array (pgm_heap_t*const, void*);
+PGM_GNUC_INTERNAL unsigned pgm_arena_exhausted (const pgm_arena_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_ARENA_H__ */
@@ -45,6 +45,11 @@ struct pgm_cpu_t {
 	bool		has_sse42;
 	bool		has_avx;
 	bool		has_avx2;
+	bool		has_avx512f;
+	bool		has_avx512bw;
+	bool		has_invariant_tsc;
+	uint32_t	tsc_khz;	/* crystal or hypervisor enumerated, 0 if unknown */
+	uint32_t	base_mhz;	/* nominal processor base frequency, 0 if unknown */
 };
 
 PGM_GNUC_INTERNAL void pgm_cpuid (pgm_cpu_t*);
@@ -0,0 +1,80 @@
+/* vim:ts=8:sts=4:sw=4:noai:noexpandtab
+ *
+ * Worker pool for off-loading parity reconstruction of transmission groups.
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if !defined (__PGM_IMPL_FRAMEWORK_H_INSIDE__) && !defined (PGM_COMPILATION)
+#	error "Only <framework.h> can be included directly."
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_FEC_POOL_H__
+#define __PGM_IMPL_FEC_POOL_H__
+
+typedef struct pgm_fec_job_t pgm_fec_job_t;
+typedef struct pgm_fec_pool_t pgm_fec_pool_t;
+
+#include <pgm/types.h>
+#include <pgm/error.h>
+#include <pgm/list.h>
+#include <pgm/skbuff.h>
+#include <impl/galois.h>
+
+PGM_BEGIN_DECLS
+
+/* maximum worker threads per socket */
+#define PGM_FEC_POOL_MAX_WORKERS	64
+
+typedef void (*pgm_fec_pool_notify_func)(void*);
+
+/* one transmission group decode.  the job holds a reference on every skbuff
+ * in tg_skbs[], repair skbuffs are released to the receive window on commit.
+ */
+struct pgm_fec_job_t {
+	pgm_list_t		link_;
+	const void*		window;			/* owning receive window */
+	void*			user_data;		/* owning peer */
+	uint32_t		tg_sqn;
+	uint8_t			rs_n, rs_k;
+	uint8_t			tg_depth_shift;
+	uint16_t		parity_length;
+	bool			is_op_encoded;
+	bool			is_var_pktlen;
+
+	struct pgm_sk_buff_t**	tg_skbs;		/* [rs_n] */
+	pgm_gf8_t**		tg_data;		/* [rs_n] */
+	pgm_gf8_t**		tg_opts;		/* [rs_n] */
+	uint8_t*		offsets;		/* [rs_k] */
+};
+
+PGM_GNUC_INTERNAL pgm_fec_pool_t* pgm_fec_pool_create (const unsigned, pgm_fec_pool_notify_func, void*, pgm_error_t**) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_fec_pool_destroy (pgm_fec_pool_t*);
+PGM_GNUC_INTERNAL pgm_fec_job_t* pgm_fec_job_new (const uint8_t, const uint8_t) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_fec_job_free (pgm_fec_job_t*);
+PGM_GNUC_INTERNAL void pgm_fec_pool_push (pgm_fec_pool_t*const restrict, pgm_fec_job_t*const restrict);
+PGM_GNUC_INTERNAL pgm_fec_job_t* pgm_fec_pool_pop_completed (pgm_fec_pool_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL bool pgm_fec_pool_has_completed (const pgm_fec_pool_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL bool pgm_fec_pool_is_pending (pgm_fec_pool_t*const, const void*const, const uint32_t) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_fec_pool_cancel (pgm_fec_pool_t*const, const void*const);
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_FEC_POOL_H__ */
@@ -0,0 +1,49 @@
+/* vim:ts=8:sts=4:sw=4:noai:noexpandtab
+ *
+ * Receive side source filtering.
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if !defined (__PGM_IMPL_FRAMEWORK_H_INSIDE__) && !defined (PGM_COMPILATION)
+#	error "Only <framework.h> can be included directly."
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_FILTER_H__
+#define __PGM_IMPL_FILTER_H__
+
+#include <pgm/types.h>
+#include <pgm/skbuff.h>
+#include <pgm/socket.h>
+
+PGM_BEGIN_DECLS
+
+/* same limits as the Linux socket filter */
+#define PGM_FILTER_MAX_INSNS		4096
+#define PGM_FILTER_MEMWORDS		16
+
+PGM_GNUC_INTERNAL bool pgm_filter_validate (const struct pgm_filter_insn_t*const, const unsigned) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL uint32_t pgm_filter_run (const struct pgm_filter_insn_t*const, const uint8_t*const, const uint32_t) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL bool pgm_filter_accept (const pgm_sock_t*const, const struct pgm_sk_buff_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL bool pgm_filter_attach (pgm_sock_t*const);
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_FILTER_H__ */
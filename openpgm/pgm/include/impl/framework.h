@@ -42,11 +42,14 @@
 #include <pgm/tsi.h>
 #include <pgm/types.h>
 
+#include <impl/arena.h>
 #include <impl/byteorder.h>
 #include <impl/checksum.h>
 #include <impl/cpu.h>
 #include <impl/endian.h>
 #include <impl/errno.h>
+#include <impl/fec_pool.h>
+#include <impl/filter.h>
 #include <impl/fixed.h>
 #include <impl/galois.h>
 #include <impl/getifaddrs.h>
@@ -55,6 +58,7 @@
 #include <impl/getnodeaddr.h>
 #include <impl/getprotobyname.h>
 #include <impl/hashtable.h>
+#include <impl/heap.h>
 #include <impl/histogram.h>
 #include <impl/indextoaddr.h>
 #include <impl/indextoname.h>
@@ -72,11 +76,14 @@
 #include <impl/rate_control.h>
 #include <impl/reed_solomon.h>
 #include <impl/security.h>
+#include <impl/sendq.h>
 #include <impl/slist.h>
 #include <impl/sn.h>
 #include <impl/sockaddr.h>
+#include <impl/stats.h>
 #include <impl/string.h>
 #include <impl/thread.h>
+#include <impl/ticket.h>
 #include <impl/time.h>
 #include <impl/tsi.h>
 #include <impl/wsastrerror.h>
@@ -30,6 +30,7 @@
 #define __PGM_IMPL_HASHTABLE_H__
 
 #include <pgm/types.h>
+#include <impl/heap.h>
 
 PGM_BEGIN_DECLS
 
@@ -40,6 +41,7 @@ typedef pgm_hash_t (*pgm_hashfunc_t) (const void*);
 typedef bool (*pgm_equalfunc_t) (const void*restrict, const void*restrict);
 
 PGM_GNUC_INTERNAL pgm_hashtable_t* pgm_hashtable_new (pgm_hashfunc_t, pgm_equalfunc_t);
+PGM_GNUC_INTERNAL pgm_hashtable_t* pgm_hashtable_new_full (pgm_hashfunc_t, pgm_equalfunc_t, pgm_heap_t*);
 PGM_GNUC_INTERNAL void pgm_hashtable_destroy (pgm_hashtable_t*);
 PGM_GNUC_INTERNAL void pgm_hashtable_insert (pgm_hashtable_t*restrict, const void*restrict, void*restrict);
 PGM_GNUC_INTERNAL bool pgm_hashtable_remove (pgm_hashtable_t*restrict, const void*restrict);
@@ -0,0 +1,58 @@
+/* vim:ts=8:sts=4:sw=4:noai:noexpandtab
+ *
+ * Per-socket object heap with optional size-class arena.
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if !defined (__PGM_IMPL_FRAMEWORK_H_INSIDE__) && !defined (PGM_COMPILATION)
+#	error "Only <framework.h> can be included directly."
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_HEAP_H__
+#define __PGM_IMPL_HEAP_H__
+
+typedef struct pgm_heap_t pgm_heap_t;
+
+#include <pgm/types.h>
+#include <pgm/mem.h>
+
+PGM_BEGIN_DECLS
+
+/* alignment and size-class granularity of heap blocks */
+#define PGM_HEAP_ALIGN			16
+
+/* largest block, including header, carved from arena chunks */
+#define PGM_HEAP_MAX_SMALL		1024
+
+#define PGM_HEAP_CHUNK_SIZE		(64 * 1024)
+
+PGM_GNUC_INTERNAL pgm_heap_t* pgm_heap_create (const pgm_allocator_t*const, const bool) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_heap_destroy (pgm_heap_t*const);
+PGM_GNUC_INTERNAL void* pgm_heap_alloc0 (pgm_heap_t*const, const size_t) PGM_GNUC_MALLOC;
+PGM_GNUC_INTERNAL void pgm_heap_free (pgm_heap_t*const, void*);
+PGM_GNUC_INTERNAL void pgm_heap_stats (pgm_heap_t*const, struct pgm_mem_stats_t*const);
+
+#define pgm_heap_new0(heap, struct_type, n_structs) \
+	((struct_type*)pgm_heap_alloc0 ((heap), sizeof(struct_type) * (size_t)(n_structs)))
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_HEAP_H__ */
@@ -32,9 +32,28 @@
 
 PGM_BEGIN_DECLS
 
-PGM_GNUC_INTERNAL ssize_t pgm_sendto_hops (pgm_sock_t*restrict, bool, pgm_rate_t*restrict, bool, int, const void*restrict, size_t, const struct sockaddr*restrict, socklen_t);
+PGM_GNUC_INTERNAL ssize_t pgm_sendto_hops (pgm_sock_t*restrict, bool, pgm_rate_t*restrict, bool, int, const void*restrict, size_t, const struct sockaddr*restrict, socklen_t, pgm_time_t);
 PGM_GNUC_INTERNAL int pgm_set_nonblocking (SOCKET fd[2]);
 
+/* send with the loop time of the caller */
+static inline
+ssize_t
+pgm_sendto_now (
+	pgm_sock_t*restrict		sock,
+	bool				use_rate_limit,
+	pgm_rate_t*restrict		minor_rate_control,
+	bool				use_router_alert,
+	const void*restrict		buf,
+	size_t				len,
+	const struct sockaddr*restrict	to,
+	socklen_t			tolen,
+	pgm_time_t			now
+	)
+{
+	return pgm_sendto_hops (sock, use_rate_limit, minor_rate_control, use_router_alert, -1, buf, len, to, tolen, now);
+}
+
+/* send reading the clock only when rate limited */
 static inline
 ssize_t
 pgm_sendto (
@@ -48,7 +67,8 @@ pgm_sendto (
 	socklen_t			tolen
 	)
 {
-	return pgm_sendto_hops (sock, use_rate_limit, minor_rate_control, use_router_alert, -1, buf, len, to, tolen);
+	return pgm_sendto_hops (sock, use_rate_limit, minor_rate_control, use_router_alert, -1, buf, len, to, tolen,
+				use_rate_limit ? pgm_time_update_now() : 0);
 }
 
 PGM_END_DECLS
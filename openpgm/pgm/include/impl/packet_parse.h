@@ -32,8 +32,12 @@
 
 PGM_BEGIN_DECLS
 
-PGM_GNUC_INTERNAL bool pgm_parse_raw (struct pgm_sk_buff_t*const restrict, struct sockaddr*const restrict, pgm_error_t**restrict);
-PGM_GNUC_INTERNAL bool pgm_parse_udp_encap (struct pgm_sk_buff_t*const restrict, pgm_error_t**restrict);
+/* PGM checksum handling on parse */
+#define PGM_PARSE_DEFER_CSUM	0x1		/* defer ODATA & RDATA verification to delivery */
+#define PGM_PARSE_NO_CSUM	0x2		/* rely upon the UDP checksum */
+
+PGM_GNUC_INTERNAL bool pgm_parse_raw (struct pgm_sk_buff_t*const restrict, struct sockaddr*const restrict, const unsigned, pgm_error_t**restrict);
+PGM_GNUC_INTERNAL bool pgm_parse_udp_encap (struct pgm_sk_buff_t*const restrict, const unsigned, pgm_error_t**restrict);
 PGM_GNUC_INTERNAL bool pgm_verify_spm (const struct pgm_sk_buff_t* const);
 PGM_GNUC_INTERNAL bool pgm_verify_spmr (const struct pgm_sk_buff_t* const);
 PGM_GNUC_INTERNAL bool pgm_verify_nak (const struct pgm_sk_buff_t* const);
@@ -323,6 +323,7 @@
        #define COLUMN_PGMRECEIVERRXWLEAD		55
        #define COLUMN_PGMRECEIVERNAKFAILURESLASTINTERVAL		56
        #define COLUMN_PGMRECEIVERLASTINTERVALNAKFAILURES		57
+       #define COLUMN_PGMRECEIVERSOCKETOVERFLOWDROPS		58
 
 /* column number definitions for table pgmDlrSourceTable */
        #define COLUMN_PGMDLRSOURCEGLOBALID		1
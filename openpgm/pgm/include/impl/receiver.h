@@ -84,8 +84,15 @@ enum {
 	PGM_PC_RECEIVER_MAX
 };
 
+/* delivery latency histogram, log₂ microseconds */
+#define PGM_PEER_LATENCY_BUCKETS	24
+
+/* minimum interval between receive buffer increases on overflow */
+#define PGM_RCVBUF_RESIZE_IVL		pgm_secs(1)
+
 struct pgm_peer_t {
 	volatile uint32_t		ref_count;		    /* atomic integer */
+	pgm_heap_t*			heap;			    /* owning socket heap, outlives socket */
 
 	pgm_tsi_t			tsi;
 	struct sockaddr_storage		group_nla;
@@ -118,18 +125,31 @@ struct pgm_peer_t {
 	unsigned			last_commit;
 	uint32_t			lost_count;
 	uint32_t			last_cumulative_losses;
+	uint32_t			last_cumulative_csum_errors;
 	volatile uint32_t		cumulative_stats[PGM_PC_RECEIVER_MAX];
 	uint32_t			snap_stats[PGM_PC_RECEIVER_MAX];
 
 	uint32_t			min_fail_time;
 	uint32_t			max_fail_time;
+
+/* delivery scheduling */
+	uint32_t			weight;			    /* quantum multiplier */
+	int64_t				deficit;		    /* bytes of credit this round */
+	uint32_t			latency_count;		    /* APDUs delivered */
+	uint32_t			latency_max;		    /* receipt to delivery, microseconds */
+	uint64_t			latency_sum;
+	uint32_t			latency_histogram[PGM_PEER_LATENCY_BUCKETS];
 };
 
 PGM_GNUC_INTERNAL pgm_peer_t* pgm_new_peer (pgm_sock_t*const restrict, const pgm_tsi_t*const restrict, const struct sockaddr*const restrict, const socklen_t, const struct sockaddr*const restrict, const socklen_t, const pgm_time_t);
 PGM_GNUC_INTERNAL void pgm_peer_unref (pgm_peer_t*);
 PGM_GNUC_INTERNAL int pgm_flush_peers_pending (pgm_sock_t*const restrict, struct pgm_msgv_t**restrict, const struct pgm_msgv_t*const, size_t*const restrict, unsigned*const restrict);
+PGM_GNUC_INTERNAL void pgm_flush_peers_reconstructed (pgm_sock_t*const);
 PGM_GNUC_INTERNAL bool pgm_peer_has_pending (pgm_peer_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL void pgm_peer_set_pending (pgm_sock_t*const restrict, pgm_peer_t*const restrict);
+PGM_GNUC_INTERNAL uint32_t pgm_peer_latency_percentile (const pgm_peer_t*const, const unsigned) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL bool pgm_rcvbuf_resize (pgm_sock_t*const, const int);
+PGM_GNUC_INTERNAL void pgm_on_rxq_overflow (pgm_sock_t*const, const uint32_t, const pgm_time_t);
 PGM_GNUC_INTERNAL bool pgm_check_peer_state (pgm_sock_t*const, const pgm_time_t);
 PGM_GNUC_INTERNAL void pgm_set_reset_error (pgm_sock_t*const restrict, pgm_peer_t*const restrict, struct pgm_msgv_t*const restrict);
 PGM_GNUC_INTERNAL pgm_time_t pgm_min_receiver_expiry (pgm_sock_t*, pgm_time_t) PGM_GNUC_WARN_UNUSED_RESULT;
@@ -58,10 +58,12 @@ enum
 	PGM_RXW_UNKNOWN
 };
 
-/* must be smaller than PGM skbuff control buffer */
+/* per-sequence recovery state, held in a dense array parallel to pdata[]
+ * so that window walks do not touch each skbuff.
+ */
 struct pgm_rxw_state_t {
 	pgm_time_t	timer_expiry;
-        int		pkt_state;
+	uint8_t		pkt_state;
 
 	uint8_t		nak_transmit_count;	/* 8-bit for size constraints */
         uint8_t		ncf_retry_count;
@@ -69,6 +71,10 @@ struct pgm_rxw_state_t {
 
 /* only valid on tg_sqn::pkt_sqn = 0 */
 	unsigned	is_contiguous:1;	/* transmission group */
+	unsigned	is_reassembled:1;	/* fragment copied into APDU buffer */
+
+/* only valid on first sequence of a fragmented APDU */
+	struct pgm_sk_buff_t*	apdu;		/* contiguous reassembly buffer */
 };
 
 struct pgm_rxw_t {
@@ -85,6 +91,8 @@ struct pgm_rxw_t {
 	uint32_t		committed_count;	/* but still in window */
 
         uint16_t		max_tpdu;               /* maximum packet size */
+	pgm_arena_t*		arena;			/* skbuff storage, maybe NULL */
+	pgm_heap_t*		heap;			/* window storage, maybe NULL */
         uint32_t		lead, trail;
         uint32_t		rxw_trail, rxw_trail_init;
 	uint32_t		commit_lead;
@@ -92,9 +100,13 @@ struct pgm_rxw_t {
         unsigned		is_defined:1;
 	unsigned		has_event:1;		/* edge triggered */
 	unsigned		is_fec_available:1;
+	unsigned		is_reassembling:1;	/* deliver fragmented APDUs contiguous */
 	pgm_rs_t		rs;
 	uint32_t		tg_size;		/* transmission group size for parity recovery */
 	uint8_t			tg_sqn_shift;
+	uint8_t			tg_depth_shift;		/* log2 interleave depth */
+	pgm_fec_pool_t*		fec_pool;		/* off-load parity reconstruction */
+	void*			fec_user_data;		/* owning peer */
 
 	uint32_t		bitmap;			/* receive status of last 32 packets */
 	uint32_t		data_loss;		/* p */
@@ -106,17 +118,24 @@ struct pgm_rxw_t {
 	uint32_t		min_nak_transmit_count;
 	uint32_t		max_nak_transmit_count;
 	uint32_t		cumulative_losses;
+	uint32_t		cumulative_csum_errors;	/* deferred checksum failures */
 	uint32_t		bytes_delivered;
 	uint32_t		msgs_delivered;
 
+/* delivered buffers held by the application beyond the trail, atomic */
+	volatile uint32_t	detached_count;
+	volatile uint32_t	detached_size;		/* truesize in bytes */
+
 	size_t			size;			/* in bytes */
 	unsigned		alloc;			/* in pkts */
+	uint32_t		mask;			/* length of pdata[] - 1 */
+	pgm_rxw_state_t*	pstate;			/* parallel to pdata[] */
 /* C90 and older */
 	struct pgm_sk_buff_t*   pdata[1];
 };
 
 
-PGM_GNUC_INTERNAL pgm_rxw_t* pgm_rxw_create (const pgm_tsi_t*const, const uint16_t, const unsigned, const unsigned, const ssize_t, const uint32_t) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL pgm_rxw_t* pgm_rxw_create (const pgm_tsi_t*const, const uint16_t, const unsigned, const unsigned, const ssize_t, const uint32_t, pgm_arena_t*const, pgm_heap_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL void pgm_rxw_destroy (pgm_rxw_t*const);
 PGM_GNUC_INTERNAL int pgm_rxw_add (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict, const pgm_time_t, const pgm_time_t) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL void pgm_rxw_add_ack (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict, const pgm_time_t);
@@ -125,7 +144,9 @@ PGM_GNUC_INTERNAL void pgm_rxw_remove_commit (pgm_rxw_t*const);
 PGM_GNUC_INTERNAL ssize_t pgm_rxw_readv (pgm_rxw_t*const restrict, struct pgm_msgv_t** restrict, const unsigned) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL unsigned pgm_rxw_remove_trail (pgm_rxw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL unsigned pgm_rxw_update (pgm_rxw_t*const, const uint32_t, const uint32_t, const pgm_time_t, const pgm_time_t) PGM_GNUC_WARN_UNUSED_RESULT;
-PGM_GNUC_INTERNAL void pgm_rxw_update_fec (pgm_rxw_t*const, const uint8_t);
+PGM_GNUC_INTERNAL void pgm_rxw_update_fec (pgm_rxw_t*const, const uint8_t, const uint8_t);
+PGM_GNUC_INTERNAL void pgm_rxw_set_fec_pool (pgm_rxw_t*const restrict, pgm_fec_pool_t*const restrict, void*const restrict);
+PGM_GNUC_INTERNAL void pgm_rxw_reconstruct_commit (pgm_rxw_t*const restrict, pgm_fec_job_t*const restrict);
 PGM_GNUC_INTERNAL int pgm_rxw_confirm (pgm_rxw_t*const, const uint32_t, const pgm_time_t, const pgm_time_t, const pgm_time_t) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL void pgm_rxw_lost (pgm_rxw_t*const, const uint32_t);
 PGM_GNUC_INTERNAL void pgm_rxw_state (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict, const int);
@@ -142,6 +163,7 @@ static inline bool pgm_rxw_is_empty (const pgm_rxw_t*const) PGM_GNUC_WARN_UNUSED
 static inline bool pgm_rxw_is_full (const pgm_rxw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
 static inline uint32_t pgm_rxw_lead (const pgm_rxw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
 static inline uint32_t pgm_rxw_next_lead (const pgm_rxw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
+static inline pgm_rxw_state_t* pgm_rxw_peek_state (const pgm_rxw_t*const, const uint32_t) PGM_GNUC_WARN_UNUSED_RESULT;
 
 static inline
 unsigned
@@ -213,6 +235,20 @@ pgm_rxw_next_lead (
 	return (uint32_t)(pgm_rxw_lead (window) + 1);
 }
 
+/* recovery state of sequence, valid only inside the window.
+ */
+
+static inline
+pgm_rxw_state_t*
+pgm_rxw_peek_state (
+	const pgm_rxw_t* const	window,
+	const uint32_t		sequence
+	)
+{
+	pgm_assert (NULL != window);
+	return &window->pstate[ sequence & window->mask ];
+}
+
 PGM_END_DECLS
 
 #endif /* __PGM_IMPL_RXW_H__ */
@@ -0,0 +1,53 @@
+/* vim:ts=8:sts=4:sw=4:noai:noexpandtab
+ *
+ * Bounded multi-producer, single-consumer queue of original data skbuffs.
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if !defined (__PGM_IMPL_FRAMEWORK_H_INSIDE__) && !defined (PGM_COMPILATION)
+#	error "Only <framework.h> can be included directly."
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_SENDQ_H__
+#define __PGM_IMPL_SENDQ_H__
+
+typedef struct pgm_sendq_t pgm_sendq_t;
+
+#include <pgm/types.h>
+#include <pgm/skbuff.h>
+
+PGM_BEGIN_DECLS
+
+/* maximum queue length, rounded up to a power of two */
+#define PGM_SENDQ_MAX_LENGTH	65536
+
+PGM_GNUC_INTERNAL pgm_sendq_t* pgm_sendq_create (const unsigned) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_sendq_destroy (pgm_sendq_t*const);
+PGM_GNUC_INTERNAL bool pgm_sendq_push (pgm_sendq_t*const restrict, struct pgm_sk_buff_t*const restrict) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL struct pgm_sk_buff_t* pgm_sendq_pop (pgm_sendq_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL bool pgm_sendq_is_empty (const pgm_sendq_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL unsigned pgm_sendq_max_length (const pgm_sendq_t*const) PGM_GNUC_PURE;
+PGM_GNUC_INTERNAL bool pgm_sendq_try_acquire (pgm_sendq_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL bool pgm_sendq_release (pgm_sendq_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_SENDQ_H__ */
@@ -50,7 +50,6 @@ struct pgm_sock_t {
 	pgm_rwlock_t			lock;				/* running / destroyed */
 	pgm_mutex_t			receiver_mutex;			/* receiver API */
 	pgm_mutex_t			source_mutex;			/* source API */
-	pgm_spinlock_t			txw_spinlock;			/* transmit window */
 	pgm_mutex_t			send_mutex;			/* non-router alert socket */
 	pgm_mutex_t			timer_mutex;			/* next timer expiration */
 
@@ -65,6 +64,9 @@ struct pgm_sock_t {
 	bool				can_recv_data;			/* send-only */
 	bool				is_edge_triggered_recv;
 	bool				is_nonblocking;
+	bool				is_single_threaded;		/* no internal locking */
+	bool				use_deferred_csum;		/* verify DATA at delivery */
+	bool				use_udp_csum;			/* trust UDP checksum */
 
 	struct group_source_req		send_gsr;			/* multicast */
 	struct sockaddr_storage		send_addr;			/* unicast nla */
@@ -118,6 +120,7 @@ struct pgm_sock_t {
 	pgm_time_t			ack_bo_ivl;
 	struct sockaddr_storage		acker_nla;
 	uint64_t			acker_loss;
+	uint16_t			acker_loss_rate;	/* 1/65536ths */
 
 	pgm_notify_t			ack_notify;
 	pgm_notify_t			rdata_notify;
@@ -128,6 +131,7 @@ struct pgm_sock_t {
 	size_t				blocklen;		    /* length of buffer blocked */
 	bool				is_apdu_eagain;		    /* writer-lock on window_lock exists as send would block */
 	bool				is_spm_eagain;		    /* writer-lock in receiver */
+	bool				is_sendq_eagain;	    /* drain blocked on pkt_dontwait_state::skb */
 
 	struct {
 		size_t			    	data_pkt_offset;
@@ -147,6 +151,9 @@ struct pgm_sock_t {
 	unsigned* restrict		spm_heartbeat_interval;     /* zero terminated, zero lead-pad */
 	unsigned			spm_heartbeat_state;	    /* indexof spm_heartbeat_interval */
 	unsigned			spm_heartbeat_len;
+	volatile uint32_t		spm_heartbeat_data_tstamp;  /* low 32-bits of last ODATA time */
+	volatile uint32_t		spm_heartbeat_data_count;   /* ODATA since heartbeat armed */
+	pgm_time_t			spm_heartbeat_base;	    /* ODATA time of heartbeat sequence */
 	unsigned			peer_expiry;		    /* from absence of SPMs */
 	unsigned			spmr_expiry;		    /* waiting for peer SPMRs */
 
@@ -162,17 +169,67 @@ struct pgm_sock_t {
 	uint8_t				rs_k;
 	uint8_t				rs_proactive_h;		    /* 0 <= proactive-h <= ( n - k ) */
 	uint8_t				tg_sqn_shift;
+	uint8_t				tg_depth_shift;		    /* log2 interleave depth */
+	bool				use_adaptive_parity;
+	uint8_t				rs_proactive_h_min;
+	uint8_t				rs_proactive_h_max;
+	volatile uint32_t		parity_loss_count;	    /* NAK'd packets, atomic */
+	uint32_t			parity_loss_snap;
+	uint32_t			parity_loss_rate;	    /* smoothed, 1/65536ths */
+	volatile uint32_t		proactive_lead;		    /* end of blocks sent, atomic */
+	uint32_t			proactive_trail;	    /* end of blocks scheduled */
+	unsigned			fec_workers;		    /* parity decode threads */
+	pgm_fec_pool_t*			fec_pool;
+	unsigned			sendq_len;		    /* submission queue length */
+	pgm_sendq_t*			sendq;
+	bool				use_arena;		    /* huge page window storage */
+	bool				use_arena_mlock;
+	int				arena_numa_node;	    /* -1 for no placement */
+	pgm_arena_t*			tx_arena;
+	pgm_arena_t*			rx_arena;
+	pgm_allocator_t			allocator;		    /* NULL malloc for default */
+	bool				use_object_arena;
+	pgm_heap_t*			heap;			    /* peers, windows, hash nodes */
+	bool				use_reassembly;		    /* contiguous APDU delivery */
+	struct pgm_recv_callback_info_t	recv_callback;		    /* push delivery */
 	struct pgm_sk_buff_t* restrict	rx_buffer;
+	bool				use_compact_recv;	    /* copy out small data packets */
+	bool				is_filtering;		    /* any source list or program */
+	pgm_slist_t*			allow_sources;		    /* pgm_tsi_t, zero sport matches GSI */
+	pgm_slist_t*			deny_sources;
+	struct pgm_filter_insn_t*	filter;			    /* downstream BPF program */
+	unsigned			filter_len;
+	bool				is_filter_attached;	    /* pushed down to recv_sock */
+	uint32_t			filtered_packets;
+	bool				use_rxq_ovfl;		    /* SO_RXQ_OVFL enabled on recv_sock */
+	uint32_t			rxq_ovfl_counter;	    /* last kernel drop count */
+	uint32_t			rxq_overflow_drops;
+	bool				use_rcvbuf_autotune;
+	bool				is_rcvbuf_at_limit;	    /* kernel refused to grow further */
+	pgm_time_t			next_rcvbuf_resize;
+	uint32_t			rcvbuf_resizes;
 
 	pgm_rwlock_t			peers_lock;
 	pgm_hashtable_t* restrict	peers_hashtable;	    /* fast lookup */
 	pgm_list_t*      restrict	peers_list;		    /* easy iteration */
 	pgm_slist_t*     restrict	peers_pending;		    /* rxw: have or lost data */
+	pgm_slist_t*			peers_pending_tail;	    /* valid whilst list not empty */
+	uint32_t			delivery_quantum;	    /* bytes per peer per round, 0 drains */
+	unsigned			delivery_budget;	    /* APDUs per receive call, 0 unlimited */
+	unsigned			delivery_count;
+	pgm_slist_t*			peer_weights;		    /* struct pgm_peer_weight_t */
 	pgm_notify_t			pending_notify;		    /* timer to rx */
 	bool				is_pending_read;
 	pgm_time_t			next_poll;
+	bool				use_timer_sock;
+	SOCKET				timer_sock;		    /* timerfd armed at next_poll */
+	pgm_time_t			timer_sock_expiry;
+	bool				use_ready_sock;
+	SOCKET				ready_sock;		    /* epoll set of all readable fds */
+	unsigned			busy_poll_budget;	    /* μs */
+	struct pgm_busy_poll_stats_t	busy_poll_stats;
 
-	uint32_t			cumulative_stats[PGM_PC_SOURCE_MAX];
+	pgm_stats_t			stats;			    /* PGM_PC_SOURCE_* by role */
 	uint32_t			snap_stats[PGM_PC_SOURCE_MAX];
 	pgm_time_t			snap_time;
 };
@@ -184,6 +241,108 @@ extern pgm_slist_t* pgm_sock_list;
 
 size_t pgm_pkt_offset (bool, sa_family_t);
 
+/* socket locks on the send and receive paths are skipped when the application
+ * drives the socket from a single thread.
+ */
+
+static inline
+void
+pgm_sock_mutex_lock (
+	pgm_sock_t*  const sock,
+	pgm_mutex_t* const mutex
+	)
+{
+	if (!sock->is_single_threaded)
+		pgm_mutex_lock (mutex);
+}
+
+static inline
+void
+pgm_sock_mutex_unlock (
+	pgm_sock_t*  const sock,
+	pgm_mutex_t* const mutex
+	)
+{
+	if (!sock->is_single_threaded)
+		pgm_mutex_unlock (mutex);
+}
+
+static inline
+void
+pgm_sock_spinlock_lock (
+	pgm_sock_t*     const sock,
+	pgm_spinlock_t* const spinlock
+	)
+{
+	if (!sock->is_single_threaded)
+		pgm_spinlock_lock (spinlock);
+}
+
+static inline
+void
+pgm_sock_spinlock_unlock (
+	pgm_sock_t*     const sock,
+	pgm_spinlock_t* const spinlock
+	)
+{
+	if (!sock->is_single_threaded)
+		pgm_spinlock_unlock (spinlock);
+}
+
+static inline
+bool
+pgm_sock_reader_trylock (
+	pgm_sock_t*   const sock,
+	pgm_rwlock_t* const rwlock
+	)
+{
+	return sock->is_single_threaded || pgm_rwlock_reader_trylock (rwlock);
+}
+
+static inline
+void
+pgm_sock_reader_lock (
+	pgm_sock_t*   const sock,
+	pgm_rwlock_t* const rwlock
+	)
+{
+	if (!sock->is_single_threaded)
+		pgm_rwlock_reader_lock (rwlock);
+}
+
+static inline
+void
+pgm_sock_reader_unlock (
+	pgm_sock_t*   const sock,
+	pgm_rwlock_t* const rwlock
+	)
+{
+	if (!sock->is_single_threaded)
+		pgm_rwlock_reader_unlock (rwlock);
+}
+
+static inline
+void
+pgm_sock_writer_lock (
+	pgm_sock_t*   const sock,
+	pgm_rwlock_t* const rwlock
+	)
+{
+	if (!sock->is_single_threaded)
+		pgm_rwlock_writer_lock (rwlock);
+}
+
+static inline
+void
+pgm_sock_writer_unlock (
+	pgm_sock_t*   const sock,
+	pgm_rwlock_t* const rwlock
+	)
+{
+	if (!sock->is_single_threaded)
+		pgm_rwlock_writer_unlock (rwlock);
+}
+
 PGM_END_DECLS
 
 #endif /* __PGM_IMPL_SOCKET_H__ */
@@ -60,13 +60,18 @@ enum {
 	PGM_PC_SOURCE_PARITY_NNAKS_RECEIVED,
 	PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED,
 	PGM_PC_SOURCE_NNAK_ERRORS,
+	PGM_PC_SOURCE_PROACTIVE_PARITY_PACKETS,		/* current h */
+	PGM_PC_SOURCE_PROACTIVE_PARITY_CHANGES,
 
 /* marker */
 	PGM_PC_SOURCE_MAX
 };
 
+PGM_STATIC_ASSERT(PGM_PC_SOURCE_MAX <= PGM_STATS_MAX_COUNTERS);
+
 PGM_GNUC_INTERNAL bool pgm_send_spm (pgm_sock_t*const, const int) PGM_GNUC_WARN_UNUSED_RESULT;
-PGM_GNUC_INTERNAL bool pgm_on_deferred_nak (pgm_sock_t*const);
+PGM_GNUC_INTERNAL bool pgm_on_deferred_nak (pgm_sock_t*const, const pgm_time_t);
+PGM_GNUC_INTERNAL void pgm_on_proactive_nak (pgm_sock_t*const);
 PGM_GNUC_INTERNAL bool pgm_on_spmr (pgm_sock_t*const restrict, pgm_peer_t*const restrict, struct pgm_sk_buff_t*const restrict) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL bool pgm_on_nak (pgm_sock_t*const restrict, struct pgm_sk_buff_t*const restrict) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL bool pgm_on_nnak (pgm_sock_t*const restrict, struct pgm_sk_buff_t*const restrict) PGM_GNUC_WARN_UNUSED_RESULT;
@@ -0,0 +1,98 @@
+/* vim:ts=8:sts=4:sw=4:noai:noexpandtab
+ *
+ * Performance counters sharded by writer role.
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if !defined (__PGM_IMPL_FRAMEWORK_H_INSIDE__) && !defined (PGM_COMPILATION)
+#	error "Only <framework.h> can be included directly."
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_STATS_H__
+#define __PGM_IMPL_STATS_H__
+
+typedef struct pgm_stats_t pgm_stats_t;
+
+#include <pgm/types.h>
+
+PGM_BEGIN_DECLS
+
+/* writers, each role is serialised by its own lock so counters within a
+ * block are updated without atomics.
+ */
+enum {
+	PGM_STATS_ROLE_SOURCE = 0,	/* application send calls, source_mutex */
+	PGM_STATS_ROLE_RECEIVER,	/* packet receive and timers, receiver_mutex */
+	PGM_STATS_ROLE_REPAIR,		/* repair data transmission */
+
+/* marker */
+	PGM_STATS_ROLE_MAX
+};
+
+#define PGM_STATS_CACHELINE		64
+#define PGM_STATS_MAX_COUNTERS		32
+
+/* one block per role, padded so no two blocks share a cache line whatever
+ * the alignment of the socket allocation.
+ */
+struct pgm_stats_block_t {
+	uint32_t		counters[PGM_STATS_MAX_COUNTERS];
+	char			pad[PGM_STATS_CACHELINE];
+};
+
+struct pgm_stats_t {
+	char			pad[PGM_STATS_CACHELINE];	/* isolate from preceding members */
+	struct pgm_stats_block_t block[PGM_STATS_ROLE_MAX];
+};
+
+/* hot path update, the caller must hold the lock of role.
+ */
+
+static inline
+void
+pgm_stats_add (
+	pgm_stats_t*const	stats,
+	const unsigned		role,
+	const unsigned		counter,
+	const uint32_t		value
+	)
+{
+	stats->block[role].counters[counter] += value;
+}
+
+static inline
+void
+pgm_stats_inc (
+	pgm_stats_t*const	stats,
+	const unsigned		role,
+	const unsigned		counter
+	)
+{
+	stats->block[role].counters[counter]++;
+}
+
+PGM_GNUC_INTERNAL void pgm_stats_set (pgm_stats_t*const, const unsigned, const unsigned, const uint32_t);
+PGM_GNUC_INTERNAL uint32_t pgm_stats_read (const pgm_stats_t*const, const unsigned) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_stats_snapshot (const pgm_stats_t*const restrict, uint32_t*restrict, const unsigned);
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_STATS_H__ */
@@ -120,7 +120,7 @@ pgm_atomic_compare_and_exchange32 (
 	__asm__ volatile ("lock; cmpxchgl %2, %0\n\t"
 			  "setz %1\n\t"
 			: "+m" (*atomic), "=q" (result)
-			: "ir" (newval),  "a" (oldval)
+			: "r" (newval),  "a" (oldval)
 			: "memory", "cc"  );
 	return (bool)result;
 #elif defined( __SUNPRO_C ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
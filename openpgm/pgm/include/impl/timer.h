@@ -31,9 +31,15 @@
 PGM_BEGIN_DECLS
 
 PGM_GNUC_INTERNAL bool pgm_timer_prepare (pgm_sock_t*const);
-PGM_GNUC_INTERNAL bool pgm_timer_check (pgm_sock_t*const);
+PGM_GNUC_INTERNAL bool pgm_timer_check (pgm_sock_t*const, const pgm_time_t);
 PGM_GNUC_INTERNAL pgm_time_t pgm_timer_expiration (pgm_sock_t*const);
-PGM_GNUC_INTERNAL bool pgm_timer_dispatch (pgm_sock_t*const);
+PGM_GNUC_INTERNAL bool pgm_timer_dispatch (pgm_sock_t*const, const pgm_time_t);
+#ifdef HAVE_TIMERFD_CREATE
+PGM_GNUC_INTERNAL bool pgm_timer_sock_init (pgm_sock_t*const);
+PGM_GNUC_INTERNAL void pgm_timer_sock_arm (pgm_sock_t*const);
+PGM_GNUC_INTERNAL void pgm_timer_sock_disarm (pgm_sock_t*const);
+PGM_GNUC_INTERNAL void pgm_timer_sock_destroy (pgm_sock_t*const);
+#endif
 
 static inline
 void
@@ -41,7 +47,7 @@ pgm_timer_lock (
 	pgm_sock_t* const sock
 	)
 {
-	if (sock->can_send_data)
+	if (sock->can_send_data && !sock->is_single_threaded)
 		pgm_mutex_lock (&sock->timer_mutex);
 }
 
@@ -51,7 +57,7 @@ pgm_timer_unlock (
 	pgm_sock_t* const sock
 	)
 {
-	if (sock->can_send_data)
+	if (sock->can_send_data && !sock->is_single_threaded)
 		pgm_mutex_unlock (&sock->timer_mutex);
 }
 
@@ -46,15 +46,28 @@ struct pgm_txw_state_t {
 
 struct pgm_txw_t {
 	const pgm_tsi_t* restrict	tsi;
+	pgm_heap_t*			heap;			/* window storage, maybe NULL */
 
-/* option: lockless atomics */
+/* single producer: lead is published with release semantics after the
+ * skbuff is stored, the repair side reads without a lock.
+ */
         volatile uint32_t		lead;
         volatile uint32_t		trail;
 
-        pgm_queue_t			retransmit_queue;
+/* repair side pins the window whilst dereferencing skbuffs, evictions
+ * under a pin are deferred to the next eviction or shutdown.
+ */
+	volatile uint32_t		repair_pins;
+	struct pgm_sk_buff_t*		deferred;
+
+/* repair side private FIFO of sequence numbers, one more than alloc */
+	uint32_t*			retransmit_queue;
+	uint32_t			retransmit_head;
+	uint32_t			retransmit_tail;
 
 	pgm_rs_t			rs;
 	uint8_t				tg_sqn_shift;
+	uint8_t				tg_depth_shift;		/* log2 interleave depth */
 	struct pgm_sk_buff_t* restrict	parity_buffer;
 
 /* Advance with data */
@@ -67,12 +80,13 @@ struct pgm_txw_t {
 	unsigned			adv_mode:1;		/* 0 = advance by time, 1 = advance by data */
 
 	size_t				size;			/* window content size in bytes */
-	unsigned			alloc;			/* length of pdata[] */
+	unsigned			alloc;			/* in pkts */
+	uint32_t			mask;			/* length of pdata[] - 1 */
 /* C90 and older */
 	struct pgm_sk_buff_t*		pdata[1];
 };
 
-PGM_GNUC_INTERNAL pgm_txw_t* pgm_txw_create (const pgm_tsi_t*const, const uint16_t, const uint32_t, const unsigned, const ssize_t, const bool, const uint8_t, const uint8_t) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL pgm_txw_t* pgm_txw_create (const pgm_tsi_t*const, const uint16_t, const uint32_t, const unsigned, const ssize_t, const bool, const uint8_t, const uint8_t, const uint8_t, const pgm_arena_t*const, pgm_heap_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL void pgm_txw_shutdown (pgm_txw_t*const);
 PGM_GNUC_INTERNAL void pgm_txw_add (pgm_txw_t*const restrict, struct pgm_sk_buff_t*const restrict);
 PGM_GNUC_INTERNAL struct pgm_sk_buff_t* pgm_txw_peek (const pgm_txw_t*const, const uint32_t) PGM_GNUC_WARN_UNUSED_RESULT;
@@ -224,4 +224,71 @@ pgm_atomic_write32 (
 	*atomic = val;
 }
 
+/* 32-bit word load with acquire semantics, subsequent memory accesses
+ * cannot be reordered before the load.  Pairs with
+ * pgm_atomic_write32_release() for single producer publication.
+ */
+
+static inline
+uint32_t
+pgm_atomic_read32_acquire (
+	const volatile uint32_t* atomic
+	)
+{
+#if defined( __GNUC__ ) && ( __GNUC__ * 100 + __GNUC_MINOR__ >= 407 )
+	return __atomic_load_n (atomic, __ATOMIC_ACQUIRE);
+#else
+	const uint32_t val = *atomic;
+#	if defined( __GNUC__ ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+	__asm__ volatile ("" ::: "memory");
+#	elif (defined( __SUNPRO_C ) || defined( __SUNPRO_CC )) && (defined( __i386 ) || defined( __amd64 ))
+	__asm__ volatile ("" ::: "memory");
+#	elif defined( __sun ) || defined( __NetBSD__ )
+	membar_consumer ();
+#	elif defined( __APPLE__ )
+	OSMemoryBarrier ();
+#	elif defined( __GNUC__ ) && ( __GNUC__ * 100 + __GNUC_MINOR__ >= 401 )
+	__sync_synchronize ();
+#	elif defined( _AIX )
+	__lwsync ();
+#	elif defined( _WIN32 )
+	_ReadWriteBarrier ();
+#	endif
+	return val;
+#endif
+}
+
+/* 32-bit word store with release semantics, preceding memory accesses
+ * cannot be reordered after the store.
+ */
+
+static inline
+void
+pgm_atomic_write32_release (
+	volatile uint32_t*	atomic,
+	const uint32_t		val
+	)
+{
+#if defined( __GNUC__ ) && ( __GNUC__ * 100 + __GNUC_MINOR__ >= 407 )
+	__atomic_store_n (atomic, val, __ATOMIC_RELEASE);
+#else
+#	if defined( __GNUC__ ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+	__asm__ volatile ("" ::: "memory");
+#	elif (defined( __SUNPRO_C ) || defined( __SUNPRO_CC )) && (defined( __i386 ) || defined( __amd64 ))
+	__asm__ volatile ("" ::: "memory");
+#	elif defined( __sun ) || defined( __NetBSD__ )
+	membar_producer ();
+#	elif defined( __APPLE__ )
+	OSMemoryBarrier ();
+#	elif defined( __GNUC__ ) && ( __GNUC__ * 100 + __GNUC_MINOR__ >= 401 )
+	__sync_synchronize ();
+#	elif defined( _AIX )
+	__lwsync ();
+#	elif defined( _WIN32 )
+	_ReadWriteBarrier ();
+#	endif
+	*atomic = val;
+#endif
+}
+
 #endif /* __PGM_ATOMIC_H__ */
@@ -36,8 +36,28 @@
 
 PGM_BEGIN_DECLS
 
+/* allocator vtable, each entry receives user_data as the last parameter. */
+struct pgm_allocator_t {
+	void*	(*malloc)	(size_t, void*);
+	void*	(*realloc)	(void*, size_t, void*);
+	void	(*free)		(void*, void*);
+	void*	user_data;
+};
+
+typedef struct pgm_allocator_t pgm_allocator_t;
+
+struct pgm_mem_stats_t {
+	uint64_t				bytes_allocated;	/* live */
+	uint64_t				bytes_peak;
+	uint64_t				bytes_reserved;		/* arena chunks */
+	uint64_t				allocations;
+	uint64_t				frees;
+};
+
 extern bool pgm_mem_gc_friendly;
 
+bool pgm_mem_set_allocator (const pgm_allocator_t*);
+
 void* pgm_malloc (const size_t) PGM_GNUC_MALLOC PGM_GNUC_ALLOC_SIZE(1);
 void* pgm_malloc_n (const size_t, const size_t) PGM_GNUC_MALLOC PGM_GNUC_ALLOC_SIZE2(1, 2);
 void* pgm_malloc0 (const size_t) PGM_GNUC_MALLOC PGM_GNUC_ALLOC_SIZE(1);
@@ -45,6 +65,8 @@ void* pgm_malloc0_n (const size_t, const size_t) PGM_GNUC_MALLOC PGM_GNUC_ALLOC_
 void* pgm_memdup (const void*, const size_t) PGM_GNUC_MALLOC;
 void* pgm_realloc (void*, const size_t) PGM_GNUC_WARN_UNUSED_RESULT;
 void pgm_free (void*);
+void* pgm_malloc_aligned (const size_t, const size_t) PGM_GNUC_MALLOC PGM_GNUC_ALLOC_SIZE(2);
+void pgm_free_aligned (void*);
 
 /* Convenience memory allocators that wont work well above 32-bit sizes
  */
@@ -73,6 +73,11 @@ extern int pgm_ipproto_pgm;
 #	define PGM_MAX_FRAGMENTS		16
 #endif
 
+/* interleaved transmission groups, parity covers every depth'th sequence */
+#ifndef PGM_MAX_FEC_DEPTH
+#	define PGM_MAX_FEC_DEPTH		16
+#endif
+
 
 enum pgm_type_e {
 	PGM_SPM		= 0x00,	/* 8.1: source path message */
@@ -278,6 +283,8 @@ struct pgm_opt_parity_prm {
 #define PGM_PARITY_PRM_MASK 0x3
 #define PGM_PARITY_PRM_PRO  0x1		/* source provides pro-active parity packets */
 #define PGM_PARITY_PRM_OND  0x2		/*                 on-demand parity packets */
+#define PGM_PARITY_PRM_DEPTH_MASK  0x70	/* log2 interleave depth, non-RFC */
+#define PGM_PARITY_PRM_DEPTH_SHIFT 4
 	uint32_t	parity_prm_tgs;		/* transmission group size */
 };
 
@@ -28,6 +28,8 @@
 #include <string.h>
 
 struct pgm_sk_buff_t;
+struct pgm_arena_t;
+struct pgm_peer_t;
 
 #include <pgm/types.h>
 #include <pgm/atomic.h>
@@ -40,57 +42,78 @@ struct pgm_sk_buff_t;
 
 PGM_BEGIN_DECLS
 
+/* buffers are allocated on a cache line boundary with the payload following
+ * the header, as the header is a whole number of lines the payload is also
+ * line aligned for vector checksum and FEC kernels.
+ */
+#define PGM_SKB_CACHELINE		64
+
+/* receive payloads up to this size are copied into a right sized buffer so
+ * small message feeds do not pin a full TPDU per windowed packet.
+ */
+#define PGM_SKB_COMPACT_SIZE		256
+
 struct pgm_sk_buff_t {
+/* first line: window queues, parsing and delivery.  link_ must be first as
+ * skbuffs are cast to and from list links.
+ */
 	pgm_list_t			link_;
 
-	pgm_sock_t* restrict		sock;
-	pgm_time_t			tstamp;
-	pgm_tsi_t			tsi;
+	void			       *data,		/* all may-alias */
+				       *tail;
+	struct pgm_header*		pgm_header;
+	struct pgm_data*		pgm_data;
 
 	uint32_t			sequence;
-	uint32_t			__padding;	/* push alignment of pgm_sk_buff_t::cb to 8 bytes */
-
-	char				cb[48];		/* control buffer */
-
 	uint16_t			len;		/* actual data */
-	unsigned			zero_padded:1;
-	unsigned			__padding2:31;	/* fix bit field */
+	char				__padding[PGM_SKB_CACHELINE - (7 * sizeof(void*) + 6)];
 
-	struct pgm_header*		pgm_header;
+/* second and third lines: read mostly */
+	pgm_time_t			tstamp;
+	pgm_tsi_t			tsi;
+
+	pgm_sock_t* restrict		sock;
 	struct pgm_opt_fragment* 	pgm_opt_fragment;
 #define of_apdu_first_sqn		pgm_opt_fragment->opt_sqn
 #define of_frag_offset			pgm_opt_fragment->opt_frag_off
 #define of_apdu_len			pgm_opt_fragment->opt_frag_len
 	struct pgm_opt_pgmcc_data*	pgm_opt_pgmcc_data;
-	struct pgm_data*		pgm_data;
-
-	void			       *head,		/* all may-alias */
-				       *data,
-				       *tail,
+	void			       *head,
 				       *end;
 	uint32_t			truesize;
-	volatile uint32_t		users;		/* atomic */
+	unsigned			zero_padded:1;
+	unsigned			csum_pending:1;	/* PGM checksum deferred to delivery */
+	unsigned			single_threaded:1; /* users not atomic */
+	unsigned			__padding2:29;	/* fix bit field */
+
+	struct pgm_arena_t*		arena;		/* owning arena, NULL for heap */
+	struct pgm_peer_t*		peer;		/* delivering peer, referenced whilst detached */
+	char				cb[40];		/* control buffer */
+	char				__padding3[2 * PGM_SKB_CACHELINE - (7 * sizeof(void*) + 64)];
+
+/* fourth line: reference count alone as it is written by every thread that
+ * holds the buffer.
+ */
+	volatile uint32_t		users;		/* atomic unless single_threaded */
+	char				__padding4[PGM_SKB_CACHELINE - sizeof(uint32_t)];
 };
 
 void pgm_skb_over_panic (const struct pgm_sk_buff_t*const, const uint16_t) PGM_GNUC_NORETURN;
 void pgm_skb_under_panic (const struct pgm_sk_buff_t*const, const uint16_t) PGM_GNUC_NORETURN;
 bool pgm_skb_is_valid (const struct pgm_sk_buff_t*const) PGM_GNUC_PURE PGM_GNUC_WARN_UNUSED_RESULT;
+void pgm_arena_free_skb (struct pgm_sk_buff_t*const);
+struct pgm_sk_buff_t* pgm_skb_detach (struct pgm_sk_buff_t*const);
+void pgm_skb_release (struct pgm_sk_buff_t*const);
 
-/* attribute __pure__ only valid for platforms with atomic ops.
- * attribute __malloc__ not used as only part of the memory should be aliased.
- * attribute __alloc_size__ does not allow headroom.
+/* initialise header of a buffer with size bytes of payload capacity.
  */
-static inline struct pgm_sk_buff_t* pgm_alloc_skb (const uint16_t) PGM_GNUC_WARN_UNUSED_RESULT;
-
 static inline
-struct pgm_sk_buff_t*
-pgm_alloc_skb (
+void
+_pgm_skb_init (
+	struct pgm_sk_buff_t*const skb,
 	const uint16_t		size
 	)
 {
-	struct pgm_sk_buff_t* skb;
-
-	skb = (struct pgm_sk_buff_t*)pgm_malloc (size + sizeof(struct pgm_sk_buff_t));
 /* Requires fast FSB to test
 	pgm_prefetchw (skb);
  */
@@ -105,9 +128,39 @@ pgm_alloc_skb (
 	skb->head = skb + 1;
 	skb->data = skb->tail = skb->head;
 	skb->end  = (char*)skb->data + size;
+}
+
+/* attribute __pure__ only valid for platforms with atomic ops.
+ * attribute __malloc__ not used as only part of the memory should be aliased.
+ * attribute __alloc_size__ does not allow headroom.
+ */
+static inline struct pgm_sk_buff_t* pgm_alloc_skb (const uint16_t) PGM_GNUC_WARN_UNUSED_RESULT;
+
+static inline
+struct pgm_sk_buff_t*
+pgm_alloc_skb (
+	const uint16_t		size
+	)
+{
+	struct pgm_sk_buff_t* skb;
+
+	skb = (struct pgm_sk_buff_t*)pgm_malloc_aligned (PGM_SKB_CACHELINE, size + sizeof(struct pgm_sk_buff_t));
+	_pgm_skb_init (skb, size);
 	return skb;
 }
 
+static inline
+void
+_pgm_skb_release (
+	struct pgm_sk_buff_t*const skb
+	)
+{
+	if (skb->arena)
+		pgm_arena_free_skb (skb);
+	else
+		pgm_free_aligned (skb);
+}
+
 /* increase reference count */
 static inline
 struct pgm_sk_buff_t*
@@ -115,7 +168,10 @@ pgm_skb_get (
 	struct pgm_sk_buff_t*const skb
 	)
 {
-	pgm_atomic_inc32 (&skb->users);
+	if (skb->single_threaded)
+		skb->users++;
+	else
+		pgm_atomic_inc32 (&skb->users);
 	return skb;
 }
 
@@ -125,8 +181,11 @@ pgm_free_skb (
 	struct pgm_sk_buff_t*const skb
 	)
 {
-	if (pgm_atomic_exchange_and_add32 (&skb->users, (uint32_t)-1) == 1)
-		pgm_free (skb);
+	if (skb->single_threaded) {
+		if (0 == --skb->users)
+			_pgm_skb_release (skb);
+	} else if (pgm_atomic_exchange_and_add32 (&skb->users, (uint32_t)-1) == 1)
+		_pgm_skb_release (skb);
 }
 
 /* add data */
@@ -204,31 +263,65 @@ pgm_skb_reserve (
 		pgm_skb_under_panic (skb, len);
 }
 
+static inline struct pgm_sk_buff_t* _pgm_skb_copy (const struct pgm_sk_buff_t* const, const uint16_t) PGM_GNUC_WARN_UNUSED_RESULT;
 static inline struct pgm_sk_buff_t* pgm_skb_copy (const struct pgm_sk_buff_t* const) PGM_GNUC_WARN_UNUSED_RESULT;
+static inline struct pgm_sk_buff_t* pgm_skb_compact (const struct pgm_sk_buff_t* const) PGM_GNUC_WARN_UNUSED_RESULT;
+
+#define _pgm_skb_relocate(newskb, skb, p) \
+	((void*)((char*)(newskb)->head + ((const char*)(p) - (const char*)(skb)->head)))
+
+/* copy header and the first size bytes of buffer from head, size must cover tail.
+ */
 
 static inline
 struct pgm_sk_buff_t*
-pgm_skb_copy (
-	const struct pgm_sk_buff_t* const skb
+_pgm_skb_copy (
+	const struct pgm_sk_buff_t* const skb,
+	const uint16_t		size
 	)
 {
 	struct pgm_sk_buff_t* newskb;
-	newskb = (struct pgm_sk_buff_t*)pgm_malloc (skb->truesize);
-	memcpy (newskb, skb, PGM_OFFSETOF(struct pgm_sk_buff_t, pgm_header));
+	newskb = (struct pgm_sk_buff_t*)pgm_malloc_aligned (PGM_SKB_CACHELINE, size + sizeof(struct pgm_sk_buff_t));
+	memcpy (newskb, skb, PGM_OFFSETOF(struct pgm_sk_buff_t, users));
 	newskb->zero_padded = 0;
-	newskb->truesize = skb->truesize;
+	newskb->arena = NULL;
+	newskb->peer = NULL;
+	newskb->truesize = size + sizeof(struct pgm_sk_buff_t);
 	pgm_atomic_write32 (&newskb->users, 1);
 	newskb->head = newskb + 1;
-	newskb->end  = (char*)newskb->head + ((char*)skb->end  - (char*)skb->head);
-	newskb->data = (char*)newskb->head + ((char*)skb->data - (char*)skb->head);
-	newskb->tail = (char*)newskb->head + ((char*)skb->tail - (char*)skb->head);
-	newskb->pgm_header = skb->pgm_header ? (struct pgm_header*)((char*)newskb->head + ((char*)skb->pgm_header - (char*)skb->head)) : skb->pgm_header;
-	newskb->pgm_opt_fragment = skb->pgm_opt_fragment ? (struct pgm_opt_fragment*)((char*)newskb->head + ((char*)skb->pgm_opt_fragment - (char*)skb->head)) : skb->pgm_opt_fragment;
-	newskb->pgm_data = skb->pgm_data ? (struct pgm_data*)((char*)newskb->head + ((char*)skb->pgm_data - (char*)skb->head)) : skb->pgm_data;
-	memcpy (newskb->head, skb->head, (char*)skb->end - (char*)skb->head);
+	newskb->end  = (char*)newskb->head + size;
+	newskb->data = _pgm_skb_relocate (newskb, skb, skb->data);
+	newskb->tail = _pgm_skb_relocate (newskb, skb, skb->tail);
+	newskb->pgm_header = skb->pgm_header ? (struct pgm_header*)_pgm_skb_relocate (newskb, skb, skb->pgm_header) : skb->pgm_header;
+	newskb->pgm_opt_fragment = skb->pgm_opt_fragment ? (struct pgm_opt_fragment*)_pgm_skb_relocate (newskb, skb, skb->pgm_opt_fragment) : skb->pgm_opt_fragment;
+	newskb->pgm_opt_pgmcc_data = skb->pgm_opt_pgmcc_data ? (struct pgm_opt_pgmcc_data*)_pgm_skb_relocate (newskb, skb, skb->pgm_opt_pgmcc_data) : skb->pgm_opt_pgmcc_data;
+	newskb->pgm_data = skb->pgm_data ? (struct pgm_data*)_pgm_skb_relocate (newskb, skb, skb->pgm_data) : skb->pgm_data;
+	memcpy (newskb->head, skb->head, size);
 	return newskb;
 }
 
+static inline
+struct pgm_sk_buff_t*
+pgm_skb_copy (
+	const struct pgm_sk_buff_t* const skb
+	)
+{
+	return _pgm_skb_copy (skb, (uint16_t)((char*)skb->end - (char*)skb->head));
+}
+
+/* copy into a buffer ending at tail, releasing the unused tailroom of a receive
+ * sized buffer.  no tailroom remains for zero padding so not for FEC windows.
+ */
+
+static inline
+struct pgm_sk_buff_t*
+pgm_skb_compact (
+	const struct pgm_sk_buff_t* const skb
+	)
+{
+	return _pgm_skb_copy (skb, (uint16_t)((char*)skb->tail - (char*)skb->head));
+}
+
 static inline
 void
 pgm_skb_zero_pad (
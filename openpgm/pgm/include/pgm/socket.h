@@ -88,12 +88,82 @@ struct pgm_fecinfo_t {
 	bool					var_pktlen_enabled;
 };
 
+struct pgm_adaptive_fecinfo_t {
+	uint8_t					min_proactive_packets;
+	uint8_t					max_proactive_packets;
+};
+
+struct pgm_busy_poll_stats_t {
+	uint64_t				spins;		/* empty receives whilst spinning */
+	uint64_t				hits;		/* spins ending with data */
+	uint64_t				idles;		/* spins ending on budget */
+	uint32_t				kernel_busy_poll;	/* SO_BUSY_POLL applied, μs */
+	uint32_t				kernel_prefer_busy_poll;	/* SO_PREFER_BUSY_POLL applied */
+};
+
+struct pgm_source_stats_t {
+	uint32_t				data_bytes_sent;
+	uint32_t				data_msgs_sent;		/* packets not APDUs */
+	uint32_t				bytes_sent;
+	uint32_t				cksum_errors;
+	uint32_t				malformed_naks;
+	uint32_t				packets_discarded;
+	uint32_t				selective_bytes_retransmitted;
+	uint32_t				selective_msgs_retransmitted;
+	uint32_t				parity_naks_received;
+	uint32_t				selective_naks_received;
+	uint32_t				ack_packets_received;
+	uint32_t				ack_errors;
+	uint32_t				selective_nnak_packets_received;
+	uint32_t				selective_nnaks_received;
+	uint32_t				nnak_errors;
+	uint32_t				proactive_parity_packets;	/* current h */
+	uint32_t				proactive_parity_changes;
+};
+
+struct pgm_receiver_stats_t {
+	uint32_t				rxq_overflow_drops;	/* lost in the kernel, including socket filter */
+	uint32_t				filtered_packets;	/* dropped by the library source filter */
+	uint32_t				rcvbuf_resizes;		/* auto-tuned SO_RCVBUF increases */
+};
+
 struct pgm_pgmccinfo_t {
 	uint32_t				ack_bo_ivl;
 	uint32_t				ack_c;
 	uint32_t				ack_c_p;
 };
 
+/* push delivery, called once per APDU from inside the receive call.  return
+ * non-zero to stop delivery until the next receive call.
+ */
+typedef int (*pgm_recv_callback_t) (const pgm_tsi_t*, struct pgm_sk_buff_t**, const unsigned, const size_t, void*);
+
+struct pgm_peer_weight_t {
+	pgm_tsi_t				tsi;
+	uint32_t				weight;		/* delivery quantum multiplier, default 1 */
+};
+
+/* classic BPF instruction, binary compatible with Linux struct sock_filter */
+struct pgm_filter_insn_t {
+	uint16_t				code;
+	uint8_t					jt;
+	uint8_t					jf;
+	uint32_t				k;
+};
+
+/* program run over the PGM header and payload of downstream packets, a zero
+ * return drops the packet.
+ */
+struct pgm_filter_prog_t {
+	unsigned short				len;		/* instructions */
+	struct pgm_filter_insn_t*		filter;
+};
+
+struct pgm_recv_callback_info_t {
+	pgm_recv_callback_t			callback;	/* NULL to disable */
+	void*					user_data;
+};
+
 /* socket options */
 enum {
 	PGM_SEND_SOCK		= 0x2000,
@@ -149,7 +219,38 @@ enum {
 	PGM_UNCONTROLLED_ODATA,
 	PGM_UNCONTROLLED_RDATA,
 	PGM_ODATA_MAX_RTE,
-	PGM_RDATA_MAX_RTE
+	PGM_RDATA_MAX_RTE,
+	PGM_FEC_WORKERS,
+	PGM_ADAPTIVE_FEC,
+	PGM_FEC_INTERLEAVE,
+	PGM_DEFER_CHECKSUM,
+	PGM_UDP_CHECKSUM,
+	PGM_USE_TIMER_SOCK,
+	PGM_TIMER_SOCK,
+	PGM_USE_READY_SOCK,
+	PGM_READY_SOCK,
+	PGM_BUSY_POLL,
+	PGM_BUSY_POLL_STATS,
+	PGM_SINGLE_THREADED,
+	PGM_SEND_QUEUE,
+	PGM_SOURCE_STATS,
+	PGM_USE_ARENA,
+	PGM_ARENA_MLOCK,
+	PGM_ARENA_NUMA_NODE,
+	PGM_ALLOCATOR,
+	PGM_USE_OBJECT_ARENA,
+	PGM_MEM_STATS,
+	PGM_REASSEMBLE_APDU,
+	PGM_RECV_CALLBACK,
+	PGM_DELIVERY_QUANTUM,
+	PGM_DELIVERY_BUDGET,
+	PGM_PEER_WEIGHT,
+	PGM_ALLOW_SOURCE,
+	PGM_DENY_SOURCE,
+	PGM_ATTACH_FILTER,
+	PGM_RECEIVER_STATS,
+	PGM_RCVBUF_AUTOTUNE,
+	PGM_RECV_COMPACT
 };
 
 /* IO status */
@@ -185,10 +286,14 @@ void pgm_freeaddrinfo (struct pgm_addrinfo_t*);
 int pgm_send (pgm_sock_t*const restrict, const void*restrict, const size_t, size_t*restrict);
 int pgm_sendv (pgm_sock_t*const restrict, const struct pgm_iovec*const restrict, const unsigned, const bool, size_t*restrict);
 int pgm_send_skbv (pgm_sock_t*const restrict, struct pgm_sk_buff_t**const restrict, const unsigned, const bool, size_t*restrict);
+int pgm_send_enqueue (pgm_sock_t*const restrict, const void*restrict, const size_t, size_t*restrict);
+int pgm_send_skb_enqueue (pgm_sock_t*const restrict, struct pgm_sk_buff_t*const restrict, size_t*restrict);
+int pgm_send_flush (pgm_sock_t*const restrict, size_t*restrict);
 int pgm_recvmsg (pgm_sock_t*const restrict, struct pgm_msgv_t*const restrict, const int, size_t*restrict, pgm_error_t**restrict) PGM_GNUC_WARN_UNUSED_RESULT;
 int pgm_recvmsgv (pgm_sock_t*const restrict, struct pgm_msgv_t*const restrict, const size_t, const int, size_t*restrict, pgm_error_t**restrict) PGM_GNUC_WARN_UNUSED_RESULT;
 int pgm_recv (pgm_sock_t*const restrict, void*restrict, const size_t, const int, size_t*const restrict, pgm_error_t**restrict) PGM_GNUC_WARN_UNUSED_RESULT;
 int pgm_recvfrom (pgm_sock_t*const restrict, void*restrict, const size_t, const int, size_t*restrict, struct pgm_sockaddr_t*restrict, socklen_t*restrict, pgm_error_t**restrict) PGM_GNUC_WARN_UNUSED_RESULT;
+int pgm_recv_dispatch (pgm_sock_t*const restrict, const int, size_t*restrict, pgm_error_t**restrict) PGM_GNUC_WARN_UNUSED_RESULT;
 
 bool pgm_getsockname (pgm_sock_t*const restrict, struct pgm_sockaddr_t*restrict, socklen_t*restrict);
 int pgm_select_info (pgm_sock_t*const restrict, fd_set*const restrict, fd_set*const restrict, int*const restrict);
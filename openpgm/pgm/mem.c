@@ -41,6 +41,10 @@
 
 bool pgm_mem_gc_friendly PGM_GNUC_READ_MOSTLY = FALSE;
 
+/* application allocator, fixed whilst the library is initialised */
+static pgm_allocator_t mem_allocator PGM_GNUC_READ_MOSTLY;
+static bool mem_has_allocator PGM_GNUC_READ_MOSTLY = FALSE;
+
 
 /* locals */
 
@@ -149,6 +153,34 @@ pgm_mem_shutdown (void)
 	/* nop */
 }
 
+/* install an application allocator for all library memory, NULL restores the
+ * C heap.  must be called before pgm_init() and before any other call that
+ * allocates, as memory is returned to the allocator that provided it.
+ *
+ * returns TRUE on success, returns FALSE if the library is initialised or the
+ * vtable is incomplete.
+ */
+
+bool
+pgm_mem_set_allocator (
+	const pgm_allocator_t*	allocator
+	)
+{
+	if (PGM_UNLIKELY(pgm_atomic_read32 (&mem_ref_count) > 0))
+		return FALSE;
+	if (NULL == allocator) {
+		mem_has_allocator = FALSE;
+		return TRUE;
+	}
+	if (PGM_UNLIKELY(NULL == allocator->malloc ||
+			 NULL == allocator->realloc ||
+			 NULL == allocator->free))
+		return FALSE;
+	mem_allocator = *allocator;
+	mem_has_allocator = TRUE;
+	return TRUE;
+}
+
 /* malloc wrappers to hard fail */
 void*
 pgm_malloc (
@@ -157,7 +189,9 @@ pgm_malloc (
 {
 	if (PGM_LIKELY (n_bytes))
 	{
-		void* mem = malloc (n_bytes);
+		void* mem = PGM_UNLIKELY(mem_has_allocator) ?
+				mem_allocator.malloc (n_bytes, mem_allocator.user_data) :
+				malloc (n_bytes);
 		if (mem)
 			return mem;
 
@@ -204,7 +238,13 @@ pgm_malloc0 (
 {
 	if (PGM_LIKELY (n_bytes))
 	{
-		void* mem = calloc (1, n_bytes);
+		void* mem;
+		if (PGM_UNLIKELY(mem_has_allocator)) {
+			mem = mem_allocator.malloc (n_bytes, mem_allocator.user_data);
+			if (mem)
+				memset (mem, 0, n_bytes);
+		} else
+			mem = calloc (1, n_bytes);
 		if (mem)
 			return mem;
 
@@ -230,7 +270,14 @@ pgm_malloc0_n (
 {
 	if (PGM_LIKELY (n_blocks && block_bytes))
 	{
-		void* mem = calloc (n_blocks, block_bytes);
+		void* mem;
+		if (PGM_UNLIKELY(mem_has_allocator)) {
+			if (SIZE_OVERFLOWS (n_blocks, block_bytes))
+				mem = NULL;
+			else if (NULL != (mem = mem_allocator.malloc (n_blocks * block_bytes, mem_allocator.user_data)))
+				memset (mem, 0, n_blocks * block_bytes);
+		} else
+			mem = calloc (n_blocks, block_bytes);
 		if (mem)
 			return mem;
 
@@ -273,6 +320,8 @@ pgm_realloc (
 	const size_t	n_bytes
 	)
 {
+	if (PGM_UNLIKELY(mem_has_allocator))
+		return mem_allocator.realloc (mem, n_bytes, mem_allocator.user_data);
 	return realloc (mem, n_bytes);
 }
 
@@ -281,8 +330,77 @@ pgm_free (
 	void*		mem
 	)
 {
-	if (PGM_LIKELY (NULL != mem))
+	if (PGM_LIKELY (NULL != mem)) {
+		if (PGM_UNLIKELY(mem_has_allocator))
+			mem_allocator.free (mem, mem_allocator.user_data);
+		else
+			free (mem);
+	}
+}
+
+/* allocate n_bytes on an alignment boundary, alignment must be a power of two
+ * multiple of sizeof(void*).  memory must be released with pgm_free_aligned().
+ *
+ * an application allocator is over-allocated with the original pointer stored
+ * immediately before the aligned block.
+ */
+
+void*
+pgm_malloc_aligned (
+	const size_t	alignment,
+	const size_t	n_bytes
+	)
+{
+	if (PGM_LIKELY (n_bytes))
+	{
+		void* mem;
+		if (PGM_UNLIKELY(mem_has_allocator)) {
+			char* raw = mem_allocator.malloc (n_bytes + alignment - 1 + sizeof(void*), mem_allocator.user_data);
+			if (raw) {
+				mem = (void*)(((uintptr_t)raw + sizeof(void*) + alignment - 1) & ~((uintptr_t)alignment - 1));
+				((void**)mem)[-1] = raw;
+			} else
+				mem = NULL;
+		} else {
+#ifdef _WIN32
+			mem = _aligned_malloc (n_bytes, alignment);
+#else
+			if (0 != posix_memalign (&mem, alignment, n_bytes))
+				mem = NULL;
+#endif
+		}
+		if (mem)
+			return mem;
+
+#ifdef __GNUC__
+		pgm_fatal ("file %s: line %d (%s): failed to allocate %" PRIzu " bytes",
+			__FILE__, __LINE__, __PRETTY_FUNCTION__,
+			n_bytes);
+#else
+		pgm_fatal ("file %s: line %d: failed to allocate %" PRIzu " bytes",
+			__FILE__, __LINE__,
+			n_bytes);
+#endif
+		abort ();
+	}
+	return NULL;
+}
+
+void
+pgm_free_aligned (
+	void*		mem
+	)
+{
+	if (PGM_UNLIKELY(NULL == mem))
+		return;
+	if (PGM_UNLIKELY(mem_has_allocator))
+		mem_allocator.free (((void**)mem)[-1], mem_allocator.user_data);
+	else
+#ifdef _WIN32
+		_aligned_free (mem);
+#else
 		free (mem);
+#endif
 }
 
 /* eof */
@@ -40,7 +40,8 @@
 //#define NET_DEBUG
 
 
-/* locked and rate regulated sendto
+/* locked and rate regulated sendto, now is the caller's loop time and only
+ * read when rate limited.
  *
  * on success, returns number of bytes sent.  on error, -1 is returned, and
  * errno set appropriately.
@@ -57,7 +58,8 @@ pgm_sendto_hops (
 	const void*	       restrict	buf,
 	size_t				len,
 	const struct sockaddr* restrict	to,
-	socklen_t			tolen
+	socklen_t			tolen,
+	pgm_time_t			now
 	)
 {
 	pgm_assert( NULL != sock );
@@ -87,7 +89,7 @@ pgm_sendto_hops (
 	{
 		if (NULL == minor_rate_control)
 		{
-			if (!pgm_rate_check (&sock->rate_control, len, sock->is_nonblocking))
+			if (!pgm_rate_check (&sock->rate_control, len, sock->is_nonblocking, now))
 			{
 				pgm_set_last_sock_error (PGM_SOCK_ENOBUFS);
 				return (const ssize_t)-1;
@@ -95,7 +97,7 @@ pgm_sendto_hops (
 		}
 		else
 		{
-			if (!pgm_rate_check2 (&sock->rate_control, minor_rate_control, len, sock->is_nonblocking))
+			if (!pgm_rate_check2 (&sock->rate_control, minor_rate_control, len, sock->is_nonblocking, now))
 			{
 				pgm_set_last_sock_error (PGM_SOCK_ENOBUFS);
 				return (const ssize_t)-1;
@@ -104,7 +106,7 @@ pgm_sendto_hops (
 	}
 
 	if (!use_router_alert && sock->can_send_data)
-		pgm_mutex_lock (&sock->send_mutex);
+		pgm_sock_mutex_lock (sock, &sock->send_mutex);
 	if (-1 != hops)
 		pgm_sockaddr_multicast_hops (send_sock, sock->send_gsr.gsr_group.ss_family, hops);
 
@@ -173,7 +175,7 @@ pgm_sendto_hops (
 	if (-1 != hops)
 		pgm_sockaddr_multicast_hops (send_sock, sock->send_gsr.gsr_group.ss_family, sock->hops);
 	if (!use_router_alert && sock->can_send_data)
-		pgm_mutex_unlock (&sock->send_mutex);
+		pgm_sock_mutex_unlock (sock, &sock->send_mutex);
 	return sent;
 }
 
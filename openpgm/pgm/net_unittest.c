@@ -165,7 +165,8 @@ bool
 mock_pgm_rate_check (
 	pgm_rate_t*		bucket,
 	const size_t		data_size,
-	const bool		is_nonblocking
+	const bool		is_nonblocking,
+	pgm_time_t		now
 	)
 {
 	g_debug ("mock_pgm_rate_check (bucket:%p data-size:%" PRIzu " is-nonblocking:%s)",
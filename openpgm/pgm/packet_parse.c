@@ -36,7 +36,7 @@
 
 /* locals */
 
-static bool pgm_parse (struct pgm_sk_buff_t*const restrict, pgm_error_t**restrict);
+static bool pgm_parse (struct pgm_sk_buff_t*const restrict, const unsigned, pgm_error_t**restrict);
 
 
 /* Parse a raw-IP packet for IP and PGM header and any payload.
@@ -52,6 +52,7 @@ bool
 pgm_parse_raw (
 	struct pgm_sk_buff_t* const restrict skb,	/* data will be modified */
 	struct sockaddr*      const restrict dst,
+	const unsigned			     flags,	/* PGM_PARSE_DEFER_CSUM */
 	pgm_error_t**		    restrict error
 	)
 {
@@ -59,8 +60,8 @@ pgm_parse_raw (
 	pgm_assert (NULL != skb);
 	pgm_assert (NULL != dst);
 
-	pgm_debug ("pgm_parse_raw (skb:%p dst:%p error:%p)",
-		(const void*)skb, (const void*)dst, (const void*)error);
+	pgm_debug ("pgm_parse_raw (skb:%p dst:%p flags:%u error:%p)",
+		(const void*)skb, (const void*)dst, flags, (const void*)error);
 
 /* minimum size should be IPv4 header plus PGM header, check IP version later */
 	if (PGM_UNLIKELY(skb->len < PGM_MIN_SIZE))
@@ -232,13 +233,14 @@ pgm_parse_raw (
 /* advance DATA pointer to PGM packet */
 	skb->data	= skb->pgm_header;
 	skb->len       -= ip_header_length;
-	return pgm_parse (skb, error);
+	return pgm_parse (skb, flags & ~PGM_PARSE_NO_CSUM, error);
 }
 
 PGM_GNUC_INTERNAL
 bool
 pgm_parse_udp_encap (
 	struct pgm_sk_buff_t*const restrict skb,		/* will be modified */
+	const unsigned			    flags,		/* PGM_PARSE_DEFER_CSUM or PGM_PARSE_NO_CSUM */
 	pgm_error_t**	      restrict error
 	)
 {
@@ -255,24 +257,43 @@ pgm_parse_udp_encap (
 
 /* DATA payload is PGM packet, no headers */
 	skb->pgm_header = skb->data;
-	return pgm_parse (skb, error);
+	return pgm_parse (skb, flags, error);
 }
 
-/* will modify packet contents to calculate and check PGM checksum
+/* will modify packet contents to calculate and check PGM checksum.
+ *
+ * with PGM_PARSE_DEFER_CSUM original data packets are only tagged, the
+ * checksum is verified by the receive window immediately before delivery
+ * such that duplicates and unread data are never summed.  parity packets
+ * feed reconstruction of other sequences and are always verified here.
+ *
+ * with PGM_PARSE_NO_CSUM the UDP checksum verified by the kernel is trusted.
  */
 static
 bool
 pgm_parse (
 	struct pgm_sk_buff_t*const restrict skb,		/* will be modified to calculate checksum */
+	const unsigned			    flags,
 	pgm_error_t**		    restrict error
 	)
 {
 /* pre-conditions */
 	pgm_assert (NULL != skb);
 
+	skb->csum_pending = 0;
+
 /* pgm_checksum == 0 means no transmitted checksum */
 	if (skb->pgm_header->pgm_checksum)
 	{
+		if (flags & PGM_PARSE_NO_CSUM)
+			goto parse_tsi;
+		if ((flags & PGM_PARSE_DEFER_CSUM) &&
+		    (PGM_ODATA == skb->pgm_header->pgm_type || PGM_RDATA == skb->pgm_header->pgm_type) &&
+		    !(skb->pgm_header->pgm_options & PGM_OPT_PARITY))
+		{
+			skb->csum_pending = 1;
+			goto parse_tsi;
+		}
 		const uint16_t sum = skb->pgm_header->pgm_checksum;
 		skb->pgm_header->pgm_checksum = 0;
 		const uint16_t pgm_sum = pgm_csum_fold (pgm_csum_partial ((const char*)skb->pgm_header, skb->len, 0));
@@ -299,6 +320,7 @@ pgm_parse (
 		pgm_debug ("No PGM checksum :O");
 	}
 
+parse_tsi:
 /* copy packets source transport identifier */
 	memcpy (&skb->tsi.gsi, skb->pgm_header->pgm_gsi, sizeof(pgm_gsi_t));
 	skb->tsi.sport = skb->pgm_header->pgm_sport;
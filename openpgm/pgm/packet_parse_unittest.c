@@ -182,6 +182,7 @@ pgm_get_nprocs (void)
  *	pgm_parse_raw (
  *		struct pgm_sk_buff_t* const	skb,
  *		struct sockaddr* const		addr,
+ *		const unsigned			flags,
  *		pgm_error_t**			error
  *	)
  */
@@ -191,7 +192,7 @@ START_TEST (test_parse_raw_pass_001)
 	struct sockaddr_storage addr;
 	pgm_error_t* err = NULL;
 	struct pgm_sk_buff_t* skb = generate_raw_pgm ();
-	gboolean success = pgm_parse_raw (skb, (struct sockaddr*)&addr, &err);
+	gboolean success = pgm_parse_raw (skb, (struct sockaddr*)&addr, 0, &err);
 	if (!success && err) {
 		g_error ("Parsing raw packet: %s", err->message);
 	}
@@ -206,7 +207,7 @@ START_TEST (test_parse_raw_fail_001)
 {
 	struct sockaddr_storage addr;
 	pgm_error_t* err = NULL;
-	pgm_parse_raw (NULL, (struct sockaddr*)&addr, &err);
+	pgm_parse_raw (NULL, (struct sockaddr*)&addr, 0, &err);
 	fail ("reached");
 }
 END_TEST
@@ -215,6 +216,7 @@ END_TEST
  *	bool
  *	pgm_parse_udp_encap (
  *		struct pgm_sk_buff_t* const	skb,
+ *		const unsigned			flags,
  *		pgm_error_t**			error
  *	)
  */
@@ -223,7 +225,7 @@ START_TEST (test_parse_udp_encap_pass_001)
 {
 	pgm_error_t* err = NULL;
 	struct pgm_sk_buff_t* skb = generate_udp_encap_pgm ();
-	gboolean success = pgm_parse_udp_encap (skb, &err);
+	gboolean success = pgm_parse_udp_encap (skb, 0, &err);
 	if (!success && err) {
 		g_error ("Parsing UDP encapsulated packet: %s", err->message);
 	}
@@ -231,10 +233,32 @@ START_TEST (test_parse_udp_encap_pass_001)
 }
 END_TEST
 
+/* corrupt payload passes when verification is deferred to the receive window */
+START_TEST (test_parse_udp_encap_pass_002)
+{
+	pgm_error_t* err = NULL;
+	struct pgm_sk_buff_t* skb = generate_udp_encap_pgm ();
+	((guint8*)skb->tail)[-1] ^= 0xff;
+	gboolean success = pgm_parse_udp_encap (skb, PGM_PARSE_DEFER_CSUM, &err);
+	fail_unless (TRUE == success, "parse_udp_encap failed");
+	fail_unless (1 == skb->csum_pending, "checksum not pending");
+}
+END_TEST
+
+START_TEST (test_parse_udp_encap_fail_002)
+{
+	pgm_error_t* err = NULL;
+	struct pgm_sk_buff_t* skb = generate_udp_encap_pgm ();
+	((guint8*)skb->tail)[-1] ^= 0xff;
+	gboolean success = pgm_parse_udp_encap (skb, 0, &err);
+	fail_unless (FALSE == success, "parse_udp_encap succeeded");
+}
+END_TEST
+
 START_TEST (test_parse_udp_encap_fail_001)
 {
 	pgm_error_t* err = NULL;
-	pgm_parse_udp_encap (NULL, &err);
+	pgm_parse_udp_encap (NULL, 0, &err);
 	fail ("reached");
 }
 END_TEST
@@ -353,6 +377,8 @@ make_test_suite (void)
 	TCase* tc_parse_udp_encap = tcase_create ("parse-udp-encap");
 	suite_add_tcase (s, tc_parse_udp_encap);
 	tcase_add_test (tc_parse_udp_encap, test_parse_udp_encap_pass_001);
+	tcase_add_test (tc_parse_udp_encap, test_parse_udp_encap_pass_002);
+	tcase_add_test (tc_parse_udp_encap, test_parse_udp_encap_fail_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_parse_udp_encap, test_parse_udp_encap_fail_001, SIGABRT);
 #endif
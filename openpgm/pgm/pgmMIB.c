@@ -998,7 +998,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCEDATABYTESSENT:
 				{
-					const unsigned data_bytes = sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT];
+					const unsigned data_bytes = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_DATA_BYTES_SENT);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&data_bytes, sizeof(data_bytes) );
 				}
@@ -1006,7 +1006,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCEDATAMSGSSENT:
 				{
-					const unsigned data_msgs = sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT];
+					const unsigned data_msgs = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_DATA_MSGS_SENT);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&data_msgs, sizeof(data_msgs) );
 				}
@@ -1031,7 +1031,7 @@ pgmSourcePerformanceTable_handler (
 /* PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED + COLUMN_PGMSOURCEPARITYBYTESRETRANSMITTED */
 			case COLUMN_PGMSOURCEBYTESRETRANSMITTED:
 				{
-					const unsigned bytes_resent = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED];
+					const unsigned bytes_resent = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&bytes_resent, sizeof(bytes_resent) );
 				}
@@ -1040,7 +1040,7 @@ pgmSourcePerformanceTable_handler (
 /* PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED + COLUMN_PGMSOURCEPARITYMSGSRETRANSMITTED */
 			case COLUMN_PGMSOURCEMSGSRETRANSMITTED:
 				{
-					const unsigned msgs_resent = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED];
+					const unsigned msgs_resent = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&msgs_resent, sizeof(msgs_resent) );
 				}
@@ -1048,7 +1048,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCEBYTESSENT:
 				{
-					const unsigned bytes_sent = sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT];
+					const unsigned bytes_sent = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_BYTES_SENT);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&bytes_sent, sizeof(bytes_sent) );
 				}
@@ -1057,7 +1057,7 @@ pgmSourcePerformanceTable_handler (
 /* COLUMN_PGMSOURCEPARITYNAKPACKETSRECEIVED + COLUMN_PGMSOURCESELECTIVENAKPACKETSRECEIVED */
 			case COLUMN_PGMSOURCERAWNAKSRECEIVED:
 				{
-					const unsigned nak_packets = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED];
+					const unsigned nak_packets = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&nak_packets, sizeof(nak_packets) );
 				}
@@ -1066,7 +1066,7 @@ pgmSourcePerformanceTable_handler (
 /* PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED + COLUMN_PGMSOURCEPARITYNAKSIGNORED */
 			case COLUMN_PGMSOURCENAKSIGNORED:
 				{
-					const unsigned naks_ignored = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED];
+					const unsigned naks_ignored = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&naks_ignored, sizeof(naks_ignored) );
 				}
@@ -1074,7 +1074,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCECKSUMERRORS:
 				{
-					const unsigned cksum_errors = sock->cumulative_stats[PGM_PC_SOURCE_CKSUM_ERRORS];
+					const unsigned cksum_errors = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_CKSUM_ERRORS);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&cksum_errors, sizeof(cksum_errors) );
 				}
@@ -1082,7 +1082,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCEMALFORMEDNAKS:
 				{
-					const unsigned malformed_naks = sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS];
+					const unsigned malformed_naks = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_MALFORMED_NAKS);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&malformed_naks, sizeof(malformed_naks) );
 				}
@@ -1090,7 +1090,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCEPACKETSDISCARDED:
 				{
-					const unsigned packets_discarded = sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED];
+					const unsigned packets_discarded = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_PACKETS_DISCARDED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&packets_discarded, sizeof(packets_discarded) );
 				}
@@ -1099,7 +1099,7 @@ pgmSourcePerformanceTable_handler (
 /* PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED + COLUMN_PGMSOURCEPARITYNAKSRECEIVED */
 			case COLUMN_PGMSOURCENAKSRCVD:
 				{
-					const unsigned naks_received = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED];
+					const unsigned naks_received = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&naks_received, sizeof(naks_received) );
 				}
@@ -1116,7 +1116,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCESELECTIVEBYTESRETRANSMITED:
 				{
-					const unsigned selective_bytes_resent = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED];
+					const unsigned selective_bytes_resent = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&selective_bytes_resent, sizeof(selective_bytes_resent) );
 				}
@@ -1133,7 +1133,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCESELECTIVEMSGSRETRANSMITTED:
 				{
-					const unsigned selective_msgs_resent = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED];
+					const unsigned selective_msgs_resent = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&selective_msgs_resent, sizeof(selective_msgs_resent) );
 				}
@@ -1168,7 +1168,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCESELECTIVENAKPACKETSRECEIVED:
 				{
-					const unsigned selective_nak_packets = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED];
+					const unsigned selective_nak_packets = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&selective_nak_packets, sizeof(selective_nak_packets) );
 				}
@@ -1185,7 +1185,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCESELECTIVENAKSRECEIVED:
 				{
-					const unsigned selective_naks = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED];
+					const unsigned selective_naks = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&selective_naks, sizeof(selective_naks) );
 				}
@@ -1202,7 +1202,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCESELECTIVENAKSIGNORED:
 				{
-					const unsigned selective_naks_ignored = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED];
+					const unsigned selective_naks_ignored = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&selective_naks_ignored, sizeof(selective_naks_ignored) );
 				}
@@ -1210,7 +1210,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCEACKERRORS:
 				{
-					const unsigned ack_errors = sock->cumulative_stats[PGM_PC_SOURCE_ACK_ERRORS];;
+					const unsigned ack_errors = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_ACK_ERRORS);;
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&ack_errors, sizeof(ack_errors) );
 				}
@@ -1231,7 +1231,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCETRANSMISSIONCURRENTRATE:
 				{
-					const unsigned tx_current_rate = sock->cumulative_stats[PGM_PC_SOURCE_TRANSMISSION_CURRENT_RATE];
+					const unsigned tx_current_rate = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_TRANSMISSION_CURRENT_RATE);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&tx_current_rate, sizeof(tx_current_rate) );
 				}
@@ -1239,7 +1239,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCEACKPACKETSRECEIVED:
 				{
-					const unsigned ack_packets = sock->cumulative_stats[PGM_PC_SOURCE_ACK_PACKETS_RECEIVED];
+					const unsigned ack_packets = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_ACK_PACKETS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&ack_packets, sizeof(ack_packets) );
 				}
@@ -1248,7 +1248,7 @@ pgmSourcePerformanceTable_handler (
 /* COLUMN_PGMSOURCEPARITYNNAKPACKETSRECEIVED + COLUMN_PGMSOURCESELECTIVENNAKPACKETSRECEIVED */
 			case COLUMN_PGMSOURCENNAKPACKETSRECEIVED:
 				{
-					const unsigned nnak_packets = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED];
+					const unsigned nnak_packets = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&nnak_packets, sizeof(nnak_packets) );
 				}
@@ -1265,7 +1265,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCESELECTIVENNAKPACKETSRECEIVED:
 				{
-					const unsigned selective_nnak_packets = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED];
+					const unsigned selective_nnak_packets = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&selective_nnak_packets, sizeof(selective_nnak_packets) );
 				}
@@ -1274,7 +1274,7 @@ pgmSourcePerformanceTable_handler (
 /* COLUMN_PGMSOURCEPARITYNNAKSRECEIVED + COLUMN_PGMSOURCESELECTIVENNAKSRECEIVED */
 			case COLUMN_PGMSOURCENNAKSRECEIVED:
 				{
-					const unsigned nnaks_received = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED];
+					const unsigned nnaks_received = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&nnaks_received, sizeof(nnaks_received) );
 				}
@@ -1291,7 +1291,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCESELECTIVENNAKSRECEIVED:
 				{
-					const unsigned selective_nnaks = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED];
+					const unsigned selective_nnaks = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&selective_nnaks, sizeof(selective_nnaks) );
 				}
@@ -1299,7 +1299,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCENNAKERRORS:
 				{
-					const unsigned malformed_nnaks = sock->cumulative_stats[PGM_PC_SOURCE_NNAK_ERRORS];
+					const unsigned malformed_nnaks = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_NNAK_ERRORS);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&malformed_nnaks, sizeof(malformed_nnaks) );
 				}
@@ -2101,7 +2101,7 @@ initialize_table_pgmReceiverPerformanceTable (void)
 		goto error;
 
 	table_info->min_column = COLUMN_PGMRECEIVERDATABYTESRECEIVED;
-	table_info->max_column = COLUMN_PGMRECEIVERLASTINTERVALNAKFAILURES;
+	table_info->max_column = COLUMN_PGMRECEIVERSOCKETOVERFLOWDROPS;
 
 	netsnmp_table_helper_add_indexes (table_info,
 					  ASN_OCTET_STR,  /* index: pgmReceiverGlobalId */
@@ -2411,10 +2411,10 @@ pgmReceiverPerformanceTable_handler (
 				}
 				break;
 	
-/* bogus: same as source checksum errors */	
+/* bogus: same as source checksum errors plus this peer's deferred failures */	
 			case COLUMN_PGMRECEIVERCKSUMERRORS:
 				{
-					const unsigned cksum_errors = sock->cumulative_stats[PGM_PC_SOURCE_CKSUM_ERRORS];
+					const unsigned cksum_errors = pgm_stats_read (&sock->stats, PGM_PC_SOURCE_CKSUM_ERRORS) + ((const pgm_rxw_t*)peer->window)->cumulative_csum_errors;
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&cksum_errors, sizeof(cksum_errors) );
 				}
@@ -2798,6 +2798,15 @@ pgmReceiverPerformanceTable_handler (
 				}
 				break;
 
+/* shared by all peers of the socket */
+			case COLUMN_PGMRECEIVERSOCKETOVERFLOWDROPS:
+				{
+					const unsigned overflow_drops = sock->rxq_overflow_drops;
+					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
+								  (const u_char*)&overflow_drops, sizeof(overflow_drops) );
+				}
+				break;
+
 			default:
 				snmp_log (LOG_ERR, "pgmReceiverTable_handler: unknown column.\n");
 				break;
@@ -59,6 +59,27 @@ pgm_queue_push_head_link (
 	queue->length++;
 }
 
+PGM_GNUC_INTERNAL
+void
+pgm_queue_push_tail_link (
+	pgm_queue_t* restrict queue,
+	pgm_list_t*  restrict tail_link
+	)
+{
+	pgm_return_if_fail (queue != NULL);
+	pgm_return_if_fail (tail_link != NULL);
+	pgm_return_if_fail (tail_link->prev == NULL);
+	pgm_return_if_fail (tail_link->next == NULL);
+
+	tail_link->prev = queue->tail;
+	if (queue->tail)
+		queue->tail->next = tail_link;
+	else
+		queue->head = tail_link;
+	queue->tail = tail_link;
+	queue->length++;
+}
+
 PGM_GNUC_INTERNAL
 pgm_list_t*
 pgm_queue_pop_tail_link (
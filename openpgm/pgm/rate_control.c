@@ -25,6 +25,29 @@
 #include <impl/framework.h>
 
 
+/* bucket owned by a single-threaded socket needs no lock.
+ */
+
+static inline
+void
+rate_lock (
+	pgm_rate_t*		bucket
+	)
+{
+	if (!bucket->is_single_threaded)
+		pgm_spinlock_lock (&bucket->spinlock);
+}
+
+static inline
+void
+rate_unlock (
+	pgm_rate_t*		bucket
+	)
+{
+	if (!bucket->is_single_threaded)
+		pgm_spinlock_unlock (&bucket->spinlock);
+}
+
 /* create machinery for rate regulation.
  * the rate_per_sec is ammortized over millisecond time periods.
  *
@@ -70,6 +93,8 @@ pgm_rate_destroy (
 }
 
 /* check bit bucket whether an operation can proceed or should wait.
+ *
+ * now is the caller's loop time, only a blocking wait reads the clock.
  *
  * returns TRUE when leaky bucket permits unless non-blocking flag is set.
  * returns FALSE if operation should block and non-blocking flag is set.
@@ -81,11 +106,11 @@ pgm_rate_check2 (
 	pgm_rate_t*		major_bucket,
 	pgm_rate_t*		minor_bucket,
 	const size_t		data_size,
-	const bool		is_nonblocking
+	const bool		is_nonblocking,
+	pgm_time_t		now
 	)
 {
 	int64_t new_major_limit, new_minor_limit;
-	pgm_time_t now;
 
 /* pre-conditions */
 	pgm_assert (NULL != major_bucket);
@@ -97,8 +122,10 @@ pgm_rate_check2 (
 
 	if (0 != major_bucket->rate_per_sec)
 	{
-		pgm_spinlock_lock (&major_bucket->spinlock);
-		now = pgm_time_update_now();
+		rate_lock (major_bucket);
+/* loop time may predate a check from another thread */
+		if (pgm_time_before (now, major_bucket->last_rate_check))
+			now = major_bucket->last_rate_check;
 
 		if (major_bucket->rate_per_msec)
 		{
@@ -125,7 +152,7 @@ pgm_rate_check2 (
 
 		new_major_limit -= ( major_bucket->iphdr_len + data_size );
 		if (is_nonblocking && new_major_limit < 0) {
-			pgm_spinlock_unlock (&major_bucket->spinlock);
+			rate_unlock (major_bucket);
 			return FALSE;
 		}
 
@@ -140,14 +167,12 @@ pgm_rate_check2 (
 			new_major_limit += sleep_amount;
 		} 
 	}
-	else
-	{
-/* ensure we have a timestamp */
-		now = pgm_time_update_now();
-	}
 
 	if (0 != minor_bucket->rate_per_sec)
 	{
+		if (pgm_time_before (now, minor_bucket->last_rate_check))
+			now = minor_bucket->last_rate_check;
+
 		if (minor_bucket->rate_per_msec)
 		{
 			const pgm_time_t time_since_last_rate_check = now - minor_bucket->last_rate_check;
@@ -174,7 +199,7 @@ pgm_rate_check2 (
 		new_minor_limit -= ( minor_bucket->iphdr_len + data_size );
 		if (is_nonblocking && new_minor_limit < 0) {
 			if (0 != major_bucket->rate_per_sec)
-				pgm_spinlock_unlock (&major_bucket->spinlock);
+				rate_unlock (major_bucket);
 			return FALSE;
 		}
 
@@ -186,7 +211,7 @@ pgm_rate_check2 (
 	if (0 != major_bucket->rate_per_sec) {
 		major_bucket->rate_limit = new_major_limit;
 		major_bucket->last_rate_check = now;
-		pgm_spinlock_unlock (&major_bucket->spinlock);
+		rate_unlock (major_bucket);
 	}
 
 /* sleep on minor bucket outside of lock */
@@ -209,7 +234,8 @@ bool
 pgm_rate_check (
 	pgm_rate_t*		bucket,
 	const size_t		data_size,
-	const bool		is_nonblocking
+	const bool		is_nonblocking,
+	pgm_time_t		now
 	)
 {
 	int64_t new_rate_limit;
@@ -221,8 +247,10 @@ pgm_rate_check (
 	if (0 == bucket->rate_per_sec)
 		return TRUE;
 
-	pgm_spinlock_lock (&bucket->spinlock);
-	pgm_time_t now = pgm_time_update_now();
+	rate_lock (bucket);
+/* loop time may predate a check from another thread */
+	if (pgm_time_before (now, bucket->last_rate_check))
+		now = bucket->last_rate_check;
 
 	if (bucket->rate_per_msec)
 	{
@@ -249,7 +277,7 @@ pgm_rate_check (
 
 	new_rate_limit -= ( bucket->iphdr_len + data_size );
 	if (is_nonblocking && new_rate_limit < 0) {
-		pgm_spinlock_unlock (&bucket->spinlock);
+		rate_unlock (bucket);
 		return FALSE;
 	}
 
@@ -265,7 +293,7 @@ pgm_rate_check (
 		bucket->rate_limit += sleep_amount;
 		bucket->last_rate_check = now;
 	} 
-	pgm_spinlock_unlock (&bucket->spinlock);
+	rate_unlock (bucket);
 	return TRUE;
 }
 
@@ -289,7 +317,7 @@ pgm_rate_remaining2 (
 
 	if (0 != major_bucket->rate_per_sec)
 	{
-		pgm_spinlock_lock (&major_bucket->spinlock);
+		rate_lock (major_bucket);
 		now = pgm_time_update_now();
 		const int64_t bucket_bytes = major_bucket->rate_limit + pgm_to_secs (major_bucket->rate_per_sec * (now - major_bucket->last_rate_check)) - n;
 
@@ -318,7 +346,7 @@ pgm_rate_remaining2 (
 
 	if (0 != major_bucket->rate_per_sec)
 	{
-		pgm_spinlock_unlock (&major_bucket->spinlock);
+		rate_unlock (major_bucket);
 	}
 
 	return remaining;
@@ -337,11 +365,11 @@ pgm_rate_remaining (
 	if (PGM_UNLIKELY(0 == bucket->rate_per_sec))
 		return 0;
 
-	pgm_spinlock_lock (&bucket->spinlock);
+	rate_lock (bucket);
 	const pgm_time_t now = pgm_time_update_now();
 	const pgm_time_t time_since_last_rate_check = now - bucket->last_rate_check;
 	const int64_t bucket_bytes = bucket->rate_limit + pgm_to_secs (bucket->rate_per_sec * time_since_last_rate_check) - n;
-	pgm_spinlock_unlock (&bucket->spinlock);
+	rate_unlock (bucket);
 
 	if (bucket_bytes >= 0)
 		return 0;
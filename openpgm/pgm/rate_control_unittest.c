@@ -126,7 +126,8 @@ END_TEST
  *	pgm_rate_check (
  *		pgm_rate_t*		bucket,
  *		const size_t		data_size,
- *		const bool		is_nonblocking
+ *		const bool		is_nonblocking,
+ *		pgm_time_t		now
  *	)
  *
  * 001: should use seconds resolution to allow 2 packets through then fault.
@@ -138,16 +139,16 @@ START_TEST (test_check_pass_001)
 	memset (&rate, 0, sizeof(rate));
 	pgm_rate_create (&rate, 2*1010, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
-	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
-	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
+	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
 	pgm_rate_destroy (&rate);
 }
 END_TEST
 
 START_TEST (test_check_fail_001)
 {
-	pgm_rate_check (NULL, 1000, FALSE);
+	pgm_rate_check (NULL, 1000, FALSE, pgm_time_update_now());
 	fail ("reached");
 }
 END_TEST
@@ -161,8 +162,8 @@ START_TEST (test_check_pass_002)
 	memset (&rate, 0, sizeof(rate));
 	pgm_rate_create (&rate, 2*900, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
-	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
+	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
 	pgm_rate_destroy (&rate);
 }
 END_TEST
@@ -176,28 +177,28 @@ START_TEST (test_check_pass_003)
 	memset (&rate, 0, sizeof(rate));
 	pgm_rate_create (&rate, 2*1010*1000, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
-	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
-	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
+	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
 /* duplicate check at same time point */
-	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
 /* advance time causing a millisecond fill to occur */
 	mock_pgm_time_now += pgm_msecs(1);
-	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
-	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
-	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
+	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
 /* advance time to fill bucket enough for only one packet */
 	mock_pgm_time_now += pgm_usecs(500);
-	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
-	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
+	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
 /* advance time to fill the bucket a little but not enough for one packet */
 	mock_pgm_time_now += pgm_usecs(100);
-	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
 /* advance time a lot, should be limited to millisecond fill rate */
 	mock_pgm_time_now += pgm_secs(10);
-	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
-	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
-	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
+	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE, pgm_time_update_now()), "rate_check failed");
 	pgm_rate_destroy (&rate);
 }
 END_TEST
@@ -208,7 +209,8 @@ END_TEST
  *		pgm_rate_t*		major_bucket,
  *		pgm_rate_t*		minor_bucket,
  *		const size_t		data_size,
- *		const bool		is_nonblocking
+ *		const bool		is_nonblocking,
+ *		pgm_time_t		now
  *	)
  *
  * 001: should use seconds resolution to allow 2 packets through then fault.
@@ -224,9 +226,9 @@ START_TEST (test_check2_pass_001)
 	mock_pgm_time_now = 1;
 	pgm_rate_create (&major, 2*1010, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major#1 failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major#2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major#3 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major#1 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major#2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major#3 failed");
 	pgm_rate_destroy (&major);
 
 /* minor-only */
@@ -235,9 +237,9 @@ START_TEST (test_check2_pass_001)
 	mock_pgm_time_now = 1;
 	pgm_rate_create (&minor, 2*1010, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
 	pgm_rate_destroy (&minor);
 
 /* major with large minor */
@@ -247,9 +249,9 @@ START_TEST (test_check2_pass_001)
 	pgm_rate_create (&major, 2*1010, 10, 1500);
 	pgm_rate_create (&minor, 999*1010, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
 	pgm_rate_destroy (&major);
 	pgm_rate_destroy (&minor);
 
@@ -260,9 +262,9 @@ START_TEST (test_check2_pass_001)
 	pgm_rate_create (&major, 999*1010, 10, 1500);
 	pgm_rate_create (&minor, 2*1010, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
 	pgm_rate_destroy (&major);
 	pgm_rate_destroy (&minor);
 
@@ -273,9 +275,9 @@ START_TEST (test_check2_pass_001)
 	pgm_rate_create (&major, 2*1010, 10, 1500);
 	pgm_rate_create (&minor, 2*1010, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
 	pgm_rate_destroy (&major);
 	pgm_rate_destroy (&minor);
 }
@@ -283,7 +285,7 @@ END_TEST
 
 START_TEST (test_check2_fail_001)
 {
-	pgm_rate_check2 (NULL, NULL, 1000, FALSE);
+	pgm_rate_check2 (NULL, NULL, 1000, FALSE, pgm_time_update_now());
 	fail ("reached");
 }
 END_TEST
@@ -301,8 +303,8 @@ START_TEST (test_check2_pass_002)
 	mock_pgm_time_now = 1;
 	pgm_rate_create (&major, 2*900, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
 	pgm_rate_destroy (&major);
 
 /* minor-only */
@@ -311,8 +313,8 @@ START_TEST (test_check2_pass_002)
 	mock_pgm_time_now = 1;
 	pgm_rate_create (&minor, 2*900, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
 	pgm_rate_destroy (&minor);
 
 /* major with large minor */
@@ -322,8 +324,8 @@ START_TEST (test_check2_pass_002)
 	pgm_rate_create (&major, 2*900, 10, 1500);
 	pgm_rate_create (&minor, 999*1010, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
 	pgm_rate_destroy (&major);
 	pgm_rate_destroy (&minor);
 
@@ -334,8 +336,8 @@ START_TEST (test_check2_pass_002)
 	pgm_rate_create (&major, 999*1010, 10, 1500);
 	pgm_rate_create (&minor, 2*900, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
 	pgm_rate_destroy (&major);
 	pgm_rate_destroy (&minor);
 
@@ -346,8 +348,8 @@ START_TEST (test_check2_pass_002)
 	pgm_rate_create (&major, 2*900, 10, 1500);
 	pgm_rate_create (&minor, 2*900, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
 	pgm_rate_destroy (&major);
 	pgm_rate_destroy (&minor);
 }
@@ -366,28 +368,28 @@ START_TEST (test_check2_pass_003)
 	mock_pgm_time_now = 1;
 	pgm_rate_create (&major, 2*1010*1000, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
 /* duplicate check at same time point */
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
 /* advance time causing a millisecond fill to occur */
 	mock_pgm_time_now += pgm_msecs(1);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
 /* advance time to fill bucket enough for only one packet */
 	mock_pgm_time_now += pgm_usecs(500);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
 /* advance time to fill the bucket a little but not enough for one packet */
 	mock_pgm_time_now += pgm_usecs(100);
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
 /* advance time a lot, should be limited to millisecond fill rate */
 	mock_pgm_time_now += pgm_secs(10);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:major failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:major failed");
 	pgm_rate_destroy (&major);
 
 /** minor-only **/
@@ -396,28 +398,28 @@ START_TEST (test_check2_pass_003)
 	mock_pgm_time_now = 1;
 	pgm_rate_create (&minor, 2*1010*1000, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
 /* duplicate check at same time point */
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
 /* advance time causing a millisecond fill to occur */
 	mock_pgm_time_now += pgm_msecs(1);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
 /* advance time to fill bucket enough for only one packet */
 	mock_pgm_time_now += pgm_usecs(500);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
 /* advance time to fill the bucket a little but not enough for one packet */
 	mock_pgm_time_now += pgm_usecs(100);
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
 /* advance time a lot, should be limited to millisecond fill rate */
 	mock_pgm_time_now += pgm_secs(10);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:minor failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:minor failed");
 	pgm_rate_destroy (&minor);
 
 /** major with large minor **/
@@ -427,28 +429,28 @@ START_TEST (test_check2_pass_003)
 	pgm_rate_create (&major, 2*1010*1000, 10, 1500);
 	pgm_rate_create (&minor, 999*1010*1000, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
 /* duplicate check at same time point */
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
 /* advance time causing a millisecond fill to occur */
 	mock_pgm_time_now += pgm_msecs(1);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
 /* advance time to fill bucket enough for only one packet */
 	mock_pgm_time_now += pgm_usecs(500);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
 /* advance time to fill the bucket a little but not enough for one packet */
 	mock_pgm_time_now += pgm_usecs(100);
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
 /* advance time a lot, should be limited to millisecond fill rate */
 	mock_pgm_time_now += pgm_secs(10);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1<2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1<2 failed");
 	pgm_rate_destroy (&major);
 	pgm_rate_destroy (&minor);
 
@@ -459,28 +461,28 @@ START_TEST (test_check2_pass_003)
 	pgm_rate_create (&major, 999*1010*1000, 10, 1500);
 	pgm_rate_create (&minor, 2*1010*1000, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
 /* duplicate check at same time point */
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
 /* advance time causing a millisecond fill to occur */
 	mock_pgm_time_now += pgm_msecs(1);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:>>2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:>>2 failed");
 /* advance time to fill bucket enough for only one packet */
 	mock_pgm_time_now += pgm_usecs(500);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
 /* advance time to fill the bucket a little but not enough for one packet */
 	mock_pgm_time_now += pgm_usecs(100);
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
 /* advance time a lot, should be limited to millisecond fill rate */
 	mock_pgm_time_now += pgm_secs(10);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1>2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1>2 failed");
 	pgm_rate_destroy (&major);
 	pgm_rate_destroy (&minor);
 
@@ -491,28 +493,28 @@ START_TEST (test_check2_pass_003)
 	pgm_rate_create (&major, 2*1010*1000, 10, 1500);
 	pgm_rate_create (&minor, 2*1010*1000, 10, 1500);
 	mock_pgm_time_now += pgm_secs(2);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
 /* duplicate check at same time point */
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
 /* advance time causing a millisecond fill to occur */
 	mock_pgm_time_now += pgm_msecs(1);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
 /* advance time to fill bucket enough for only one packet */
 	mock_pgm_time_now += pgm_usecs(500);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
 /* advance time to fill the bucket a little but not enough for one packet */
 	mock_pgm_time_now += pgm_usecs(100);
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
 /* advance time a lot, should be limited to millisecond fill rate */
 	mock_pgm_time_now += pgm_secs(10);
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
-	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
-	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2:1=2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE, pgm_time_update_now()), "rate_check2:1=2 failed");
 	pgm_rate_destroy (&major);
 	pgm_rate_destroy (&minor);
 
@@ -23,6 +23,7 @@
 #	include <config.h>
 #endif
 #include <errno.h>
+#include <limits.h>
 #include <impl/i18n.h>
 #include <impl/framework.h>
 #include <impl/receiver.h>
@@ -81,7 +82,7 @@ next_nak_rb_expiry (
 	pgm_assert (NULL != window->nak_backoff_queue.tail);
 
 	skb = (const struct pgm_sk_buff_t*)window->nak_backoff_queue.tail;
-	state = (const pgm_rxw_state_t*)&skb->cb;
+	state = pgm_rxw_peek_state (window, skb->sequence);
 	return state->timer_expiry;
 }
 
@@ -98,7 +99,7 @@ next_nak_rpt_expiry (
 	pgm_assert (NULL != window->wait_ncf_queue.tail);
 
 	skb = (const struct pgm_sk_buff_t*)window->wait_ncf_queue.tail;
-	state = (const pgm_rxw_state_t*)&skb->cb;
+	state = pgm_rxw_peek_state (window, skb->sequence);
 	return state->timer_expiry;
 }
 
@@ -115,7 +116,7 @@ next_nak_rdata_expiry (
 	pgm_assert (NULL != window->wait_data_queue.tail);
 
 	skb = (const struct pgm_sk_buff_t*)window->wait_data_queue.tail;
-	state = (const pgm_rxw_state_t*)&skb->cb;
+	state = pgm_rxw_peek_state (window, skb->sequence);
 	return state->timer_expiry;
 }
 
@@ -306,10 +307,56 @@ pgm_peer_unref (
 	peer->window = NULL;
 
 /* object */
-	pgm_free (peer);
+	pgm_heap_free (peer->heap, peer);
 	peer = NULL;
 }
 
+/* take an application reference on a buffer delivered by pgm_recvmsgv(),
+ * must be called before the next receive call on the socket.  the buffer
+ * survives the window trail advancing and is returned with pgm_skb_release()
+ * from any thread, to the receive arena when enabled.  the delivering peer
+ * and window are held until release and account the buffer as detached.
+ *
+ * returns skb.
+ */
+
+struct pgm_sk_buff_t*
+pgm_skb_detach (
+	struct pgm_sk_buff_t*const skb
+	)
+{
+	pgm_peer_t* peer;
+
+	pgm_return_val_if_fail (NULL != skb, NULL);
+	pgm_return_val_if_fail (NULL != skb->peer, NULL);
+
+	peer = skb->peer;
+/* the window and application may now release on different threads */
+	skb->single_threaded = 0;
+	pgm_skb_get (skb);
+	_pgm_peer_ref (peer);
+	pgm_atomic_inc32 (&peer->window->detached_count);
+	pgm_atomic_add32 (&peer->window->detached_size, skb->truesize);
+	return skb;
+}
+
+void
+pgm_skb_release (
+	struct pgm_sk_buff_t*const skb
+	)
+{
+	pgm_peer_t* peer;
+
+	pgm_return_if_fail (NULL != skb);
+	pgm_return_if_fail (NULL != skb->peer);
+
+	peer = skb->peer;
+	pgm_atomic_dec32 (&peer->window->detached_count);
+	pgm_atomic_add32 (&peer->window->detached_size, (uint32_t)-skb->truesize);
+	pgm_free_skb (skb);
+	pgm_peer_unref (peer);
+}
+
 /* find PGM options in received SKB.
  *
  * returns TRUE if opt_fragment is found, otherwise FALSE is returned.
@@ -400,8 +447,17 @@ pgm_new_peer (
 		(void*)sock, pgm_tsi_print (tsi), saddr, (unsigned)src_addrlen, daddr, (unsigned)dst_addrlen);
 #endif
 
-	peer = pgm_new0 (pgm_peer_t, 1);
+	peer = pgm_heap_new0 (sock->heap, pgm_peer_t, 1);
+	peer->heap = sock->heap;
 	peer->expiry = now + sock->peer_expiry;
+	peer->weight = 1;
+	for (pgm_slist_t* list = sock->peer_weights; list; list = list->next) {
+		const struct pgm_peer_weight_t* peer_weight = list->data;
+		if (pgm_tsi_equal (&peer_weight->tsi, tsi)) {
+			peer->weight = peer_weight->weight;
+			break;
+		}
+	}
 	memcpy (&peer->tsi, tsi, sizeof(pgm_tsi_t));
 	memcpy (&peer->group_nla, dst_addr, dst_addrlen);
 	memcpy (&peer->local_nla, src_addr, src_addrlen);
@@ -415,15 +471,20 @@ pgm_new_peer (
 					sock->rxw_sqns,
 					sock->rxw_secs,
 					sock->rxw_max_rte,
-					sock->ack_c_p);
+					sock->ack_c_p,
+					sock->rx_arena,
+					sock->heap);
+	if (sock->fec_pool)
+		pgm_rxw_set_fec_pool (peer->window, sock->fec_pool, peer);
+	peer->window->is_reassembling = sock->use_reassembly;
 	peer->spmr_expiry = now + sock->spmr_expiry;
 
 /* add peer to hash table and linked list */
-	pgm_rwlock_writer_lock (&sock->peers_lock);
+	pgm_sock_writer_lock (sock, &sock->peers_lock);
 	pgm_hashtable_insert (sock->peers_hashtable, &peer->tsi, _pgm_peer_ref (peer));
 	peer->peers_link.data = peer;
 	sock->peers_list = pgm_list_prepend_link (sock->peers_list, &peer->peers_link);
-	pgm_rwlock_writer_unlock (&sock->peers_lock);
+	pgm_sock_writer_unlock (sock, &sock->peers_lock);
 
 	pgm_timer_lock (sock);
 	if (pgm_time_after( sock->next_poll, peer->spmr_expiry ))
@@ -432,10 +493,186 @@ pgm_new_peer (
 	return peer;
 }
 
+/* commit transmission groups decoded by the FEC worker pool to their receive
+ * windows in completion order, delivery order is maintained by the windows.
+ * peers with newly contiguous data are added to the pending list.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_flush_peers_reconstructed (
+	pgm_sock_t* const	sock
+	)
+{
+	pgm_fec_job_t* job;
+
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (NULL != sock->fec_pool);
+
+	while (NULL != (job = pgm_fec_pool_pop_completed (sock->fec_pool)))
+	{
+		pgm_peer_t* peer = job->user_data;
+		pgm_rxw_reconstruct_commit (peer->window, job);
+		if (pgm_peer_has_pending (peer))
+			pgm_peer_set_pending (sock, peer);
+	}
+}
+
+/* record receipt to delivery latency of an APDU, log₂ microsecond buckets.
+ */
+
+static inline
+void
+_pgm_peer_record_latency (
+	pgm_peer_t*		    const restrict peer,
+	const struct pgm_sk_buff_t* const restrict skb,
+	const pgm_time_t			   now
+	)
+{
+	unsigned bucket = 0;
+
+	const uint32_t latency = pgm_time_after (now, skb->tstamp) ? (uint32_t)MIN(now - skb->tstamp, UINT32_MAX) : 0;
+	while (bucket < (PGM_PEER_LATENCY_BUCKETS - 1) && (UINT32_C(1) << bucket) < latency)
+		bucket++;
+	peer->latency_histogram[ bucket ]++;
+	peer->latency_count++;
+	peer->latency_sum += latency;
+	if (latency > peer->latency_max)
+		peer->latency_max = latency;
+}
+
+/* returns upper bound in microseconds of the percentile of delivery latency.
+ */
+
+PGM_GNUC_INTERNAL
+uint32_t
+pgm_peer_latency_percentile (
+	const pgm_peer_t* const	peer,
+	const unsigned		percent
+	)
+{
+	uint64_t count = 0;
+
+/* pre-conditions */
+	pgm_assert (NULL != peer);
+	pgm_assert_cmpuint (percent, <=, 100);
+
+	if (0 == peer->latency_count)
+		return 0;
+	const uint64_t target = ((uint64_t)peer->latency_count * percent + 99) / 100;
+	for (unsigned i = 0; i < PGM_PEER_LATENCY_BUCKETS; i++) {
+		count += peer->latency_histogram[ i ];
+		if (count >= target)
+			return (i == PGM_PEER_LATENCY_BUCKETS - 1) ? peer->latency_max : UINT32_C(1) << i;
+	}
+	return peer->latency_max;
+}
+
+/* request a receive buffer of size bytes, the kernel may clamp or round the
+ * request so the reported size is re-read.  a request that does not grow the
+ * buffer marks the system limit as reached.
+ *
+ * returns TRUE if the buffer grew, returns FALSE otherwise.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_rcvbuf_resize (
+	pgm_sock_t* const	sock,
+	const int		size
+	)
+{
+	int rcvbuf = 0;
+	socklen_t optlen = sizeof (rcvbuf);
+
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (size > 0);
+
+	if (SOCKET_ERROR == setsockopt (sock->recv_sock, SOL_SOCKET, SO_RCVBUF, (const char*)&size, sizeof (size)) ||
+	    SOCKET_ERROR == getsockopt (sock->recv_sock, SOL_SOCKET, SO_RCVBUF, (char*)&rcvbuf, &optlen) ||
+	    (size_t)rcvbuf <= sock->rcvbuf)
+	{
+		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Receive buffer limit reached at %" PRIzu " bytes."), sock->rcvbuf);
+		sock->is_rcvbuf_at_limit = TRUE;
+		return FALSE;
+	}
+	pgm_trace (PGM_LOG_ROLE_NETWORK,_("Receive buffer grown from %" PRIzu " to %d bytes."), sock->rcvbuf, rcvbuf);
+	sock->rcvbuf = rcvbuf;
+	sock->rcvbuf_resizes++;
+	return TRUE;
+}
+
+/* account the kernel drop counter carried with a datagram, the counter is
+ * cumulative for the socket so only the difference is new loss.  with auto
+ * tuning each burst of drops doubles the receive buffer, at most once per
+ * resize interval so a single burst spread over many datagrams only counts
+ * once.
+ *
+ * NB: Linux counts packets rejected by an attached socket filter as drops, so
+ *     with the kernel filter the counter cannot drive buffer growth.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_on_rxq_overflow (
+	pgm_sock_t* const	sock,
+	const uint32_t		counter,
+	const pgm_time_t	now
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+
+	const uint32_t drops = counter - sock->rxq_ovfl_counter;
+	sock->rxq_ovfl_counter = counter;
+	if (PGM_LIKELY(0 == drops))
+		return;
+	sock->rxq_overflow_drops += drops;
+	pgm_trace (PGM_LOG_ROLE_NETWORK,_("%" PRIu32 " datagrams dropped by receive socket overflow."), drops);
+	if (!sock->use_rcvbuf_autotune ||
+	    sock->is_filter_attached ||
+	    sock->is_rcvbuf_at_limit ||
+	    pgm_time_after (sock->next_rcvbuf_resize, now))
+		return;
+	sock->next_rcvbuf_resize = now + PGM_RCVBUF_RESIZE_IVL;
+/* Linux reports twice the requested size, requesting the reported size doubles
+ * the buffer.
+ */
+	pgm_rcvbuf_resize (sock, (int)MIN(sock->rcvbuf, INT_MAX));
+}
+
+/* move the peer at the head of the pending list to the tail.
+ */
+
+static inline
+void
+_pgm_peers_pending_rotate (
+	pgm_sock_t* const	sock
+	)
+{
+	pgm_slist_t* link = sock->peers_pending;
+
+	if (NULL == link->next)
+		return;
+	sock->peers_pending = link->next;
+	link->next = NULL;
+	sock->peers_pending_tail->next = link;
+	sock->peers_pending_tail = link;
+}
+
 /* copy any contiguous buffers in the peer list to the provided 
- * message vector.
- * returns -PGM_SOCK_ENOBUFS if the vector is full, returns -PGM_SOCK_ECONNRESET if
- * data loss is detected, returns 0 when all peers flushed.
+ * message vector, or with a receive callback deliver them directly leaving
+ * the vector untouched.
+ *
+ * peers are served in order of arrival on the pending list.  with a delivery
+ * quantum set, deficit round robin bounds each visit to quantum × weight bytes
+ * of APDUs before the peer moves to the tail, otherwise each peer is drained.
+ *
+ * returns -PGM_SOCK_ENOBUFS if the vector is full, the callback blocks or the
+ * delivery budget is spent, returns -PGM_SOCK_ECONNRESET if data loss is
+ * detected, returns 0 when all peers flushed.
  */
 
 PGM_GNUC_INTERNAL
@@ -461,12 +698,71 @@ pgm_flush_peers_pending (
 	pgm_debug ("pgm_flush_peers_pending (sock:%p pmsg:%p msg-end:%p bytes-read:%p data-read:%p)",
 		(const void*)sock, (const void*)pmsg, (const void*)msg_end, (const void*)bytes_read, (const void*)data_read);
 
+	const pgm_time_t now = pgm_time_update_now();
+	const bool is_scheduled = (0 != sock->delivery_quantum);
+
 	while (sock->peers_pending)
 	{
 		pgm_peer_t* peer = sock->peers_pending->data;
+		ssize_t peer_bytes = -1;
+		bool is_full = FALSE;
 		if (peer->last_commit && peer->last_commit < sock->last_commit)
 			pgm_rxw_remove_commit (peer->window);
-		const ssize_t peer_bytes = pgm_rxw_readv (peer->window, pmsg, (unsigned)(msg_end - *pmsg + 1));
+/* a visit cut short by the budget resumes on its remaining credit */
+		if (is_scheduled && peer->deficit <= 0)
+			peer->deficit += (int64_t)sock->delivery_quantum * peer->weight;
+
+		for (;;)
+		{
+			struct pgm_msgv_t msgv, *peer_msg, *msg_start;
+			ssize_t apdu_bytes;
+			if (sock->recv_callback.callback) {
+				msg_start = peer_msg = &msgv;
+				apdu_bytes = pgm_rxw_readv (peer->window, &peer_msg, 1);
+			} else {
+				unsigned msg_len = is_scheduled ? 1 : (unsigned)(msg_end - *pmsg + 1);
+/* a drain reads many APDUs at once, within the remaining budget */
+				if (sock->delivery_budget)
+					msg_len = MIN(msg_len, sock->delivery_budget - sock->delivery_count);
+				msg_start = *pmsg;
+				apdu_bytes = pgm_rxw_readv (peer->window, pmsg, msg_len);
+				peer_msg = *pmsg;
+			}
+			if (apdu_bytes < 0)
+				break;
+
+/* tag delivered buffers for pgm_skb_detach() */
+			for (struct pgm_msgv_t* msg = msg_start; msg < peer_msg; msg++) {
+				for (unsigned i = 0; i < msg->msgv_len; i++)
+					msg->msgv_skb[i]->peer = peer;
+				_pgm_peer_record_latency (peer, msg->msgv_skb[0], now);
+			}
+			peer_bytes = (peer_bytes < 0 ? 0 : peer_bytes) + apdu_bytes;
+			sock->delivery_count += (unsigned)(peer_msg - msg_start);
+
+			if (sock->recv_callback.callback) {
+				const int status = sock->recv_callback.callback (&peer->tsi,
+										 msgv.msgv_skb,
+										 msgv.msgv_len,
+										 (size_t)apdu_bytes,
+										 sock->recv_callback.user_data);
+/* buffers are only referenced for the duration of the call unless detached */
+				pgm_rxw_remove_commit (peer->window);
+				if (0 != status)
+					is_full = TRUE;
+			} else if (*pmsg > msg_end)
+				is_full = TRUE;
+			if (sock->delivery_budget && sock->delivery_count >= sock->delivery_budget)
+				is_full = TRUE;
+
+/* zero-length APDUs still consume credit */
+			if (is_scheduled)
+				peer->deficit -= MAX(apdu_bytes, 1);
+			if (is_full || (is_scheduled && peer->deficit <= 0))
+				break;
+			if (!is_scheduled && !sock->recv_callback.callback)
+				break;
+		}
 
 		if (peer->last_cumulative_losses != ((pgm_rxw_t*)peer->window)->cumulative_losses)
 		{
@@ -475,23 +771,41 @@ pgm_flush_peers_pending (
 			peer->last_cumulative_losses = ((pgm_rxw_t*)peer->window)->cumulative_losses;
 		}
 
+/* deferred checksum failures leave expired placeholders, wake the timer to NAK */
+		if (peer->last_cumulative_csum_errors != ((pgm_rxw_t*)peer->window)->cumulative_csum_errors)
+		{
+			peer->last_cumulative_csum_errors = ((pgm_rxw_t*)peer->window)->cumulative_csum_errors;
+			pgm_timer_lock (sock);
+			if (pgm_time_after (sock->next_poll, now))
+				sock->next_poll = now;
+			pgm_timer_unlock (sock);
+		}
+
 		if (peer_bytes >= 0)
 		{
 			(*bytes_read) += peer_bytes;
 			(*data_read)  ++;
 			peer->last_commit = sock->last_commit;
-			if (*pmsg > msg_end) {			/* commit full */
-				retval = -PGM_SOCK_ENOBUFS;
-				break;
-			}
 		} else
 			peer->last_commit = 0;
+
+/* lost peer remains at the head for the reset report */
 		if (PGM_UNLIKELY(sock->is_reset)) {
-			retval = -PGM_SOCK_ECONNRESET;
+			retval = is_full ? -PGM_SOCK_ENOBUFS : -PGM_SOCK_ECONNRESET;
+			break;
+		}
+/* credit spent, more data may follow after the other peers */
+		if (is_scheduled && peer_bytes >= 0 && peer->deficit <= 0)
+			_pgm_peers_pending_rotate (sock);
+		else if (!is_full) {
+/* drained, clear this reference and move to next */
+			peer->deficit = 0;
+			sock->peers_pending = pgm_slist_remove_first (sock->peers_pending);
+		}
+		if (is_full) {
+			retval = -PGM_SOCK_ENOBUFS;
 			break;
 		}
-/* clear this reference and move to next */
-		sock->peers_pending = pgm_slist_remove_first (sock->peers_pending);
 	}
 
 	return retval;
@@ -532,7 +846,13 @@ pgm_peer_set_pending (
 
 	if (peer->pending_link.data) return;
 	peer->pending_link.data = peer;
-	sock->peers_pending = pgm_slist_prepend_link (sock->peers_pending, &peer->pending_link);
+/* append for arrival order delivery */
+	peer->pending_link.next = NULL;
+	if (sock->peers_pending)
+		sock->peers_pending_tail->next = &peer->pending_link;
+	else
+		sock->peers_pending = &peer->pending_link;
+	sock->peers_pending_tail = &peer->pending_link;
 }
 
 /* Create a new error SKB detailing data loss.
@@ -682,11 +1002,19 @@ pgm_on_spm (
 					return FALSE;
 				}
 			
+				const unsigned parity_prm_depth = 1 << ((opt_parity_prm->opt_reserved & PGM_PARITY_PRM_DEPTH_MASK) >> PGM_PARITY_PRM_DEPTH_SHIFT);
+				if (PGM_UNLIKELY(parity_prm_depth > PGM_MAX_FEC_DEPTH))
+				{
+					pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded malformed SPM."));
+					source->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_SPMS]++;
+					return FALSE;
+				}
+			
 				source->has_proactive_parity = opt_parity_prm->opt_reserved & PGM_PARITY_PRM_PRO;
 				source->has_ondemand_parity  = opt_parity_prm->opt_reserved & PGM_PARITY_PRM_OND;
 				if (source->has_proactive_parity || source->has_ondemand_parity) {
 					source->is_fec_enabled = 1;
-					pgm_rxw_update_fec (source->window, parity_prm_tgs);
+					pgm_rxw_update_fec (source->window, parity_prm_tgs, parity_prm_depth);
 				}
 			}
 		} while (!(opt_header->opt_type & PGM_OPT_END));
@@ -1016,7 +1344,8 @@ send_spmr (
 					header,
 					tpdu_length,
 					(struct sockaddr*)&sock->recv_gsr[i].gsr_group,
-					pgm_sockaddr_len ((struct sockaddr*)&sock->recv_gsr[i].gsr_group));
+					pgm_sockaddr_len ((struct sockaddr*)&sock->recv_gsr[i].gsr_group),
+					0);
 /* ignore errors on peer multicast */
 
 /* send unicast SPMR with regular TTL */
@@ -1031,7 +1360,7 @@ send_spmr (
 	if (sent < 0 && PGM_LIKELY(PGM_SOCK_EAGAIN == pgm_get_last_sock_error()))
 		return FALSE;
 
-	sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT] += tpdu_length * 2;
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_BYTES_SENT, (uint32_t)(tpdu_length * 2));
 	return TRUE;
 }
 
@@ -1155,7 +1484,7 @@ send_parity_nak (
         header->pgm_tsdu_length = 0;
 
 /* NAK */
-	nak->nak_sqn		= pgm_htonl (nak_tg_sqn | (nak_pkt_cnt - 1) );
+	nak->nak_sqn		= pgm_htonl (nak_tg_sqn + ((nak_pkt_cnt - 1) << source->window->tg_depth_shift));
 
 /* source nla */
 	pgm_sockaddr_to_nla ((struct sockaddr*)&source->nla, (char*)&nak->nak_src_nla_afi);
@@ -1533,13 +1862,22 @@ nak_rb_state (
 /* calculate current transmission group for parity enabled peers */
 	if (peer->has_ondemand_parity)
 	{
-		const uint32_t tg_sqn_mask = 0xffffffff << peer->window->tg_sqn_shift;
+		const uint32_t tg_block_mask  = 0xffffffff << (peer->window->tg_sqn_shift + peer->window->tg_depth_shift);
+		const uint32_t tg_stripe_mask = ~(0xffffffff << peer->window->tg_depth_shift);
 
-/* NAKs only generated previous to current transmission group */
-		const uint32_t current_tg_sqn = peer->window->lead & tg_sqn_mask;
+/* NAKs only generated previous to current transmission group, or block of
+ * groups when interleaved.
+ */
+		const uint32_t current_tg_block = peer->window->lead & tg_block_mask;
 
-		uint32_t nak_tg_sqn = 0;
-		uint32_t nak_pkt_cnt = 0;
+/* one parity NAK per transmission group, interleaved groups are collected
+ * side by side.
+ */
+		struct {
+			uint32_t	tg_sqn;
+			uint32_t	pkt_cnt;
+		} nak_tg[ PGM_MAX_FEC_DEPTH ];
+		unsigned nak_tg_len = 0;
 
 /* parity NAK generation */
 
@@ -1548,7 +1886,7 @@ nak_rb_state (
 		     it = prev)
 		{
 			struct pgm_sk_buff_t* skb	= (struct pgm_sk_buff_t*)it;
-			pgm_rxw_state_t* state		= (pgm_rxw_state_t*)&skb->cb;
+			pgm_rxw_state_t* state		= pgm_rxw_peek_state (peer->window, skb->sequence);
 
 			prev = it->prev;
 
@@ -1563,35 +1901,48 @@ nak_rb_state (
 					continue;
 				}
 
-/* TODO: parity nak lists */
-				const uint32_t tg_sqn = skb->sequence & tg_sqn_mask;
-				if (	(  nak_pkt_cnt && tg_sqn == nak_tg_sqn ) ||
-					( !nak_pkt_cnt && tg_sqn != current_tg_sqn )	)
+/* current group remains in back-off until complete, later groups are still
+ * NAKed.
+ */
+				if ((skb->sequence & tg_block_mask) == current_tg_block)
+					continue;
+
+				const uint32_t tg_sqn = (skb->sequence & tg_block_mask) | (skb->sequence & tg_stripe_mask);
+				unsigned i;
+				for (i = 0; i < nak_tg_len; i++)
+					if (tg_sqn == nak_tg[i].tg_sqn)
+						break;
+				if (i == nak_tg_len)
 				{
-					pgm_rxw_state (peer->window, skb, PGM_PKT_STATE_WAIT_NCF);
+/* flush when as many groups as the interleave depth allows are pending */
+					if (nak_tg_len == PGM_N_ELEMENTS(nak_tg)) {
+						for (unsigned j = 0; j < nak_tg_len; j++)
+							if (!send_parity_nak (sock, peer, nak_tg[j].tg_sqn, nak_tg[j].pkt_cnt))
+								return FALSE;
+						nak_tg_len = i = 0;
+					}
+					nak_tg[i].tg_sqn  = tg_sqn;
+					nak_tg[i].pkt_cnt = 0;
+					nak_tg_len++;
+				}
 
-					if (!nak_pkt_cnt++)
-						nak_tg_sqn = tg_sqn;
-					state->nak_transmit_count++;
+				pgm_rxw_state (peer->window, skb, PGM_PKT_STATE_WAIT_NCF);
+				nak_tg[i].pkt_cnt++;
+				state->nak_transmit_count++;
 
 #ifdef PGM_ABSOLUTE_EXPIRY
+				state->timer_expiry += sock->nak_rpt_ivl;
+				while (pgm_time_after_eq (now, state->timer_expiry)) {
 					state->timer_expiry += sock->nak_rpt_ivl;
-					while (pgm_time_after_eq (now, state->timer_expiry)) {
-						state->timer_expiry += sock->nak_rpt_ivl;
-						state->ncf_retry_count++;
-					}
+					state->ncf_retry_count++;
+				}
 #else
-					state->timer_expiry = now + sock->nak_rpt_ivl;
+				state->timer_expiry = now + sock->nak_rpt_ivl;
 #endif
-					pgm_timer_lock (sock);
-					if (pgm_time_after (sock->next_poll, state->timer_expiry))
-						sock->next_poll = state->timer_expiry;
-					pgm_timer_unlock (sock);
-				}
-				else
-				{	/* different transmission group */
-					break;
-				}
+				pgm_timer_lock (sock);
+				if (pgm_time_after (sock->next_poll, state->timer_expiry))
+					sock->next_poll = state->timer_expiry;
+				pgm_timer_unlock (sock);
 			}
 			else
 			{	/* packet expires some time later */
@@ -1599,8 +1950,9 @@ nak_rb_state (
 			}
 		}
 
-		if (nak_pkt_cnt && !send_parity_nak (sock, peer, nak_tg_sqn, nak_pkt_cnt))
-			return FALSE;
+		for (unsigned i = 0; i < nak_tg_len; i++)
+			if (!send_parity_nak (sock, peer, nak_tg[i].tg_sqn, nak_tg[i].pkt_cnt))
+				return FALSE;
 	}
 	else
 	{
@@ -1613,7 +1965,7 @@ nak_rb_state (
 		     it = prev)
 		{
 			struct pgm_sk_buff_t* skb	= (struct pgm_sk_buff_t*)it;
-			pgm_rxw_state_t* state		= (pgm_rxw_state_t*)&skb->cb;
+			pgm_rxw_state_t* state		= pgm_rxw_peek_state (peer->window, skb->sequence);
 
 			prev = it->prev;
 
@@ -1806,6 +2158,8 @@ pgm_check_peer_state (
 				sock->peers_list = pgm_list_remove_link (sock->peers_list, &peer->peers_link);
 				if (sock->last_hash_value == peer)
 					sock->last_hash_value = NULL;
+/* detached buffers may hold the peer beyond the FEC workers */
+				pgm_rxw_set_fec_pool (peer->window, NULL, NULL);
 				pgm_peer_unref (peer);
 			}
 		}
@@ -1923,7 +2277,7 @@ nak_rpt_state (
 	{
 		struct pgm_sk_buff_t* skb	= (struct pgm_sk_buff_t*)it;
 		pgm_assert (NULL != skb);
-		pgm_rxw_state_t* state		= (pgm_rxw_state_t*)&skb->cb;
+		pgm_rxw_state_t* state		= pgm_rxw_peek_state (peer->window, skb->sequence);
 
 		prev = it->prev;
 
@@ -2056,7 +2410,7 @@ nak_rdata_state (
 	{
 		struct pgm_sk_buff_t* rdata_skb	= (struct pgm_sk_buff_t*)it;
 		pgm_assert (NULL != rdata_skb);
-		pgm_rxw_state_t* rdata_state	= (pgm_rxw_state_t*)&rdata_skb->cb;
+		pgm_rxw_state_t* rdata_state	= pgm_rxw_peek_state (peer->window, rdata_skb->sequence);
 
 		prev = it->prev;
 
@@ -63,6 +63,8 @@
 #define pgm_rxw_create		mock_pgm_rxw_create
 #define pgm_rxw_update		mock_pgm_rxw_update
 #define pgm_rxw_update_fec	mock_pgm_rxw_update_fec
+#define pgm_rxw_set_fec_pool	mock_pgm_rxw_set_fec_pool
+#define pgm_rxw_reconstruct_commit	mock_pgm_rxw_reconstruct_commit
 #define pgm_rxw_confirm		mock_pgm_rxw_confirm
 #define pgm_rxw_lost		mock_pgm_rxw_lost
 #define pgm_rxw_state		mock_pgm_rxw_state
@@ -149,6 +151,9 @@ mock_pgm_on_spmr (
 }
 
 /** net module */
+static uint32_t mock_nak_sqn[ 8 ];
+static unsigned mock_nak_len = 0;
+
 PGM_GNUC_INTERNAL
 ssize_t
 mock_pgm_sendto_hops (
@@ -160,9 +165,17 @@ mock_pgm_sendto_hops (
 	const void*			buf,
 	size_t				len,
 	const struct sockaddr*		to,
-	socklen_t			tolen
+	socklen_t			tolen,
+	pgm_time_t			now
 	)
 {
+	const struct pgm_header* header = buf;
+	if (PGM_NAK == header->pgm_type &&
+	    mock_nak_len < G_N_ELEMENTS(mock_nak_sqn))
+	{
+		const struct pgm_nak* nak = (const struct pgm_nak*)(header + 1);
+		mock_nak_sqn[ mock_nak_len++ ] = g_ntohl (nak->nak_sqn);
+	}
 	return len;
 }
 
@@ -218,7 +231,9 @@ mock_pgm_rxw_create (
 	const unsigned		sqns,
 	const unsigned		secs,
 	const ssize_t		max_rte,
-	const uint32_t		ack_c_p
+	const uint32_t		ack_c_p,
+	pgm_arena_t*		arena,
+	pgm_heap_t*		heap
 	)
 {
 	return g_malloc0 (sizeof(pgm_rxw_t));
@@ -230,6 +245,8 @@ mock_pgm_rxw_destroy (
 	)
 {
 	g_assert (NULL != window);
+/* real window would cancel outstanding jobs on the pool */
+	g_assert (NULL == window->fec_pool);
 	g_free (window);
 }
 
@@ -277,9 +294,30 @@ mock_pgm_rxw_update (
 void
 mock_pgm_rxw_update_fec (
 	pgm_rxw_t* const		window,
-	const uint8_t			rs_k
+	const uint8_t			rs_k,
+	const uint8_t			tg_depth
+	)
+{
+}
+
+void
+mock_pgm_rxw_set_fec_pool (
+	pgm_rxw_t* const		window,
+	pgm_fec_pool_t* const		pool,
+	void* const			user_data
 	)
 {
+	window->fec_pool	= pool;
+	window->fec_user_data	= user_data;
+}
+
+void
+mock_pgm_rxw_reconstruct_commit (
+	pgm_rxw_t* const		window,
+	pgm_fec_job_t* const		job
+	)
+{
+	pgm_fec_job_free (job);
 }
 
 int
@@ -293,13 +331,23 @@ mock_pgm_rxw_add (
 	return PGM_RXW_APPENDED;
 }
 
+static unsigned mock_remove_commit_count = 0;
+
 void
 mock_pgm_rxw_remove_commit (
 	pgm_rxw_t* const		window
 	)
 {
+	mock_remove_commit_count++;
 }
 
+/* scripted APDUs, up to pmsglen per read */
+static struct {
+	const pgm_rxw_t*	window;
+	size_t			len;
+} mock_apdus[ 16 ];
+static unsigned mock_apdu_count = 0;
+
 ssize_t
 mock_pgm_rxw_readv (
 	pgm_rxw_t* const		window,
@@ -307,7 +355,23 @@ mock_pgm_rxw_readv (
 	const unsigned			pmsglen
 	)
 {
-	return 0;
+	ssize_t bytes_read = -1;
+	unsigned msg_count = 0;
+	g_assert (pmsglen > 0);
+	for (unsigned i = 0; i < mock_apdu_count && msg_count < pmsglen; i++)
+	{
+		if (window != mock_apdus[i].window)
+			continue;
+		struct pgm_sk_buff_t* skb = pgm_alloc_skb (0);
+		skb->tstamp = mock_pgm_time_now;
+		(*pmsg)->msgv_len = 1;
+		(*pmsg)->msgv_skb[0] = skb;
+		(*pmsg)++;
+		mock_apdus[i].window = NULL;
+		bytes_read = (bytes_read < 0 ? 0 : bytes_read) + (ssize_t)mock_apdus[i].len;
+		msg_count++;
+	}
+	return bytes_read;
 }
 
 /* checksum module */
@@ -407,6 +471,412 @@ START_TEST (test_peer_unref_fail_001)
 }
 END_TEST
 
+/* target:
+ *	struct pgm_sk_buff_t*
+ *	pgm_skb_detach (
+ *		struct pgm_sk_buff_t*const	skb
+ *		)
+ *
+ *	void
+ *	pgm_skb_release (
+ *		struct pgm_sk_buff_t*const	skb
+ *		)
+ */
+
+/* buffer and peer survive the window reference */
+START_TEST (test_skb_detach_pass_001)
+{
+	pgm_peer_t* peer = generate_peer();
+	struct pgm_sk_buff_t* skb = pgm_alloc_skb (100);
+	skb->peer = peer;
+	fail_unless (skb == pgm_skb_detach (skb), "detach failed");
+	fail_unless (2 == pgm_atomic_read32 (&skb->users), "users failed");
+	fail_unless (2 == pgm_atomic_read32 (&peer->ref_count), "ref_count failed");
+	fail_unless (1 == peer->window->detached_count, "detached_count failed");
+	fail_unless (skb->truesize == peer->window->detached_size, "detached_size failed");
+	pgm_skb_release (skb);
+	fail_unless (1 == pgm_atomic_read32 (&skb->users), "users failed");
+	fail_unless (1 == pgm_atomic_read32 (&peer->ref_count), "ref_count failed");
+	fail_unless (0 == peer->window->detached_count, "detached_count failed");
+	fail_unless (0 == peer->window->detached_size, "detached_size failed");
+	pgm_free_skb (skb);
+	pgm_peer_unref (peer);
+}
+END_TEST
+
+START_TEST (test_skb_detach_fail_001)
+{
+	fail_unless (NULL == pgm_skb_detach (NULL), "detach failed");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_peer_set_pending (
+ *		pgm_sock_t* const	sock,
+ *		pgm_peer_t* const	peer
+ *		)
+ */
+
+/* arrival order, no duplicates */
+START_TEST (test_peer_set_pending_pass_001)
+{
+	pgm_sock_t* sock = generate_sock();
+	pgm_peer_t* peer_a = generate_peer();
+	pgm_peer_t* peer_b = generate_peer();
+	pgm_peer_set_pending (sock, peer_a);
+	pgm_peer_set_pending (sock, peer_b);
+	pgm_peer_set_pending (sock, peer_a);
+	fail_unless (&peer_a->pending_link == sock->peers_pending, "head failed");
+	fail_unless (&peer_b->pending_link == sock->peers_pending_tail, "tail failed");
+	fail_unless (2 == pgm_slist_length (sock->peers_pending), "length failed");
+}
+END_TEST
+
+START_TEST (test_peer_set_pending_fail_001)
+{
+	pgm_peer_set_pending (NULL, generate_peer());
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	int
+ *	pgm_flush_peers_pending (
+ *		pgm_sock_t* const		sock,
+ *		struct pgm_msgv_t**		pmsg,
+ *		const struct pgm_msgv_t* const	msg_end,
+ *		size_t* const			bytes_read,
+ *		unsigned* const			data_read
+ *		)
+ */
+
+static
+void
+mock_push_apdus (
+	const pgm_peer_t* const	peer,
+	const unsigned		count,
+	const size_t		len
+	)
+{
+	for (unsigned i = 0; i < count; i++) {
+		mock_apdus[ mock_apdu_count ].window = peer->window;
+		mock_apdus[ mock_apdu_count ].len    = len;
+		mock_apdu_count++;
+	}
+}
+
+/* push delivery, recording each call and stopping on a scripted call */
+static struct {
+	const pgm_tsi_t*	tsi;
+	const pgm_peer_t*	peer;
+	unsigned		len;
+	size_t			apdu_length;
+	void*			user_data;
+	unsigned		remove_commit_count;
+} mock_callbacks[ 16 ];
+static unsigned mock_callback_count = 0;
+static unsigned mock_callback_stop = 0;	/* 1-based call to refuse after, 0 never */
+
+static
+int
+mock_recv_callback (
+	const pgm_tsi_t*		tsi,
+	struct pgm_sk_buff_t**		skbs,
+	const unsigned			len,
+	const size_t			apdu_length,
+	void*				user_data
+	)
+{
+	mock_callbacks[ mock_callback_count ].tsi		  = tsi;
+	mock_callbacks[ mock_callback_count ].peer		  = skbs[0]->peer;
+	mock_callbacks[ mock_callback_count ].len		  = len;
+	mock_callbacks[ mock_callback_count ].apdu_length	  = apdu_length;
+	mock_callbacks[ mock_callback_count ].user_data		  = user_data;
+	mock_callbacks[ mock_callback_count ].remove_commit_count = mock_remove_commit_count;
+	return (++mock_callback_count == mock_callback_stop) ? 1 : 0;
+}
+
+/* deficit round robin, weight 2 peer takes twice the quantum each round and
+ * overdrawn credit is carried into the next round.
+ */
+START_TEST (test_flush_peers_pending_pass_001)
+{
+	pgm_sock_t* sock = generate_sock();
+	sock->delivery_quantum = 1000;
+	pgm_peer_t* peer_a = generate_peer();
+	pgm_peer_t* peer_b = generate_peer();
+	peer_a->weight = 1;
+	peer_b->weight = 2;
+	mock_apdu_count = 0;
+	mock_push_apdus (peer_a, 3, 600);
+	mock_push_apdus (peer_b, 4, 600);
+	pgm_peer_set_pending (sock, peer_a);
+	pgm_peer_set_pending (sock, peer_b);
+	struct pgm_msgv_t msgv[ 16 ], *pmsg = msgv;
+	size_t bytes_read = 0;
+	unsigned data_read = 0;
+	fail_unless (0 == pgm_flush_peers_pending (sock, &pmsg, msgv + G_N_ELEMENTS(msgv) - 1, &bytes_read, &data_read), "flush failed");
+/* A: 1000 credit, 600, 600 ⇒ -200.  B: 2000, four APDUs ⇒ -400.  A: 800, 600 */
+	const pgm_peer_t* order[] = { peer_a, peer_a, peer_b, peer_b, peer_b, peer_b, peer_a };
+	fail_unless (G_N_ELEMENTS(order) == (unsigned)(pmsg - msgv), "msgv count failed");
+	for (unsigned i = 0; i < G_N_ELEMENTS(order); i++)
+		fail_unless (order[i] == msgv[i].msgv_skb[0]->peer, "delivery order failed");
+	fail_unless (7 * 600 == bytes_read, "bytes_read failed");
+/* one count per visit that delivered */
+	fail_unless (3 == data_read, "data_read failed");
+	fail_unless (NULL == sock->peers_pending, "peers_pending failed");
+/* drained peers start the next round without credit or debt */
+	fail_unless (0 == peer_a->deficit, "deficit failed");
+	fail_unless (0 == peer_b->deficit, "deficit failed");
+}
+END_TEST
+
+/* budget cut-off keeps the peer in place with its remaining credit, a spent
+ * peer moves to the tail carrying its debt.
+ */
+START_TEST (test_flush_peers_pending_pass_002)
+{
+	pgm_sock_t* sock = generate_sock();
+	sock->delivery_quantum = 1000;
+	sock->delivery_budget = 2;
+	pgm_peer_t* peer_a = generate_peer();
+	pgm_peer_t* peer_b = generate_peer();
+	peer_a->weight = 1;
+	peer_b->weight = 2;
+	mock_apdu_count = 0;
+	mock_push_apdus (peer_a, 3, 600);
+	mock_push_apdus (peer_b, 4, 600);
+	pgm_peer_set_pending (sock, peer_a);
+	pgm_peer_set_pending (sock, peer_b);
+	struct pgm_msgv_t msgv[ 16 ], *pmsg = msgv;
+	size_t bytes_read = 0;
+	unsigned data_read = 0;
+/* A spends its credit on the budget */
+	sock->delivery_count = 0;
+	fail_unless (-PGM_SOCK_ENOBUFS == pgm_flush_peers_pending (sock, &pmsg, msgv + G_N_ELEMENTS(msgv) - 1, &bytes_read, &data_read), "flush failed");
+	fail_unless (2 == (unsigned)(pmsg - msgv), "msgv count failed");
+	fail_unless (-200 == peer_a->deficit, "deficit failed");
+	fail_unless (&peer_b->pending_link == sock->peers_pending, "head failed");
+	fail_unless (&peer_a->pending_link == sock->peers_pending_tail, "tail failed");
+/* B cut with credit remaining */
+	sock->delivery_count = 0;
+	pmsg = msgv;
+	fail_unless (-PGM_SOCK_ENOBUFS == pgm_flush_peers_pending (sock, &pmsg, msgv + G_N_ELEMENTS(msgv) - 1, &bytes_read, &data_read), "flush failed");
+	fail_unless (2 == (unsigned)(pmsg - msgv), "msgv count failed");
+	fail_unless (peer_b == msgv[0].msgv_skb[0]->peer, "delivery order failed");
+	fail_unless (800 == peer_b->deficit, "deficit failed");
+	fail_unless (&peer_b->pending_link == sock->peers_pending, "head failed");
+/* B resumes without new credit, overdraws and yields to A */
+	sock->delivery_count = 0;
+	pmsg = msgv;
+	fail_unless (-PGM_SOCK_ENOBUFS == pgm_flush_peers_pending (sock, &pmsg, msgv + G_N_ELEMENTS(msgv) - 1, &bytes_read, &data_read), "flush failed");
+	fail_unless (peer_b == msgv[0].msgv_skb[0]->peer, "delivery order failed");
+	fail_unless (peer_b == msgv[1].msgv_skb[0]->peer, "delivery order failed");
+	fail_unless (-400 == peer_b->deficit, "deficit failed");
+	fail_unless (&peer_a->pending_link == sock->peers_pending, "head failed");
+}
+END_TEST
+
+/* without a quantum one read drains the peer, only up to the budget */
+START_TEST (test_flush_peers_pending_pass_003)
+{
+	pgm_sock_t* sock = generate_sock();
+	sock->delivery_budget = 2;
+	pgm_peer_t* peer_a = generate_peer();
+	pgm_peer_t* peer_b = generate_peer();
+	mock_apdu_count = 0;
+	mock_push_apdus (peer_a, 5, 100);
+	mock_push_apdus (peer_b, 1, 100);
+	pgm_peer_set_pending (sock, peer_a);
+	pgm_peer_set_pending (sock, peer_b);
+	struct pgm_msgv_t msgv[ 16 ], *pmsg = msgv;
+	size_t bytes_read = 0;
+	unsigned data_read = 0;
+	sock->delivery_count = 0;
+	fail_unless (-PGM_SOCK_ENOBUFS == pgm_flush_peers_pending (sock, &pmsg, msgv + G_N_ELEMENTS(msgv) - 1, &bytes_read, &data_read), "flush failed");
+	fail_unless (2 == (unsigned)(pmsg - msgv), "msgv count failed");
+	fail_unless (2 * 100 == bytes_read, "bytes_read failed");
+	fail_unless (&peer_a->pending_link == sock->peers_pending, "head failed");
+/* next call resumes the same peer */
+	sock->delivery_count = 0;
+	pmsg = msgv;
+	fail_unless (-PGM_SOCK_ENOBUFS == pgm_flush_peers_pending (sock, &pmsg, msgv + G_N_ELEMENTS(msgv) - 1, &bytes_read, &data_read), "flush failed");
+	fail_unless (2 == (unsigned)(pmsg - msgv), "msgv count failed");
+	fail_unless (peer_a == msgv[0].msgv_skb[0]->peer, "delivery order failed");
+	fail_unless (peer_a == msgv[1].msgv_skb[0]->peer, "delivery order failed");
+/* last of A and then B fit the budget */
+	sock->delivery_count = 0;
+	pmsg = msgv;
+	fail_unless (-PGM_SOCK_ENOBUFS == pgm_flush_peers_pending (sock, &pmsg, msgv + G_N_ELEMENTS(msgv) - 1, &bytes_read, &data_read), "flush failed");
+	fail_unless (2 == (unsigned)(pmsg - msgv), "msgv count failed");
+	fail_unless (peer_a == msgv[0].msgv_skb[0]->peer, "delivery order failed");
+	fail_unless (peer_b == msgv[1].msgv_skb[0]->peer, "delivery order failed");
+	fail_unless (6 * 100 == bytes_read, "bytes_read failed");
+}
+END_TEST
+
+/* push delivery, one call per APDU with the window trail removed after each */
+START_TEST (test_flush_peers_pending_pass_004)
+{
+	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_sock_t* sock = generate_sock();
+	sock->recv_callback.callback = mock_recv_callback;
+	sock->recv_callback.user_data = sock;
+	pgm_peer_t* peer = generate_peer();
+	memcpy (&peer->tsi, &tsi, sizeof(pgm_tsi_t));
+	mock_apdu_count = 0;
+	mock_push_apdus (peer, 1, 100);
+	mock_push_apdus (peer, 1, 200);
+	mock_push_apdus (peer, 1, 300);
+	mock_callback_count = mock_callback_stop = mock_remove_commit_count = 0;
+	pgm_peer_set_pending (sock, peer);
+	struct pgm_msgv_t msgv[ 16 ], *pmsg = msgv;
+	size_t bytes_read = 0;
+	unsigned data_read = 0;
+	fail_unless (0 == pgm_flush_peers_pending (sock, &pmsg, msgv + G_N_ELEMENTS(msgv) - 1, &bytes_read, &data_read), "flush failed");
+	fail_unless (msgv == pmsg, "msgv used");
+	fail_unless (3 == mock_callback_count, "callback count failed");
+	for (unsigned i = 0; i < 3; i++) {
+		fail_unless (&peer->tsi == mock_callbacks[i].tsi, "tsi failed");
+		fail_unless (peer == mock_callbacks[i].peer, "skb peer failed");
+		fail_unless (1 == mock_callbacks[i].len, "skb count failed");
+		fail_unless ((i + 1) * 100 == mock_callbacks[i].apdu_length, "apdu length failed");
+		fail_unless (sock == mock_callbacks[i].user_data, "user data failed");
+/* previous APDU released before the next call */
+		fail_unless (i == mock_callbacks[i].remove_commit_count, "remove commit failed");
+	}
+	fail_unless (3 == mock_remove_commit_count, "remove commit failed");
+	fail_unless (600 == bytes_read, "bytes_read failed");
+	fail_unless (1 == data_read, "data_read failed");
+	fail_unless (NULL == sock->peers_pending, "peers_pending failed");
+}
+END_TEST
+
+/* non-zero return stops delivery with the peer pending, the next receive
+ * call resumes at the following APDU.
+ */
+START_TEST (test_flush_peers_pending_pass_005)
+{
+	const pgm_tsi_t tsi_a = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const pgm_tsi_t tsi_b = { { 1, 2, 3, 4, 5, 6 }, 2000 };
+	pgm_sock_t* sock = generate_sock();
+	sock->recv_callback.callback = mock_recv_callback;
+	pgm_peer_t* peer_a = generate_peer();
+	pgm_peer_t* peer_b = generate_peer();
+	memcpy (&peer_a->tsi, &tsi_a, sizeof(pgm_tsi_t));
+	memcpy (&peer_b->tsi, &tsi_b, sizeof(pgm_tsi_t));
+	mock_apdu_count = 0;
+	mock_push_apdus (peer_a, 3, 100);
+	mock_push_apdus (peer_b, 1, 100);
+	mock_callback_count = mock_remove_commit_count = 0;
+	mock_callback_stop = 2;
+	pgm_peer_set_pending (sock, peer_a);
+	pgm_peer_set_pending (sock, peer_b);
+	struct pgm_msgv_t msgv[ 16 ], *pmsg = msgv;
+	size_t bytes_read = 0;
+	unsigned data_read = 0;
+	sock->delivery_count = 0;
+	fail_unless (-PGM_SOCK_ENOBUFS == pgm_flush_peers_pending (sock, &pmsg, msgv + G_N_ELEMENTS(msgv) - 1, &bytes_read, &data_read), "flush failed");
+	fail_unless (2 == mock_callback_count, "callback count failed");
+/* refused APDU was delivered and released */
+	fail_unless (2 == mock_remove_commit_count, "remove commit failed");
+	fail_unless (200 == bytes_read, "bytes_read failed");
+	fail_unless (&peer_a->pending_link == sock->peers_pending, "head failed");
+	fail_unless (2 == pgm_slist_length (sock->peers_pending), "length failed");
+/* resume */
+	sock->delivery_count = 0;
+	fail_unless (0 == pgm_flush_peers_pending (sock, &pmsg, msgv + G_N_ELEMENTS(msgv) - 1, &bytes_read, &data_read), "flush failed");
+	fail_unless (4 == mock_callback_count, "callback count failed");
+	fail_unless (&peer_a->tsi == mock_callbacks[2].tsi, "resume order failed");
+	fail_unless (&peer_b->tsi == mock_callbacks[3].tsi, "resume order failed");
+	fail_unless (4 == mock_remove_commit_count, "remove commit failed");
+	fail_unless (400 == bytes_read, "bytes_read failed");
+	fail_unless (NULL == sock->peers_pending, "peers_pending failed");
+}
+END_TEST
+
+START_TEST (test_flush_peers_pending_fail_001)
+{
+	struct pgm_msgv_t msgv[ 1 ], *pmsg = msgv;
+	size_t bytes_read = 0;
+	unsigned data_read = 0;
+	pgm_flush_peers_pending (NULL, &pmsg, msgv, &bytes_read, &data_read);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	uint32_t
+ *	pgm_peer_latency_percentile (
+ *		const pgm_peer_t* const	peer,
+ *		const unsigned		percent
+ *		)
+ */
+
+START_TEST (test_peer_latency_percentile_pass_001)
+{
+	pgm_peer_t* peer = generate_peer();
+	struct pgm_sk_buff_t* skb = pgm_alloc_skb (100);
+	fail_unless (0 == pgm_peer_latency_percentile (peer, 99), "empty failed");
+	skb->tstamp = 1000;
+	for (unsigned i = 0; i < 99; i++)
+		_pgm_peer_record_latency (peer, skb, 1100);
+	_pgm_peer_record_latency (peer, skb, 6000);
+	fail_unless (100 == peer->latency_count, "count failed");
+	fail_unless (5000 == peer->latency_max, "max failed");
+	fail_unless (128 == pgm_peer_latency_percentile (peer, 50), "p50 failed");
+	fail_unless (128 == pgm_peer_latency_percentile (peer, 99), "p99 failed");
+	fail_unless (8192 == pgm_peer_latency_percentile (peer, 100), "p100 failed");
+	pgm_free_skb (skb);
+}
+END_TEST
+
+START_TEST (test_peer_latency_percentile_fail_001)
+{
+	pgm_peer_latency_percentile (NULL, 99);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_on_rxq_overflow (
+ *		pgm_sock_t*		sock,
+ *		const uint32_t		counter,
+ *		const pgm_time_t	now
+ *		)
+ */
+
+START_TEST (test_on_rxq_overflow_pass_001)
+{
+	pgm_sock_t* sock = generate_sock();
+	pgm_on_rxq_overflow (sock, 0, mock_pgm_time_now);
+	fail_unless (0 == sock->rxq_overflow_drops, "idle failed");
+	pgm_on_rxq_overflow (sock, 5, mock_pgm_time_now);
+	fail_unless (5 == sock->rxq_overflow_drops, "drops failed");
+	pgm_on_rxq_overflow (sock, 5, mock_pgm_time_now);
+	fail_unless (5 == sock->rxq_overflow_drops, "repeat failed");
+/* cumulative counter wraps */
+	sock->rxq_ovfl_counter = UINT32_MAX - 1;
+	pgm_on_rxq_overflow (sock, 2, mock_pgm_time_now);
+	fail_unless (9 == sock->rxq_overflow_drops, "wrap failed");
+/* no growth past the system limit */
+	sock->use_rcvbuf_autotune = TRUE;
+	sock->is_rcvbuf_at_limit = TRUE;
+	pgm_on_rxq_overflow (sock, 3, mock_pgm_time_now);
+	fail_unless (10 == sock->rxq_overflow_drops, "limit drops failed");
+	fail_unless (0 == sock->rcvbuf_resizes, "limit resize failed");
+}
+END_TEST
+
+START_TEST (test_on_rxq_overflow_fail_001)
+{
+	pgm_on_rxq_overflow (NULL, 1, mock_pgm_time_now);
+	fail ("reached");
+}
+END_TEST
+
 /* target:
  *	bool
  *	pgm_check_peer_state (
@@ -423,6 +893,38 @@ START_TEST (test_check_peer_state_pass_001)
 }
 END_TEST
 
+/* expired peer held by a detached buffer is unhooked from the FEC pool
+ * before the socket destroys the pool.
+ */
+START_TEST (test_check_peer_state_pass_002)
+{
+	pgm_sock_t* sock = generate_sock();
+	sock->is_bound = TRUE;
+	sock->peer_expiry = TEST_PEER_EXPIRY;
+	sock->peers_hashtable = pgm_hashtable_new (pgm_tsi_hash, pgm_tsi_equal);
+	pgm_fec_pool_t* pool = pgm_fec_pool_create (1, NULL, NULL, NULL);
+	fail_if (NULL == pool, "fec_pool_create failed");
+	pgm_peer_t* peer = generate_peer();
+	pgm_rxw_set_fec_pool (peer->window, pool, peer);
+	pgm_hashtable_insert (sock->peers_hashtable, &peer->tsi, peer);
+	peer->peers_link.data = peer;
+	sock->peers_list = pgm_list_prepend_link (sock->peers_list, &peer->peers_link);
+	peer->expiry = mock_pgm_time_now;
+	struct pgm_sk_buff_t* skb = pgm_alloc_skb (100);
+	skb->peer = peer;
+	fail_unless (skb == pgm_skb_detach (skb), "detach failed");
+	pgm_check_peer_state (sock, mock_pgm_time_now);
+	fail_unless (NULL == sock->peers_list, "peer not expired");
+	fail_unless (NULL == peer->window->fec_pool, "fec_pool not cleared");
+/* pgm_close() */
+	pgm_fec_pool_destroy (pool);
+/* last peer reference */
+	pgm_skb_release (skb);
+	pgm_free_skb (skb);
+	pgm_hashtable_destroy (sock->peers_hashtable);
+}
+END_TEST
+
 START_TEST (test_check_peer_state_fail_001)
 {
 	pgm_check_peer_state (NULL, mock_pgm_time_now);
@@ -430,6 +932,90 @@ START_TEST (test_check_peer_state_fail_001)
 }
 END_TEST
 
+/* target:
+ *	bool
+ *	nak_rb_state (
+ *		pgm_sock_t*		sock,
+ *		pgm_peer_t*		peer,
+ *		const pgm_time_t	now
+ *		)
+ */
+
+/* one parity NAK for each complete transmission group with expired back-off,
+ * the group at the window lead waits.
+ */
+START_TEST (test_nak_rb_state_pass_001)
+{
+	const uint32_t sequences[] = { 1, 5, 9, 6, 13 };
+	pgm_sock_t* sock = generate_sock();
+	sock->nak_rpt_ivl = TEST_NAK_RPT_IVL;
+	pgm_peer_t* peer = generate_peer();
+	peer->nla.ss_family = AF_INET;
+	peer->group_nla.ss_family = AF_INET;
+	peer->has_ondemand_parity = TRUE;
+	peer->window->mask = 31;
+	peer->window->pstate = g_new0 (pgm_rxw_state_t, 32);
+	peer->window->tg_sqn_shift = 2;
+	peer->window->lead = 10;
+	struct pgm_sk_buff_t* skb[ G_N_ELEMENTS(sequences) ];
+	for (unsigned i = 0; i < G_N_ELEMENTS(sequences); i++) {
+		skb[i] = pgm_alloc_skb (0);
+		skb[i]->sequence = sequences[i];
+		pgm_rxw_peek_state (peer->window, sequences[i])->timer_expiry = 1;
+		pgm_queue_push_head_link (&peer->window->nak_backoff_queue, (pgm_list_t*)skb[i]);
+	}
+/* #13 not yet expired */
+	pgm_rxw_peek_state (peer->window, 13)->timer_expiry = 10;
+	mock_nak_len = 0;
+	fail_unless (TRUE == nak_rb_state (sock, peer, 2), "nak_rb_state failed");
+/* group #0 one packet, group #4 two packets past the lead group #8 */
+	fail_unless (2 == mock_nak_len, "nak count failed");
+	fail_unless ((0 | 0) == mock_nak_sqn[0], "nak_sqn failed");
+	fail_unless ((4 | 1) == mock_nak_sqn[1], "nak_sqn failed");
+	fail_unless (1 == pgm_rxw_peek_state (peer->window, 5)->nak_transmit_count, "nak_transmit_count failed");
+	fail_unless (1 == pgm_rxw_peek_state (peer->window, 6)->nak_transmit_count, "nak_transmit_count failed");
+	fail_unless (0 == pgm_rxw_peek_state (peer->window, 9)->nak_transmit_count, "nak_transmit_count failed");
+	fail_unless (0 == pgm_rxw_peek_state (peer->window, 13)->nak_transmit_count, "nak_transmit_count failed");
+}
+END_TEST
+
+/* interleaved groups alternate in the back-off queue */
+START_TEST (test_nak_rb_state_pass_002)
+{
+	const uint32_t sequences[] = { 0, 1, 4, 5, 6 };
+	pgm_sock_t* sock = generate_sock();
+	sock->nak_rpt_ivl = TEST_NAK_RPT_IVL;
+	pgm_peer_t* peer = generate_peer();
+	peer->nla.ss_family = AF_INET;
+	peer->group_nla.ss_family = AF_INET;
+	peer->has_ondemand_parity = TRUE;
+	peer->window->mask = 31;
+	peer->window->pstate = g_new0 (pgm_rxw_state_t, 32);
+	peer->window->tg_sqn_shift = 2;
+	peer->window->tg_depth_shift = 1;
+	peer->window->lead = 20;
+	for (unsigned i = 0; i < G_N_ELEMENTS(sequences); i++) {
+		struct pgm_sk_buff_t* skb = pgm_alloc_skb (0);
+		skb->sequence = sequences[i];
+		pgm_rxw_peek_state (peer->window, sequences[i])->timer_expiry = 1;
+		pgm_queue_push_head_link (&peer->window->nak_backoff_queue, (pgm_list_t*)skb);
+	}
+	mock_nak_len = 0;
+	fail_unless (TRUE == nak_rb_state (sock, peer, 2), "nak_rb_state failed");
+/* even stripe #0,#4,#6 and odd stripe #1,#5 of block #0, count scaled by depth */
+	fail_unless (2 == mock_nak_len, "nak count failed");
+	fail_unless ((0 + (2 << 1)) == mock_nak_sqn[0], "nak_sqn failed");
+	fail_unless ((1 + (1 << 1)) == mock_nak_sqn[1], "nak_sqn failed");
+}
+END_TEST
+
+START_TEST (test_nak_rb_state_fail_001)
+{
+	nak_rb_state (NULL, NULL, mock_pgm_time_now);
+	fail ("reached");
+}
+END_TEST
+
 /* target:
  *	pgm_time_t
  *	pgm_min_receiver_expiry (
@@ -818,15 +1404,67 @@ make_test_suite (void)
 	tcase_add_test_raise_signal (tc_peer_unref, test_peer_unref_fail_001, SIGABRT);
 #endif
 
+	TCase* tc_skb_detach = tcase_create ("skb-detach");
+	suite_add_tcase (s, tc_skb_detach);
+	tcase_add_checked_fixture (tc_skb_detach, mock_setup, NULL);
+	tcase_add_test (tc_skb_detach, test_skb_detach_pass_001);
+	tcase_add_test (tc_skb_detach, test_skb_detach_fail_001);
+
+	TCase* tc_peer_set_pending = tcase_create ("peer-set-pending");
+	suite_add_tcase (s, tc_peer_set_pending);
+	tcase_add_checked_fixture (tc_peer_set_pending, mock_setup, NULL);
+	tcase_add_test (tc_peer_set_pending, test_peer_set_pending_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_peer_set_pending, test_peer_set_pending_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_flush_peers_pending = tcase_create ("flush-peers-pending");
+	suite_add_tcase (s, tc_flush_peers_pending);
+	tcase_add_checked_fixture (tc_flush_peers_pending, mock_setup, NULL);
+	tcase_add_test (tc_flush_peers_pending, test_flush_peers_pending_pass_001);
+	tcase_add_test (tc_flush_peers_pending, test_flush_peers_pending_pass_002);
+	tcase_add_test (tc_flush_peers_pending, test_flush_peers_pending_pass_003);
+	tcase_add_test (tc_flush_peers_pending, test_flush_peers_pending_pass_004);
+	tcase_add_test (tc_flush_peers_pending, test_flush_peers_pending_pass_005);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_flush_peers_pending, test_flush_peers_pending_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_peer_latency_percentile = tcase_create ("peer-latency-percentile");
+	suite_add_tcase (s, tc_peer_latency_percentile);
+	tcase_add_checked_fixture (tc_peer_latency_percentile, mock_setup, NULL);
+	tcase_add_test (tc_peer_latency_percentile, test_peer_latency_percentile_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_peer_latency_percentile, test_peer_latency_percentile_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_on_rxq_overflow = tcase_create ("on-rxq-overflow");
+	suite_add_tcase (s, tc_on_rxq_overflow);
+	tcase_add_checked_fixture (tc_on_rxq_overflow, mock_setup, NULL);
+	tcase_add_test (tc_on_rxq_overflow, test_on_rxq_overflow_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_on_rxq_overflow, test_on_rxq_overflow_fail_001, SIGABRT);
+#endif
+
 /* formally check-peer-nak-state */
 	TCase* tc_check_peer_state = tcase_create ("check-peer-state");
 	suite_add_tcase (s, tc_check_peer_state);
 	tcase_add_checked_fixture (tc_check_peer_state, mock_setup, NULL);
 	tcase_add_test (tc_check_peer_state, test_check_peer_state_pass_001);
+	tcase_add_test (tc_check_peer_state, test_check_peer_state_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_check_peer_state, test_check_peer_state_fail_001, SIGABRT);
 #endif
 
+	TCase* tc_nak_rb_state = tcase_create ("nak-rb-state");
+	suite_add_tcase (s, tc_nak_rb_state);
+	tcase_add_checked_fixture (tc_nak_rb_state, mock_setup, NULL);
+	tcase_add_test (tc_nak_rb_state, test_nak_rb_state_pass_001);
+	tcase_add_test (tc_nak_rb_state, test_nak_rb_state_pass_002);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_nak_rb_state, test_nak_rb_state_fail_001, SIGABRT);
+#endif
+
 /* formally min-nak-expiry */
 	TCase* tc_min_receiver_expiry = tcase_create ("min-receiver-expiry");
 	suite_add_tcase (s, tc_min_receiver_expiry);
@@ -46,6 +46,9 @@
 
 //#define RECV_DEBUG
 
+/* empty receives between clock reads when busy polling */
+#define PGM_BUSY_POLL_CLOCK_SPINS	16
+
 #ifndef RECV_DEBUG
 #	define PGM_DISABLE_ASSERT
 #endif
@@ -90,7 +93,8 @@ recvskb (
 	struct sockaddr*      const restrict src_addr,
 	const socklen_t			     src_addrlen,
 	struct sockaddr*      const restrict dst_addr,
-	const socklen_t			     dst_addrlen
+	const socklen_t			     dst_addrlen,
+	const pgm_time_t		     now		/* loop time */
 	)
 {
 /* pre-conditions */
@@ -153,20 +157,36 @@ recvskb (
 #endif
 
 	skb->sock		= sock;
-	skb->tstamp		= pgm_time_update_now();
+	skb->single_threaded	= sock->is_single_threaded;
+	skb->tstamp		= now;
 	skb->data		= skb->head;
 	skb->len		= (uint16_t)len;
 	skb->zero_padded	= 0;
 	skb->tail		= (char*)skb->data + len;
 
-	if (sock->udp_encap_ucast_port ||
-	    AF_INET6 == pgm_sockaddr_family (src_addr))
+	const bool has_dst_addr = (sock->udp_encap_ucast_port ||
+				   AF_INET6 == pgm_sockaddr_family (src_addr));
+	if (has_dst_addr || sock->use_rxq_ovfl)
 	{
 		struct pgm_cmsghdr* cmsg;
 		for (cmsg = PGM_CMSG_FIRSTHDR(&msg);
 		     cmsg != NULL;
 		     cmsg = PGM_CMSG_NXTHDR(&msg, cmsg))
 		{
+/* socket level messages precede IP level on Linux, ahead of the breaks below */
+#ifdef SO_RXQ_OVFL
+			if (SOL_SOCKET == cmsg->cmsg_level &&
+			    SO_RXQ_OVFL == cmsg->cmsg_type)
+			{
+				uint32_t counter;
+				memcpy (&counter, PGM_CMSG_DATA(cmsg), sizeof (counter));
+				pgm_on_rxq_overflow (sock, counter, now);
+				continue;
+			}
+#endif
+			if (!has_dst_addr)
+				continue;
+
 /* both IP_PKTINFO and IP_RECVDSTADDR exist on OpenSolaris, so capture
  * each type if defined.
  */
@@ -310,7 +330,7 @@ on_upstream (
 
 	return TRUE;
 out_discarded:
-	sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED]++;
+	pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_PACKETS_DISCARDED);
 	return FALSE;
 }
 
@@ -354,9 +374,9 @@ on_peer (
 	memcpy (&upstream_tsi.gsi, &skb->tsi.gsi, sizeof(pgm_gsi_t));
 	upstream_tsi.sport = skb->pgm_header->pgm_dport;
 
-	pgm_rwlock_reader_lock (&sock->peers_lock);
+	pgm_sock_reader_lock (sock, &sock->peers_lock);
 	*source = pgm_hashtable_lookup (sock->peers_hashtable, &upstream_tsi);
-	pgm_rwlock_reader_unlock (&sock->peers_lock);
+	pgm_sock_reader_unlock (sock, &sock->peers_lock);
 	if (PGM_UNLIKELY(NULL == *source)) {
 /* this source is unknown, we don't care about messages about it */
 		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded peer packet about new source."));
@@ -390,7 +410,7 @@ out_discarded:
 	if (*source)
 		(*source)->cumulative_stats[PGM_PC_RECEIVER_PACKETS_DISCARDED]++;
 	else if (sock->can_send_data)
-		sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED]++;
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_PACKETS_DISCARDED);
 	return FALSE;
 }
 
@@ -443,9 +463,9 @@ on_downstream (
 	}
 	else
 	{
-		pgm_rwlock_reader_lock (&sock->peers_lock);
+		pgm_sock_reader_lock (sock, &sock->peers_lock);
 		*source = pgm_hashtable_lookup_extended (sock->peers_hashtable, &skb->tsi, &sock->last_hash_key);
-		pgm_rwlock_reader_unlock (&sock->peers_lock);
+		pgm_sock_reader_unlock (sock, &sock->peers_lock);
 		if (PGM_UNLIKELY(NULL == *source)) {
 			*source = pgm_new_peer (sock,
 					       &skb->tsi,
@@ -466,9 +486,23 @@ on_downstream (
 	switch (skb->pgm_header->pgm_type) {
 	case PGM_ODATA:
 	case PGM_RDATA:
+/* small packets are optionally copied out so the receive buffer is
+ * recycled, FEC needs the tailroom of a full TPDU for zero padding.
+ */
+		if (sock->use_compact_recv &&
+		    skb->len <= PGM_SKB_COMPACT_SIZE &&
+		    !(*source)->is_fec_enabled)
+		{
+			struct pgm_sk_buff_t* compact_skb = pgm_skb_compact (skb);
+			if (PGM_UNLIKELY(!pgm_on_data (sock, *source, compact_skb))) {
+				pgm_free_skb (compact_skb);
+				goto out_discarded;
+			}
+			break;
+		}
 		if (PGM_UNLIKELY(!pgm_on_data (sock, *source, skb)))
 			goto out_discarded;
-		sock->rx_buffer = pgm_alloc_skb (sock->max_tpdu);
+		sock->rx_buffer = pgm_arena_alloc_skb (sock->rx_arena, sock->max_tpdu);
 		break;
 
 	case PGM_NCF:
@@ -502,7 +536,7 @@ out_discarded:
 	if (*source)
 		(*source)->cumulative_stats[PGM_PC_RECEIVER_PACKETS_DISCARDED]++;
 	else if (sock->can_send_data)
-		sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED]++;
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_PACKETS_DISCARDED);
 	return FALSE;
 }
 
@@ -550,10 +584,89 @@ on_pgm (
 
 	pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded unknown PGM packet."));
 	if (sock->can_send_data)
-		sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED]++;
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_PACKETS_DISCARDED);
 	return FALSE;
 }
 
+/* repair side of a source whilst holding sock::receiver-mutex, schedules the
+ * pro-active parity of blocks completed by the send path then sends one queued
+ * repair.  the repair wake is cleared before reading the completed blocks so a
+ * block completing concurrently raises it again.
+ *
+ * returns FALSE if the repair would block.
+ */
+
+static
+bool
+on_repairs (
+	pgm_sock_t* const	sock,
+	const pgm_time_t	now
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (sock->can_send_data);
+
+	if (pgm_txw_retransmit_is_empty (sock->window))
+		pgm_notify_clear (&sock->rdata_notify);
+	if (sock->use_proactive_parity)
+		pgm_on_proactive_nak (sock);
+	if (pgm_txw_retransmit_is_empty (sock->window))
+		return TRUE;
+	return pgm_on_deferred_nak (sock, now);
+}
+
+/* spin on receiving socket whilst holding sock::receiver-mutex, the clock is
+ * only read every PGM_BUSY_POLL_CLOCK_SPINS empty receives to update the loop
+ * time and check the timers and the spin budget.
+ *
+ * returns EAGAIN to receive again, returns EINTR for waiting timer event,
+ * returns ETIMEDOUT on spent budget, and returns ENOENT on closed sock.
+ */
+
+static
+int
+busy_poll_for_event (
+	pgm_sock_t* const	sock,
+	pgm_time_t* const	expiry,		/* in: 0 to start spinning */
+	unsigned*   const	spins,
+	pgm_time_t* const	now		/* in/out: loop time */
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (NULL != expiry);
+	pgm_assert (NULL != spins);
+	pgm_assert (NULL != now);
+	pgm_assert (sock->busy_poll_budget > 0);
+
+	if (PGM_UNLIKELY(sock->is_destroyed))
+		return ENOENT;
+
+	if (PGM_LIKELY(0 != *expiry && 0 != (++(*spins) % PGM_BUSY_POLL_CLOCK_SPINS))) {
+		sock->busy_poll_stats.spins++;
+		return EAGAIN;
+	}
+
+	*now = pgm_time_update_now();
+	if (0 == *expiry)
+		*expiry = *now + pgm_usecs (sock->busy_poll_budget);
+
+	if (sock->can_send_data)
+		on_repairs (sock, *now);
+
+	if (pgm_timer_check (sock, *now))
+		return EINTR;
+
+	if (pgm_time_after_eq (*now, *expiry)) {
+		sock->busy_poll_stats.idles++;
+		return ETIMEDOUT;
+	}
+
+	sock->busy_poll_stats.spins++;
+	return EAGAIN;
+}
+
 /* block on receiving socket whilst holding sock::waiting-mutex
  * returns EAGAIN for waiting data, returns EINTR for waiting timer event,
  * returns ENOENT on closed sock, and returns EFAULT for libc error.
@@ -565,8 +678,6 @@ wait_for_event (
 	pgm_sock_t* const	sock
 	)
 {
-	int n_fds = 3;
-
 /* pre-conditions */
 	pgm_assert (NULL != sock);
 
@@ -576,10 +687,12 @@ wait_for_event (
 		if (PGM_UNLIKELY(sock->is_destroyed))
 			return ENOENT;
 
-		if (sock->can_send_data && !pgm_txw_retransmit_is_empty (sock->window))
 /* tight loop on blocked send */
-			pgm_on_deferred_nak (sock);
+		if (sock->can_send_data)
+			on_repairs (sock, pgm_time_update_now());
 
+/* reset each pass, the count is rewritten below */
+		int n_fds = 4;
 #ifdef HAVE_POLL
 		struct pollfd fds[ n_fds ];
 		memset (fds, 0, sizeof(fds));
@@ -592,6 +705,14 @@ wait_for_event (
 		pgm_assert (-1 != status);
 #endif /* HAVE_POLL */
 
+#ifdef HAVE_TIMERFD_CREATE
+/* the wait below has a precise timeout, an expired timer socket, possibly
+ * inside the readiness socket, would otherwise end the wait immediately.
+ */
+		if (sock->use_timer_sock)
+			pgm_timer_sock_disarm (sock);
+#endif
+
 /* flush any waiting notifications */
 		if (sock->is_pending_read) {
 			pgm_notify_clear (&sock->pending_notify);
@@ -604,7 +725,14 @@ wait_for_event (
 		else
 			timeout = (int)pgm_timer_expiration (sock);
 		
-#ifdef HAVE_POLL
+#if defined(HAVE_POLL) && defined(HAVE_PPOLL)
+/* poll() would round sub-millisecond timers to 0 or 1ms */
+		const struct timespec ts_timeout = {
+			.tv_sec		= timeout / 1000000L,
+			.tv_nsec	= (timeout % 1000000L) * 1000L
+		};
+		const int ready = ppoll (fds, n_fds, &ts_timeout, NULL);
+#elif defined(HAVE_POLL)
 		const int ready = poll (fds, n_fds, timeout /* μs */ / 1000 /* to ms */);
 #else
 		struct timeval tv_timeout = {
@@ -620,7 +748,8 @@ wait_for_event (
 			pgm_debug ("recv again on empty");
 			return EAGAIN;
 		}
-	} while (pgm_timer_check (sock));
+/* time has passed whilst waiting, read the clock */
+	} while (pgm_timer_check (sock, pgm_time_update_now()));
 	pgm_debug ("state generated event");
 	return EINTR;
 }
@@ -642,8 +771,9 @@ wait_for_event (
  * closed, returns PGM_IO_STATUS_EOF.  On error, returns PGM_IO_STATUS_ERROR.
  */
 
+static
 int
-pgm_recvmsgv (
+recvmsgv (
 	pgm_sock_t*   	   const restrict sock,
 	struct pgm_msgv_t* const restrict msg_start,
 	const size_t			  msg_len,
@@ -654,21 +784,14 @@ pgm_recvmsgv (
 {
 	int status = PGM_IO_STATUS_WOULD_BLOCK;
 
-	pgm_debug ("pgm_recvmsgv (sock:%p msg-start:%p msg-len:%" PRIzu " flags:%d bytes-read:%p error:%p)",
-		(void*)sock, (void*)msg_start, msg_len, flags, (void*)_bytes_read, (void*)error);
-
-/* parameters */
-	pgm_return_val_if_fail (NULL != sock, PGM_IO_STATUS_ERROR);
-	if (PGM_LIKELY(msg_len)) pgm_return_val_if_fail (NULL != msg_start, PGM_IO_STATUS_ERROR);
-
 /* shutdown */
-	if (PGM_UNLIKELY(!pgm_rwlock_reader_trylock (&sock->lock)))
+	if (PGM_UNLIKELY(!pgm_sock_reader_trylock (sock, &sock->lock)))
 		pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
 
 /* state */
 	if (PGM_UNLIKELY(!sock->is_bound || sock->is_destroyed))
 	{
-		pgm_rwlock_reader_unlock (&sock->lock);
+		pgm_sock_reader_unlock (sock, &sock->lock);
 		pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
 	}
 
@@ -682,7 +805,7 @@ pgm_recvmsgv (
 	}
 
 /* receiver */
-	pgm_mutex_lock (&sock->receiver_mutex);
+	pgm_sock_mutex_lock (sock, &sock->receiver_mutex);
 
 	if (PGM_UNLIKELY(sock->is_reset)) {
 		pgm_assert (NULL != sock->peers_pending);
@@ -701,37 +824,42 @@ pgm_recvmsgv (
 		}
 		if (!sock->is_abort_on_reset)
 			sock->is_reset = !sock->is_reset;
-		pgm_mutex_unlock (&sock->receiver_mutex);
-		pgm_rwlock_reader_unlock (&sock->lock);
+		pgm_sock_mutex_unlock (sock, &sock->receiver_mutex);
+		pgm_sock_reader_unlock (sock, &sock->lock);
 		return PGM_IO_STATUS_RESET;
 	}
 
+/* one clock read for the receive batch, refreshed after waiting */
+	pgm_time_t now = pgm_time_update_now();
+
 /* timer status */
-	if (pgm_timer_check (sock) &&
-	    !pgm_timer_dispatch (sock))
+	if (pgm_timer_check (sock, now) &&
+	    !pgm_timer_dispatch (sock, now))
 	{
 /* block on send-in-recv */
 		status = PGM_IO_STATUS_RATE_LIMITED;
 	}
 /* NAK status */
-	else if (sock->can_send_data)
+	else if (sock->can_send_data &&
+		 !on_repairs (sock, now))
 	{
-		if (!pgm_txw_retransmit_is_empty (sock->window))
-		{
-			if (!pgm_on_deferred_nak (sock))
-				status = PGM_IO_STATUS_RATE_LIMITED;
-		}
-		else
-			pgm_notify_clear (&sock->rdata_notify);
+		status = PGM_IO_STATUS_RATE_LIMITED;
 	}
 
 	size_t bytes_read = 0;
 	unsigned data_read = 0;
 	struct pgm_msgv_t* pmsg = msg_start;
 	const struct pgm_msgv_t* msg_end = msg_start + msg_len - 1;
+	pgm_time_t busy_poll_expiry = 0;
+	unsigned busy_poll_spins = 0;
 
 	if (PGM_UNLIKELY(0 == ++(sock->last_commit)))
 		++(sock->last_commit);
+	sock->delivery_count = 0;
+
+/* commit parity reconstructed by worker threads */
+	if (sock->fec_pool)
+		pgm_flush_peers_reconstructed (sock);
 
 	/* second, flush any remaining contiguous messages from previous call(s) */
 	if (sock->peers_pending) {
@@ -756,7 +884,8 @@ recv_again:
 		       (struct sockaddr*)&src,
 		       sizeof(src),
 		       (struct sockaddr*)&dst,
-		       sizeof(dst));
+		       sizeof(dst),
+		       now);
 	if (len < 0)
 	{
 		const int save_errno = pgm_get_last_sock_error();
@@ -784,9 +913,12 @@ recv_again:
 	}
 
 	pgm_error_t* err = NULL;
+/* raw IPv6 delivers PGM without UDP header and hence no UDP checksum */
+	const unsigned parse_flags = (sock->use_deferred_csum ? PGM_PARSE_DEFER_CSUM : 0) |
+				     ((sock->use_udp_csum && sock->udp_encap_ucast_port) ? PGM_PARSE_NO_CSUM : 0);
 	const bool is_valid = (sock->udp_encap_ucast_port || AF_INET6 == src.ss_family) ?
-					pgm_parse_udp_encap (sock->rx_buffer, &err) :
-					pgm_parse_raw (sock->rx_buffer, (struct sockaddr*)&dst, &err);
+					pgm_parse_udp_encap (sock->rx_buffer, parse_flags, &err) :
+					pgm_parse_raw (sock->rx_buffer, (struct sockaddr*)&dst, parse_flags, &err);
 	if (PGM_UNLIKELY(!is_valid))
 	{
 /* inherently cannot determine PGM_PC_RECEIVER_CKSUM_ERRORS unless only one receiver */
@@ -796,12 +928,18 @@ recv_again:
 		pgm_error_free (err);
 		if (sock->can_send_data) {
 			if (err && PGM_ERROR_CKSUM == err->code)
-				sock->cumulative_stats[PGM_PC_SOURCE_CKSUM_ERRORS]++;
-			sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED]++;
+				pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_CKSUM_ERRORS);
+			pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_PACKETS_DISCARDED);
 		}
 		goto recv_again;
 	}
 
+/* unwanted sources never create peer, window or NAK state */
+	if (sock->is_filtering && !pgm_filter_accept (sock, sock->rx_buffer)) {
+		sock->filtered_packets++;
+		goto recv_again;
+	}
+
 	pgm_peer_t* source = NULL;
 	if (PGM_UNLIKELY(!on_pgm (sock, sock->rx_buffer, (struct sockaddr*)&src, (struct sockaddr*)&dst, &source)))
 		goto recv_again;
@@ -824,6 +962,39 @@ flush_pending:
 	}
 
 check_for_repeat:
+/* transmission groups decoded whilst receiving */
+	if (sock->fec_pool && pgm_fec_pool_has_completed (sock->fec_pool)) {
+		pgm_flush_peers_reconstructed (sock);
+		if (sock->peers_pending)
+			goto flush_pending;
+	}
+
+/* spin if empty, i.e. no data or non-data packet, until the budget is spent */
+	if (sock->busy_poll_budget && 0 == data_read)
+	{
+		switch (busy_poll_for_event (sock, &busy_poll_expiry, &busy_poll_spins, &now)) {
+		case EAGAIN:
+			goto recv_again;
+		case EINTR:
+			if (!pgm_timer_dispatch (sock, now))
+				goto check_for_repeat;
+			goto flush_pending;
+		case ENOENT:
+			pgm_sock_mutex_unlock (sock, &sock->receiver_mutex);
+			pgm_sock_reader_unlock (sock, &sock->lock);
+			return PGM_IO_STATUS_EOF;
+		case ETIMEDOUT:
+			if (sock->is_nonblocking || flags & MSG_DONTWAIT)
+				goto out;
+/* restart spinning after the next wake */
+			busy_poll_expiry = 0;
+			busy_poll_spins = 0;
+			break;
+		default:
+			pgm_assert_not_reached();
+		}
+	}
+
 /* repeat if non-blocking and not full */
 	if (sock->is_nonblocking ||
 	    flags & MSG_DONTWAIT)
@@ -839,16 +1010,17 @@ check_for_repeat:
  */
 		if (0 == data_read) {
 			const int wait_status = wait_for_event (sock);
+			now = pgm_time_update_now();
 			switch (wait_status) {
 			case EAGAIN:
 				goto recv_again;
 			case EINTR:
-				if (!pgm_timer_dispatch (sock))
+				if (!pgm_timer_dispatch (sock, now))
 					goto check_for_repeat;
 				goto flush_pending;
 			case ENOENT:
-				pgm_mutex_unlock (&sock->receiver_mutex);
-				pgm_rwlock_reader_unlock (&sock->lock);
+				pgm_sock_mutex_unlock (sock, &sock->receiver_mutex);
+				pgm_sock_reader_unlock (sock, &sock->lock);
 				return PGM_IO_STATUS_EOF;
 			case EFAULT: {
 				const int save_errno = pgm_get_last_sock_error();
@@ -859,8 +1031,8 @@ check_for_repeat:
 						_("Waiting for event: %s"),
 						pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno)
 						);
-				pgm_mutex_unlock (&sock->receiver_mutex);
-				pgm_rwlock_reader_unlock (&sock->lock);
+				pgm_sock_mutex_unlock (sock, &sock->receiver_mutex);
+				pgm_sock_reader_unlock (sock, &sock->lock);
 				return PGM_IO_STATUS_ERROR;
 			}
 			default:
@@ -870,6 +1042,9 @@ check_for_repeat:
 	}
 
 out:
+	if (busy_poll_expiry && data_read)
+		sock->busy_poll_stats.hits++;
+
 	if (0 == data_read)
 	{
 /* clear event notification */
@@ -877,6 +1052,11 @@ out:
 			pgm_notify_clear (&sock->pending_notify);
 			sock->is_pending_read = FALSE;
 		}
+#ifdef HAVE_TIMERFD_CREATE
+/* caller is about to wait, wake at next timer expiration */
+		if (sock->use_timer_sock)
+			pgm_timer_sock_arm (sock);
+#endif
 /* report data loss */
 		if (PGM_UNLIKELY(sock->is_reset)) {
 			pgm_assert (NULL != sock->peers_pending);
@@ -895,12 +1075,12 @@ out:
 			}
 			if (!sock->is_abort_on_reset)
 				sock->is_reset = !sock->is_reset;
-			pgm_mutex_unlock (&sock->receiver_mutex);
-			pgm_rwlock_reader_unlock (&sock->lock);
+			pgm_sock_mutex_unlock (sock, &sock->receiver_mutex);
+			pgm_sock_reader_unlock (sock, &sock->lock);
 			return PGM_IO_STATUS_RESET;
 		}
-		pgm_mutex_unlock (&sock->receiver_mutex);
-		pgm_rwlock_reader_unlock (&sock->lock);
+		pgm_sock_mutex_unlock (sock, &sock->receiver_mutex);
+		pgm_sock_reader_unlock (sock, &sock->lock);
 		if (PGM_IO_STATUS_WOULD_BLOCK == status &&
 		    ( sock->can_send_data ||
 		      ( sock->can_recv_data && NULL != sock->peers_list )))
@@ -929,11 +1109,43 @@ out:
 
 	if (NULL != _bytes_read)
 		*_bytes_read = bytes_read;
-	pgm_mutex_unlock (&sock->receiver_mutex);
-	pgm_rwlock_reader_unlock (&sock->lock);
+	pgm_sock_mutex_unlock (sock, &sock->receiver_mutex);
+	pgm_sock_reader_unlock (sock, &sock->lock);
 	return PGM_IO_STATUS_NORMAL;
 }
 
+/* pull receive, refused whilst a receive callback is set as delivery would
+ * bypass the message vector.
+ */
+
+int
+pgm_recvmsgv (
+	pgm_sock_t*   	   const restrict sock,
+	struct pgm_msgv_t* const restrict msg_start,
+	const size_t			  msg_len,
+	const int			  flags,	/* MSG_DONTWAIT for non-blocking */
+	size_t*			 restrict _bytes_read,	/* may be NULL */
+	pgm_error_t**		 restrict error
+	)
+{
+	pgm_debug ("pgm_recvmsgv (sock:%p msg-start:%p msg-len:%" PRIzu " flags:%d bytes-read:%p error:%p)",
+		(void*)sock, (void*)msg_start, msg_len, flags, (void*)_bytes_read, (void*)error);
+
+/* parameters */
+	pgm_return_val_if_fail (NULL != sock, PGM_IO_STATUS_ERROR);
+	if (PGM_LIKELY(msg_len)) pgm_return_val_if_fail (NULL != msg_start, PGM_IO_STATUS_ERROR);
+
+	if (PGM_UNLIKELY(NULL != sock->recv_callback.callback)) {
+		pgm_set_error (error,
+			     PGM_ERROR_DOMAIN_RECV,
+			     PGM_ERROR_INVAL,
+			     _("Receive callback is set, use pgm_recv_dispatch()."));
+		return PGM_IO_STATUS_ERROR;
+	}
+
+	return recvmsgv (sock, msg_start, msg_len, flags, _bytes_read, error);
+}
+
 /* read one contiguous apdu and return as a IO scatter/gather array.  msgv is owned by
  * the caller, tpdu contents are owned by the receive window.
  *
@@ -958,6 +1170,35 @@ pgm_recvmsg (
 	return pgm_recvmsgv (sock, msgv, 1, flags, bytes_read, error);
 }
 
+/* run the receive loop delivering every available APDU to the callback set
+ * with PGM_RECV_CALLBACK, without a message vector bounding each call.  the
+ * callback runs with the socket receive lock held and must not call back into
+ * receive functions on the same socket, buffers may be kept with
+ * pgm_skb_detach() before returning.
+ *
+ * returns as pgm_recvmsgv(), bytes_read is the total delivered.
+ */
+
+int
+pgm_recv_dispatch (
+	pgm_sock_t* const restrict sock,
+	const int		   flags,	/* MSG_DONTWAIT for non-blocking */
+	size_t*		  restrict bytes_read,	/* may be NULL */
+	pgm_error_t**	  restrict error
+	)
+{
+	struct pgm_msgv_t msgv;
+
+	pgm_return_val_if_fail (NULL != sock, PGM_IO_STATUS_ERROR);
+	pgm_return_val_if_fail (NULL != sock->recv_callback.callback, PGM_IO_STATUS_ERROR);
+
+	pgm_debug ("pgm_recv_dispatch (sock:%p flags:%d bytes_read:%p error:%p)",
+		(const void*)sock, flags, (const void*)bytes_read, (const void*)error);
+
+/* vector is never written when a callback is set */
+	return recvmsgv (sock, &msgv, 1, flags & ~(MSG_ERRQUEUE), bytes_read, error);
+}
+
 /* vanilla read function.  copies from the receive window to the provided buffer
  * location.  the caller must provide an adequately sized buffer to store the largest
  * expected apdu or else it will be truncated.
@@ -78,6 +78,7 @@ struct pgm_peer_t;
 
 GList* mock_recvmsg_list = NULL;
 static int mock_pgm_type = -1;
+static struct pgm_sk_buff_t* mock_data_skb = NULL;
 static gboolean mock_reset_on_spmr = FALSE;
 static gboolean mock_data_on_spmr = FALSE;
 static struct pgm_peer_t* mock_peer = NULL;
@@ -100,6 +101,7 @@ static int mock_recvfrom (SOCKET, char*, int, int, struct sockaddr*, int*);
 #define pgm_poll_info			mock_pgm_poll_info
 #define pgm_set_reset_error		mock_pgm_set_reset_error
 #define pgm_flush_peers_pending		mock_pgm_flush_peers_pending
+#define pgm_flush_peers_reconstructed	mock_pgm_flush_peers_reconstructed
 #define pgm_peer_has_pending		mock_pgm_peer_has_pending
 #define pgm_peer_set_pending		mock_pgm_peer_set_pending
 #define pgm_txw_retransmit_is_empty	mock_pgm_txw_retransmit_is_empty
@@ -111,6 +113,7 @@ static int mock_recvfrom (SOCKET, char*, int, int, struct sockaddr*, int*);
 #define pgm_on_ack			mock_pgm_on_ack
 #define pgm_on_nak			mock_pgm_on_nak
 #define pgm_on_deferred_nak		mock_pgm_on_deferred_nak
+#define pgm_on_proactive_nak		mock_pgm_on_proactive_nak
 #define pgm_on_peer_nak			mock_pgm_on_peer_nak
 #define pgm_on_nnak			mock_pgm_on_nnak
 #define pgm_on_ncf			mock_pgm_on_ncf
@@ -120,6 +123,8 @@ static int mock_recvfrom (SOCKET, char*, int, int, struct sockaddr*, int*);
 #define pgm_timer_check			mock_pgm_timer_check
 #define pgm_timer_expiration		mock_pgm_timer_expiration
 #define pgm_timer_dispatch		mock_pgm_timer_dispatch
+#define pgm_timer_sock_arm		mock_pgm_timer_sock_arm
+#define pgm_timer_sock_disarm		mock_pgm_timer_sock_disarm
 #define pgm_time_now			mock_pgm_time_now
 #define pgm_time_update_now		mock_pgm_time_update_now
 #define recvmsg				mock_recvmsg
@@ -131,7 +136,7 @@ static int mock_recvfrom (SOCKET, char*, int, int, struct sockaddr*, int*);
 #include "recv.c"
 
 
-pgm_rxw_t* mock_pgm_rxw_create (const pgm_tsi_t*, const uint16_t, const unsigned, const unsigned, const ssize_t, const uint32_t);
+pgm_rxw_t* mock_pgm_rxw_create (const pgm_tsi_t*, const uint16_t, const unsigned, const unsigned, const ssize_t, const uint32_t, pgm_arena_t*, pgm_heap_t*);
 static pgm_time_t _mock_pgm_time_update_now (void);
 pgm_time_update_func mock_pgm_time_update_now = _mock_pgm_time_update_now;
 
@@ -560,6 +565,7 @@ bool
 mock_pgm_parse_raw (
 	struct pgm_sk_buff_t* const	skb,
 	struct sockaddr* const		dst,
+	const unsigned			flags,
 	pgm_error_t**			error
 	)
 {
@@ -579,6 +585,7 @@ mock_pgm_parse_raw (
 bool
 mock_pgm_parse_udp_encap (
 	struct pgm_sk_buff_t* const	skb,
+	const unsigned			flags,
 	pgm_error_t**			error
 	)
 {
@@ -668,7 +675,9 @@ mock_pgm_new_peer (
 					    sock->rxw_sqns,
 					    sock->rxw_secs,
 					    sock->rxw_max_rte,
-					    sock->ack_c_p);
+					    sock->ack_c_p,
+					    sock->rx_arena,
+					    sock->heap);
 	peer->spmr_expiry = now + sock->spmr_expiry;
 	gpointer entry = mock__pgm_peer_ref(peer);
 	pgm_hashtable_insert (sock->peers_hashtable, &peer->tsi, entry);
@@ -690,6 +699,14 @@ mock_pgm_set_reset_error (
 {
 }
 
+PGM_GNUC_INTERNAL
+void
+mock_pgm_flush_peers_reconstructed (
+	pgm_sock_t* const		sock
+	)
+{
+}
+
 PGM_GNUC_INTERNAL
 int
 mock_pgm_flush_peers_pending (
@@ -757,6 +774,7 @@ mock_pgm_on_data (
 	g_debug ("mock_pgm_on_data (sock:%p sender:%p skb:%p)",
 		(gpointer)sock, (gpointer)sender, (gpointer)skb);
 	mock_pgm_type = PGM_ODATA;
+	mock_data_skb = skb;
 	((pgm_rxw_t*)sender->window)->has_event = 1;
 	return TRUE;
 }
@@ -777,12 +795,21 @@ mock_pgm_on_ack (
 PGM_GNUC_INTERNAL
 bool
 mock_pgm_on_deferred_nak (
-	pgm_sock_t* const		sock
+	pgm_sock_t* const		sock,
+	const pgm_time_t		now
 	)
 {
 	return TRUE;
 }
 
+PGM_GNUC_INTERNAL
+void
+mock_pgm_on_proactive_nak (
+	pgm_sock_t* const		sock
+	)
+{
+}
+
 PGM_GNUC_INTERNAL
 bool
 mock_pgm_on_nak (
@@ -890,7 +917,9 @@ mock_pgm_rxw_create (
 	const unsigned		sqns,
 	const unsigned		secs,
 	const ssize_t		max_rte,
-	const uint32_t		ack_c_p
+	const uint32_t		ack_c_p,
+	pgm_arena_t*		arena,
+	pgm_heap_t*		heap
 	)
 {
 	return g_new0 (pgm_rxw_t, 1);
@@ -935,7 +964,8 @@ mock_pgm_timer_prepare (
 PGM_GNUC_INTERNAL
 bool
 mock_pgm_timer_check (
-	pgm_sock_t* const		sock
+	pgm_sock_t* const		sock,
+	const pgm_time_t		now
 	)
 {
 	return FALSE;
@@ -953,12 +983,29 @@ mock_pgm_timer_expiration (
 PGM_GNUC_INTERNAL
 bool
 mock_pgm_timer_dispatch (
-	pgm_sock_t* const		sock
+	pgm_sock_t* const		sock,
+	const pgm_time_t		now
 	)
 {
 	return TRUE;
 }
 
+PGM_GNUC_INTERNAL
+void
+mock_pgm_timer_sock_arm (
+	pgm_sock_t* const		sock
+	)
+{
+}
+
+PGM_GNUC_INTERNAL
+void
+mock_pgm_timer_sock_disarm (
+	pgm_sock_t* const		sock
+	)
+{
+}
+
 /** time module */
 static pgm_time_t mock_pgm_time_now = 0x1;
 
@@ -1168,6 +1215,30 @@ START_TEST (test_data_pass_001)
 	pgm_error_t* err = NULL;
 	fail_unless (PGM_IO_STATUS_TIMER_PENDING == pgm_recv (sock, buffer, sizeof(buffer), MSG_DONTWAIT, &bytes_read, &err), "recv failed");
 	fail_unless (PGM_ODATA == mock_pgm_type, "unexpected PGM packet");
+/* receive buffer passed on by default */
+	fail_unless (mock_data_skb->truesize >= TEST_MAX_TPDU, "data compacted");
+}
+END_TEST
+
+/* recv -> on_data, small packet copied out */
+START_TEST (test_data_pass_002)
+{
+	const char source[] = "i am not a string";
+	pgm_sock_t* sock = generate_sock();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->use_compact_recv = TRUE;
+	guint8 buffer[ TEST_TXW_SQNS * TEST_MAX_TPDU ];
+	gpointer packet; gsize packet_len;
+	generate_odata (source, sizeof(source), 0 /* sqn */, -1 /* trail */, &packet, &packet_len);
+	generate_msghdr (packet, packet_len);
+	push_block_event ();
+	struct pgm_sk_buff_t* rx_buffer = sock->rx_buffer;
+	gsize bytes_read;
+	pgm_error_t* err = NULL;
+	fail_unless (PGM_IO_STATUS_TIMER_PENDING == pgm_recv (sock, buffer, sizeof(buffer), MSG_DONTWAIT, &bytes_read, &err), "recv failed");
+	fail_unless (PGM_ODATA == mock_pgm_type, "unexpected PGM packet");
+	fail_unless (mock_data_skb->truesize < TEST_MAX_TPDU, "data not compacted");
+	fail_unless (rx_buffer == sock->rx_buffer, "receive buffer not recycled");
 }
 END_TEST
 
@@ -1576,6 +1647,36 @@ START_TEST (test_recv_fail_001)
 }
 END_TEST
 
+static
+int
+mock_recv_callback (
+	const pgm_tsi_t*	tsi,
+	struct pgm_sk_buff_t**	skbs,
+	const unsigned		skb_len,
+	const size_t		apdu_len,
+	void*			user_data
+	)
+{
+	return 0;
+}
+
+/* pull receive with a callback set, data is left for pgm_recv_dispatch() */
+START_TEST (test_recv_fail_002)
+{
+	pgm_error_t* err = NULL;
+	guint8 buffer[ TEST_TXW_SQNS * TEST_MAX_TPDU ];
+	size_t bytes_read = 0;
+	pgm_sock_t* sock = generate_sock();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->recv_callback.callback = mock_recv_callback;
+	push_block_event ();
+	fail_unless (PGM_IO_STATUS_ERROR == pgm_recv (sock, buffer, sizeof(buffer), MSG_DONTWAIT, &bytes_read, &err), "recv failed");
+	fail_if (NULL == err, "error not raised");
+	fail_unless (0 == bytes_read, "bytes read");
+	pgm_error_free (err);
+}
+END_TEST
+
 /* target:
  *	int
  *	pgm_recvfrom (
@@ -1636,6 +1737,31 @@ START_TEST (test_recvmsgv_fail_001)
 }
 END_TEST
 
+/* target:
+ *	int
+ *	pgm_recv_dispatch (
+ *		pgm_sock_t*		sock,
+ *		int			flags,
+ *		size_t*			bytes_read,
+ *		pgm_error_t**		error
+ *		)
+ */
+
+START_TEST (test_recv_dispatch_fail_001)
+{
+	fail_unless (PGM_IO_STATUS_ERROR == pgm_recv_dispatch (NULL, 0, NULL, NULL), "recv_dispatch failed");
+}
+END_TEST
+
+/* no callback registered */
+START_TEST (test_recv_dispatch_fail_002)
+{
+	pgm_sock_t* sock = generate_sock();
+	fail_if (NULL == sock, "generate_sock failed");
+	fail_unless (PGM_IO_STATUS_ERROR == pgm_recv_dispatch (sock, 0, NULL, NULL), "recv_dispatch failed");
+}
+END_TEST
+
 
 static
 Suite*
@@ -1654,6 +1780,7 @@ make_test_suite (void)
 	suite_add_tcase (s, tc_data);
 	tcase_add_checked_fixture (tc_data, mock_setup, mock_teardown);
 	tcase_add_test (tc_data, test_data_pass_001);
+	tcase_add_test (tc_data, test_data_pass_002);
 
 	TCase* tc_spm = tcase_create ("spm");
 	suite_add_tcase (s, tc_spm);
@@ -1729,6 +1856,7 @@ make_test_suite (void)
 	suite_add_tcase (s, tc_recv);
 	tcase_add_checked_fixture (tc_recv, mock_setup, mock_teardown);
 	tcase_add_test (tc_recv, test_recv_fail_001);
+	tcase_add_test (tc_recv, test_recv_fail_002);
 
 	TCase* tc_recvfrom = tcase_create ("recvfrom");
 	suite_add_tcase (s, tc_recvfrom);
@@ -1745,6 +1873,12 @@ make_test_suite (void)
 	tcase_add_checked_fixture (tc_recvmsgv, mock_setup, mock_teardown);
 	tcase_add_test (tc_recvmsgv, test_recvmsgv_fail_001);
 
+	TCase* tc_recv_dispatch = tcase_create ("recv-dispatch");
+	suite_add_tcase (s, tc_recv_dispatch);
+	tcase_add_checked_fixture (tc_recv_dispatch, mock_setup, mock_teardown);
+	tcase_add_test (tc_recv_dispatch, test_recv_dispatch_fail_001);
+	tcase_add_test (tc_recv_dispatch, test_recv_dispatch_fail_002);
+
 	return s;
 }
 
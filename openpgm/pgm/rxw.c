@@ -56,13 +56,13 @@ _pgm_tsi_is_null (
 	return (0 == u->l[0] && 0 == u->l[1]);
 }
 
-/* sequence state must be smaller than PGM skbuff control buffer */
-PGM_STATIC_ASSERT(sizeof(struct pgm_rxw_state_t) <= sizeof(((struct pgm_sk_buff_t*)0)->cb));
 
 static void _pgm_rxw_define (pgm_rxw_t*const, const uint32_t);
 static void _pgm_rxw_update_trail (pgm_rxw_t*const, const uint32_t);
 static inline uint32_t _pgm_rxw_update_lead (pgm_rxw_t*const, const uint32_t, const pgm_time_t, const pgm_time_t);
 static inline uint32_t _pgm_rxw_tg_sqn (pgm_rxw_t*const, const uint32_t);
+static inline uint32_t _pgm_rxw_tg_block (pgm_rxw_t*const, const uint32_t);
+static inline uint32_t _pgm_rxw_tg_member (pgm_rxw_t*const, const uint32_t, const uint32_t);
 static inline uint32_t _pgm_rxw_pkt_sqn (pgm_rxw_t*const, const uint32_t);
 static inline bool _pgm_rxw_is_first_of_tg_sqn (pgm_rxw_t*const, const uint32_t);
 static inline bool _pgm_rxw_is_last_of_tg_sqn (pgm_rxw_t*const, const uint32_t);
@@ -72,10 +72,15 @@ static int _pgm_rxw_add_placeholder_range (pgm_rxw_t*const, const uint32_t, cons
 static void _pgm_rxw_unlink (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict);
 static uint32_t _pgm_rxw_remove_trail (pgm_rxw_t*const);
 static void _pgm_rxw_state (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict, const int);
-static inline void _pgm_rxw_shuffle_parity (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict);
+static inline struct pgm_sk_buff_t* _pgm_rxw_shuffle_parity (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict);
 static inline ssize_t _pgm_rxw_incoming_read (pgm_rxw_t*const restrict, struct pgm_msgv_t**restrict, uint32_t);
+static bool _pgm_rxw_verify_csum (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict);
 static bool _pgm_rxw_is_apdu_complete (pgm_rxw_t*const, const uint32_t);
+static bool _pgm_rxw_is_tg_recoverable (pgm_rxw_t*const, const uint32_t);
+static void _pgm_rxw_reconstruct_async (pgm_rxw_t*const, const uint32_t);
 static inline ssize_t _pgm_rxw_incoming_read_apdu (pgm_rxw_t*const restrict, struct pgm_msgv_t**restrict);
+static struct pgm_sk_buff_t* _pgm_rxw_apdu_buffer (pgm_rxw_t*const restrict, const struct pgm_sk_buff_t*const restrict);
+static void _pgm_rxw_reassemble_fragment (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict);
 static inline int _pgm_rxw_recovery_update (pgm_rxw_t*const, const uint32_t, const pgm_time_t);
 static inline int _pgm_rxw_recovery_append (pgm_rxw_t*const, const pgm_time_t, const pgm_time_t);
 
@@ -98,7 +103,7 @@ _pgm_rxw_peek (
 
 	if (pgm_uint32_gte (sequence, window->trail) && pgm_uint32_lte (sequence, window->lead))
 	{
-		const uint_fast32_t index_ = sequence % pgm_rxw_max_length (window);
+		const uint_fast32_t index_ = sequence & window->mask;
 		struct pgm_sk_buff_t* skb = window->pdata[index_];
 /* availability only guaranteed inside commit window */
 		if (pgm_uint32_lt (sequence, window->commit_lead)) {
@@ -178,7 +183,9 @@ pgm_rxw_create (
 	const unsigned		sqns,		/* receive window size in sequence numbers */
 	const unsigned		secs,		/* size in seconds */
 	const ssize_t		max_rte,	/* max bandwidth */
-	const uint32_t		ack_c_p
+	const uint32_t		ack_c_p,
+	pgm_arena_t*const	arena,		/* maybe NULL */
+	pgm_heap_t*const	heap		/* maybe NULL */
 	)
 {
 	pgm_rxw_t* window;
@@ -202,10 +209,16 @@ pgm_rxw_create (
 /* calculate receive window parameters */
 	pgm_assert (sqns || (secs && max_rte));
 	const unsigned alloc_sqns = sqns ? sqns : (unsigned)( (secs * max_rte) / tpdu_size );
-	window = pgm_malloc0 (sizeof(pgm_rxw_t) + ( alloc_sqns * sizeof(struct pgm_sk_buff_t*) ));
+/* index by mask, slots beyond alloc_sqns are never simultaneously occupied */
+	const unsigned slots = (unsigned)pgm_nearest_power (1, alloc_sqns);
+	window = pgm_arena_alloc_array (arena, heap, sizeof(pgm_rxw_t) + ( slots * ( sizeof(struct pgm_sk_buff_t*) + sizeof(pgm_rxw_state_t) ) ));
+	window->pstate = (pgm_rxw_state_t*)&window->pdata[ slots ];
+	window->mask = slots - 1;
 
 	window->tsi		= tsi;
 	window->max_tpdu	= tpdu_size;
+	window->arena		= arena;
+	window->heap		= heap;
 
 /* empty state:
  *
@@ -253,6 +266,10 @@ pgm_rxw_destroy (
 
 	pgm_debug ("destroy (window:%p)", (const void*)window);
 
+/* outstanding parity reconstruction */
+	if (window->fec_pool)
+		pgm_fec_pool_cancel (window->fec_pool, window);
+
 /* contents of window */
 	while (!pgm_rxw_is_empty (window)) {
 		_pgm_rxw_remove_trail (window);
@@ -265,7 +282,7 @@ pgm_rxw_destroy (
 	pgm_assert (!pgm_rxw_is_full (window));
 
 /* window */
-	pgm_free (window);
+	pgm_arena_free_array (window->heap, window);
 }
 
 /* add skb to receive window.  window has fixed size and will not grow.
@@ -293,16 +310,15 @@ pgm_rxw_destroy (
  * it is an error to try to free the skb after adding to the window.
  */
 
-PGM_GNUC_INTERNAL
+static
 int
-pgm_rxw_add (
+_pgm_rxw_add (
 	pgm_rxw_t*	      const restrict window,
 	struct pgm_sk_buff_t* const restrict skb,
 	const pgm_time_t		     now,
 	const pgm_time_t		     nak_rb_expiry	/* calculated expiry time for this skb */
 	)
 {
-	pgm_rxw_state_t* const state = (pgm_rxw_state_t*)&skb->cb;
 	int status;
 
 /* pre-conditions */
@@ -360,31 +376,31 @@ pgm_rxw_add (
 	else
 		_pgm_rxw_update_trail (window, pgm_ntohl (skb->pgm_data->data_trail));
 
-/* bounds checking for parity data occurs at the transmission group sequence number */
+/* bounds checking for parity data occurs at the transmission group sequence number,
+ * the window is extended to span the entire group before the parity fills a gap.
+ */
 	if (skb->pgm_header->pgm_options & PGM_OPT_PARITY)
 	{
-		if (pgm_uint32_lt (_pgm_rxw_tg_sqn (window, skb->sequence), _pgm_rxw_tg_sqn (window, window->commit_lead)))
-			return PGM_RXW_DUPLICATE;
+		if (PGM_UNLIKELY(!window->is_fec_available))
+			return PGM_RXW_BOUNDS;
 
-		if (pgm_uint32_lt (_pgm_rxw_tg_sqn (window, skb->sequence), _pgm_rxw_tg_sqn (window, window->lead))) {
-			window->has_event = 1;
-			return _pgm_rxw_insert (window, skb);
-		}
+		const uint32_t tg_sqn  = _pgm_rxw_tg_sqn (window, skb->sequence);
+		const uint32_t tg_last = _pgm_rxw_tg_member (window, tg_sqn, window->tg_size - 1);
 
-		const struct pgm_sk_buff_t* const first_skb = _pgm_rxw_peek (window, _pgm_rxw_tg_sqn (window, skb->sequence));
-		const pgm_rxw_state_t* const first_state = (pgm_rxw_state_t*)&first_skb->cb;
+		if (pgm_uint32_lt (tg_last, window->commit_lead))
+			return PGM_RXW_DUPLICATE;
 
-		if (_pgm_rxw_tg_sqn (window, skb->sequence) == _pgm_rxw_tg_sqn (window, window->lead)) {
-			window->has_event = 1;
-			if (NULL == first_state || first_state->is_contiguous) {
-				state->is_contiguous = 1;
-				return _pgm_rxw_append (window, skb, now);
-			} else
-				return _pgm_rxw_insert (window, skb);
-		}
+		window->has_event = 1;
+		if (pgm_uint32_lte (tg_last, window->lead))
+			return _pgm_rxw_insert (window, skb);
 
-		pgm_assert (NULL != first_state);
-		status = _pgm_rxw_add_placeholder_range (window, _pgm_rxw_tg_sqn (window, skb->sequence), now, nak_rb_expiry);
+		_pgm_rxw_update_lead (window, tg_last, now, nak_rb_expiry);
+		if (PGM_UNLIKELY(tg_last != window->lead))
+			return PGM_RXW_BOUNDS;		/* constrained by commit window */
+		status = _pgm_rxw_insert (window, skb);
+		if (PGM_RXW_INSERTED == status)
+			status = PGM_RXW_MISSING;
+		return status;
 	}
 	else
 	{
@@ -402,9 +418,11 @@ pgm_rxw_add (
 
 		if (skb->sequence == pgm_rxw_next_lead (window)) {
 			window->has_event = 1;
-			if (_pgm_rxw_is_first_of_tg_sqn (window, skb->sequence))
-				state->is_contiguous = 1;
-			return _pgm_rxw_append (window, skb, now);
+			status = _pgm_rxw_append (window, skb, now);
+			if (PGM_RXW_APPENDED == status &&
+			    _pgm_rxw_is_first_of_tg_sqn (window, skb->sequence))
+				pgm_rxw_peek_state (window, skb->sequence)->is_contiguous = 1;
+			return status;
 		}
 
 		status = _pgm_rxw_add_placeholder_range (window, skb->sequence, now, nak_rb_expiry);
@@ -418,6 +436,41 @@ pgm_rxw_add (
 	return status;
 }
 
+PGM_GNUC_INTERNAL
+int
+pgm_rxw_add (
+	pgm_rxw_t*	      const restrict window,
+	struct pgm_sk_buff_t* const restrict skb,
+	const pgm_time_t		     now,
+	const pgm_time_t		     nak_rb_expiry	/* calculated expiry time for this skb */
+	)
+{
+	const int status = _pgm_rxw_add (window, skb, now, nak_rb_expiry);
+
+/* copy fragments into a contiguous APDU on arrival whilst the payload is
+ * still hot in cache.
+ */
+	if (window->is_reassembling &&
+	    NULL != skb->pgm_opt_fragment &&
+	    !(skb->pgm_header->pgm_options & PGM_OPT_PARITY) &&
+	    (PGM_RXW_INSERTED == status || PGM_RXW_APPENDED == status || PGM_RXW_MISSING == status))
+	{
+		_pgm_rxw_reassemble_fragment (window, skb);
+	}
+
+/* start decoding as soon as a transmission group becomes recoverable rather
+ * than when the group reaches the commit lead.
+ */
+	if (NULL != window->fec_pool &&
+	    (PGM_RXW_INSERTED == status || PGM_RXW_APPENDED == status))
+	{
+		const uint32_t tg_sqn = _pgm_rxw_tg_sqn (window, skb->sequence);
+		if (_pgm_rxw_is_tg_recoverable (window, tg_sqn))
+			_pgm_rxw_reconstruct_async (window, tg_sqn);
+	}
+	return status;
+}
+
 /* trail is the next packet to commit upstream, lead is the leading edge
  * of the receive window with possible gaps inside, rxw_trail is the transmit
  * window trail for retransmit requests.
@@ -559,7 +612,7 @@ _pgm_rxw_update_trail (
 
 		skb = _pgm_rxw_peek (window, sequence);
 		pgm_assert (NULL != skb);
-		state = (pgm_rxw_state_t*)&skb->cb;
+		state = pgm_rxw_peek_state (window, skb->sequence);
 
 		switch (state->pkt_state) {
 		case PGM_PKT_STATE_HAVE_DATA:
@@ -587,16 +640,19 @@ PGM_GNUC_INTERNAL
 void
 pgm_rxw_update_fec (
 	pgm_rxw_t* const	window,
-	const uint8_t		rs_k
+	const uint8_t		rs_k,
+	const uint8_t		tg_depth	/* interleave depth, 1 = none */
 	)
 {
 /* pre-conditions */
 	pgm_assert (NULL != window);
 	pgm_assert_cmpuint (rs_k, >, 1);
+	pgm_assert_cmpuint (tg_depth, >, 0);
 
-	pgm_debug ("pgm_rxw_update_fec (window:%p rs(k):%u)",
-		(void*)window, rs_k);
+	pgm_debug ("pgm_rxw_update_fec (window:%p rs(k):%u depth:%u)",
+		(void*)window, rs_k, tg_depth);
 
+	window->tg_depth_shift = pgm_power2_log2 (tg_depth);
 	if (window->is_fec_available) {
 		if (rs_k == window->rs.k) return;
 		pgm_rs_destroy (&window->rs);
@@ -607,6 +663,29 @@ pgm_rxw_update_fec (
 	window->tg_size = window->rs.k;
 }
 
+/* off-load parity reconstruction to a worker pool, user_data is returned
+ * with each completed job to identify the owning peer.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_rxw_set_fec_pool (
+	pgm_rxw_t*      const restrict window,
+	pgm_fec_pool_t* const restrict pool,
+	void*		const restrict user_data
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (NULL == window->fec_pool || NULL == pool);
+
+/* detaching from a pool abandons outstanding reconstruction */
+	if (NULL == pool && window->fec_pool)
+		pgm_fec_pool_cancel (window->fec_pool, window);
+	window->fec_pool	= pool;
+	window->fec_user_data	= user_data;
+}
+
 /* add one placeholder to leading edge due to detected lost packet.
  */
 
@@ -638,23 +717,23 @@ _pgm_rxw_add_placeholder (
  */
 	window->data_loss = window->ack_c_p + pgm_fp16mul ((pgm_fp16 (1) - window->ack_c_p), window->data_loss);
 
-	skb			= pgm_alloc_skb (window->max_tpdu);
-	state			= (pgm_rxw_state_t*)&skb->cb;
+	skb			= pgm_arena_alloc_skb (window->arena, window->max_tpdu);
 	skb->tstamp		= now;
 	skb->sequence		= window->lead;
+	state			= pgm_rxw_peek_state (window, skb->sequence);
 	state->timer_expiry	= nak_rb_expiry;
 
 	if (!_pgm_rxw_is_first_of_tg_sqn (window, skb->sequence))
 	{
 		struct pgm_sk_buff_t* first_skb = _pgm_rxw_peek (window, _pgm_rxw_tg_sqn (window, skb->sequence));
 		if (first_skb) {
-			pgm_rxw_state_t* first_state = (pgm_rxw_state_t*)&first_skb->cb;
+			pgm_rxw_state_t* first_state = pgm_rxw_peek_state (window, first_skb->sequence);
 			first_state->is_contiguous = 0;
 		}
 	}
 
 /* add skb to window */
-	const uint_fast32_t index_	= skb->sequence % pgm_rxw_max_length (window);
+	const uint_fast32_t index_	= skb->sequence & window->mask;
 	window->pdata[index_]		= skb;
 
 	pgm_rxw_state (window, skb, PGM_PKT_STATE_BACK_OFF);
@@ -776,16 +855,10 @@ _pgm_rxw_is_apdu_lost (
 	struct pgm_sk_buff_t* const restrict skb
 	)
 {
-	const pgm_rxw_state_t* state = (pgm_rxw_state_t*)&skb->cb;
-
 /* pre-conditions */
 	pgm_assert (NULL != window);
 	pgm_assert (NULL != skb);
 
-/* lost is lost */
-	if (PGM_PKT_STATE_LOST_DATA == state->pkt_state)
-		return TRUE;
-
 /* by definition, a single-TPDU APDU is complete */
 	if (!skb->pgm_opt_fragment)
 		return FALSE;
@@ -801,7 +874,7 @@ _pgm_rxw_is_apdu_lost (
 	if (NULL == first_skb)
 		return TRUE;
 
-	const pgm_rxw_state_t* first_state = (pgm_rxw_state_t*)&first_skb->cb;
+	const pgm_rxw_state_t* first_state = pgm_rxw_peek_state (window, apdu_first_sqn);
 	if (PGM_PKT_STATE_LOST_DATA == first_state->pkt_state)
 		return TRUE;
 
@@ -816,7 +889,7 @@ static inline
 struct pgm_sk_buff_t*
 _pgm_rxw_find_missing (
 	pgm_rxw_t* const		window,
-	const uint32_t			tg_sqn		/* tg_sqn | pkt_sqn */
+	const uint32_t			tg_sqn
 	)
 {
 	struct pgm_sk_buff_t* skb;
@@ -825,11 +898,12 @@ _pgm_rxw_find_missing (
 /* pre-conditions */
 	pgm_assert (NULL != window);
 
-	for (uint32_t i = tg_sqn, j = 0; j < window->tg_size; i++, j++)
+	for (uint32_t j = 0; j < window->tg_size; j++)
 	{
-		skb = _pgm_rxw_peek (window, i);
-		pgm_assert (NULL != skb);
-		state = (pgm_rxw_state_t*)&skb->cb;
+		skb = _pgm_rxw_peek (window, _pgm_rxw_tg_member (window, tg_sqn, j));
+		if (NULL == skb)		/* beyond window lead */
+			break;
+		state = pgm_rxw_peek_state (window, skb->sequence);
 		switch (state->pkt_state) {
 		case PGM_PKT_STATE_BACK_OFF:
 		case PGM_PKT_STATE_WAIT_NCF:
@@ -839,6 +913,7 @@ _pgm_rxw_find_missing (
 
 		case PGM_PKT_STATE_HAVE_DATA:
 		case PGM_PKT_STATE_HAVE_PARITY:
+		case PGM_PKT_STATE_COMMIT_DATA:
 			break;
 
 		default: pgm_assert_not_reached(); break;
@@ -848,6 +923,43 @@ _pgm_rxw_find_missing (
 	return NULL;
 }
 
+/* returns the first other member of the skb's transmission group holding
+ * original data to validate against, placeholders for lost packets carry
+ * neither length nor header.  returns NULL if no such member is present.
+ */
+
+static
+const struct pgm_sk_buff_t*
+_pgm_rxw_peek_tg_reference (
+	pgm_rxw_t*		    const restrict window,
+	const struct pgm_sk_buff_t* const restrict skb
+	)
+{
+	const struct pgm_sk_buff_t* first_skb;
+	const pgm_rxw_state_t* state;
+
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (NULL != skb);
+
+	const uint32_t tg_sqn = _pgm_rxw_tg_sqn (window, skb->sequence);
+	for (uint32_t j = 0; j < window->tg_size; j++)
+	{
+		const uint32_t sequence = _pgm_rxw_tg_member (window, tg_sqn, j);
+		if (sequence == skb->sequence)
+			continue;
+		first_skb = _pgm_rxw_peek (window, sequence);
+		if (NULL == first_skb)		/* beyond window lead */
+			break;
+		state = pgm_rxw_peek_state (window, first_skb->sequence);
+		if (PGM_PKT_STATE_HAVE_DATA == state->pkt_state ||
+		    PGM_PKT_STATE_COMMIT_DATA == state->pkt_state)
+			return first_skb;
+	}
+
+	return NULL;
+}
+
 /* returns TRUE if skb is a parity packet with packet length not
  * matching the transmission group length without the variable-packet-length
  * flag set.
@@ -871,13 +983,9 @@ _pgm_rxw_is_invalid_var_pktlen (
 	if (skb->pgm_header->pgm_options & PGM_OPT_VAR_PKTLEN)
 		return FALSE;
 
-	const uint32_t tg_sqn = _pgm_rxw_tg_sqn (window, skb->sequence);
-	if (tg_sqn == skb->sequence)
-		return FALSE;
-
-	first_skb = _pgm_rxw_peek (window, tg_sqn);
+	first_skb = _pgm_rxw_peek_tg_reference (window, skb);
 	if (NULL == first_skb)
-		return TRUE;	/* transmission group unrecoverable */
+		return FALSE;
 
 	if (first_skb->len == skb->len)
 		return FALSE;
@@ -917,13 +1025,9 @@ _pgm_rxw_is_invalid_payload_op (
 	if (!window->is_fec_available)
 		return FALSE;
 
-	const uint32_t tg_sqn = _pgm_rxw_tg_sqn (window, skb->sequence);
-	if (tg_sqn == skb->sequence)
-		return FALSE;
-
-	first_skb = _pgm_rxw_peek (window, tg_sqn);
+	first_skb = _pgm_rxw_peek_tg_reference (window, skb);
 	if (NULL == first_skb)
-		return TRUE;	/* transmission group unrecoverable */
+		return FALSE;
 
 	if (_pgm_rxw_has_payload_op (first_skb) == _pgm_rxw_has_payload_op (skb))
 		return FALSE;
@@ -962,16 +1066,18 @@ _pgm_rxw_insert (
 
 	if (new_skb->pgm_header->pgm_options & PGM_OPT_PARITY)
 	{
-		skb = _pgm_rxw_find_missing (window, new_skb->sequence);
+		skb = _pgm_rxw_find_missing (window, _pgm_rxw_tg_sqn (window, new_skb->sequence));
 		if (NULL == skb)
 			return PGM_RXW_DUPLICATE;
-		state = (pgm_rxw_state_t*)&skb->cb;
+		state = pgm_rxw_peek_state (window, skb->sequence);
+/* parity takes the sequence of the gap it fills */
+		new_skb->sequence = skb->sequence;
 	}
 	else
 	{
 		skb = _pgm_rxw_peek (window, new_skb->sequence);
 		pgm_assert (NULL != skb);
-		state = (pgm_rxw_state_t*)&skb->cb;
+		state = pgm_rxw_peek_state (window, skb->sequence);
 
 		if (state->pkt_state == PGM_PKT_STATE_HAVE_DATA)
 			return PGM_RXW_DUPLICATE;
@@ -979,6 +1085,7 @@ _pgm_rxw_insert (
 
 /* APDU fragments are already declared lost */
 	if (new_skb->pgm_opt_fragment &&
+	    !(new_skb->pgm_header->pgm_options & PGM_OPT_PARITY) &&
 	    _pgm_rxw_is_apdu_lost (window, new_skb))
 	{
 		pgm_rxw_lost (window, skb->sequence);
@@ -994,7 +1101,8 @@ _pgm_rxw_insert (
 		break;
 
 	case PGM_PKT_STATE_HAVE_PARITY:
-		_pgm_rxw_shuffle_parity (window, skb);
+		skb = _pgm_rxw_shuffle_parity (window, skb);
+		state = pgm_rxw_peek_state (window, skb->sequence);
 		break;
 
 	default: pgm_assert_not_reached(); break;
@@ -1041,13 +1149,10 @@ _pgm_rxw_insert (
 	if (s > window->data_loss)	window->data_loss = 0;
 	else				window->data_loss -= s;
 
-/* replace place holder skb with incoming skb */
-	memcpy (new_skb->cb, skb->cb, sizeof(skb->cb));
-	state = (void*)new_skb->cb;
-	state->pkt_state = PGM_PKT_STATE_ERROR;
+/* replace place holder skb with incoming skb, retry counters remain in the slot */
 	_pgm_rxw_unlink (window, skb);
 	pgm_free_skb (skb);
-	const uint_fast32_t index_ = new_skb->sequence % pgm_rxw_max_length (window);
+	const uint_fast32_t index_ = new_skb->sequence & window->mask;
 	window->pdata[index_] = new_skb;
 	if (new_skb->pgm_header->pgm_options & PGM_OPT_PARITY)
 		_pgm_rxw_state (window, new_skb, PGM_PKT_STATE_HAVE_PARITY);
@@ -1058,36 +1163,52 @@ _pgm_rxw_insert (
 	return PGM_RXW_INSERTED;
 }
 
-/* shuffle parity packet at skb->sequence to any other needed spot.
+/* shuffle parity packet at skb->sequence to any other needed spot, the
+ * placeholder of that spot is moved to skb->sequence in exchange.
+ *
+ * returns the skb now occupying skb->sequence, the parity packet itself if no
+ * other spot needs it.
  */
 
 static inline
-void
+struct pgm_sk_buff_t*
 _pgm_rxw_shuffle_parity (
 	pgm_rxw_t*	      const restrict window,
 	struct pgm_sk_buff_t* const restrict skb
 	)
 {
 	struct pgm_sk_buff_t* restrict missing;
-	char cb[48];
 
 /* pre-conditions */
 	pgm_assert (NULL != window);
 	pgm_assert (NULL != skb);
 
-	missing = _pgm_rxw_find_missing (window, skb->sequence);
+	missing = _pgm_rxw_find_missing (window, _pgm_rxw_tg_sqn (window, skb->sequence));
 	if (NULL == missing)
-		return;
+		return skb;
 
-/* replace place holder skb with parity skb */
-	_pgm_rxw_unlink (window, missing);
-	memcpy (cb, skb->cb, sizeof(skb->cb));
-	memcpy (skb->cb, missing->cb, sizeof(skb->cb));
-	memcpy (missing->cb, cb, sizeof(skb->cb));
-	const uint32_t parity_index = skb->sequence % pgm_rxw_max_length (window);
-	window->pdata[parity_index] = skb;
-	const uint32_t missing_index = missing->sequence % pgm_rxw_max_length (window);
-	window->pdata[missing_index] = missing;
+/* swap positions, each skb keeps its own packet state whilst the reassembly
+ * and transmission group flags stay with the sequence they describe.
+ */
+	const uint32_t parity_sequence = skb->sequence;
+	pgm_rxw_state_t* parity_state  = pgm_rxw_peek_state (window, parity_sequence);
+	pgm_rxw_state_t* missing_state = pgm_rxw_peek_state (window, missing->sequence);
+	const pgm_rxw_state_t state    = *parity_state;
+	parity_state->timer_expiry		= missing_state->timer_expiry;
+	parity_state->pkt_state			= missing_state->pkt_state;
+	parity_state->nak_transmit_count	= missing_state->nak_transmit_count;
+	parity_state->ncf_retry_count		= missing_state->ncf_retry_count;
+	parity_state->data_retry_count		= missing_state->data_retry_count;
+	missing_state->timer_expiry		= state.timer_expiry;
+	missing_state->pkt_state		= state.pkt_state;
+	missing_state->nak_transmit_count	= state.nak_transmit_count;
+	missing_state->ncf_retry_count		= state.ncf_retry_count;
+	missing_state->data_retry_count		= state.data_retry_count;
+	skb->sequence = missing->sequence;
+	missing->sequence = parity_sequence;
+	window->pdata[ skb->sequence & window->mask ] = skb;
+	window->pdata[ missing->sequence & window->mask ] = missing;
+	return missing;
 }
 
 /* skb advances the window lead.
@@ -1145,12 +1266,12 @@ _pgm_rxw_append (
 	if (PGM_UNLIKELY(skb->pgm_opt_fragment &&
 	    _pgm_rxw_is_apdu_lost (window, skb)))
 	{
-		struct pgm_sk_buff_t* lost_skb	= pgm_alloc_skb (window->max_tpdu);
+		struct pgm_sk_buff_t* lost_skb	= pgm_arena_alloc_skb (window->arena, window->max_tpdu);
 		lost_skb->tstamp		= now;
 		lost_skb->sequence		= skb->sequence;
 
 /* add lost-placeholder skb to window */
-		const uint_fast32_t index_	= lost_skb->sequence % pgm_rxw_max_length (window);
+		const uint_fast32_t index_	= lost_skb->sequence & window->mask;
 		window->pdata[index_]		= lost_skb;
 
 		_pgm_rxw_state (window, lost_skb, PGM_PKT_STATE_LOST_DATA);
@@ -1160,13 +1281,13 @@ _pgm_rxw_append (
 /* add skb to window */
 	if (skb->pgm_header->pgm_options & PGM_OPT_PARITY)
 	{
-		const uint_fast32_t index_	= skb->sequence % pgm_rxw_max_length (window);
+		const uint_fast32_t index_	= skb->sequence & window->mask;
 		window->pdata[index_]		= skb;
 		_pgm_rxw_state (window, skb, PGM_PKT_STATE_HAVE_PARITY);
 	}
 	else
 	{
-		const uint_fast32_t index_	= skb->sequence % pgm_rxw_max_length (window);
+		const uint_fast32_t index_	= skb->sequence & window->mask;
 		window->pdata[index_]		= skb;
 		_pgm_rxw_state (window, skb, PGM_PKT_STATE_HAVE_DATA);
 	}
@@ -1178,7 +1299,7 @@ _pgm_rxw_append (
 }
 
 /* remove references to all commit packets not in the same transmission group
- * as the commit-lead
+ * as the commit-lead, with interleaving the same block of transmission groups.
  */
 
 PGM_GNUC_INTERNAL
@@ -1190,10 +1311,10 @@ pgm_rxw_remove_commit (
 /* pre-conditions */
 	pgm_assert (NULL != window);
 
-	const uint32_t tg_sqn_of_commit_lead = _pgm_rxw_tg_sqn (window, window->commit_lead);
+	const uint32_t tg_block_of_commit_lead = _pgm_rxw_tg_block (window, window->commit_lead);
 
 	while (!_pgm_rxw_commit_is_empty (window) &&
-	       tg_sqn_of_commit_lead != _pgm_rxw_tg_sqn (window, window->trail))
+	       tg_block_of_commit_lead != _pgm_rxw_tg_block (window, window->trail))
 	{
 		_pgm_rxw_remove_trail (window);
 	}
@@ -1208,8 +1329,8 @@ pgm_rxw_remove_commit (
  *
  * returns -1 on nothing read, returns length of bytes read, 0 is a valid read length.
  *
- * PGM skbuffs will have an increased reference count and must be unreferenced by the 
- * calling application.
+ * PGM skbuffs remain owned by the window until the next commit is removed, the
+ * application must take its own reference with pgm_skb_detach() to hold them longer.
  */
 
 PGM_GNUC_INTERNAL
@@ -1241,7 +1362,7 @@ pgm_rxw_readv (
 	skb = _pgm_rxw_peek (window, window->commit_lead);
 	pgm_assert (NULL != skb);
 
-	state = (pgm_rxw_state_t*)&skb->cb;
+	state = pgm_rxw_peek_state (window, skb->sequence);
 	switch (state->pkt_state) {
 	case PGM_PKT_STATE_HAVE_DATA:
 		bytes_read = _pgm_rxw_incoming_read (window, pmsg, (unsigned)(msg_end - *pmsg + 1));
@@ -1287,6 +1408,7 @@ _pgm_rxw_remove_trail (
 	)
 {
 	struct pgm_sk_buff_t* skb;
+	pgm_rxw_state_t* state;
 
 /* pre-conditions */
 	pgm_assert (NULL != window);
@@ -1295,10 +1417,15 @@ _pgm_rxw_remove_trail (
 	skb = _pgm_rxw_peek (window, window->trail);
 	pgm_assert (NULL != skb);
 	_pgm_rxw_unlink (window, skb);
+/* vacated slot starts clean for the next lap */
+	state = pgm_rxw_peek_state (window, skb->sequence);
+	if (state->apdu)
+		pgm_free_skb (state->apdu);
+	memset (state, 0, sizeof(pgm_rxw_state_t));
 	window->size -= skb->len;
 /* remove reference to skb */
 	if (PGM_UNLIKELY(pgm_mem_gc_friendly)) {
-		const uint_fast32_t index_ = skb->sequence % pgm_rxw_max_length (window);
+		const uint_fast32_t index_ = skb->sequence & window->mask;
 		window->pdata[index_] = NULL;
 	}
 	pgm_free_skb (skb);
@@ -1357,6 +1484,9 @@ _pgm_rxw_incoming_read (
 	do {
 		skb = _pgm_rxw_peek (window, window->commit_lead);
 		pgm_assert (NULL != skb);
+/* fragment header is only trustworthy after checksum verification */
+		if (!_pgm_rxw_verify_csum (window, skb))
+			break;
 		if (_pgm_rxw_is_apdu_complete (window,
 					      skb->pgm_opt_fragment ? pgm_ntohl (skb->of_apdu_first_sqn) : skb->sequence))
 		{
@@ -1374,6 +1504,78 @@ _pgm_rxw_incoming_read (
 	return data_read > 0 ? bytes_read : -1;
 }
 
+/* verify a PGM checksum deferred from receipt, covering header, options and
+ * payload.  a corrupt packet reverts to an already expired placeholder at the
+ * tail of the NAK back-off queue: corruption is private to this receiver so
+ * there is nothing for back-off to suppress, repair is requested on the next
+ * timer check.
+ *
+ * returns TRUE if the packet is intact.
+ */
+
+static
+bool
+_pgm_rxw_verify_csum (
+	pgm_rxw_t*	      const restrict window,
+	struct pgm_sk_buff_t* const restrict skb
+	)
+{
+	struct pgm_sk_buff_t *placeholder, *apdu;
+	pgm_rxw_state_t* state;
+
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (NULL != skb);
+
+	if (PGM_LIKELY(!skb->csum_pending))
+		return TRUE;
+
+	skb->csum_pending = 0;
+	const uint16_t tpdu_length = (uint16_t)((char*)skb->tail - (char*)skb->pgm_header);
+	const uint16_t sum = skb->pgm_header->pgm_checksum;
+	skb->pgm_header->pgm_checksum = 0;
+	const uint16_t pgm_sum = pgm_csum_fold (pgm_csum_partial ((const char*)skb->pgm_header, tpdu_length, 0));
+	skb->pgm_header->pgm_checksum = sum;
+	if (PGM_LIKELY(pgm_sum == sum))
+		return TRUE;
+
+	pgm_trace (PGM_LOG_ROLE_RX_WINDOW,_("Deferred PGM checksum mismatch on #%" PRIu32 ", reported 0x%x whilst calculated 0x%x."),
+		skb->sequence, sum, pgm_sum);
+	window->cumulative_csum_errors++;
+
+	placeholder		= pgm_arena_alloc_skb (window->arena, window->max_tpdu);
+	placeholder->tstamp	= skb->tstamp;
+	placeholder->sequence	= skb->sequence;
+
+	if (!_pgm_rxw_is_first_of_tg_sqn (window, skb->sequence))
+	{
+		struct pgm_sk_buff_t* first_skb = _pgm_rxw_peek (window, _pgm_rxw_tg_sqn (window, skb->sequence));
+		if (first_skb) {
+			pgm_rxw_state_t* first_state = pgm_rxw_peek_state (window, first_skb->sequence);
+			first_state->is_contiguous = 0;
+		}
+	}
+
+	_pgm_rxw_unlink (window, skb);
+	window->size -= skb->len;
+	const uint_fast32_t index_	= skb->sequence & window->mask;
+	window->pdata[index_]		= placeholder;
+	pgm_free_skb (skb);
+
+/* recovery restarts from a clean slot, keeping any reassembly buffer of the APDU */
+	state			= pgm_rxw_peek_state (window, placeholder->sequence);
+	apdu			= state->apdu;
+	memset (state, 0, sizeof(pgm_rxw_state_t));
+	state->timer_expiry	= placeholder->tstamp;
+	state->apdu		= apdu;
+
+/* back-off queue is ordered by expiry with the oldest at the tail */
+	_pgm_rxw_state (window, placeholder, PGM_PKT_STATE_BACK_OFF);
+	pgm_queue_unlink (&window->nak_backoff_queue, (pgm_list_t*)placeholder);
+	pgm_queue_push_tail_link (&window->nak_backoff_queue, (pgm_list_t*)placeholder);
+	return FALSE;
+}
+
 /* returns TRUE if transmission group is lost.
  *
  * checking is lightly limited to bounds.
@@ -1399,70 +1601,81 @@ _pgm_rxw_is_tg_sqn_lost (
 	return FALSE;
 }
 
-/* reconstruct missing sequences in a transmission group using embedded parity data.
+/* gather the transmission group into a decode job, allocating a zero padded
+ * skbuff for each missing sequence.  with take_refs set the job holds its own
+ * reference on every window owned skbuff so the payloads remain valid outside
+ * of the window lock.
  */
 
 static
 void
-_pgm_rxw_reconstruct (
-	pgm_rxw_t* const	window,
-	const uint32_t		tg_sqn		/* transmission group sequence */
+_pgm_rxw_reconstruct_prepare (
+	pgm_rxw_t*     const restrict window,
+	pgm_fec_job_t* const restrict job,
+	const bool		      take_refs
 	)
 {
 	struct pgm_sk_buff_t	*skb;
 	pgm_rxw_state_t		*state;
-	struct pgm_sk_buff_t   **tg_skbs;
-	pgm_gf8_t	       **tg_data, **tg_opts;
-	uint8_t			*offsets;
 	uint8_t			 rs_h = 0;
 
 /* pre-conditions */
 	pgm_assert (NULL != window);
+	pgm_assert (NULL != job);
 	pgm_assert (1 == window->is_fec_available);
-	pgm_assert_cmpuint (_pgm_rxw_pkt_sqn (window, tg_sqn), ==, 0);
-
-/* use stack memory */
-	tg_skbs = pgm_newa (struct pgm_sk_buff_t*, window->rs.n);
-	tg_data = pgm_newa (pgm_gf8_t*, window->rs.n);
-	tg_opts = pgm_newa (pgm_gf8_t*, window->rs.n);
-	offsets = pgm_newa (uint8_t, window->rs.k);
+	pgm_assert_cmpuint (_pgm_rxw_pkt_sqn (window, job->tg_sqn), ==, 0);
 
-	skb = _pgm_rxw_peek (window, tg_sqn);
+	skb = _pgm_rxw_peek (window, job->tg_sqn);
 	pgm_assert (NULL != skb);
 
-	const bool is_var_pktlen = skb->pgm_header->pgm_options & PGM_OPT_VAR_PKTLEN;
-	const bool is_op_encoded = skb->pgm_header->pgm_options & PGM_OPT_PRESENT;
-	const uint16_t parity_length = pgm_ntohs (skb->pgm_header->pgm_tsdu_length);
+	const struct pgm_header* const tg_header = skb->pgm_header;
+	job->window = window;
+	job->is_var_pktlen = skb->pgm_header->pgm_options & PGM_OPT_VAR_PKTLEN;
+	job->is_op_encoded = skb->pgm_header->pgm_options & PGM_OPT_PRESENT;
+	job->parity_length = pgm_ntohs (skb->pgm_header->pgm_tsdu_length);
+
+	const uint16_t parity_length = job->parity_length;
 
-	for (uint32_t i = tg_sqn, j = 0; i != (tg_sqn + window->rs.k); i++, j++)
+	job->tg_depth_shift = window->tg_depth_shift;
+	for (uint32_t j = 0; j < window->rs.k; j++)
 	{
+		const uint32_t i = _pgm_rxw_tg_member (window, job->tg_sqn, j);
 		skb = _pgm_rxw_peek (window, i);
 		pgm_assert (NULL != skb);
-		state = (pgm_rxw_state_t*)&skb->cb;
+		state = pgm_rxw_peek_state (window, skb->sequence);
 		switch (state->pkt_state) {
 		case PGM_PKT_STATE_HAVE_DATA:
-			tg_skbs[ j ] = skb;
-			tg_data[ j ] = skb->data;
-			tg_opts[ j ] = (pgm_gf8_t*)skb->pgm_opt_fragment;
-			offsets[ j ] = j;
+		case PGM_PKT_STATE_COMMIT_DATA:
+			job->tg_skbs[ j ] = take_refs ? pgm_skb_get (skb) : skb;
+			job->tg_data[ j ] = skb->data;
+			job->tg_opts[ j ] = (pgm_gf8_t*)skb->pgm_opt_fragment;
+			job->offsets[ j ] = j;
 			break;
 
 		case PGM_PKT_STATE_HAVE_PARITY:
-			tg_skbs[ window->rs.k + rs_h ] = skb;
-			tg_data[ window->rs.k + rs_h ] = skb->data;
-			tg_opts[ window->rs.k + rs_h ] = (pgm_gf8_t*)skb->pgm_opt_fragment;
-			offsets[ j ] = window->rs.k + rs_h;
+			job->tg_skbs[ window->rs.k + rs_h ] = take_refs ? pgm_skb_get (skb) : skb;
+			job->tg_data[ window->rs.k + rs_h ] = skb->data;
+			job->tg_opts[ window->rs.k + rs_h ] = (pgm_gf8_t*)skb->pgm_opt_fragment;
+			job->offsets[ j ] = window->rs.k + rs_h;
 			++rs_h;
 /* fall through and alloc new skb for reconstructed data */
 		case PGM_PKT_STATE_BACK_OFF:
 		case PGM_PKT_STATE_WAIT_NCF:
 		case PGM_PKT_STATE_WAIT_DATA:
 		case PGM_PKT_STATE_LOST_DATA:
-			skb = pgm_alloc_skb (window->max_tpdu);
+			skb = pgm_arena_alloc_skb (window->arena, window->max_tpdu);
+			skb->tsi = *window->tsi;
+			skb->sequence = i;
+			skb->tstamp = _pgm_rxw_peek (window, i)->tstamp;
 			pgm_skb_reserve (skb, sizeof(struct pgm_header) + sizeof(struct pgm_data));
 			skb->pgm_header = skb->head;
 			skb->pgm_data = (void*)( skb->pgm_header + 1 );
-			if (is_op_encoded) {
+/* repair packets inherit the transmission group header as original data */
+			memcpy (skb->pgm_header, tg_header, sizeof(struct pgm_header));
+			skb->pgm_header->pgm_options &= ~PGM_OPT_PARITY;
+			skb->pgm_data->data_sqn = pgm_htonl (i);
+			skb->pgm_data->data_trail = 0;
+			if (job->is_op_encoded) {
 				const uint16_t opt_total_length = sizeof(struct pgm_opt_length) +
 								 sizeof(struct pgm_opt_header) +
 								 sizeof(struct pgm_opt_fragment);
@@ -1474,9 +1687,9 @@ _pgm_rxw_reconstruct (
 				pgm_skb_put (skb, parity_length);
 				memset (skb->data, 0, parity_length);
 			}
-			tg_skbs[ j ] = skb;
-			tg_data[ j ] = skb->data;
-			tg_opts[ j ] = (void*)skb->pgm_opt_fragment;
+			job->tg_skbs[ j ] = skb;
+			job->tg_data[ j ] = skb->data;
+			job->tg_opts[ j ] = (void*)skb->pgm_opt_fragment;
 			break;
 
 		default: pgm_assert_not_reached(); break;
@@ -1488,57 +1701,225 @@ _pgm_rxw_reconstruct (
 		}
 
 	}
+}
 
-/* reconstruct payload */
-	pgm_rs_decode_parity_appended (&window->rs,
-				       tg_data,
-				       offsets,
-				       parity_length);
+/* swap parity skbs with reconstructed skbs.  sequences recovered by other
+ * means whilst the decode was in progress are skipped.  repair skbuffs
+ * consumed by the window are cleared from the job.
+ */
 
-/* reconstruct opt_fragment option */
-	if (is_op_encoded)
-		pgm_rs_decode_parity_appended (&window->rs,
-					       tg_opts,
-					       offsets,
-					       sizeof(struct pgm_opt_fragment));
+static
+void
+_pgm_rxw_reconstruct_insert (
+	pgm_rxw_t*     const restrict window,
+	pgm_fec_job_t* const restrict job
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (NULL != job);
 
-/* swap parity skbs with reconstructed skbs */
-	for (uint_fast8_t i = 0; i < window->rs.k; i++)
+	for (uint_fast8_t i = 0; i < job->rs_k; i++)
 	{
 		struct pgm_sk_buff_t* repair_skb;
+		const pgm_rxw_state_t* state;
 
-		if (offsets[i] < window->rs.k)
+		if (job->offsets[i] < job->rs_k)
 			continue;
 
-		repair_skb = tg_skbs[i];
+		repair_skb = job->tg_skbs[i];
+		state = pgm_rxw_peek_state (window, repair_skb->sequence);
+/* data arrived or was already read whilst the group was being decoded */
+		if (PGM_PKT_STATE_HAVE_DATA == state->pkt_state ||
+		    PGM_PKT_STATE_COMMIT_DATA == state->pkt_state)
+			continue;
 
-		if (is_var_pktlen)
+		if (job->is_var_pktlen)
 		{
 			const uint16_t pktlen = *(uint16_t*)( (char*)repair_skb->tail - sizeof(uint16_t));
-			if (pktlen > parity_length) {
+			if (pktlen > job->parity_length) {
 				pgm_trace (PGM_LOG_ROLE_RX_WINDOW,_("Invalid encoded variable packet length in reconstructed packet, dropping entire transmission group."));
-				pgm_free_skb (repair_skb);
-				for (uint_fast8_t j = i; j < window->rs.k; j++)
+				for (uint_fast8_t j = i; j < job->rs_k; j++)
 				{
-					if (offsets[j] < window->rs.k)
+					if (job->offsets[j] < job->rs_k)
 						continue;
-					pgm_rxw_lost (window, tg_skbs[offsets[j]]->sequence);
+					const uint32_t sequence = _pgm_rxw_tg_member (window, job->tg_sqn, j);
+					state = pgm_rxw_peek_state (window, sequence);
+					if (PGM_PKT_STATE_HAVE_DATA != state->pkt_state &&
+					    PGM_PKT_STATE_COMMIT_DATA != state->pkt_state &&
+					    PGM_PKT_STATE_LOST_DATA != state->pkt_state)
+						pgm_rxw_lost (window, sequence);
 				}
 				break;
 			}
-			const uint16_t padding = parity_length - pktlen;
+			const uint16_t padding = job->parity_length - pktlen;
 			repair_skb->len -= padding;
 			repair_skb->tail = (char*)repair_skb->tail - padding;
 		}
 
-#ifdef PGM_DISABLE_ASSERT
-		_pgm_rxw_insert (window, repair_skb);
-#else
-		pgm_assert_cmpint (_pgm_rxw_insert (window, repair_skb), ==, PGM_RXW_INSERTED);
-#endif
+		if (PGM_RXW_INSERTED == _pgm_rxw_insert (window, repair_skb))
+			job->tg_skbs[i] = NULL;
 	}
 }
 
+/* reconstruct missing sequences in a transmission group using embedded parity data.
+ */
+
+static
+void
+_pgm_rxw_reconstruct (
+	pgm_rxw_t* const	window,
+	const uint32_t		tg_sqn		/* transmission group sequence */
+	)
+{
+	pgm_fec_job_t job;
+
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (1 == window->is_fec_available);
+	pgm_assert_cmpuint (_pgm_rxw_pkt_sqn (window, tg_sqn), ==, 0);
+
+/* use stack memory */
+	memset (&job, 0, sizeof(job));
+	job.tg_sqn  = tg_sqn;
+	job.rs_n    = window->rs.n;
+	job.rs_k    = window->rs.k;
+	job.tg_skbs = pgm_newa (struct pgm_sk_buff_t*, window->rs.n);
+	job.tg_data = pgm_newa (pgm_gf8_t*, window->rs.n);
+	job.tg_opts = pgm_newa (pgm_gf8_t*, window->rs.n);
+	job.offsets = pgm_newa (uint8_t, window->rs.k);
+
+	_pgm_rxw_reconstruct_prepare (window, &job, FALSE);
+
+/* reconstruct payload */
+	pgm_rs_decode_parity_appended (&window->rs,
+				       job.tg_data,
+				       job.offsets,
+				       job.parity_length);
+
+/* reconstruct opt_fragment option */
+	if (job.is_op_encoded)
+		pgm_rs_decode_parity_appended (&window->rs,
+					       job.tg_opts,
+					       job.offsets,
+					       sizeof(struct pgm_opt_fragment));
+
+	_pgm_rxw_reconstruct_insert (window, &job);
+
+/* release repair skbs not taken by the window */
+	for (uint_fast8_t i = 0; i < window->rs.k; i++)
+		if (job.offsets[i] >= window->rs.k && NULL != job.tg_skbs[i])
+			pgm_free_skb (job.tg_skbs[i]);
+}
+
+/* returns TRUE if sufficient data and parity packets are held to recover
+ * the missing sequences of a complete transmission group.
+ */
+
+static
+bool
+_pgm_rxw_is_tg_recoverable (
+	pgm_rxw_t* const	window,
+	const uint32_t		tg_sqn
+	)
+{
+	unsigned have_data = 0, have_parity = 0;
+
+/* pre-conditions */
+	pgm_assert (NULL != window);
+
+	if (!window->is_fec_available ||
+	    _pgm_rxw_is_tg_sqn_lost (window, tg_sqn) ||
+	    pgm_uint32_gt (_pgm_rxw_tg_member (window, tg_sqn, window->tg_size - 1), window->lead))
+		return FALSE;
+
+	for (uint32_t j = 0; j < window->tg_size; j++)
+	{
+		struct pgm_sk_buff_t* skb = _pgm_rxw_peek (window, _pgm_rxw_tg_member (window, tg_sqn, j));
+		const pgm_rxw_state_t* state = pgm_rxw_peek_state (window, skb->sequence);
+		switch (state->pkt_state) {
+		case PGM_PKT_STATE_HAVE_DATA:
+		case PGM_PKT_STATE_COMMIT_DATA:
+/* compacted data received before FEC was announced has no tailroom to pad */
+			if (PGM_UNLIKELY(skb->truesize < sizeof(struct pgm_sk_buff_t) + window->max_tpdu))
+				return FALSE;
+/* corrupt data must not seed reconstruction */
+			if (PGM_PKT_STATE_COMMIT_DATA == state->pkt_state ||
+			    _pgm_rxw_verify_csum (window, skb))
+				++have_data;
+			break;
+		case PGM_PKT_STATE_HAVE_PARITY:
+			++have_parity;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return (have_parity > 0 && (have_data + have_parity) >= window->tg_size);
+}
+
+/* hand off reconstruction of a transmission group to the worker pool, at most
+ * one job per transmission group is outstanding.
+ */
+
+static
+void
+_pgm_rxw_reconstruct_async (
+	pgm_rxw_t* const	window,
+	const uint32_t		tg_sqn		/* transmission group sequence */
+	)
+{
+	pgm_fec_job_t* job;
+
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (NULL != window->fec_pool);
+
+	if (pgm_fec_pool_is_pending (window->fec_pool, window, tg_sqn))
+		return;
+
+	pgm_debug ("_pgm_rxw_reconstruct_async (window:%p tg-sqn:%" PRIu32 ")",
+		(void*)window, tg_sqn);
+
+	job = pgm_fec_job_new (window->rs.n, window->rs.k);
+	job->tg_sqn	= tg_sqn;
+	job->user_data	= window->fec_user_data;
+	_pgm_rxw_reconstruct_prepare (window, job, TRUE);
+	pgm_fec_pool_push (window->fec_pool, job);
+}
+
+/* commit a transmission group decoded by the worker pool back into the window,
+ * the job is consumed.  results for groups that have since fallen out of the
+ * window, or for a changed RS(n, k) or interleave depth, are discarded.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_rxw_reconstruct_commit (
+	pgm_rxw_t*     const restrict window,
+	pgm_fec_job_t* const restrict job
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (NULL != job);
+	pgm_assert (job->window == window);
+
+	pgm_debug ("reconstruct_commit (window:%p tg-sqn:%" PRIu32 ")",
+		(void*)window, job->tg_sqn);
+
+	if (window->is_fec_available &&
+	    job->rs_k == window->rs.k &&
+	    job->tg_depth_shift == window->tg_depth_shift &&
+	    !_pgm_rxw_is_tg_sqn_lost (window, job->tg_sqn))
+	{
+		_pgm_rxw_reconstruct_insert (window, job);
+		window->has_event = 1;
+	}
+	pgm_fec_job_free (job);
+}
+
 /* check every TPDU in an APDU and verify that the data has arrived
  * and is available to commit to the application.
  *
@@ -1549,7 +1930,8 @@ _pgm_rxw_reconstruct (
  * packets with single fragment fragment headers must be normalised as regular
  * packets before calling.
  *
- * APDUs exceeding PGM_MAX_FRAGMENTS or PGM_MAX_APDU length will be discarded.
+ * APDUs exceeding PGM_MAX_FRAGMENTS or PGM_MAX_APDU length will be discarded,
+ * the fragment limit does not apply when reassembling to a contiguous buffer.
  *
  * returns FALSE if APDU is incomplete or longer than max_len sequences.
  */
@@ -1564,7 +1946,6 @@ _pgm_rxw_is_apdu_complete (
 	struct pgm_sk_buff_t	*skb;
 	unsigned		 contiguous_tpdus = 0;
 	size_t			 contiguous_size = 0;
-	bool			 check_parity = FALSE;
 
 /* pre-conditions */
 	pgm_assert (NULL != window);
@@ -1576,9 +1957,10 @@ _pgm_rxw_is_apdu_complete (
 	if (PGM_UNLIKELY(NULL == skb)) {
 		return FALSE;
 	}
+	if (!_pgm_rxw_verify_csum (window, skb))
+		return FALSE;
 
 	const size_t apdu_size = skb->pgm_opt_fragment ? pgm_ntohl (skb->of_apdu_len) : skb->len;
-	const uint32_t  tg_sqn = _pgm_rxw_tg_sqn (window, first_sequence);
 
 	pgm_assert_cmpuint (apdu_size, >=, skb->len);
 
@@ -1592,69 +1974,69 @@ _pgm_rxw_is_apdu_complete (
 	     skb;
 	     skb = _pgm_rxw_peek (window, ++sequence))
 	{
-		pgm_rxw_state_t* state = (pgm_rxw_state_t*)&skb->cb;
+		pgm_rxw_state_t* state = pgm_rxw_peek_state (window, skb->sequence);
 
-		if (!check_parity &&
-		    PGM_PKT_STATE_HAVE_DATA != state->pkt_state)
+/* a gap can be filled by reconstructing the transmission group it sits within,
+ * with interleaving that need not be the group of the first fragment.
+ */
+		if (PGM_PKT_STATE_HAVE_DATA != state->pkt_state)
 		{
-			if (window->is_fec_available &&
-			    !_pgm_rxw_is_tg_sqn_lost (window, tg_sqn) )
-			{
-				check_parity = TRUE;
-/* pre-seed committed sequence count */
-				if (pgm_uint32_lte (tg_sqn, window->commit_lead))
-					contiguous_tpdus += window->commit_lead - tg_sqn;
-			}
-			else
-			{
+			const uint32_t tg_sqn = _pgm_rxw_tg_sqn (window, sequence);
+			if (!_pgm_rxw_is_tg_recoverable (window, tg_sqn))
+				return FALSE;
+			if (window->fec_pool) {
+				_pgm_rxw_reconstruct_async (window, tg_sqn);
 				return FALSE;
 			}
+			_pgm_rxw_reconstruct (window, tg_sqn);
+			state = pgm_rxw_peek_state (window, sequence);
+			if (PGM_PKT_STATE_HAVE_DATA != state->pkt_state)
+				return FALSE;
+			return _pgm_rxw_is_apdu_complete (window, first_sequence);
 		}
 
-		if (check_parity)
-		{
-			if (PGM_PKT_STATE_HAVE_DATA == state->pkt_state ||
-			    PGM_PKT_STATE_HAVE_PARITY == state->pkt_state)
-				++contiguous_tpdus;
-
-/* have sufficient been received for reconstruction */
-			if (contiguous_tpdus >= window->tg_size) {
-				_pgm_rxw_reconstruct (window, tg_sqn);
-				return _pgm_rxw_is_apdu_complete (window, first_sequence);
-			}
-		}
-		else
-		{
+		if (!_pgm_rxw_verify_csum (window, skb))
+			return FALSE;
+
 /* single packet APDU, already complete */
-			if (PGM_PKT_STATE_HAVE_DATA == state->pkt_state &&
-			    !skb->pgm_opt_fragment)
-				return TRUE;
+		if (PGM_PKT_STATE_HAVE_DATA == state->pkt_state &&
+		    !skb->pgm_opt_fragment)
+			return TRUE;
 
 /* protocol sanity check: matching first sequence reference */
-			if (PGM_UNLIKELY(pgm_ntohl (skb->of_apdu_first_sqn) != first_sequence)) {
-				pgm_rxw_lost (window, first_sequence);
-				return FALSE;
-			}
+		if (PGM_UNLIKELY(pgm_ntohl (skb->of_apdu_first_sqn) != first_sequence)) {
+			pgm_rxw_lost (window, first_sequence);
+			return FALSE;
+		}
 
 /* protocol sanity check: matching apdu length */
-			if (PGM_UNLIKELY(pgm_ntohl (skb->of_apdu_len) != apdu_size)) {
-				pgm_rxw_lost (window, first_sequence);
-				return FALSE;
-			}
+		if (PGM_UNLIKELY(pgm_ntohl (skb->of_apdu_len) != apdu_size)) {
+			pgm_rxw_lost (window, first_sequence);
+			return FALSE;
+		}
 
 /* protocol sanity check: maximum number of fragments per apdu */
-			if (PGM_UNLIKELY(++contiguous_tpdus > PGM_MAX_FRAGMENTS)) {
-				pgm_rxw_lost (window, first_sequence);
-				return FALSE;
-			}
+		if (PGM_UNLIKELY(!window->is_reassembling &&
+				 ++contiguous_tpdus > PGM_MAX_FRAGMENTS))
+		{
+			pgm_rxw_lost (window, first_sequence);
+			return FALSE;
+		}
 
-			contiguous_size += skb->len;
-			if (apdu_size == contiguous_size)
-				return TRUE;
-			else if (PGM_UNLIKELY(apdu_size < contiguous_size)) {
-				pgm_rxw_lost (window, first_sequence);
-				return FALSE;
-			}
+/* protocol sanity check: fragment offset, reassembly copies by offset */
+		if (PGM_UNLIKELY(window->is_reassembling &&
+				 pgm_ntohl (skb->of_frag_offset) != contiguous_size))
+		{
+			pgm_rxw_lost (window, first_sequence);
+			return FALSE;
+		}
+
+		contiguous_size += skb->len;
+		if (apdu_size == contiguous_size)
+			return TRUE;
+		else if (PGM_UNLIKELY(apdu_size < contiguous_size)) {
+			pgm_rxw_lost (window, first_sequence);
+			return FALSE;
 		}
 	}
 
@@ -1664,6 +2046,10 @@ _pgm_rxw_is_apdu_complete (
 
 /* read one APDU consisting of one or more TPDUs.  target array is guaranteed
  * to be big enough to store complete APDU.
+ *
+ * when reassembling, a fragmented APDU is delivered as a single contiguous
+ * skbuff held by the state of the first sequence, fragments not copied on
+ * arrival are copied now.
  */
 
 static inline
@@ -1673,9 +2059,10 @@ _pgm_rxw_incoming_read_apdu (
 	struct pgm_msgv_t** restrict pmsg		/* message array, updated as messages appended */
 	)
 {
-	struct pgm_sk_buff_t *skb;
+	struct pgm_sk_buff_t *skb, *apdu = NULL;
 	size_t		      contiguous_len = 0;
 	unsigned	      count = 0;
+	bool		      is_fresh = FALSE;
 
 /* pre-conditions */
 	pgm_assert (NULL != window);
@@ -1690,9 +2077,29 @@ _pgm_rxw_incoming_read_apdu (
 	const size_t apdu_len = skb->pgm_opt_fragment ? pgm_ntohl (skb->of_apdu_len) : skb->len;
 	pgm_assert_cmpuint (apdu_len, >=, skb->len);
 
+	if (window->is_reassembling && skb->pgm_opt_fragment)
+	{
+		pgm_rxw_state_t* first_state = pgm_rxw_peek_state (window, skb->sequence);
+		if (NULL == first_state->apdu || apdu_len != first_state->apdu->len) {
+			if (first_state->apdu) {
+				pgm_free_skb (first_state->apdu);
+				first_state->apdu = NULL;
+			}
+			is_fresh = TRUE;
+		}
+		apdu = _pgm_rxw_apdu_buffer (window, skb);
+		pgm_assert (NULL != apdu);
+	}
+
 	do {
+		if (apdu) {
+			pgm_rxw_state_t* state = pgm_rxw_peek_state (window, skb->sequence);
+			if (is_fresh || !state->is_reassembled)
+				memcpy ((char*)apdu->data + contiguous_len, skb->data, skb->len);
+		} else {
+			(*pmsg)->msgv_skb[ count++ ] = skb;
+		}
 		_pgm_rxw_state (window, skb, PGM_PKT_STATE_COMMIT_DATA);
-		(*pmsg)->msgv_skb[ count++ ] = skb;
 		contiguous_len += skb->len;
 		window->commit_lead++;
 		if (apdu_len == contiguous_len)
@@ -1700,6 +2107,8 @@ _pgm_rxw_incoming_read_apdu (
 		skb = _pgm_rxw_peek (window, window->commit_lead);
 	} while (apdu_len > contiguous_len);
 
+	if (apdu)
+		(*pmsg)->msgv_skb[ count++ ] = apdu;
 	(*pmsg)->msgv_len = count;
 	(*pmsg)++;
 
@@ -1709,7 +2118,131 @@ _pgm_rxw_incoming_read_apdu (
 	return contiguous_len;
 }
 
-/* returns transmission group sequence (TG_SQN) from sequence (SQN).
+/* returns the contiguous reassembly buffer for the APDU of fragment skb,
+ * allocating on first reference.  the buffer is held by the state of the first
+ * sequence and released with that sequence from the trail.
+ *
+ * returns NULL if the first sequence is not waiting to commit or the APDU
+ * length conflicts with an existing buffer.
+ */
+
+static
+struct pgm_sk_buff_t*
+_pgm_rxw_apdu_buffer (
+	pgm_rxw_t*		    const restrict window,
+	const struct pgm_sk_buff_t* const restrict skb
+	)
+{
+	struct pgm_sk_buff_t* apdu;
+	pgm_rxw_state_t* state;
+
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (NULL != skb);
+	pgm_assert (NULL != skb->pgm_opt_fragment);
+
+	const uint32_t first_sequence = pgm_ntohl (skb->of_apdu_first_sqn);
+	const uint32_t apdu_len	      = pgm_ntohl (skb->of_apdu_len);
+
+	if (pgm_uint32_lt (first_sequence, window->commit_lead) ||
+	    pgm_uint32_gt (first_sequence, window->lead))
+		return NULL;
+
+	state = pgm_rxw_peek_state (window, first_sequence);
+	if (state->apdu)
+		return (apdu_len == state->apdu->len) ? state->apdu : NULL;
+
+	pgm_assert_cmpuint (apdu_len, <=, PGM_MAX_APDU);
+	apdu		= pgm_alloc_skb ((uint16_t)apdu_len);
+	apdu->tstamp	= skb->tstamp;
+	apdu->sequence	= first_sequence;
+	memcpy (&apdu->tsi, &skb->tsi, sizeof(pgm_tsi_t));
+	pgm_skb_put (apdu, (uint16_t)apdu_len);
+	state->apdu	= apdu;
+	return apdu;
+}
+
+/* copy a newly arrived fragment into the APDU reassembly buffer.  a deferred
+ * checksum is calculated in the same pass as the copy, on mismatch the
+ * fragment header cannot be trusted and the buffer of the referenced APDU is
+ * discarded to be rebuilt at delivery.  the fragment is left pending for
+ * _pgm_rxw_verify_csum() to request repair.
+ */
+
+static
+void
+_pgm_rxw_reassemble_fragment (
+	pgm_rxw_t*	      const restrict window,
+	struct pgm_sk_buff_t* const restrict skb
+	)
+{
+	struct pgm_sk_buff_t* apdu;
+	pgm_rxw_state_t *state, *first_state;
+
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (NULL != skb);
+	pgm_assert (NULL != skb->pgm_opt_fragment);
+
+	const uint32_t frag_offset = pgm_ntohl (skb->of_frag_offset);
+	const uint32_t apdu_len	   = pgm_ntohl (skb->of_apdu_len);
+
+	pgm_assert_cmpuint (apdu_len, >=, skb->len);
+	if (PGM_UNLIKELY(frag_offset > apdu_len - skb->len))
+		return;
+
+	apdu = _pgm_rxw_apdu_buffer (window, skb);
+	if (NULL == apdu)
+		return;
+
+	state = pgm_rxw_peek_state (window, skb->sequence);
+	if (PGM_LIKELY(!skb->csum_pending)) {
+		memcpy ((char*)apdu->data + frag_offset, skb->data, skb->len);
+		state->is_reassembled = 1;
+		return;
+	}
+
+	const uint16_t header_length = (uint16_t)((char*)skb->data - (char*)skb->pgm_header);
+	const uint16_t sum = skb->pgm_header->pgm_checksum;
+	skb->pgm_header->pgm_checksum = 0;
+	const uint32_t unfolded_header = pgm_csum_partial ((const char*)skb->pgm_header, header_length, 0);
+	skb->pgm_header->pgm_checksum = sum;
+	const uint32_t unfolded_odata = pgm_csum_partial_copy (skb->data, (char*)apdu->data + frag_offset, skb->len, 0);
+	if (PGM_LIKELY(sum == pgm_csum_fold (pgm_csum_block_add (unfolded_header, unfolded_odata, header_length)))) {
+		skb->csum_pending = 0;
+		state->is_reassembled = 1;
+		return;
+	}
+
+	first_state = pgm_rxw_peek_state (window, apdu->sequence);
+	for (uint32_t sequence = apdu->sequence; pgm_uint32_lte (sequence, window->lead); sequence++)
+		pgm_rxw_peek_state (window, sequence)->is_reassembled = 0;
+	first_state->apdu = NULL;
+	pgm_free_skb (apdu);
+}
+
+/* returns first sequence of the interleave block containing sequence (SQN),
+ * a block spans tg_size × depth sequences.  without interleaving the block is
+ * the transmission group.
+ */
+
+static inline
+uint32_t
+_pgm_rxw_tg_block (
+	pgm_rxw_t* const	window,
+	const uint32_t		sequence
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != window);
+
+	const uint32_t tg_block_mask = 0xffffffff << (window->tg_sqn_shift + window->tg_depth_shift);
+	return sequence & tg_block_mask;
+}
+
+/* returns transmission group sequence (TG_SQN) from sequence (SQN).  an
+ * interleaved group is every depth'th sequence of the block, identified by
+ * its first member.
  */
 
 static inline
@@ -1722,8 +2255,8 @@ _pgm_rxw_tg_sqn (
 /* pre-conditions */
 	pgm_assert (NULL != window);
 
-	const uint32_t tg_sqn_mask = 0xffffffff << window->tg_sqn_shift;
-	return sequence & tg_sqn_mask;
+	const uint32_t tg_stripe_mask = ~(0xffffffff << window->tg_depth_shift);
+	return _pgm_rxw_tg_block (window, sequence) | (sequence & tg_stripe_mask);
 }
 
 /* returns packet number (PKT_SQN) from sequence (SQN).
@@ -1739,8 +2272,24 @@ _pgm_rxw_pkt_sqn (
 /* pre-conditions */
 	pgm_assert (NULL != window);
 
-	const uint32_t tg_sqn_mask = 0xffffffff << window->tg_sqn_shift;
-	return sequence & ~tg_sqn_mask;
+	return (sequence - _pgm_rxw_tg_block (window, sequence)) >> window->tg_depth_shift;
+}
+
+/* returns sequence of packet number (PKT_SQN) of a transmission group.
+ */
+
+static inline
+uint32_t
+_pgm_rxw_tg_member (
+	pgm_rxw_t* const	window,
+	const uint32_t		tg_sqn,
+	const uint32_t		pkt_sqn
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != window);
+
+	return tg_sqn + (pkt_sqn << window->tg_depth_shift);
 }
 
 /* returns TRUE when the sequence is the first of a transmission group.
@@ -1792,7 +2341,7 @@ _pgm_rxw_state (
 	pgm_assert (NULL != window);
 	pgm_assert (NULL != skb);
 
-	state = (pgm_rxw_state_t*)&skb->cb;
+	state = pgm_rxw_peek_state (window, skb->sequence);
 
 /* remove current state */
 	if (PGM_PKT_STATE_ERROR != state->pkt_state)
@@ -1872,7 +2421,7 @@ _pgm_rxw_unlink (
 	pgm_assert (NULL != window);
 	pgm_assert (NULL != skb);
 
-	state = (pgm_rxw_state_t*)&skb->cb;
+	state = pgm_rxw_peek_state (window, skb->sequence);
 
 	switch (state->pkt_state) {
 	case PGM_PKT_STATE_BACK_OFF:
@@ -1960,7 +2509,7 @@ pgm_rxw_lost (
 	skb = _pgm_rxw_peek (window, sequence);
 	pgm_assert (NULL != skb);
 
-	state = (pgm_rxw_state_t*)&skb->cb;
+	state = pgm_rxw_peek_state (window, skb->sequence);
 
 	if (PGM_UNLIKELY(!(state->pkt_state == PGM_PKT_STATE_BACK_OFF  ||
 	                 state->pkt_state == PGM_PKT_STATE_WAIT_NCF  ||
@@ -2048,7 +2597,7 @@ _pgm_rxw_recovery_update (
 /* fetch skb from window and bump expiration times */
 	skb = _pgm_rxw_peek (window, sequence);
 	pgm_assert (NULL != skb);
-	state = (pgm_rxw_state_t*)&skb->cb;
+	state = pgm_rxw_peek_state (window, skb->sequence);
 	switch (state->pkt_state) {
 	case PGM_PKT_STATE_BACK_OFF:
 	case PGM_PKT_STATE_WAIT_NCF:
@@ -2114,13 +2663,13 @@ _pgm_rxw_recovery_append (
  */
 	window->data_loss = window->ack_c_p + pgm_fp16mul (pgm_fp16 (1) - window->ack_c_p, window->data_loss);
 
-	skb			= pgm_alloc_skb (window->max_tpdu);
-	state			= (pgm_rxw_state_t*)&skb->cb;
+	skb			= pgm_arena_alloc_skb (window->arena, window->max_tpdu);
 	skb->tstamp		= now;
 	skb->sequence		= window->lead;
+	state			= pgm_rxw_peek_state (window, skb->sequence);
 	state->timer_expiry	= nak_rdata_expiry;
 
-	const uint_fast32_t index_	= pgm_rxw_lead (window) % pgm_rxw_max_length (window);
+	const uint_fast32_t index_	= pgm_rxw_lead (window) & window->mask;
 	window->pdata[index_]		= skb;
 	_pgm_rxw_state (window, skb, PGM_PKT_STATE_WAIT_DATA);
 
@@ -2148,6 +2697,7 @@ pgm_rxw_dump (
 		"max_tpdu = %" PRIu16 ", "
 		"tg_size = %" PRIu32 ", "
 		"tg_sqn_shift = %u, "
+		"tg_depth_shift = %u, "
 		"lead = %" PRIu32 ", "
 		"trail = %" PRIu32 ", "
 		"rxw_trail = %" PRIu32 ", "
@@ -2191,6 +2741,7 @@ pgm_rxw_dump (
 		window->max_tpdu,
 		window->tg_size,
 		window->tg_sqn_shift,
+		window->tg_depth_shift,
 		window->lead,
 		window->trail,
 		window->rxw_trail,
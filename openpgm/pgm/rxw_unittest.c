@@ -77,6 +77,8 @@ mock_pgm_rs_create (
 	uint8_t			k
 	)
 {
+	rs->n = n;
+	rs->k = k;
 }
 
 void
@@ -139,6 +141,41 @@ generate_valid_skb (void)
 	return skb;
 }
 
+/* generate fragment of an APDU of 1000 byte fragments, payload filled with
+ * the fragment number.
+ */
+static
+struct pgm_sk_buff_t*
+generate_fragment_skb (
+	const uint32_t		first_sqn,
+	const unsigned		fragment,
+	const unsigned		fragment_count
+	)
+{
+	const pgm_tsi_t tsi = { { 200, 202, 203, 204, 205, 206 }, 2000 };
+	const guint16 tsdu_length = 1000;
+	const guint16 header_length = sizeof(struct pgm_header) + sizeof(struct pgm_data) + sizeof(struct pgm_opt_fragment);
+	struct pgm_sk_buff_t* skb = pgm_alloc_skb (1500);
+	memcpy (&skb->tsi, &tsi, sizeof(tsi));
+	skb->sock = (pgm_sock_t*)0x1;
+	skb->tstamp = pgm_time_now;
+/* header */
+	pgm_skb_reserve (skb, header_length);
+	memset (skb->head, 0, header_length);
+	skb->pgm_header = (struct pgm_header*)skb->head;
+	skb->pgm_data   = (struct pgm_data*)(skb->pgm_header + 1);
+	skb->pgm_opt_fragment = (struct pgm_opt_fragment*)(skb->pgm_data + 1);
+	skb->pgm_header->pgm_type = PGM_ODATA;
+	skb->pgm_header->pgm_tsdu_length = g_htons (tsdu_length);
+	skb->pgm_data->data_sqn = g_htonl (first_sqn + fragment);
+	skb->of_apdu_first_sqn = g_htonl (first_sqn);
+	skb->of_frag_offset = g_htonl (fragment * tsdu_length);
+	skb->of_apdu_len = g_htonl (fragment_count * tsdu_length);
+/* DATA */
+	memset (pgm_skb_put (skb, tsdu_length), fragment, tsdu_length);
+	return skb;
+}
+
 /* target:
  *	pgm_rxw_t*
  *	pgm_rxw_create (
@@ -147,7 +184,9 @@ generate_valid_skb (void)
  *		const unsigned		sqns,
  *		const unsigned		secs,
  *		const ssize_t		max_rte,
- *		const uint32_t		ack_c_p
+ *		const uint32_t		ack_c_p,
+ *		pgm_arena_t*		arena,
+ *		pgm_heap_t*		heap
  *		)
  */
 
@@ -156,7 +195,7 @@ START_TEST (test_create_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	fail_if (NULL == pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p), "create failed");
+	fail_if (NULL == pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL), "create failed");
 }
 END_TEST
 
@@ -165,7 +204,7 @@ START_TEST (test_create_pass_002)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	fail_if (NULL == pgm_rxw_create (&tsi, 1500, 0, 60, 800000, ack_c_p), "create failed");
+	fail_if (NULL == pgm_rxw_create (&tsi, 1500, 0, 60, 800000, ack_c_p, NULL, NULL), "create failed");
 }
 END_TEST
 
@@ -174,7 +213,7 @@ START_TEST (test_create_pass_003)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	fail_if (NULL == pgm_rxw_create (&tsi, 9000, 0, 60, 800000, ack_c_p), "create failed");
+	fail_if (NULL == pgm_rxw_create (&tsi, 9000, 0, 60, 800000, ack_c_p, NULL, NULL), "create failed");
 }
 END_TEST
 
@@ -183,7 +222,7 @@ START_TEST (test_create_pass_004)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	fail_if (NULL == pgm_rxw_create (&tsi, UINT16_MAX, 0, 60, 800000, ack_c_p), "create failed");
+	fail_if (NULL == pgm_rxw_create (&tsi, UINT16_MAX, 0, 60, 800000, ack_c_p, NULL, NULL), "create failed");
 }
 END_TEST
 
@@ -191,7 +230,7 @@ END_TEST
 START_TEST (test_create_fail_001)
 {
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (NULL, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (NULL, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail ("reached");
 }
 END_TEST
@@ -201,7 +240,7 @@ START_TEST (test_create_fail_002)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	fail_if (NULL == pgm_rxw_create (&tsi, 0, 100, 0, 0, ack_c_p), "create failed");
+	fail_if (NULL == pgm_rxw_create (&tsi, 0, 100, 0, 0, ack_c_p, NULL, NULL), "create failed");
 }
 END_TEST
 
@@ -209,7 +248,7 @@ START_TEST (test_create_fail_003)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 0, 0, 60, 800000, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 0, 0, 60, 800000, ack_c_p, NULL, NULL);
 	fail ("reached");
 }
 END_TEST
@@ -219,7 +258,7 @@ START_TEST (test_create_fail_004)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 0, 0, 0, 800000, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 0, 0, 0, 800000, ack_c_p, NULL, NULL);
 	fail ("reached");
 }
 END_TEST
@@ -229,7 +268,7 @@ START_TEST (test_create_fail_005)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 0, 0, 60, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 0, 0, 60, 0, ack_c_p, NULL, NULL);
 	fail ("reached");
 }
 END_TEST
@@ -237,7 +276,7 @@ END_TEST
 /* all invalid */
 START_TEST (test_create_fail_006)
 {
-	pgm_rxw_t* window = pgm_rxw_create (NULL, 0, 0, 0, 0, 0);
+	pgm_rxw_t* window = pgm_rxw_create (NULL, 0, 0, 0, 0, 0, NULL, NULL);
 	fail ("reached");
 }
 END_TEST
@@ -253,7 +292,7 @@ START_TEST (test_destroy_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	pgm_rxw_destroy (window);
 }
@@ -281,7 +320,7 @@ START_TEST (test_add_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
 	fail_if (NULL == skb, "generate_valid_skb failed");
@@ -298,7 +337,7 @@ START_TEST (test_add_pass_002)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-        pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+        pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
         fail_if (NULL == window, "create failed");
 /* #1 */
         struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -326,7 +365,7 @@ START_TEST (test_add_pass_003)
 {
         pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-        pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+        pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
         fail_if (NULL == window, "create failed");
 /* #1 */
         struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -354,7 +393,7 @@ START_TEST (test_add_pass_004)
 {
         pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-        pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+        pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
         fail_if (NULL == window, "create failed");
         struct pgm_sk_buff_t* skb = generate_valid_skb ();
         fail_if (NULL == skb, "generate_valid_skb failed"); 
@@ -371,7 +410,7 @@ START_TEST (test_add_pass_005)
 {
         pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-        pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+        pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
         fail_if (NULL == window, "create failed");
 /* #1 */
         struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -409,12 +448,173 @@ START_TEST (test_add_pass_005)
 }
 END_TEST
 
+/* sequence wrap with a window length that is not a power of two */
+START_TEST (test_add_pass_006)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
+	fail_if (NULL == window, "create failed");
+	fail_unless (100 == pgm_rxw_max_length (window), "max_length failed");
+	fail_unless (127 == window->mask, "mask not rounded to power of two");
+	const uint32_t first = UINT32_MAX - 150;
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+	struct pgm_sk_buff_t* skb;
+/* append across the wrap leaving one gap */
+	for (uint32_t i = 0; i < 300; i++) {
+		if (250 == i)
+			continue;
+		skb = generate_valid_skb ();
+		fail_if (NULL == skb, "generate_valid_skb failed");
+		skb->pgm_data->data_sqn = g_htonl (first + i);
+		skb->pgm_data->data_trail = g_htonl (first);
+		const int status = pgm_rxw_add (window, skb, now, nak_rb_expiry);
+		if (251 == i)
+			fail_unless (PGM_RXW_MISSING == status, "add not missing");
+		else
+			fail_unless (PGM_RXW_APPENDED == status, "add not appended");
+	}
+	fail_unless (PGM_PKT_STATE_BACK_OFF == pgm_rxw_peek_state (window, first + 250)->pkt_state, "placeholder not back-off");
+/* fill gap */
+	skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (first + 250);
+	skb->pgm_data->data_trail = g_htonl (first);
+	fail_unless (PGM_RXW_INSERTED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not inserted");
+	fail_unless (100 == pgm_rxw_length (window), "length failed");
+	for (uint32_t sequence = window->trail; sequence != window->lead + 1; sequence++) {
+		skb = pgm_rxw_peek (window, sequence);
+		fail_if (NULL == skb, "peek failed");
+		fail_unless (sequence == skb->sequence, "peek returned wrong sequence");
+		fail_unless (PGM_PKT_STATE_HAVE_DATA == pgm_rxw_peek_state (window, sequence)->pkt_state, "state not have-data");
+	}
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+/* compacted skbuff holds only the packet */
+START_TEST (test_add_pass_007)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
+	fail_if (NULL == window, "create failed");
+	struct pgm_sk_buff_t* skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (0);
+	memset (skb->data, 0xa5, skb->len);
+	struct pgm_sk_buff_t* compact_skb = pgm_skb_compact (skb);
+	fail_if (NULL == compact_skb, "compact failed");
+	fail_unless (compact_skb->truesize < skb->truesize, "compact not smaller");
+	fail_unless (0 == ((uintptr_t)compact_skb->head % PGM_SKB_CACHELINE), "payload not line aligned");
+	fail_unless (compact_skb->tail == compact_skb->end, "tailroom remains");
+	fail_unless (compact_skb->len == skb->len, "len mismatch");
+	fail_unless ((char*)compact_skb->pgm_data == (char*)compact_skb->head + sizeof(struct pgm_header), "pgm_data not relocated");
+	fail_unless (0 == memcmp (compact_skb->data, skb->data, skb->len), "payload mismatch");
+	pgm_free_skb (skb);
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+	fail_unless (PGM_RXW_APPENDED == pgm_rxw_add (window, compact_skb, now, nak_rb_expiry), "add not appended");
+	fail_unless (compact_skb == pgm_rxw_peek (window, 0), "peek failed");
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+/* parity displaced by original data moves without the reassembly state of
+ * either sequence.
+ */
+START_TEST (test_add_pass_008)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
+	fail_if (NULL == window, "create failed");
+	pgm_rxw_update_fec (window, 4, 1);
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+	struct pgm_sk_buff_t* skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (0);
+	fail_unless (PGM_RXW_APPENDED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not appended");
+	skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (3);
+	fail_unless (PGM_RXW_MISSING == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not missing");
+/* parity fills #1 */
+	struct pgm_sk_buff_t* parity_skb = generate_valid_skb ();
+	fail_if (NULL == parity_skb, "generate_valid_skb failed");
+	parity_skb->pgm_header->pgm_options |= PGM_OPT_PARITY;
+	parity_skb->pgm_data->data_sqn = g_htonl (0);
+	fail_unless (PGM_RXW_INSERTED == pgm_rxw_add (window, parity_skb, now, nak_rb_expiry), "add not inserted");
+	fail_unless (parity_skb == pgm_rxw_peek (window, 1), "peek failed");
+	struct pgm_sk_buff_t* apdu = pgm_alloc_skb (100);
+	pgm_rxw_peek_state (window, 1)->apdu = apdu;
+	pgm_rxw_peek_state (window, 1)->is_reassembled = 1;
+/* original #1 pushes parity on to #2 */
+	skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (1);
+	fail_unless (PGM_RXW_INSERTED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not inserted");
+	fail_unless (skb == pgm_rxw_peek (window, 1), "peek failed");
+	fail_unless (parity_skb == pgm_rxw_peek (window, 2), "peek failed");
+	fail_unless (PGM_PKT_STATE_HAVE_DATA == pgm_rxw_peek_state (window, 1)->pkt_state, "state failed");
+	fail_unless (PGM_PKT_STATE_HAVE_PARITY == pgm_rxw_peek_state (window, 2)->pkt_state, "state failed");
+	fail_unless (apdu == pgm_rxw_peek_state (window, 1)->apdu, "apdu moved");
+	fail_unless (1 == pgm_rxw_peek_state (window, 1)->is_reassembled, "is_reassembled moved");
+	fail_unless (NULL == pgm_rxw_peek_state (window, 2)->apdu, "apdu moved");
+	fail_unless (0 == pgm_rxw_peek_state (window, 2)->is_reassembled, "is_reassembled moved");
+	pgm_rxw_peek_state (window, 1)->apdu = NULL;
+	pgm_free_skb (apdu);
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+/* parity fills the gaps of its transmission group in order, surplus parity
+ * is a duplicate.
+ */
+START_TEST (test_add_pass_009)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
+	fail_if (NULL == window, "create failed");
+	pgm_rxw_update_fec (window, 4, 1);
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+	struct pgm_sk_buff_t* skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (0);
+	fail_unless (PGM_RXW_APPENDED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not appended");
+	skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (3);
+	fail_unless (PGM_RXW_MISSING == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not missing");
+/* parity index h is carried in the sequence, group #0 */
+	for (unsigned h = 0; h < 3; h++) {
+		skb = generate_valid_skb ();
+		fail_if (NULL == skb, "generate_valid_skb failed");
+		skb->pgm_header->pgm_options |= PGM_OPT_PARITY;
+		skb->pgm_data->data_sqn = g_htonl (0 | h);
+		if (h < 2) {
+			fail_unless (PGM_RXW_INSERTED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not inserted");
+			fail_unless (skb == pgm_rxw_peek (window, 1 + h), "peek failed");
+			fail_unless (PGM_PKT_STATE_HAVE_PARITY == pgm_rxw_peek_state (window, 1 + h)->pkt_state, "state failed");
+		} else {
+			fail_unless (PGM_RXW_DUPLICATE == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not duplicate");
+			pgm_free_skb (skb);
+		}
+	}
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
 /* null skb */
 START_TEST (test_add_fail_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	const pgm_time_t now = 1;
 	const pgm_time_t nak_rb_expiry = 2;
@@ -441,7 +641,7 @@ START_TEST (test_add_fail_003)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	char buffer[1500];
 	memset (buffer, 0, sizeof(buffer));
@@ -457,7 +657,7 @@ START_TEST (test_add_fail_004)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
 	fail_if (NULL == skb, "generate_valid_skb failed");
@@ -480,7 +680,7 @@ START_TEST (test_peek_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	fail_unless (NULL == pgm_rxw_peek (window, 0), "peek failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -512,7 +712,7 @@ START_TEST (test_max_length_pass_001)
 	const guint window_length = 100;
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, window_length, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, window_length, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	fail_unless (window_length == pgm_rxw_max_length (window), "max_length failed");
 	pgm_rxw_destroy (window);
@@ -532,7 +732,7 @@ START_TEST (test_length_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	fail_unless (0 == pgm_rxw_length (window), "length failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -565,7 +765,7 @@ START_TEST (test_size_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	fail_unless (0 == pgm_rxw_size (window), "size failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -598,7 +798,7 @@ START_TEST (test_is_empty_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	fail_unless (pgm_rxw_is_empty (window), "is_empty failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -625,7 +825,7 @@ START_TEST (test_is_full_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 1, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 1, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	fail_if (pgm_rxw_is_full (window), "is_full failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -652,7 +852,7 @@ START_TEST (test_lead_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	guint32 lead = pgm_rxw_lead (window);
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -679,7 +879,7 @@ START_TEST (test_next_lead_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	guint32 next_lead = pgm_rxw_next_lead (window);
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -713,7 +913,7 @@ START_TEST (test_readv_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_msgv_t msgv[2], *pmsg;
 /* #1 empty */
@@ -767,7 +967,7 @@ START_TEST (test_readv_pass_002)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_msgv_t msgv[2], *pmsg;
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -792,7 +992,7 @@ START_TEST (test_readv_pass_003)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_msgv_t msgv[1], *pmsg;
 	struct pgm_sk_buff_t* skb;
@@ -829,7 +1029,7 @@ START_TEST (test_readv_pass_004)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_msgv_t msgv[1], *pmsg;
 	struct pgm_sk_buff_t* skb;
@@ -866,7 +1066,7 @@ START_TEST (test_readv_pass_005)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_msgv_t msgv[1], *pmsg;
 	struct pgm_sk_buff_t* skb;
@@ -921,7 +1121,7 @@ START_TEST (test_readv_pass_006)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_msgv_t msgv[1], *pmsg;
 	struct pgm_sk_buff_t* skb;
@@ -976,6 +1176,64 @@ START_TEST (test_readv_pass_006)
 }
 END_TEST
 
+/* fragmented APDU reassembled into one contiguous skbuff, fragments arriving
+ * out of order.
+ */
+START_TEST (test_readv_pass_010)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
+	fail_if (NULL == window, "create failed");
+	window->is_reassembling = 1;
+	struct pgm_msgv_t msgv[1], *pmsg;
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+	struct pgm_sk_buff_t* skb = generate_fragment_skb (0, 0, 3);
+	fail_unless (PGM_RXW_APPENDED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not appended");
+	skb = generate_fragment_skb (0, 2, 3);
+	fail_unless (PGM_RXW_MISSING == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not missing");
+	pmsg = msgv;
+	fail_unless (-1 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	skb = generate_fragment_skb (0, 1, 3);
+	fail_unless (PGM_RXW_INSERTED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not inserted");
+	pmsg = msgv;
+	fail_unless (3000 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	fail_unless (1 == msgv[0].msgv_len, "msgv_len failed");
+	skb = msgv[0].msgv_skb[0];
+	fail_unless (3000 == skb->len, "len failed");
+	fail_unless (0 == skb->sequence, "sequence failed");
+	for (unsigned i = 0; i < 3; i++)
+		fail_unless (i == ((guint8*)skb->data)[ i * 1000 ] && i == ((guint8*)skb->data)[ i * 1000 + 999 ], "data failed");
+	pgm_rxw_remove_commit (window);
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+/* reassembly lifts the PGM_MAX_FRAGMENTS limit */
+START_TEST (test_readv_pass_011)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
+	fail_if (NULL == window, "create failed");
+	window->is_reassembling = 1;
+	struct pgm_msgv_t msgv[1], *pmsg;
+	const unsigned count = PGM_MAX_FRAGMENTS + 4;
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+	for (unsigned i = 0; i < count; i++) {
+		struct pgm_sk_buff_t* skb = generate_fragment_skb (0, i, count);
+		fail_unless (PGM_RXW_APPENDED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not appended");
+	}
+	pmsg = msgv;
+	fail_unless ((ssize_t)(count * 1000) == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	fail_unless (1 == msgv[0].msgv_len, "msgv_len failed");
+	fail_unless ((count - 1) == ((guint8*)msgv[0].msgv_skb[0]->data)[ count * 1000 - 1 ], "data failed");
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
 /* NULL window */
 START_TEST (test_readv_fail_001)
 {
@@ -990,7 +1248,7 @@ START_TEST (test_readv_fail_002)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
 	fail_if (NULL == skb, "generate_valid_skb failed");
@@ -1009,7 +1267,7 @@ START_TEST (test_readv_fail_003)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
 	fail_if (NULL == skb, "generate_valid_skb failed");
@@ -1036,7 +1294,7 @@ START_TEST (test_remove_commit_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_msgv_t msgv[1], *pmsg;
 	struct pgm_sk_buff_t* skb;
@@ -1127,7 +1385,7 @@ START_TEST (test_remove_trail_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_msgv_t msgv[2], *pmsg;
 	fail_unless (0 == pgm_rxw_remove_trail (window), "remove_trail failed");
@@ -1174,7 +1432,7 @@ START_TEST (test_update_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	const pgm_time_t now = 1;
 	const pgm_time_t nak_rb_expiry = 2;
@@ -1223,7 +1481,7 @@ START_TEST (test_confirm_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	const pgm_time_t now = 1;
 	const pgm_time_t nak_rdata_expiry = 2;
@@ -1256,7 +1514,7 @@ START_TEST (test_confirm_pass_002)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_msgv_t msgv[1], *pmsg;
 	struct pgm_sk_buff_t* skb;
@@ -1321,7 +1579,7 @@ START_TEST (test_lost_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	const pgm_time_t now = 1;
 	const pgm_time_t nak_rdata_expiry = 2;
@@ -1370,7 +1628,7 @@ START_TEST (test_state_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	const pgm_time_t now = 1;
 	const pgm_time_t nak_rdata_expiry = 2;
@@ -1398,7 +1656,7 @@ START_TEST (test_state_fail_002)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	pgm_rxw_state (window, NULL, PGM_PKT_STATE_BACK_OFF);
 	fail ("reached");
@@ -1409,7 +1667,7 @@ START_TEST (test_state_fail_003)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
 	fail_if (NULL == skb, "generate_valid_skb failed");
@@ -1426,7 +1684,7 @@ START_TEST (test_has_pending_pass_001)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 /* empty */
 	fail_unless (0 == window->has_event, "unexpected event");
@@ -1472,6 +1730,62 @@ START_TEST (test_has_pending_pass_001)
 }
 END_TEST
 
+/* target:
+ *	void
+ *	_pgm_rxw_reconstruct_insert (
+ *		pgm_rxw_t*		window,
+ *		pgm_fec_job_t*		job
+ *		)
+ */
+
+/* repair of a sequence already read by the application is discarded */
+START_TEST (test_reconstruct_insert_pass_001)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
+	fail_if (NULL == window, "create failed");
+	pgm_rxw_update_fec (window, 4, 1);
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+	for (unsigned i = 0; i < 4; i++) {
+		struct pgm_sk_buff_t* skb = generate_valid_skb ();
+		fail_if (NULL == skb, "generate_valid_skb failed");
+		skb->pgm_data->data_sqn = g_htonl (i);
+		fail_unless (PGM_RXW_APPENDED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not appended");
+	}
+/* #0 held by the application */
+	struct pgm_msgv_t msgv[1], *pmsg = msgv;
+	fail_unless (1000 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	struct pgm_sk_buff_t* committed_skb = pgm_rxw_peek (window, 0);
+	fail_unless (PGM_PKT_STATE_COMMIT_DATA == pgm_rxw_peek_state (window, 0)->pkt_state, "state failed");
+/* #0 and #1 decoded whilst received */
+	struct pgm_sk_buff_t* tg_skbs[4] = { NULL };
+	uint8_t offsets[4] = { 4, 4, 2, 3 };
+	pgm_fec_job_t job;
+	memset (&job, 0, sizeof(job));
+	job.tg_sqn  = 0;
+	job.rs_n    = window->rs.n;
+	job.rs_k    = window->rs.k;
+	job.tg_skbs = tg_skbs;
+	job.offsets = offsets;
+	for (unsigned i = 0; i < 2; i++) {
+		tg_skbs[i] = generate_valid_skb ();
+		fail_if (NULL == tg_skbs[i], "generate_valid_skb failed");
+		tg_skbs[i]->sequence = i;
+	}
+	_pgm_rxw_reconstruct_insert (window, &job);
+	fail_unless (NULL != tg_skbs[0], "commit data replaced");
+	fail_unless (NULL != tg_skbs[1], "have data replaced");
+	fail_unless (committed_skb == pgm_rxw_peek (window, 0), "peek failed");
+	fail_unless (PGM_PKT_STATE_COMMIT_DATA == pgm_rxw_peek_state (window, 0)->pkt_state, "state failed");
+	pgm_free_skb (tg_skbs[0]);
+	pgm_free_skb (tg_skbs[1]);
+	pgm_rxw_remove_commit (window);
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
 static
 Suite*
 make_basic_test_suite (void)
@@ -1507,6 +1821,10 @@ make_basic_test_suite (void)
 	tcase_add_test (tc_add, test_add_pass_003);
 	tcase_add_test (tc_add, test_add_pass_004);
 	tcase_add_test (tc_add, test_add_pass_005);
+	tcase_add_test (tc_add, test_add_pass_006);
+	tcase_add_test (tc_add, test_add_pass_007);
+	tcase_add_test (tc_add, test_add_pass_008);
+	tcase_add_test (tc_add, test_add_pass_009);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_add, test_add_fail_001, SIGABRT);
 	tcase_add_test_raise_signal (tc_add, test_add_fail_002, SIGABRT);
@@ -1577,6 +1895,8 @@ make_basic_test_suite (void)
 	tcase_add_test (tc_readv, test_readv_pass_004);
 	tcase_add_test (tc_readv, test_readv_pass_005);
 	tcase_add_test (tc_readv, test_readv_pass_006);
+	tcase_add_test (tc_readv, test_readv_pass_010);
+	tcase_add_test (tc_readv, test_readv_pass_011);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_readv, test_readv_fail_001, SIGABRT);
 	tcase_add_test_raise_signal (tc_readv, test_readv_fail_002, SIGABRT);
@@ -1620,6 +1940,10 @@ make_basic_test_suite (void)
 	tcase_add_test_raise_signal (tc_state, test_state_fail_001, SIGABRT);
 #endif
 
+	TCase* tc_reconstruct_insert = tcase_create ("reconstruct-insert");
+	suite_add_tcase (s, tc_reconstruct_insert);
+	tcase_add_test (tc_reconstruct_insert, test_reconstruct_insert_pass_001);
+
 	return s;
 }
 
@@ -1628,7 +1952,7 @@ START_TEST (test_readv_pass_007)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_msgv_t msgv[1], *pmsg;
 	struct pgm_sk_buff_t* skb;
@@ -1701,7 +2025,7 @@ START_TEST (test_readv_pass_008)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_msgv_t msgv[1], *pmsg;
 	struct pgm_sk_buff_t* skb;
@@ -1776,7 +2100,7 @@ START_TEST (test_readv_pass_009)
 {
 	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
 	const uint32_t ack_c_p = 500;
-	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_msgv_t msgv[1], *pmsg;
 	struct pgm_sk_buff_t* skb;
@@ -0,0 +1,248 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * Bounded multi-producer, single-consumer queue of original data skbuffs.
+ *
+ * Producers claim a slot by compare-and-swap on the enqueue position and
+ * publish it by a release store of the slot sequence, so application threads
+ * never serialise on the source mutex to submit data.  The single consumer
+ * is whichever caller wins the drain flag, it assigns transmit window
+ * sequence numbers in dequeue order.
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#include <impl/framework.h>
+
+
+//#define SENDQ_DEBUG
+
+#ifndef SENDQ_DEBUG
+#	define PGM_DISABLE_ASSERT
+#endif
+
+/* slot sequence equals the enqueue position when free, position + 1 when
+ * published, and position + length once consumed.
+ */
+struct pgm_sendq_slot_t {
+	volatile uint32_t		sequence;
+	struct pgm_sk_buff_t*		skb;
+};
+
+struct pgm_sendq_t {
+	uint32_t			mask;			/* length - 1 */
+	volatile uint32_t		enqueue_pos;		/* producers */
+	volatile uint32_t		dequeue_pos;		/* consumer */
+	volatile uint32_t		is_draining;		/* consumer election */
+/* C90 and older */
+	struct pgm_sendq_slot_t		slots[1];
+};
+
+
+/* constructor for send queue, length is rounded up to a power of two.
+ *
+ * returns pointer to queue.
+ */
+
+PGM_GNUC_INTERNAL
+pgm_sendq_t*
+pgm_sendq_create (
+	const unsigned		length
+	)
+{
+	pgm_sendq_t* queue;
+	unsigned alloc = 2;
+
+/* pre-conditions */
+	pgm_assert_cmpuint (length, >, 0);
+	pgm_assert_cmpuint (length, <=, PGM_SENDQ_MAX_LENGTH);
+
+	pgm_debug ("create (length:%u)", length);
+
+	while (alloc < length)
+		alloc <<= 1;
+
+	queue = pgm_malloc0 (sizeof(pgm_sendq_t) + ( (alloc - 1) * sizeof(struct pgm_sendq_slot_t) ));
+	queue->mask = alloc - 1;
+	for (unsigned i = 0; i < alloc; i++)
+		queue->slots[i].sequence = i;
+
+/* post-conditions */
+	pgm_assert (pgm_sendq_is_empty (queue));
+	return queue;
+}
+
+/* destructor for send queue, skbuffs remaining in the queue are released.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_sendq_destroy (
+	pgm_sendq_t*const	queue
+	)
+{
+	struct pgm_sk_buff_t* skb;
+
+/* pre-conditions */
+	pgm_assert (NULL != queue);
+
+	pgm_debug ("destroy (queue:%p)", (const void*)queue);
+
+	while (NULL != (skb = pgm_sendq_pop (queue)))
+		pgm_free_skb (skb);
+	pgm_free (queue);
+}
+
+/* add skb to the tail of the queue taking ownership, safe from any thread.
+ *
+ * returns TRUE on success, returns FALSE if the queue is full.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_sendq_push (
+	pgm_sendq_t*	      const restrict queue,
+	struct pgm_sk_buff_t* const restrict skb
+	)
+{
+	struct pgm_sendq_slot_t* slot;
+	uint32_t pos;
+
+/* pre-conditions */
+	pgm_assert (NULL != queue);
+	pgm_assert (NULL != skb);
+
+	pos = pgm_atomic_read32 (&queue->enqueue_pos);
+	for (;;)
+	{
+		slot = &queue->slots[ pos & queue->mask ];
+		const int32_t diff = (int32_t)(pgm_atomic_read32_acquire (&slot->sequence) - pos);
+		if (0 == diff) {
+			if (pgm_atomic_compare_and_exchange32 (&queue->enqueue_pos, pos + 1, pos))
+				break;
+		} else if (diff < 0) {
+/* slot of previous lap not yet consumed */
+			return FALSE;
+		}
+		pos = pgm_atomic_read32 (&queue->enqueue_pos);
+	}
+
+	slot->skb = skb;
+	pgm_atomic_write32_release (&slot->sequence, pos + 1);
+	return TRUE;
+}
+
+/* remove skb from the head of the queue passing ownership to the caller,
+ * consumer only.
+ *
+ * returns skb, or NULL if the queue is empty or the head slot is claimed but
+ * not yet published.
+ */
+
+PGM_GNUC_INTERNAL
+struct pgm_sk_buff_t*
+pgm_sendq_pop (
+	pgm_sendq_t*const	queue
+	)
+{
+	struct pgm_sendq_slot_t* slot;
+	struct pgm_sk_buff_t* skb;
+
+/* pre-conditions */
+	pgm_assert (NULL != queue);
+
+	const uint32_t pos = queue->dequeue_pos;
+	slot = &queue->slots[ pos & queue->mask ];
+	if (pgm_atomic_read32_acquire (&slot->sequence) != pos + 1)
+		return NULL;
+
+	skb = slot->skb;
+	slot->skb = NULL;
+/* free slot for the next lap */
+	pgm_atomic_write32_release (&slot->sequence, pos + queue->mask + 1);
+	queue->dequeue_pos = pos + 1;
+	return skb;
+}
+
+/* returns TRUE if no skb is published at the head of the queue.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_sendq_is_empty (
+	const pgm_sendq_t*const	queue
+	)
+{
+	pgm_assert (NULL != queue);
+
+	const uint32_t pos = pgm_atomic_read32 (&queue->dequeue_pos);
+	const struct pgm_sendq_slot_t* slot = &queue->slots[ pos & queue->mask ];
+	return (pgm_atomic_read32_acquire (&slot->sequence) != pos + 1);
+}
+
+PGM_GNUC_INTERNAL
+unsigned
+pgm_sendq_max_length (
+	const pgm_sendq_t*const	queue
+	)
+{
+	pgm_assert (NULL != queue);
+	return queue->mask + 1;
+}
+
+/* elect the calling thread as consumer.
+ *
+ * returns TRUE if elected, returns FALSE if another thread is draining.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_sendq_try_acquire (
+	pgm_sendq_t*const	queue
+	)
+{
+	pgm_assert (NULL != queue);
+
+/* test before test-and-set to keep the line shared whilst draining */
+	if (0 != pgm_atomic_read32 (&queue->is_draining))
+		return FALSE;
+	return pgm_atomic_compare_and_exchange32 (&queue->is_draining, 1, 0);
+}
+
+/* resign as consumer.  the full barrier orders the release against a
+ * producer publishing and then failing election, so one of the two
+ * observes the other.
+ *
+ * returns TRUE if data is pending and the caller should try to drain again.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_sendq_release (
+	pgm_sendq_t*const	queue
+	)
+{
+	pgm_assert (NULL != queue);
+	pgm_assert_cmpuint (queue->is_draining, ==, 1);
+
+	pgm_atomic_dec32 (&queue->is_draining);
+	return !pgm_sendq_is_empty (queue);
+}
+
+/* eof */
@@ -0,0 +1,213 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for the send submission queue.
+ *
+ * Copyright (c) 2009 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <glib.h>
+#include <check.h>
+
+#ifdef _WIN32
+#	define PGM_CHECK_NOFORK		1
+#endif
+
+
+/* mock state */
+
+#define SENDQ_DEBUG
+#include "sendq.c"
+
+
+/* mock functions for external references */
+
+size_t
+pgm_pkt_offset (
+        const bool                      can_fragment,
+        const sa_family_t		pgmcc_family	/* 0 = disable */
+        )
+{
+        return 0;
+}
+
+PGM_GNUC_INTERNAL
+int
+pgm_get_nprocs (void)
+{
+	return 1;
+}
+
+
+/* target:
+ *	pgm_sendq_t*
+ *	pgm_sendq_create (
+ *		const unsigned		length
+ *	)
+ */
+
+START_TEST (test_create_pass_001)
+{
+	pgm_sendq_t* queue = pgm_sendq_create (100);
+	fail_if (NULL == queue, "create failed");
+	fail_unless (128 == pgm_sendq_max_length (queue), "max_length failed");
+	fail_unless (TRUE == pgm_sendq_is_empty (queue), "is_empty failed");
+	pgm_sendq_destroy (queue);
+}
+END_TEST
+
+/* zero length */
+START_TEST (test_create_fail_001)
+{
+	pgm_sendq_t* queue = pgm_sendq_create (0);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_sendq_push (
+ *		pgm_sendq_t*		queue,
+ *		struct pgm_sk_buff_t*	skb
+ *	)
+ */
+
+/* first in first out, full queue rejects */
+START_TEST (test_push_pass_001)
+{
+	struct pgm_sk_buff_t* skb[ 4 ];
+	pgm_sendq_t* queue = pgm_sendq_create (4);
+	fail_if (NULL == queue, "create failed");
+	for (unsigned i = 0; i < G_N_ELEMENTS(skb); i++) {
+		skb[i] = pgm_alloc_skb (100);
+		fail_unless (TRUE == pgm_sendq_push (queue, skb[i]), "push failed");
+	}
+	struct pgm_sk_buff_t* extra = pgm_alloc_skb (100);
+	fail_unless (FALSE == pgm_sendq_push (queue, extra), "push failed");
+	for (unsigned i = 0; i < G_N_ELEMENTS(skb); i++) {
+		struct pgm_sk_buff_t* popped = pgm_sendq_pop (queue);
+		fail_unless (skb[i] == popped, "pop failed");
+		pgm_free_skb (popped);
+	}
+	fail_unless (NULL == pgm_sendq_pop (queue), "pop failed");
+/* next lap */
+	fail_unless (TRUE == pgm_sendq_push (queue, extra), "push failed");
+	fail_unless (FALSE == pgm_sendq_is_empty (queue), "is_empty failed");
+	pgm_sendq_destroy (queue);
+}
+END_TEST
+
+/* null skb */
+START_TEST (test_push_fail_001)
+{
+	pgm_sendq_t* queue = pgm_sendq_create (4);
+	fail_if (NULL == queue, "create failed");
+	const bool answer = pgm_sendq_push (queue, NULL);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_sendq_try_acquire (
+ *		pgm_sendq_t*		queue
+ *	)
+ */
+
+START_TEST (test_try_acquire_pass_001)
+{
+	pgm_sendq_t* queue = pgm_sendq_create (4);
+	fail_if (NULL == queue, "create failed");
+	fail_unless (TRUE == pgm_sendq_try_acquire (queue), "try_acquire failed");
+	fail_unless (FALSE == pgm_sendq_try_acquire (queue), "try_acquire failed");
+	fail_unless (FALSE == pgm_sendq_release (queue), "release failed");
+	fail_unless (TRUE == pgm_sendq_try_acquire (queue), "try_acquire failed");
+	fail_unless (FALSE == pgm_sendq_release (queue), "release failed");
+	pgm_sendq_destroy (queue);
+}
+END_TEST
+
+/* release reports data published whilst draining */
+START_TEST (test_release_pass_001)
+{
+	pgm_sendq_t* queue = pgm_sendq_create (4);
+	fail_if (NULL == queue, "create failed");
+	fail_unless (TRUE == pgm_sendq_try_acquire (queue), "try_acquire failed");
+	fail_unless (TRUE == pgm_sendq_push (queue, pgm_alloc_skb (100)), "push failed");
+	fail_unless (TRUE == pgm_sendq_release (queue), "release failed");
+	pgm_sendq_destroy (queue);
+}
+END_TEST
+
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_create = tcase_create ("create");
+	suite_add_tcase (s, tc_create);
+	tcase_add_test (tc_create, test_create_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_create, test_create_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_push = tcase_create ("push");
+	suite_add_tcase (s, tc_push);
+	tcase_add_test (tc_push, test_push_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_push, test_push_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_try_acquire = tcase_create ("try-acquire");
+	suite_add_tcase (s, tc_try_acquire);
+	tcase_add_test (tc_try_acquire, test_try_acquire_pass_001);
+
+	TCase* tc_release = tcase_create ("release");
+	suite_add_tcase (s, tc_release);
+	tcase_add_test (tc_release, test_release_pass_001);
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
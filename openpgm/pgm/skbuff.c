@@ -26,6 +26,15 @@
 #include "pgm/skbuff.h"
 
 
+/* layout: window and parsing fields in the first line, reference count on the
+ * last line alone, and a header of whole lines so the payload is line aligned.
+ */
+PGM_STATIC_ASSERT(PGM_OFFSETOF(struct pgm_sk_buff_t, link_) == 0);
+PGM_STATIC_ASSERT(PGM_OFFSETOF(struct pgm_sk_buff_t, tstamp) == PGM_SKB_CACHELINE);
+PGM_STATIC_ASSERT(PGM_OFFSETOF(struct pgm_sk_buff_t, users) == 3 * PGM_SKB_CACHELINE);
+PGM_STATIC_ASSERT(sizeof(struct pgm_sk_buff_t) == 4 * PGM_SKB_CACHELINE);
+
+
 void
 pgm_skb_over_panic (
 	const struct pgm_sk_buff_t*const skb,
@@ -73,6 +82,7 @@ pgm_skb_is_valid (
 /* cb can be any value */
 /* len can be any value */
 /* zero_padded can be any value */
+/* csum_pending can be any value */
 /* gpointers */
 	pgm_return_val_if_fail (NULL != skb->head, FALSE);
 	pgm_return_val_if_fail ((const char*)skb->head > (const char*)&skb->users, FALSE);
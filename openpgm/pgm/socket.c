@@ -24,6 +24,7 @@
 #	include <config.h>
 #endif
 #include <errno.h>
+#include <limits.h>
 #ifdef HAVE_POLL
 #	include <poll.h>
 #endif
@@ -204,6 +205,44 @@ CLEANUP:
 }
 #endif /* _MSC_VER */
 
+/* completed parity reconstruction, wake the receiving thread to commit the
+ * recovered packets.  called from FEC worker threads, which are never the
+ * application thread, so always locked even on single-threaded sockets.
+ */
+
+static
+void
+fec_pool_notify (
+	void*		arg
+	)
+{
+	pgm_sock_t* sock = arg;
+
+	pgm_mutex_lock (&sock->timer_mutex);
+	if (!sock->is_pending_read) {
+		pgm_notify_send (&sock->pending_notify);
+		sock->is_pending_read = TRUE;
+	}
+	pgm_mutex_unlock (&sock->timer_mutex);
+}
+
+/* free a list of option entries allocated by pgm_setsockopt.
+ */
+
+static
+void
+_pgm_free_option_list (
+	pgm_slist_t**	list
+	)
+{
+	if (NULL == *list)
+		return;
+	for (pgm_slist_t* entry = *list; entry; entry = entry->next)
+		pgm_free (entry->data);
+	pgm_slist_free (*list);
+	*list = NULL;
+}
+
 /* destroy a pgm_sock object and contents, if last sock also destroy
  * associated event loop
  *
@@ -211,8 +250,7 @@ CLEANUP:
  * 1) pgm_sock_t::lock
  * 2) pgm_sock_t::receiver_mutex
  * 3) pgm_sock_t::source_mutex
- * 4) pgm_sock_t::txw_spinlock
- * 5) pgm_sock_t::timer_mutex
+ * 4) pgm_sock_t::timer_mutex
  *
  * If application calls a function on the sock after destroy() it is a
  * programmer error: segv likely to occur on unlock.
@@ -278,12 +316,34 @@ pgm_close (
 		pgm_debug ("destroying peer list.");
 		do {
 			pgm_list_t* next = sock->peers_list->next;
-			pgm_peer_unref ((pgm_peer_t*)sock->peers_list->data);
+			pgm_peer_t* peer = sock->peers_list->data;
+/* detached buffers may hold the peer beyond the FEC workers */
+			pgm_rxw_set_fec_pool (peer->window, NULL, NULL);
+			pgm_peer_unref (peer);
 
 			sock->peers_list = next;
 		} while (sock->peers_list);
 	}
 
+	_pgm_free_option_list (&sock->peer_weights);
+	_pgm_free_option_list (&sock->allow_sources);
+	_pgm_free_option_list (&sock->deny_sources);
+	if (sock->filter) {
+		pgm_free (sock->filter);
+		sock->filter = NULL;
+	}
+
+	if (sock->fec_pool) {
+		pgm_debug ("stopping FEC worker threads.");
+		pgm_fec_pool_destroy (sock->fec_pool);
+		sock->fec_pool = NULL;
+	}
+
+	if (sock->sendq) {
+		pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Destroying send queue."));
+		pgm_sendq_destroy (sock->sendq);
+		sock->sendq = NULL;
+	}
 	if (sock->window) {
 		pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Destroying transmit window."));
 		pgm_txw_shutdown (sock->window);
@@ -313,10 +373,32 @@ pgm_close (
 		}
 		pgm_notify_destroy (&sock->rdata_notify);
 	}
+	if (sock->tx_arena) {
+		pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Destroying transmit arena."));
+		pgm_arena_destroy (sock->tx_arena);
+		sock->tx_arena = NULL;
+	}
+	if (sock->rx_arena) {
+		pgm_trace (PGM_LOG_ROLE_RX_WINDOW,_("Destroying receive arena."));
+		pgm_arena_destroy (sock->rx_arena);
+		sock->rx_arena = NULL;
+	}
+	if (sock->heap) {
+		pgm_debug ("destroying object heap.");
+		pgm_heap_destroy (sock->heap);
+		sock->heap = NULL;
+	}
 	pgm_notify_destroy (&sock->pending_notify);
+#ifdef HAVE_TIMERFD_CREATE
+	if (sock->use_timer_sock)
+		pgm_timer_sock_destroy (sock);
+#endif
+#ifdef HAVE_EPOLL_CTL
+	if (sock->use_ready_sock && sock->is_connected)
+		close (sock->ready_sock);
+#endif
 	pgm_debug ("freeing sock locks.");
 	pgm_rwlock_free (&sock->peers_lock);
-	pgm_spinlock_free (&sock->txw_spinlock);
 	pgm_mutex_free (&sock->send_mutex);
 	pgm_mutex_free (&sock->timer_mutex);
 	pgm_mutex_free (&sock->source_mutex);
@@ -377,6 +459,7 @@ pgm_socket (
 	new_sock->dport		= DEFAULT_DATA_DESTINATION_PORT;
 	new_sock->tsi.sport	= DEFAULT_DATA_SOURCE_PORT;
 	new_sock->adv_mode	= 0;	/* advance with time */
+	new_sock->arena_numa_node = -1;
 
 /* PGMCC */
 	new_sock->acker_nla.ss_family = family;
@@ -384,7 +467,6 @@ pgm_socket (
 /* source-side */
 	pgm_mutex_init (&new_sock->source_mutex);
 /* transmit window */
-	pgm_spinlock_init (&new_sock->txw_spinlock);
 /* send socket */
 	pgm_mutex_init (&new_sock->send_mutex);
 /* next timer & spm expiration */
@@ -563,6 +645,23 @@ pgm_socket (
 		}
 	}
 
+#ifdef SO_RXQ_OVFL
+/* kernel drop counter per datagram, without it overflow is invisible */
+	{
+		const int v = 1;
+		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Request socket overflow drop count."));
+		if (SOCKET_ERROR == setsockopt (new_sock->recv_sock, SOL_SOCKET, SO_RXQ_OVFL, (const char*)&v, sizeof (v)))
+		{
+			const int save_errno = pgm_get_last_sock_error();
+			char errbuf[1024];
+			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Socket overflow drop count unavailable: %s"),
+				   pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno));
+		}
+		else
+			new_sock->use_rxq_ovfl = TRUE;
+	}
+#endif
+
 	*sock = new_sock;
 
 	pgm_rwlock_writer_lock (&pgm_sock_list_lock);
@@ -715,6 +814,30 @@ pgm_getsockopt (
 		status = TRUE;
 		break;
 
+/* timer socket */
+	case PGM_TIMER_SOCK:
+		if (PGM_UNLIKELY(!sock->is_connected))
+			break;
+		if (PGM_UNLIKELY(*optlen != sizeof (SOCKET)))
+			break;
+		if (PGM_UNLIKELY(!sock->use_timer_sock))
+			break;
+		*(SOCKET*restrict)optval = sock->timer_sock;
+		status = TRUE;
+		break;
+
+/* aggregated readiness socket */
+	case PGM_READY_SOCK:
+		if (PGM_UNLIKELY(!sock->is_connected))
+			break;
+		if (PGM_UNLIKELY(*optlen != sizeof (SOCKET)))
+			break;
+		if (PGM_UNLIKELY(!sock->use_ready_sock))
+			break;
+		*(SOCKET*restrict)optval = sock->ready_sock;
+		status = TRUE;
+		break;
+
 /* ACK or congestion socket */
 	case PGM_ACK_SOCK:
 		if (PGM_UNLIKELY(!sock->is_connected))
@@ -962,6 +1085,31 @@ pgm_getsockopt (
 		status = TRUE;
 		break;
 
+	case PGM_FEC_WORKERS:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = (int)sock->fec_workers;
+		status = TRUE;
+		break;
+
+	case PGM_ADAPTIVE_FEC:
+		if (PGM_UNLIKELY(*optlen != sizeof (struct pgm_adaptive_fecinfo_t)))
+			break;
+		{
+			struct pgm_adaptive_fecinfo_t*restrict fecinfo = optval;
+			fecinfo->min_proactive_packets	 = sock->use_adaptive_parity ? sock->rs_proactive_h_min : 0;
+			fecinfo->max_proactive_packets	 = sock->use_adaptive_parity ? sock->rs_proactive_h_max : 0;
+		}
+		status = TRUE;
+		break;
+
+	case PGM_FEC_INTERLEAVE:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = 1 << sock->tg_depth_shift;
+		status = TRUE;
+		break;
+
 	case PGM_USE_CR:
 		if (PGM_UNLIKELY(*optlen != sizeof (int)))
 			break;
@@ -1016,6 +1164,206 @@ pgm_getsockopt (
 		status = TRUE;
 		break;
 
+	case PGM_DEFER_CHECKSUM:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_deferred_csum ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_UDP_CHECKSUM:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_udp_csum ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_USE_TIMER_SOCK:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_timer_sock ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_USE_READY_SOCK:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_ready_sock ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_BUSY_POLL:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = (int)sock->busy_poll_budget;
+		status = TRUE;
+		break;
+
+	case PGM_BUSY_POLL_STATS:
+		if (PGM_UNLIKELY(*optlen != sizeof (struct pgm_busy_poll_stats_t)))
+			break;
+		memcpy (optval, &sock->busy_poll_stats, sizeof (struct pgm_busy_poll_stats_t));
+		status = TRUE;
+		break;
+
+	case PGM_SINGLE_THREADED:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->is_single_threaded ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_SEND_QUEUE:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->sendq ? (int)pgm_sendq_max_length (sock->sendq) : (int)sock->sendq_len;
+		status = TRUE;
+		break;
+
+	case PGM_SOURCE_STATS:
+		if (PGM_UNLIKELY(*optlen != sizeof (struct pgm_source_stats_t)))
+			break;
+		{
+			uint32_t counters[PGM_PC_SOURCE_MAX];
+			struct pgm_source_stats_t*restrict stats = optval;
+			pgm_stats_snapshot (&sock->stats, counters, PGM_PC_SOURCE_MAX);
+			stats->data_bytes_sent			= counters[PGM_PC_SOURCE_DATA_BYTES_SENT];
+			stats->data_msgs_sent			= counters[PGM_PC_SOURCE_DATA_MSGS_SENT];
+			stats->bytes_sent			= counters[PGM_PC_SOURCE_BYTES_SENT];
+			stats->cksum_errors			= counters[PGM_PC_SOURCE_CKSUM_ERRORS];
+			stats->malformed_naks			= counters[PGM_PC_SOURCE_MALFORMED_NAKS];
+			stats->packets_discarded		= counters[PGM_PC_SOURCE_PACKETS_DISCARDED];
+			stats->selective_bytes_retransmitted	= counters[PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED];
+			stats->selective_msgs_retransmitted	= counters[PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED];
+			stats->parity_naks_received		= counters[PGM_PC_SOURCE_PARITY_NAKS_RECEIVED];
+			stats->selective_naks_received		= counters[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED];
+			stats->ack_packets_received		= counters[PGM_PC_SOURCE_ACK_PACKETS_RECEIVED];
+			stats->ack_errors			= counters[PGM_PC_SOURCE_ACK_ERRORS];
+			stats->selective_nnak_packets_received	= counters[PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED];
+			stats->selective_nnaks_received		= counters[PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED];
+			stats->nnak_errors			= counters[PGM_PC_SOURCE_NNAK_ERRORS];
+			stats->proactive_parity_packets		= counters[PGM_PC_SOURCE_PROACTIVE_PARITY_PACKETS];
+			stats->proactive_parity_changes		= counters[PGM_PC_SOURCE_PROACTIVE_PARITY_CHANGES];
+		}
+		status = TRUE;
+		break;
+
+	case PGM_RECEIVER_STATS:
+		if (PGM_UNLIKELY(*optlen != sizeof (struct pgm_receiver_stats_t)))
+			break;
+		{
+			struct pgm_receiver_stats_t*restrict stats = optval;
+			stats->rxq_overflow_drops		= sock->rxq_overflow_drops;
+			stats->filtered_packets			= sock->filtered_packets;
+			stats->rcvbuf_resizes			= sock->rcvbuf_resizes;
+		}
+		status = TRUE;
+		break;
+
+	case PGM_RCVBUF_AUTOTUNE:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_rcvbuf_autotune ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_RECV_COMPACT:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_compact_recv ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_USE_ARENA:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_arena ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_ARENA_MLOCK:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_arena_mlock ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_ARENA_NUMA_NODE:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->arena_numa_node;
+		status = TRUE;
+		break;
+
+	case PGM_ALLOCATOR:
+		if (PGM_UNLIKELY(*optlen != sizeof (pgm_allocator_t)))
+			break;
+		memcpy (optval, &sock->allocator, sizeof (pgm_allocator_t));
+		status = TRUE;
+		break;
+
+	case PGM_USE_OBJECT_ARENA:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_object_arena ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_MEM_STATS:
+		if (PGM_UNLIKELY(*optlen != sizeof (struct pgm_mem_stats_t)))
+			break;
+		if (sock->heap)
+			pgm_heap_stats (sock->heap, optval);
+		else
+			memset (optval, 0, sizeof (struct pgm_mem_stats_t));
+		status = TRUE;
+		break;
+
+	case PGM_REASSEMBLE_APDU:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_reassembly ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_RECV_CALLBACK:
+		if (PGM_UNLIKELY(*optlen != sizeof (struct pgm_recv_callback_info_t)))
+			break;
+		memcpy (optval, &sock->recv_callback, sizeof (struct pgm_recv_callback_info_t));
+		status = TRUE;
+		break;
+
+	case PGM_DELIVERY_QUANTUM:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = (int)sock->delivery_quantum;
+		status = TRUE;
+		break;
+
+	case PGM_DELIVERY_BUDGET:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = (int)sock->delivery_budget;
+		status = TRUE;
+		break;
+
+	case PGM_PEER_WEIGHT:
+		if (PGM_UNLIKELY(*optlen != sizeof (struct pgm_peer_weight_t)))
+			break;
+		{
+			struct pgm_peer_weight_t* peer_weight = optval;
+			peer_weight->weight = 1;
+			for (pgm_slist_t* list = sock->peer_weights; list; list = list->next) {
+				const struct pgm_peer_weight_t* entry = list->data;
+				if (pgm_tsi_equal (&entry->tsi, &peer_weight->tsi)) {
+					peer_weight->weight = entry->weight;
+					break;
+				}
+			}
+		}
+		status = TRUE;
+		break;
+
 	case PGM_SEND_GROUP:
 		if (PGM_UNLIKELY(*optlen != sizeof (struct group_req)))
 			break;
@@ -1049,6 +1397,9 @@ pgm_getsockopt (
 	case PGM_JOIN_SOURCE_GROUP:
 	case PGM_LEAVE_SOURCE_GROUP:
 	case PGM_MSFILTER:
+	case PGM_ALLOW_SOURCE:
+	case PGM_DENY_SOURCE:
+	case PGM_ATTACH_FILTER:
 	default:
 		break;
 	}
@@ -1475,6 +1826,72 @@ pgm_setsockopt (
 			sock->rs_n			= fecinfo->block_size;
 			sock->rs_k			= fecinfo->group_size;
 			sock->rs_proactive_h		= fecinfo->proactive_packets;
+			sock->tg_sqn_shift		= pgm_power2_log2 (fecinfo->group_size);
+			pgm_stats_set (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_PROACTIVE_PARITY_PACKETS, sock->rs_proactive_h);
+		}
+		status = TRUE;
+		break;
+
+/* decode parity on a pool of worker threads instead of the receiving thread,
+ * 0 disables.
+ */
+	case PGM_FEC_WORKERS:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval < 0 || *(const int*)optval > PGM_FEC_POOL_MAX_WORKERS))
+			break;
+		sock->fec_workers = *(const int*)optval;
+		status = TRUE;
+		break;
+
+/* vary the count of pro-active parity packets with observed loss, bounds must
+ * fit within the FEC block of a preceding PGM_USE_FEC.  min = max = 0 disables.
+ */
+	case PGM_ADAPTIVE_FEC:
+		if (PGM_UNLIKELY(optlen != sizeof (struct pgm_adaptive_fecinfo_t)))
+			break;
+		{
+			const struct pgm_adaptive_fecinfo_t* fecinfo = optval;
+			if (PGM_UNLIKELY(fecinfo->min_proactive_packets > fecinfo->max_proactive_packets))
+				break;
+			if (0 == fecinfo->max_proactive_packets) {
+				sock->use_adaptive_parity	= FALSE;
+				sock->use_proactive_parity	= (sock->rs_proactive_h > 0);
+				status = TRUE;
+				break;
+			}
+			if (PGM_UNLIKELY(0 == sock->rs_k))
+				break;
+			if (PGM_UNLIKELY(fecinfo->max_proactive_packets > (sock->rs_n - sock->rs_k)))
+				break;
+			sock->use_adaptive_parity	= TRUE;
+			sock->use_proactive_parity	= TRUE;
+			sock->rs_proactive_h_min	= fecinfo->min_proactive_packets;
+			sock->rs_proactive_h_max	= fecinfo->max_proactive_packets;
+			if (sock->rs_proactive_h < sock->rs_proactive_h_min)
+				sock->rs_proactive_h = sock->rs_proactive_h_min;
+			else if (sock->rs_proactive_h > sock->rs_proactive_h_max)
+				sock->rs_proactive_h = sock->rs_proactive_h_max;
+			pgm_stats_set (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_PROACTIVE_PARITY_PACKETS, sock->rs_proactive_h);
+		}
+		status = TRUE;
+		break;
+
+/* interleave depth d of transmission groups: parity of each group covers every
+ * d'th sequence of a k × d block so that a burst of up to d × h consecutive
+ * losses is recoverable, at the cost of pro-active parity being delayed until
+ * the end of the block.  must be a power of two, 1 disables.
+ */
+	case PGM_FEC_INTERLEAVE:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		{
+			const int tg_depth = *(const int*)optval;
+			if (PGM_UNLIKELY(tg_depth < 1 || tg_depth > PGM_MAX_FEC_DEPTH))
+				break;
+			if (PGM_UNLIKELY(0 != (tg_depth & (tg_depth - 1))))
+				break;
+			sock->tg_depth_shift = (uint8_t)pgm_power2_log2 ((unsigned)tg_depth);
 		}
 		status = TRUE;
 		break;
@@ -1554,6 +1971,336 @@ pgm_setsockopt (
 		status = TRUE;
 		break;
 
+/* verify the checksum of original data packets when delivered to the
+ * application instead of on receipt, duplicates and data never delivered
+ * are not summed.  a corrupt packet is treated as lost and immediately NAK'd.
+ * header fields are acted upon before verification.
+ */
+	case PGM_DEFER_CHECKSUM:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		sock->use_deferred_csum = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* skip the PGM checksum on UDP encapsulated packets relying upon the UDP
+ * checksum verified by the kernel, only safe where every source computes
+ * a UDP checksum as a zero UDP checksum disables verification over IPv4.
+ */
+	case PGM_UDP_CHECKSUM:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		sock->use_udp_csum = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* add a timer socket to the poll, select, and epoll sets that becomes
+ * readable at the next timer expiration with microsecond precision.
+ */
+	case PGM_USE_TIMER_SOCK:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+#ifdef HAVE_TIMERFD_CREATE
+		if (0 != *(const int*)optval && !sock->use_timer_sock) {
+			if (!pgm_timer_sock_init (sock))
+				break;
+			sock->use_timer_sock = TRUE;
+		} else if (0 == *(const int*)optval && sock->use_timer_sock) {
+			pgm_timer_sock_destroy (sock);
+			sock->use_timer_sock = FALSE;
+		}
+		status = TRUE;
+#endif
+		break;
+
+/* replace the receive, notification, and timer sockets in the poll, select,
+ * and epoll read sets with one internal epoll set created at connect, such
+ * that internal wakeups coalesce into a single readable socket.
+ */
+	case PGM_USE_READY_SOCK:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+#ifdef HAVE_EPOLL_CTL
+		sock->use_ready_sock = (0 != *(const int*)optval);
+		status = TRUE;
+#endif
+		break;
+
+/* spin on the receive socket for up to this many microseconds with the
+ * receiver locks held before waiting or returning would-block, 0 disables.
+ * the kernel is asked to busy poll the device queue on each receive, raising
+ * the kernel value needs CAP_NET_ADMIN so refusal only skips that part.
+ */
+	case PGM_BUSY_POLL:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval < 0))
+			break;
+#ifdef SO_BUSY_POLL
+		if (SOCKET_ERROR == setsockopt (sock->recv_sock, SOL_SOCKET, SO_BUSY_POLL, (const char*)optval, optlen))
+		{
+			const int save_errno = pgm_get_last_sock_error();
+			char errbuf[1024];
+			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Kernel busy poll unavailable: %s"),
+				   pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno));
+			sock->busy_poll_stats.kernel_busy_poll = 0;
+		}
+		else
+			sock->busy_poll_stats.kernel_busy_poll = *(const int*)optval;
+#endif
+#ifdef SO_PREFER_BUSY_POLL
+		{
+			const int v = (0 != *(const int*)optval);
+			if (SOCKET_ERROR == setsockopt (sock->recv_sock, SOL_SOCKET, SO_PREFER_BUSY_POLL, (const char*)&v, sizeof(v)))
+			{
+				const int save_errno = pgm_get_last_sock_error();
+				char errbuf[1024];
+				pgm_trace (PGM_LOG_ROLE_NETWORK,_("Kernel preferred busy poll unavailable: %s"),
+					   pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno));
+				sock->busy_poll_stats.kernel_prefer_busy_poll = 0;
+			}
+			else
+				sock->busy_poll_stats.kernel_prefer_busy_poll = v;
+		}
+#endif
+		sock->busy_poll_budget = *(const int*)optval;
+		status = TRUE;
+		break;
+
+/* the application calls every send, receive and option function of this
+ * socket from one thread at a time, internal send and receive path locking is
+ * skipped and socket owned skbuffs use plain reference counts.  not for use
+ * with the HTTP or SNMP interfaces which inspect the socket from their own
+ * threads.
+ */
+	case PGM_SINGLE_THREADED:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		sock->is_single_threaded = (0 != *(const int*)optval);
+/* rate buckets keep their own copy once bound */
+		sock->rate_control.is_single_threaded	    = sock->is_single_threaded;
+		sock->odata_rate_control.is_single_threaded = sock->is_single_threaded;
+		sock->rdata_rate_control.is_single_threaded = sock->is_single_threaded;
+		status = TRUE;
+		break;
+
+/* length of the lock-free submission queue for pgm_send_enqueue() and
+ * pgm_send_skb_enqueue(), rounded up to a power of two.  0 disables.
+ */
+	case PGM_SEND_QUEUE:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval < 0 || *(const int*)optval > PGM_SENDQ_MAX_LENGTH))
+			break;
+		sock->sendq_len = *(const int*)optval;
+		status = TRUE;
+		break;
+
+/* carve window skbuffs and large pointer arrays from 2 MB page arenas sized
+ * from the window parameters at bind time.
+ */
+	case PGM_USE_ARENA:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		sock->use_arena = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* lock arena pages into memory, subject to RLIMIT_MEMLOCK.
+ */
+	case PGM_ARENA_MLOCK:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		sock->use_arena_mlock = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* preferred NUMA node for arena pages, -1 for the default policy.
+ */
+	case PGM_ARENA_NUMA_NODE:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval < -1 || *(const int*)optval > PGM_ARENA_MAX_NUMA_NODE))
+			break;
+		sock->arena_numa_node = *(const int*)optval;
+		status = TRUE;
+		break;
+
+/* allocator for objects owned by the socket, peers, windows and hash table
+ * nodes.  a zeroed vtable selects the library allocator.  fixed at bind.
+ */
+	case PGM_ALLOCATOR:
+		if (PGM_UNLIKELY(optlen != sizeof (pgm_allocator_t)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		{
+			const pgm_allocator_t* allocator = optval;
+			if (NULL != allocator->malloc &&
+			    (NULL == allocator->realloc || NULL == allocator->free))
+				break;
+			sock->allocator = *allocator;
+		}
+		status = TRUE;
+		break;
+
+/* carve small socket objects from 64 KB chunks with per size-class reuse.
+ */
+	case PGM_USE_OBJECT_ARENA:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		sock->use_object_arena = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* deliver fragmented APDUs as one contiguous skbuff, copied in as each
+ * fragment arrives, lifting the PGM_MAX_FRAGMENTS limit on receive.
+ */
+	case PGM_REASSEMBLE_APDU:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		sock->use_reassembly = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* deliver each APDU to a callback from inside the receive call instead of
+ * through the caller's message vector.  fixed at bind.
+ */
+	case PGM_RECV_CALLBACK:
+		if (PGM_UNLIKELY(optlen != sizeof (struct pgm_recv_callback_info_t)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		memcpy (&sock->recv_callback, optval, sizeof (struct pgm_recv_callback_info_t));
+		status = TRUE;
+		break;
+
+/* deficit round robin across sources with pending data, bytes of APDUs each
+ * source may deliver per round.  0 drains each source in turn.
+ */
+	case PGM_DELIVERY_QUANTUM:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval < 0))
+			break;
+		sock->delivery_quantum = *(const int*)optval;
+		status = TRUE;
+		break;
+
+/* maximum APDUs delivered per receive call, 0 for unlimited.
+ */
+	case PGM_DELIVERY_BUDGET:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval < 0))
+			break;
+		sock->delivery_budget = *(const int*)optval;
+		status = TRUE;
+		break;
+
+/* per source multiple of the delivery quantum, applied as peers are created.
+ */
+	case PGM_PEER_WEIGHT:
+		if (PGM_UNLIKELY(optlen != sizeof (struct pgm_peer_weight_t)))
+			break;
+		{
+			const struct pgm_peer_weight_t* peer_weight = optval;
+			struct pgm_peer_weight_t* entry = NULL;
+			if (PGM_UNLIKELY(0 == peer_weight->weight || peer_weight->weight > UINT16_MAX))
+				break;
+			for (pgm_slist_t* list = sock->peer_weights; list; list = list->next) {
+				if (pgm_tsi_equal (&((struct pgm_peer_weight_t*)list->data)->tsi, &peer_weight->tsi)) {
+					entry = list->data;
+					break;
+				}
+			}
+			if (NULL == entry) {
+				entry = pgm_new (struct pgm_peer_weight_t, 1);
+				sock->peer_weights = pgm_slist_prepend (sock->peer_weights, entry);
+			}
+			*entry = *peer_weight;
+		}
+		status = TRUE;
+		break;
+
+/* receive only from matching sources, a zero source port matches every
+ * session of the GSI.  downstream packets are dropped before any peer state.
+ */
+	case PGM_ALLOW_SOURCE:
+	case PGM_DENY_SOURCE:
+		if (PGM_UNLIKELY(optlen != sizeof (pgm_tsi_t)))
+			break;
+		{
+			pgm_slist_t** sources = (PGM_ALLOW_SOURCE == optname) ? &sock->allow_sources : &sock->deny_sources;
+			bool is_listed = FALSE;
+			for (pgm_slist_t* list = *sources; list; list = list->next) {
+				if (pgm_tsi_equal (list->data, optval)) {
+					is_listed = TRUE;
+					break;
+				}
+			}
+			if (!is_listed) {
+				pgm_tsi_t* entry = pgm_new (pgm_tsi_t, 1);
+				memcpy (entry, optval, sizeof (pgm_tsi_t));
+				*sources = pgm_slist_prepend (*sources, entry);
+			}
+			sock->is_filtering = TRUE;
+		}
+		status = TRUE;
+		break;
+
+/* classic BPF program over the PGM header of downstream packets, zero length
+ * removes the program.  pushed down to the kernel at connect when possible.
+ */
+	case PGM_ATTACH_FILTER:
+		if (PGM_UNLIKELY(optlen != sizeof (struct pgm_filter_prog_t)))
+			break;
+		{
+			const struct pgm_filter_prog_t* prog = optval;
+			if (prog->len && PGM_UNLIKELY(!pgm_filter_validate (prog->filter, prog->len)))
+				break;
+			if (sock->filter) {
+				pgm_free (sock->filter);
+				sock->filter = NULL;
+				sock->filter_len = 0;
+			}
+			if (prog->len) {
+				sock->filter = pgm_new (struct pgm_filter_insn_t, prog->len);
+				memcpy (sock->filter, prog->filter, prog->len * sizeof (struct pgm_filter_insn_t));
+				sock->filter_len = prog->len;
+			}
+			sock->is_filtering = (NULL != sock->allow_sources || NULL != sock->deny_sources || NULL != sock->filter);
+		}
+		status = TRUE;
+		break;
+
+/* size the receive buffer from the maximum receive rate at connect and grow
+ * it on kernel overflow drops, up to rmem_max.
+ */
+	case PGM_RCVBUF_AUTOTUNE:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		sock->use_rcvbuf_autotune = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* copy data packets of at most PGM_SKB_COMPACT_SIZE bytes into a right sized
+ * skbuff and recycle the receive buffer, trading a copy per packet for
+ * receive window memory.  not applied to FEC enabled sources.
+ */
+	case PGM_RECV_COMPACT:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		sock->use_compact_recv = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
 /* sending group, singular.  note that the address is only stored and used
  * later in sendto() calls, this routine only considers the interface.
  */
@@ -2142,6 +2889,33 @@ pgm_bind3 (
 	const unsigned max_fragments = sock->txw_sqns ? MIN( PGM_MAX_FRAGMENTS, sock->txw_sqns ) : PGM_MAX_FRAGMENTS;
 	sock->max_apdu = MIN( PGM_MAX_APDU, max_fragments * sock->max_tsdu_fragment );
 
+/* per-socket heap for objects with the lifetime of the socket */
+	sock->heap = pgm_heap_create (sock->allocator.malloc ? &sock->allocator : NULL, sock->use_object_arena);
+
+/* huge page arenas sized to hold a full window, further peers or a
+ * larger send queue spill onto the heap.
+ */
+	if (sock->use_arena && sock->can_send_data)
+	{
+		const unsigned slots = sock->txw_sqns ? sock->txw_sqns : (unsigned)( (sock->txw_secs * sock->txw_max_rte) / sock->max_tpdu );
+		pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Create transmit arena."));
+		sock->tx_arena = pgm_arena_create (sock->max_tpdu, slots + sock->sendq_len + 1, sock->arena_numa_node, sock->use_arena_mlock, error);
+		if (NULL == sock->tx_arena) {
+			pgm_rwlock_writer_unlock (&sock->lock);
+			return FALSE;
+		}
+	}
+	if (sock->use_arena && sock->can_recv_data)
+	{
+		const unsigned slots = sock->rxw_sqns ? sock->rxw_sqns : (unsigned)( (sock->rxw_secs * sock->rxw_max_rte) / sock->max_tpdu );
+		pgm_trace (PGM_LOG_ROLE_RX_WINDOW,_("Create receive arena."));
+		sock->rx_arena = pgm_arena_create (sock->max_tpdu, slots + 1, sock->arena_numa_node, sock->use_arena_mlock, error);
+		if (NULL == sock->rx_arena) {
+			pgm_rwlock_writer_unlock (&sock->lock);
+			return FALSE;
+		}
+	}
+
 	if (sock->can_send_data)
 	{
 		pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Create transmit window."));
@@ -2153,7 +2927,10 @@ pgm_bind3 (
 							0,			/* TXW_MAX_RTE */
 							sock->use_ondemand_parity || sock->use_proactive_parity,
 							sock->rs_n,
-							sock->rs_k) :
+							sock->rs_k,
+							1 << sock->tg_depth_shift,
+							sock->tx_arena,
+							sock->heap) :
 					pgm_txw_create (&sock->tsi,
 							sock->max_tpdu,		/* MAX_TPDU */
 							0,			/* TXW_SQNS */
@@ -2161,13 +2938,20 @@ pgm_bind3 (
 							sock->txw_max_rte,	/* TXW_MAX_RTE */
 							sock->use_ondemand_parity || sock->use_proactive_parity,
 							sock->rs_n,
-							sock->rs_k);
+							sock->rs_k,
+							1 << sock->tg_depth_shift,
+							sock->tx_arena,
+							sock->heap);
 		pgm_assert (NULL != sock->window);
+		if (sock->sendq_len) {
+			pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Create send queue."));
+			sock->sendq = pgm_sendq_create (sock->sendq_len);
+		}
 	}
 
 /* create peer list */
 	if (sock->can_recv_data) {
-		sock->peers_hashtable = pgm_hashtable_new (pgm_tsi_hash, pgm_tsi_equal);
+		sock->peers_hashtable = pgm_hashtable_new_full (pgm_tsi_hash, pgm_tsi_equal, sock->heap);
 		pgm_assert (NULL != sock->peers_hashtable);
 	}
 
@@ -2381,10 +3165,24 @@ pgm_bind3 (
 			pgm_rate_create (&sock->rdata_rate_control, sock->rdata_max_rte, sock->iphdr_len, sock->max_tpdu);
 			sock->is_controlled_rdata = TRUE;
 		}
+		sock->rate_control.is_single_threaded	    = sock->is_single_threaded;
+		sock->odata_rate_control.is_single_threaded = sock->is_single_threaded;
+		sock->rdata_rate_control.is_single_threaded = sock->is_single_threaded;
+	}
+
+/* parity reconstruction worker pool */
+	if (sock->can_recv_data && sock->fec_workers > 0)
+	{
+		pgm_trace (PGM_LOG_ROLE_RX_WINDOW,_("Starting %u FEC worker threads."), sock->fec_workers);
+		sock->fec_pool = pgm_fec_pool_create (sock->fec_workers, fec_pool_notify, sock, error);
+		if (NULL == sock->fec_pool) {
+			pgm_rwlock_writer_unlock (&sock->lock);
+			return FALSE;
+		}
 	}
 
 /* allocate first incoming packet buffer */
-	sock->rx_buffer = pgm_alloc_skb (sock->max_tpdu);
+	sock->rx_buffer = pgm_arena_alloc_skb (sock->rx_arena, sock->max_tpdu);
 
 /* bind complete */
 	sock->is_bound = TRUE;
@@ -2460,6 +3258,53 @@ pgm_connect (
 		sock->next_poll = pgm_time_update_now() + pgm_secs( 30 );
 	}
 
+#ifdef HAVE_EPOLL_CTL
+/* aggregate all readable sockets into one level-triggered epoll set */
+	if (sock->use_ready_sock)
+	{
+		struct epoll_event event;
+		memset (&event, 0, sizeof (event));
+		event.events = EPOLLIN;
+		event.data.ptr = sock;
+		sock->ready_sock = epoll_create1 (EPOLL_CLOEXEC);
+		if (SOCKET_ERROR == sock->ready_sock ||
+		    SOCKET_ERROR == epoll_ctl (sock->ready_sock, EPOLL_CTL_ADD, sock->recv_sock, &event) ||
+		    SOCKET_ERROR == epoll_ctl (sock->ready_sock, EPOLL_CTL_ADD, pgm_notify_get_socket (&sock->pending_notify), &event) ||
+		    (sock->can_send_data &&
+		     SOCKET_ERROR == epoll_ctl (sock->ready_sock, EPOLL_CTL_ADD, pgm_notify_get_socket (&sock->rdata_notify), &event)) ||
+		    (sock->use_timer_sock &&
+		     SOCKET_ERROR == epoll_ctl (sock->ready_sock, EPOLL_CTL_ADD, sock->timer_sock, &event)))
+		{
+			const int save_errno = pgm_get_last_sock_error();
+			char errbuf[1024];
+			pgm_set_error (error,
+				       PGM_ERROR_DOMAIN_SOCKET,
+				       pgm_error_from_sock_errno (save_errno),
+				       _("Creating readiness socket: %s"),
+				       pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno));
+			if (SOCKET_ERROR != sock->ready_sock)
+				close (sock->ready_sock);
+			pgm_rwlock_writer_unlock (&sock->lock);
+			return FALSE;
+		}
+	}
+#endif
+
+/* buffer a tenth of a second at the maximum receive rate, never shrink */
+	if (sock->can_recv_data && sock->use_rcvbuf_autotune)
+	{
+		int rcvbuf = 0;
+		socklen_t optlen = sizeof (rcvbuf);
+		if (SOCKET_ERROR != getsockopt (sock->recv_sock, SOL_SOCKET, SO_RCVBUF, (char*)&rcvbuf, &optlen))
+			sock->rcvbuf = rcvbuf;
+		if (sock->rxw_max_rte > 0 && (size_t)(sock->rxw_max_rte / 10) > sock->rcvbuf)
+			pgm_rcvbuf_resize (sock, (int)MIN(sock->rxw_max_rte / 10, INT_MAX));
+	}
+
+/* kernel drops unwanted sources, failure leaves only the library filter */
+	if (sock->is_filtering)
+		pgm_filter_attach (sock);
+
 	sock->is_connected = TRUE;
 
 /* cleanup */
@@ -2518,6 +3363,20 @@ pgm_select_info (
 
 	const bool is_congested = (sock->use_pgmcc && sock->tokens < pgm_fp8 (1)) ? TRUE : FALSE;
 
+#ifdef HAVE_EPOLL_CTL
+	if (readfds && sock->use_ready_sock && sock->is_connected)
+	{
+		FD_SET(sock->ready_sock, readfds);
+		fds = sock->ready_sock + 1;
+/* ACK notification is a send-side event, not part of the readiness socket */
+		if (sock->can_send_data && is_congested) {
+			const SOCKET ack_fd = pgm_notify_get_socket (&sock->ack_notify);
+			FD_SET(ack_fd, readfds);
+			fds = MAX(fds, ack_fd + 1);
+		}
+	}
+	else
+#endif
 	if (readfds)
 	{
 		FD_SET(sock->recv_sock, readfds);
@@ -2551,6 +3410,14 @@ pgm_select_info (
 #else
 		fds++;
 #endif
+		if (sock->use_timer_sock) {
+			FD_SET(sock->timer_sock, readfds);
+#ifndef _WIN32
+			fds = MAX(fds, sock->timer_sock + 1);
+#else
+			fds++;
+#endif
+		}
 	}
 
 	if (sock->can_send_data && writefds && !is_congested)
@@ -2621,6 +3488,16 @@ pgm_wsapoll_info (
 	}
 
 /* we currently only support one incoming socket */
+#ifdef HAVE_EPOLL_CTL
+	if (events & PGM_POLLIN && sock->use_ready_sock && sock->is_connected)
+	{
+		pgm_assert ( (1 + nfds) <= *n_fds );
+		fds[nfds].fd = sock->ready_sock;
+		fds[nfds].events = PGM_POLLIN;
+		nfds++;
+	}
+	else
+#endif
 	if (events & PGM_POLLIN)
 	{
 		pgm_assert ( (1 + nfds) <= *n_fds );
@@ -2637,6 +3514,12 @@ pgm_wsapoll_info (
 		fds[nfds].fd = pgm_notify_get_socket (&sock->pending_notify);
 		fds[nfds].events = PGM_POLLIN;
 		nfds++;
+		if (sock->use_timer_sock) {
+			pgm_assert ( (1 + nfds) <= *n_fds );
+			fds[nfds].fd = sock->timer_sock;
+			fds[nfds].events = PGM_POLLIN;
+			nfds++;
+		}
 	}
 
 /* ODATA only published on regular socket, no need to poll router-alert sock */
@@ -2688,7 +3571,18 @@ pgm_epoll_ctl (
 		return SOCKET_ERROR;
 	}
 
-	if (events & EPOLLIN)
+	if (events & EPOLLIN && sock->use_ready_sock && sock->is_connected)
+	{
+		event.events = events & (EPOLLIN | EPOLLET | EPOLLONESHOT);
+		event.data.ptr = sock;
+		retval = epoll_ctl (epfd, op, sock->ready_sock, &event);
+		if (retval)
+			goto out;
+
+		if (events & EPOLLET)
+			sock->is_edge_triggered_recv = TRUE;
+	}
+	else if (events & EPOLLIN)
 	{
 		event.events = events & (EPOLLIN | EPOLLET | EPOLLONESHOT);
 		event.data.ptr = sock;
@@ -2703,6 +3597,11 @@ pgm_epoll_ctl (
 		retval = epoll_ctl (epfd, op, pgm_notify_get_socket (&sock->pending_notify), &event);
 		if (retval)
 			goto out;
+		if (sock->use_timer_sock) {
+			retval = epoll_ctl (epfd, op, sock->timer_sock, &event);
+			if (retval)
+				goto out;
+		}
 
 		if (events & EPOLLET)
 			sock->is_edge_triggered_recv = TRUE;
@@ -0,0 +1,314 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * performance tests for PGM socket internal locking
+ *
+ * Copyright (c) 2010-2016 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#ifndef _WIN32
+#	include <sys/types.h>
+#	include <sys/socket.h>
+#endif
+#include <glib.h>
+#include <check.h>
+
+
+/* mock state */
+
+#ifndef _WIN32
+ssize_t mock_sendto (int, const void*, size_t, int, const struct sockaddr*, socklen_t);
+#else
+int mock_sendto (SOCKET, const char*, int, int, const struct sockaddr*, int);
+#endif
+
+#define sendto			mock_sendto
+
+#include "net.c"
+
+PGM_GNUC_INTERNAL void pgm_checksum_init (const pgm_cpu_t*);
+
+#define PERF_MAX_TPDU		1500
+#define PERF_TXW_SQNS		1024
+/* bucket refills faster than the loop can drain it */
+#define PERF_MAX_RATE		INT32_MAX
+
+static pgm_sock_t*		perf_sock = NULL;
+static struct pgm_sk_buff_t*	perf_skb = NULL;
+static unsigned			perf_sendto_count = 0;
+
+static
+void
+mock_setup (void)
+{
+	pgm_cpu_t cpu;
+	pgm_cpuid (&cpu);
+	pgm_checksum_init (&cpu);
+	g_assert (pgm_time_init (NULL));
+	perf_sock = g_new0 (pgm_sock_t, 1);
+	perf_sock->family = AF_INET;
+	perf_sock->is_bound = TRUE;
+	perf_sock->can_send_data = TRUE;
+	perf_sock->dport = g_htons(7500);
+	perf_sock->tsi.sport = g_htons(1000);
+	((struct sockaddr_in*)&perf_sock->send_gsr.gsr_group)->sin_family = AF_INET;
+	((struct sockaddr_in*)&perf_sock->send_gsr.gsr_group)->sin_addr.s_addr = inet_addr ("239.192.0.1");
+	perf_sock->max_tpdu = PERF_MAX_TPDU;
+	perf_sock->max_tsdu = PERF_MAX_TPDU - sizeof(struct pgm_ip) - pgm_pkt_offset (FALSE, FALSE);
+	perf_sock->max_tsdu_fragment = PERF_MAX_TPDU - sizeof(struct pgm_ip) - pgm_pkt_offset (TRUE, FALSE);
+	perf_sock->max_apdu = MIN(PERF_TXW_SQNS, PGM_MAX_FRAGMENTS) * perf_sock->max_tsdu_fragment;
+	perf_sock->iphdr_len = sizeof(struct pgm_ip);
+	perf_sock->spm_heartbeat_interval = g_malloc0 (sizeof(guint) * (2+2));
+	perf_sock->spm_heartbeat_interval[0] = pgm_secs(1);
+	perf_sock->window = pgm_txw_create (&perf_sock->tsi, 0, PERF_TXW_SQNS, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
+	pgm_rate_create (&perf_sock->rate_control, PERF_MAX_RATE, perf_sock->iphdr_len, perf_sock->max_tpdu);
+	pgm_rate_create (&perf_sock->odata_rate_control, PERF_MAX_RATE, perf_sock->iphdr_len, perf_sock->max_tpdu);
+	pgm_rwlock_init (&perf_sock->lock);
+	pgm_rwlock_init (&perf_sock->peers_lock);
+	pgm_mutex_init (&perf_sock->receiver_mutex);
+	pgm_mutex_init (&perf_sock->source_mutex);
+	pgm_mutex_init (&perf_sock->timer_mutex);
+	pgm_mutex_init (&perf_sock->send_mutex);
+	perf_skb = pgm_alloc_skb (PERF_MAX_TPDU);
+	perf_sendto_count = 0;
+}
+
+static
+void
+mock_setup_locked (void)
+{
+	perf_sock->is_single_threaded = FALSE;
+	perf_sock->rate_control.is_single_threaded = perf_sock->odata_rate_control.is_single_threaded = FALSE;
+	perf_skb->single_threaded = 0;
+}
+
+static
+void
+mock_setup_single_threaded (void)
+{
+	perf_sock->is_single_threaded = TRUE;
+	perf_sock->rate_control.is_single_threaded = perf_sock->odata_rate_control.is_single_threaded = TRUE;
+	perf_skb->single_threaded = 1;
+}
+
+static
+void
+mock_teardown (void)
+{
+	pgm_free_skb (perf_skb);
+	pgm_mutex_free (&perf_sock->send_mutex);
+	pgm_mutex_free (&perf_sock->timer_mutex);
+	pgm_mutex_free (&perf_sock->source_mutex);
+	pgm_mutex_free (&perf_sock->receiver_mutex);
+	pgm_rwlock_free (&perf_sock->peers_lock);
+	pgm_rwlock_free (&perf_sock->lock);
+	pgm_rate_destroy (&perf_sock->odata_rate_control);
+	pgm_rate_destroy (&perf_sock->rate_control);
+	pgm_txw_shutdown (perf_sock->window);
+	g_free (perf_sock->spm_heartbeat_interval);
+	g_free (perf_sock);
+	g_assert (pgm_time_shutdown ());
+}
+
+/* mock functions for external references */
+
+size_t
+pgm_pkt_offset (
+	const bool			can_fragment,
+	const sa_family_t		pgmcc_family	/* 0 = disable */
+	)
+{
+	const size_t data_size = sizeof(struct pgm_header) + sizeof(struct pgm_data);
+	size_t pkt_size = data_size;
+	if (can_fragment || (0 != pgmcc_family))
+		pkt_size += sizeof(struct pgm_opt_length) + sizeof(struct pgm_opt_header);
+	if (can_fragment)
+		pkt_size += sizeof(struct pgm_opt_fragment);
+	if (AF_INET == pgmcc_family)
+		pkt_size += sizeof(struct pgm_opt_pgmcc_data);
+	else if (AF_INET6 == pgmcc_family)
+		pkt_size += sizeof(struct pgm_opt6_pgmcc_data);
+	return pkt_size;
+}
+
+PGM_GNUC_INTERNAL
+int
+pgm_get_nprocs (void)
+{
+	return 1;
+}
+
+/* discard at the libc boundary so only the library path is timed */
+#ifndef _WIN32
+ssize_t
+mock_sendto (
+	int			s,
+	const void*		buf,
+	size_t			len,
+	int			flags,
+	const struct sockaddr*	to,
+	socklen_t		tolen
+	)
+#else
+int
+mock_sendto (
+	SOCKET			s,
+	const char*		buf,
+	int			len,
+	int			flags,
+	const struct sockaddr*	to,
+	int			tolen
+	)
+#endif
+{
+	perf_sendto_count++;
+	return len;
+}
+
+
+/* target:
+ *	uncontended pgm_send() of a single ODATA packet on a blocking socket:
+ *	socket state, source API, transmit window, major and minor rate
+ *	buckets, and send socket.
+ */
+
+START_TEST (test_send)
+{
+	const unsigned iterations = 1000000;
+	const char apdu[100] = { 0 };
+	pgm_sock_t* sock = perf_sock;
+	pgm_time_t start, check;
+
+	start = pgm_time_update_now();
+	for (unsigned i = iterations; i; i--) {
+		size_t bytes_written;
+		fail_unless (PGM_IO_STATUS_NORMAL == pgm_send (sock, apdu, sizeof(apdu), &bytes_written), "send not normal");
+	}
+	check = pgm_time_update_now();
+	fail_unless (iterations == perf_sendto_count, "sendto count mismatch");
+	fail_unless (iterations == sock->stats.block[PGM_STATS_ROLE_SOURCE].counters[PGM_PC_SOURCE_DATA_MSGS_SENT], "data msgs sent mismatch");
+
+	g_message ("%s: elapsed time %" PGM_TIME_FORMAT " us, unit time %.1f ns",
+		sock->is_single_threaded ? "single-threaded" : "locked",
+		(guint64)(check - start),
+		(double)(check - start) * 1000.0 / iterations);
+}
+END_TEST
+
+/* target:
+ *	uncontended locking of one pgm_recvmsgv() delivering a single packet:
+ *	socket state, receiver API, peer lookup, and receive window skbuff
+ *	reference taken and returned by the application.
+ */
+
+START_TEST (test_recv)
+{
+	const unsigned iterations = 1000000;
+	pgm_sock_t* sock = perf_sock;
+	pgm_time_t start, check;
+
+	start = pgm_time_update_now();
+	for (unsigned i = iterations; i; i--) {
+		fail_unless (pgm_sock_reader_trylock (sock, &sock->lock), "trylock failed");
+		pgm_sock_mutex_lock (sock, &sock->receiver_mutex);
+		pgm_sock_reader_lock (sock, &sock->peers_lock);
+		pgm_sock_reader_unlock (sock, &sock->peers_lock);
+		pgm_skb_get (perf_skb);
+		pgm_sock_mutex_unlock (sock, &sock->receiver_mutex);
+		pgm_sock_reader_unlock (sock, &sock->lock);
+		pgm_free_skb (perf_skb);
+	}
+	check = pgm_time_update_now();
+	fail_unless (1 == perf_skb->users, "reference count mismatch");
+
+	g_message ("%s: elapsed time %" PGM_TIME_FORMAT " us, unit time %.1f ns",
+		sock->is_single_threaded ? "single-threaded" : "locked",
+		(guint64)(check - start),
+		(double)(check - start) * 1000.0 / iterations);
+}
+END_TEST
+
+
+static
+Suite*
+make_send_performance_suite (void)
+{
+	Suite* s;
+
+	s = suite_create ("Send locking");
+
+	TCase* tc_locked = tcase_create ("locked");
+	suite_add_tcase (s, tc_locked);
+	tcase_add_checked_fixture (tc_locked, mock_setup, mock_teardown);
+	tcase_add_checked_fixture (tc_locked, mock_setup_locked, NULL);
+	tcase_add_test (tc_locked, test_send);
+
+	TCase* tc_single = tcase_create ("single-threaded");
+	suite_add_tcase (s, tc_single);
+	tcase_add_checked_fixture (tc_single, mock_setup, mock_teardown);
+	tcase_add_checked_fixture (tc_single, mock_setup_single_threaded, NULL);
+	tcase_add_test (tc_single, test_send);
+	return s;
+}
+
+static
+Suite*
+make_recv_performance_suite (void)
+{
+	Suite* s;
+
+	s = suite_create ("Receive locking");
+
+	TCase* tc_locked = tcase_create ("locked");
+	suite_add_tcase (s, tc_locked);
+	tcase_add_checked_fixture (tc_locked, mock_setup, mock_teardown);
+	tcase_add_checked_fixture (tc_locked, mock_setup_locked, NULL);
+	tcase_add_test (tc_locked, test_recv);
+
+	TCase* tc_single = tcase_create ("single-threaded");
+	suite_add_tcase (s, tc_single);
+	tcase_add_checked_fixture (tc_single, mock_setup, mock_teardown);
+	tcase_add_checked_fixture (tc_single, mock_setup_single_threaded, NULL);
+	tcase_add_test (tc_single, test_recv);
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_send_performance_suite ());
+	srunner_add_suite (sr, make_recv_performance_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
@@ -62,6 +62,8 @@
 #define pgm_timer_check		mock_pgm_timer_check
 #define pgm_timer_expiration	mock_pgm_timer_expiration
 #define pgm_timer_dispatch	mock_pgm_timer_dispatch
+#define pgm_timer_sock_init	mock_pgm_timer_sock_init
+#define pgm_timer_sock_destroy	mock_pgm_timer_sock_destroy
 #define pgm_txw_create		mock_pgm_txw_create
 #define pgm_txw_shutdown	mock_pgm_txw_shutdown
 #define pgm_rate_create		mock_pgm_rate_create
@@ -185,7 +187,6 @@ generate_sock (void)
 	sock->dport = g_htons(TEST_PORT);
 	sock->window = g_new0 (pgm_txw_t, 1);
 	sock->iphdr_len = sizeof(struct pgm_ip);
-	pgm_spinlock_init (&sock->txw_spinlock);
 	pgm_rwlock_init (&sock->lock);
 	return sock;
 }
@@ -234,7 +235,8 @@ mock_pgm_timer_prepare (
 PGM_GNUC_INTERNAL
 bool
 mock_pgm_timer_check (
-	pgm_sock_t* const		sock
+	pgm_sock_t* const		sock,
+	const pgm_time_t		now
 	)
 {
 	return FALSE;
@@ -252,12 +254,30 @@ mock_pgm_timer_expiration (
 PGM_GNUC_INTERNAL
 bool
 mock_pgm_timer_dispatch (
+	pgm_sock_t* const		sock,
+	const pgm_time_t		now
+	)
+{
+	return TRUE;
+}
+
+PGM_GNUC_INTERNAL
+bool
+mock_pgm_timer_sock_init (
 	pgm_sock_t* const		sock
 	)
 {
 	return TRUE;
 }
 
+PGM_GNUC_INTERNAL
+void
+mock_pgm_timer_sock_destroy (
+	pgm_sock_t* const		sock
+	)
+{
+}
+
 /** transmit window module */
 pgm_txw_t*
 mock_pgm_txw_create (
@@ -268,7 +288,10 @@ mock_pgm_txw_create (
 	const ssize_t		max_rte,
 	const bool		use_fec,
 	const uint8_t		rs_n,
-	const uint8_t		rs_k
+	const uint8_t		rs_k,
+	const uint8_t		tg_depth,
+	const pgm_arena_t*const	arena,
+	pgm_heap_t*const	heap
 	)
 {
 	pgm_txw_t* window = g_new0 (pgm_txw_t, 1);
@@ -830,6 +853,95 @@ END_TEST
 /* TODO: invalid Reed-Solomon parameters
  */
 
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_ADAPTIVE_FEC,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(struct pgm_adaptive_fecinfo_t)
+ *	)
+ */
+
+START_TEST (test_set_adaptive_fec_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const struct pgm_fecinfo_t fecinfo = {
+		.ondemand_parity_enabled	= TRUE,
+		.proactive_packets		= 0,
+		.var_pktlen_enabled		= FALSE,
+		.block_size			= 255,
+		.group_size			= 64
+	};
+	fail_unless (TRUE == pgm_setsockopt (sock, level, PGM_USE_FEC, &fecinfo, sizeof(fecinfo)), "set_fec failed");
+	const struct pgm_adaptive_fecinfo_t adaptive_fecinfo = {
+		.min_proactive_packets		= 2,
+		.max_proactive_packets		= 32
+	};
+	fail_unless (TRUE == pgm_setsockopt (sock, level, PGM_ADAPTIVE_FEC, &adaptive_fecinfo, sizeof(adaptive_fecinfo)), "set_adaptive_fec failed");
+	fail_unless (TRUE == sock->use_proactive_parity, "proactive parity not enabled");
+	fail_unless (2 == sock->rs_proactive_h, "proactive h not clamped to minimum");
+}
+END_TEST
+
+/* bounds exceed parity packets of FEC block */
+START_TEST (test_set_adaptive_fec_fail_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const struct pgm_fecinfo_t fecinfo = {
+		.ondemand_parity_enabled	= TRUE,
+		.proactive_packets		= 0,
+		.var_pktlen_enabled		= FALSE,
+		.block_size			= 70,
+		.group_size			= 64
+	};
+	fail_unless (TRUE == pgm_setsockopt (sock, level, PGM_USE_FEC, &fecinfo, sizeof(fecinfo)), "set_fec failed");
+	const struct pgm_adaptive_fecinfo_t adaptive_fecinfo = {
+		.min_proactive_packets		= 2,
+		.max_proactive_packets		= 32
+	};
+	fail_unless (FALSE == pgm_setsockopt (sock, level, PGM_ADAPTIVE_FEC, &adaptive_fecinfo, sizeof(adaptive_fecinfo)), "set_adaptive_fec failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_FEC_INTERLEAVE,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_fec_interleave_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int tg_depth	= 4;
+	fail_unless (TRUE == pgm_setsockopt (sock, level, PGM_FEC_INTERLEAVE, &tg_depth, sizeof(tg_depth)), "set_fec_interleave failed");
+	fail_unless (2 == sock->tg_depth_shift, "interleave depth not stored");
+}
+END_TEST
+
+/* depth not a power of two */
+START_TEST (test_set_fec_interleave_fail_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int tg_depth	= 3;
+	fail_unless (FALSE == pgm_setsockopt (sock, level, PGM_FEC_INTERLEAVE, &tg_depth, sizeof(tg_depth)), "set_fec_interleave failed");
+}
+END_TEST
+
 /* target:
  *	bool
  *	pgm_setsockopt (
@@ -1049,6 +1161,295 @@ START_TEST (test_set_abort_on_reset_fail_001)
 }
 END_TEST
 
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_DEFER_CHECKSUM,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_defer_checksum_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_DEFER_CHECKSUM;
+	const int defer		= 1;
+	const void* optval	= &defer;
+	const socklen_t optlen	= sizeof(defer);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_defer_checksum failed");
+	fail_unless (TRUE == sock->use_deferred_csum, "use_deferred_csum not set");
+}
+END_TEST
+
+START_TEST (test_set_defer_checksum_fail_001)
+{
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_DEFER_CHECKSUM;
+	const int defer		= 1;
+	const void* optval	= &defer;
+	const socklen_t optlen	= sizeof(defer);
+	fail_unless (FALSE == pgm_setsockopt (NULL, level, optname, optval, optlen), "set_defer_checksum failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_USE_TIMER_SOCK,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_use_timer_sock_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_USE_TIMER_SOCK;
+	const int use_timer_sock = 1;
+	const void* optval	= &use_timer_sock;
+	const socklen_t optlen	= sizeof(use_timer_sock);
+#ifdef HAVE_TIMERFD_CREATE
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_use_timer_sock failed");
+	fail_unless (TRUE == sock->use_timer_sock, "use_timer_sock not set");
+#else
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_use_timer_sock failed");
+#endif
+}
+END_TEST
+
+START_TEST (test_set_use_timer_sock_fail_001)
+{
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_USE_TIMER_SOCK;
+	const int use_timer_sock = 1;
+	const void* optval	= &use_timer_sock;
+	const socklen_t optlen	= sizeof(use_timer_sock);
+	fail_unless (FALSE == pgm_setsockopt (NULL, level, optname, optval, optlen), "set_use_timer_sock failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_USE_READY_SOCK,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_use_ready_sock_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_USE_READY_SOCK;
+	const int use_ready_sock = 1;
+	const void* optval	= &use_ready_sock;
+	const socklen_t optlen	= sizeof(use_ready_sock);
+#ifdef HAVE_EPOLL_CTL
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_use_ready_sock failed");
+	fail_unless (TRUE == sock->use_ready_sock, "use_ready_sock not set");
+#else
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_use_ready_sock failed");
+#endif
+}
+END_TEST
+
+START_TEST (test_set_use_ready_sock_fail_001)
+{
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_USE_READY_SOCK;
+	const int use_ready_sock = 1;
+	const void* optval	= &use_ready_sock;
+	const socklen_t optlen	= sizeof(use_ready_sock);
+	fail_unless (FALSE == pgm_setsockopt (NULL, level, optname, optval, optlen), "set_use_ready_sock failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_BUSY_POLL,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_busy_poll_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_BUSY_POLL;
+	const int busy_poll	= 50;
+	const void* optval	= &busy_poll;
+	const socklen_t optlen	= sizeof(busy_poll);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_busy_poll failed");
+	fail_unless (50 == sock->busy_poll_budget, "busy_poll_budget not set");
+}
+END_TEST
+
+/* kernel refuses, e.g. without CAP_NET_ADMIN */
+START_TEST (test_set_busy_poll_pass_002)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	closesocket (sock->recv_sock);
+	sock->recv_sock = INVALID_SOCKET;
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_BUSY_POLL;
+	const int busy_poll	= 50;
+	const void* optval	= &busy_poll;
+	const socklen_t optlen	= sizeof(busy_poll);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_busy_poll failed");
+	fail_unless (50 == sock->busy_poll_budget, "busy_poll_budget not set");
+	struct pgm_busy_poll_stats_t stats;
+	socklen_t statslen = sizeof(stats);
+	fail_unless (TRUE == pgm_getsockopt (sock, level, PGM_BUSY_POLL_STATS, &stats, &statslen), "get_busy_poll_stats failed");
+	fail_unless (0 == stats.kernel_busy_poll, "kernel_busy_poll reported");
+	fail_unless (0 == stats.kernel_prefer_busy_poll, "kernel_prefer_busy_poll reported");
+}
+END_TEST
+
+START_TEST (test_set_busy_poll_fail_001)
+{
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_BUSY_POLL;
+	const int busy_poll	= 50;
+	const void* optval	= &busy_poll;
+	const socklen_t optlen	= sizeof(busy_poll);
+	fail_unless (FALSE == pgm_setsockopt (NULL, level, optname, optval, optlen), "set_busy_poll failed");
+}
+END_TEST
+
+/* negative budget */
+START_TEST (test_set_busy_poll_fail_002)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_BUSY_POLL;
+	const int busy_poll	= -1;
+	const void* optval	= &busy_poll;
+	const socklen_t optlen	= sizeof(busy_poll);
+	fail_unless (FALSE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_busy_poll failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_setsockopt (
+ *		pgm_sock_t* const	sock,
+ *		const int		level = IPPROTO_PGM,
+ *		const int		optname = PGM_SINGLE_THREADED,
+ *		const void*		optval,
+ *		const socklen_t		optlen = sizeof(int)
+ *	)
+ */
+
+START_TEST (test_set_single_threaded_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_SINGLE_THREADED;
+	const int single_threaded = 1;
+	const void* optval	= &single_threaded;
+	const socklen_t optlen	= sizeof(single_threaded);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_single_threaded failed");
+	fail_unless (sock->is_single_threaded, "is_single_threaded not set");
+}
+END_TEST
+
+/* rate buckets follow a change after bind */
+START_TEST (test_set_single_threaded_pass_002)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->is_bound = TRUE;
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_SINGLE_THREADED;
+	int single_threaded	= 1;
+	const void* optval	= &single_threaded;
+	const socklen_t optlen	= sizeof(single_threaded);
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_single_threaded failed");
+	fail_unless (sock->rate_control.is_single_threaded, "rate_control not set");
+	fail_unless (sock->odata_rate_control.is_single_threaded, "odata_rate_control not set");
+	fail_unless (sock->rdata_rate_control.is_single_threaded, "rdata_rate_control not set");
+	single_threaded = 0;
+	fail_unless (TRUE == pgm_setsockopt (sock, level, optname, optval, optlen), "set_single_threaded failed");
+	fail_unless (!sock->rate_control.is_single_threaded, "rate_control not cleared");
+	fail_unless (!sock->odata_rate_control.is_single_threaded, "odata_rate_control not cleared");
+	fail_unless (!sock->rdata_rate_control.is_single_threaded, "rdata_rate_control not cleared");
+}
+END_TEST
+
+/* FEC workers still take the timer lock to wake the application thread */
+START_TEST (test_set_single_threaded_pass_003)
+{
+	pgm_gf8_t packets[4][64];
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->is_single_threaded = TRUE;
+	fail_unless (0 == pgm_notify_init (&sock->pending_notify), "notify_init failed");
+	pgm_mutex_init (&sock->timer_mutex);
+	pgm_fec_pool_t* pool = pgm_fec_pool_create (1, fec_pool_notify, sock, NULL);
+	fail_if (NULL == pool, "fec_pool_create failed");
+/* complete group, nothing to reconstruct */
+	pgm_fec_job_t* job = pgm_fec_job_new (8, 4);
+	job->window = sock;
+	job->parity_length = sizeof(packets[0]);
+	for (unsigned i = 0; i < 4; i++) {
+		memset (packets[ i ], 'a' + i, sizeof(packets[ i ]));
+		job->tg_data[ i ] = packets[ i ];
+		job->offsets[ i ] = i;
+	}
+	pgm_mutex_lock (&sock->timer_mutex);
+	pgm_fec_pool_push (pool, job);
+	for (unsigned i = 0; i < 1000 && !pgm_fec_pool_has_completed (pool); i++)
+		g_usleep (1000);
+	fail_unless (pgm_fec_pool_has_completed (pool), "job not completed");
+/* worker blocked on the timer lock */
+	g_usleep (10 * 1000);
+	fail_unless (!sock->is_pending_read, "notify without timer lock");
+	pgm_mutex_unlock (&sock->timer_mutex);
+	bool is_pending_read = FALSE;
+	for (unsigned i = 0; i < 1000 && !is_pending_read; i++) {
+		g_usleep (1000);
+		pgm_mutex_lock (&sock->timer_mutex);
+		is_pending_read = sock->is_pending_read;
+		pgm_mutex_unlock (&sock->timer_mutex);
+	}
+	fail_unless (is_pending_read, "notify failed");
+	pgm_fec_job_free (pgm_fec_pool_pop_completed (pool));
+	pgm_fec_pool_destroy (pool);
+}
+END_TEST
+
+START_TEST (test_set_single_threaded_fail_001)
+{
+	const int level		= IPPROTO_PGM;
+	const int optname	= PGM_SINGLE_THREADED;
+	const int single_threaded = 1;
+	const void* optval	= &single_threaded;
+	const socklen_t optlen	= sizeof(single_threaded);
+	fail_unless (FALSE == pgm_setsockopt (NULL, level, optname, optval, optlen), "set_single_threaded failed");
+}
+END_TEST
+
 /* target:
  *	bool
  *	pgm_setsockopt (
@@ -1225,6 +1626,18 @@ make_test_suite (void)
 	tcase_add_test (tc_set_fec, test_set_fec_pass_001);
 	tcase_add_test (tc_set_fec, test_set_fec_fail_001);
 
+	TCase* tc_set_adaptive_fec = tcase_create ("set-adaptive-fec");
+	suite_add_tcase (s, tc_set_adaptive_fec);
+	tcase_add_checked_fixture (tc_set_adaptive_fec, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_adaptive_fec, test_set_adaptive_fec_pass_001);
+	tcase_add_test (tc_set_adaptive_fec, test_set_adaptive_fec_fail_001);
+
+	TCase* tc_set_fec_interleave = tcase_create ("set-fec-interleave");
+	suite_add_tcase (s, tc_set_fec_interleave);
+	tcase_add_checked_fixture (tc_set_fec_interleave, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_fec_interleave, test_set_fec_interleave_pass_001);
+	tcase_add_test (tc_set_fec_interleave, test_set_fec_interleave_fail_001);
+
 	TCase* tc_set_pgmcc = tcase_create ("set-pgmcc");
 	suite_add_tcase (s, tc_set_pgmcc);
 	tcase_add_checked_fixture (tc_set_pgmcc, mock_setup, mock_teardown);
@@ -1263,6 +1676,40 @@ make_test_suite (void)
 	tcase_add_test (tc_set_noblock, test_set_noblock_pass_001);
 	tcase_add_test (tc_set_noblock, test_set_noblock_fail_001);
 
+	TCase* tc_set_defer_checksum = tcase_create ("set-defer-checksum");
+	suite_add_tcase (s, tc_set_defer_checksum);
+	tcase_add_checked_fixture (tc_set_defer_checksum, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_defer_checksum, test_set_defer_checksum_pass_001);
+	tcase_add_test (tc_set_defer_checksum, test_set_defer_checksum_fail_001);
+
+	TCase* tc_set_use_timer_sock = tcase_create ("set-use-timer-sock");
+	suite_add_tcase (s, tc_set_use_timer_sock);
+	tcase_add_checked_fixture (tc_set_use_timer_sock, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_use_timer_sock, test_set_use_timer_sock_pass_001);
+	tcase_add_test (tc_set_use_timer_sock, test_set_use_timer_sock_fail_001);
+
+	TCase* tc_set_use_ready_sock = tcase_create ("set-use-ready-sock");
+	suite_add_tcase (s, tc_set_use_ready_sock);
+	tcase_add_checked_fixture (tc_set_use_ready_sock, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_use_ready_sock, test_set_use_ready_sock_pass_001);
+	tcase_add_test (tc_set_use_ready_sock, test_set_use_ready_sock_fail_001);
+
+	TCase* tc_set_busy_poll = tcase_create ("set-busy-poll");
+	suite_add_tcase (s, tc_set_busy_poll);
+	tcase_add_checked_fixture (tc_set_busy_poll, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_busy_poll, test_set_busy_poll_pass_001);
+	tcase_add_test (tc_set_busy_poll, test_set_busy_poll_pass_002);
+	tcase_add_test (tc_set_busy_poll, test_set_busy_poll_fail_001);
+	tcase_add_test (tc_set_busy_poll, test_set_busy_poll_fail_002);
+
+	TCase* tc_set_single_threaded = tcase_create ("set-single-threaded");
+	suite_add_tcase (s, tc_set_single_threaded);
+	tcase_add_checked_fixture (tc_set_single_threaded, mock_setup, mock_teardown);
+	tcase_add_test (tc_set_single_threaded, test_set_single_threaded_pass_001);
+	tcase_add_test (tc_set_single_threaded, test_set_single_threaded_pass_002);
+	tcase_add_test (tc_set_single_threaded, test_set_single_threaded_pass_003);
+	tcase_add_test (tc_set_single_threaded, test_set_single_threaded_fail_001);
+
 	TCase* tc_set_udp_unicast = tcase_create ("set-udp-encap-ucast-port");
 	suite_add_tcase (s, tc_set_udp_unicast);
 	tcase_add_checked_fixture (tc_set_udp_unicast, mock_setup, mock_teardown);
@@ -30,6 +30,7 @@
 #include <impl/sqn_list.h>
 #include <impl/packet_parse.h>
 #include <impl/net.h>
+#include <impl/timer.h>
 
 
 //#define SOURCE_DEBUG
@@ -48,7 +49,10 @@ static bool send_ncf_list (pgm_sock_t*const restrict, const struct sockaddr*cons
 static int send_odata (pgm_sock_t*const restrict, struct pgm_sk_buff_t*const restrict, size_t*restrict);
 static int send_odata_copy (pgm_sock_t*const restrict, const void*restrict, const uint16_t, size_t*restrict);
 static int send_odatav (pgm_sock_t*const restrict, const struct pgm_iovec*const restrict, const unsigned, size_t*restrict);
-static bool send_rdata (pgm_sock_t*restrict, struct pgm_sk_buff_t*restrict);
+static bool send_rdata (pgm_sock_t*restrict, struct pgm_sk_buff_t*restrict, const pgm_time_t);
+static int drain_send_queue (pgm_sock_t*const restrict, size_t*restrict);
+static int push_send_queue (pgm_sock_t*const restrict, struct pgm_sk_buff_t*const restrict);
+static int lock_direct_send (pgm_sock_t*const);
 
 
 static inline
@@ -110,24 +114,124 @@ source_max_tsdu (
 	return max_tsdu;
 }
 
-/* prototype of function to send pro-active parity NAKs.
+/* re-calculate count of pro-active parity packets per transmission group from
+ * a smoothed loss estimate.  loss is sampled once per block of interleaved
+ * groups as the count of packets requested by NAKs since the last sample, raised to the
+ * ACKer reported loss rate when PGMCC is enabled.  the estimate is a 1/8 gain
+ * moving average, h is set to 1.5× the expected loss within the bounds.  runs on
+ * the receive path from pgm_on_proactive_nak() hence the receiver role counters.
+ */
+
+static
+void
+adapt_proactive_parity (
+	pgm_sock_t*		sock
+	)
+{
+	const uint32_t loss_count = pgm_atomic_read32 (&sock->parity_loss_count);
+	const uint32_t lost = loss_count - sock->parity_loss_snap;
+	sock->parity_loss_snap = loss_count;
+
+	const uint32_t block_size = (uint32_t)sock->rs_k << sock->tg_depth_shift;
+	uint32_t sample = lost >= block_size ? 65536 : (lost << 16) / block_size;
+	if (sock->use_pgmcc && sock->acker_loss_rate > sample)
+		sample = sock->acker_loss_rate;
+	sock->parity_loss_rate = (uint32_t)((int32_t)sock->parity_loss_rate + ((int32_t)sample - (int32_t)sock->parity_loss_rate) / 8);
+
+	uint32_t h = ((sock->parity_loss_rate * sock->rs_k * 3) + (1 << 17) - 1) >> 17;
+	if (h < sock->rs_proactive_h_min)
+		h = sock->rs_proactive_h_min;
+	else if (h > sock->rs_proactive_h_max)
+		h = sock->rs_proactive_h_max;
+	if (h != sock->rs_proactive_h) {
+		pgm_trace (PGM_LOG_ROLE_FEC,_("Pro-active parity %u -> %u packets per transmission group, loss estimate %.2f%%."),
+			(unsigned)sock->rs_proactive_h, (unsigned)h,
+			(100.0 * sock->parity_loss_rate) / 65536.0);
+		sock->rs_proactive_h = (uint8_t)h;
+		pgm_stats_set (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_PROACTIVE_PARITY_PACKETS, h);
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_PROACTIVE_PARITY_CHANGES);
+	}
+}
+
+/* prototype of function to send pro-active parity NAKs, one per transmission
+ * group of the completed block.
  */
 
 static
 bool
 pgm_schedule_proactive_nak (
 	pgm_sock_t*		sock,
-	uint32_t		nak_tg_sqn	/* transmission group (shifted) */
+	uint32_t		nak_tg_block	/* first sequence of block */
 	)
 {
-	pgm_return_val_if_fail (NULL != sock, FALSE);
-	const bool status = pgm_txw_retransmit_push (sock->window,
-						     nak_tg_sqn | sock->rs_proactive_h,
-						     TRUE /* is_parity */,
-						     sock->tg_sqn_shift);
+	bool status = TRUE;
+
+	pgm_assert (NULL != sock);
+	if (sock->use_adaptive_parity) {
+		adapt_proactive_parity (sock);
+		if (0 == sock->rs_proactive_h)
+			return TRUE;
+	}
+	const uint32_t tg_depth = 1 << sock->tg_depth_shift;
+	for (uint32_t i = 0; i < tg_depth; i++)
+	{
+		const uint32_t nak_tg_sqn = nak_tg_block + i;
+		if (!pgm_txw_retransmit_push (sock->window,
+					      nak_tg_sqn + ((sock->rs_proactive_h - 1u) << sock->tg_depth_shift),
+					      TRUE /* is_parity */,
+					      sock->tg_sqn_shift))
+			status = FALSE;
+	}
 	return status;
 }
 
+/* publish the end of a block of transmission groups completed by the send path,
+ * the repair side schedules the pro-active parity as only the receive path may
+ * change the retransmit queue.
+ */
+
+static inline
+void
+queue_proactive_nak (
+	pgm_sock_t*		sock,
+	uint32_t		tg_block_end	/* first sequence of next block */
+	)
+{
+	pgm_atomic_write32_release (&sock->proactive_lead, tg_block_end);
+	pgm_notify_send (&sock->rdata_notify);
+}
+
+/* schedule pro-active parity for each block completed by the send path since the
+ * last call, blocks already evicted from the transmit window are skipped.  called
+ * with the receiver mutex held as per pgm_on_nak().
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_on_proactive_nak (
+	pgm_sock_t* const	sock
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (sock->use_proactive_parity);
+
+	const uint32_t lead = pgm_atomic_read32_acquire (&sock->proactive_lead);
+	if (PGM_LIKELY(lead == sock->proactive_trail))
+		return;
+
+	const uint32_t tg_block_len  = 1 << (sock->tg_sqn_shift + sock->tg_depth_shift);
+	const uint32_t tg_block_mask = ~(tg_block_len - 1);
+	const uint32_t window_trail  = pgm_txw_trail_atomic (sock->window) & tg_block_mask;
+	if (pgm_uint32_lt (sock->proactive_trail, window_trail))
+		sock->proactive_trail = window_trail;
+	while (pgm_uint32_lt (sock->proactive_trail, lead)) {
+		pgm_schedule_proactive_nak (sock, sock->proactive_trail);
+		sock->proactive_trail += tg_block_len;
+	}
+	sock->proactive_trail = lead;
+}
+
 /* a deferred request for RDATA, now processing in the timer thread, we check the transmit
  * window to see if the packet exists and forward on, maintaining a lock until the queue is
  * empty.
@@ -138,7 +242,8 @@ pgm_schedule_proactive_nak (
 PGM_GNUC_INTERNAL
 bool
 pgm_on_deferred_nak (
-	pgm_sock_t* const	sock
+	pgm_sock_t* const	sock,
+	const pgm_time_t	now
 	)
 {
 	struct pgm_sk_buff_t* skb;
@@ -156,14 +261,12 @@ pgm_on_deferred_nak (
  */
 
 /* peek from the retransmit queue so we can eliminate duplicate NAKs up until the repair packet
- * has been retransmitted.
+ * has been retransmitted.  the window is read without a lock, the returned skbuff carries its
+ * own reference.
  */
-	pgm_spinlock_lock (&sock->txw_spinlock);
 	skb = pgm_txw_retransmit_try_peek (sock->window);
 	if (skb) {
-		skb = pgm_skb_get (skb);
-		pgm_spinlock_unlock (&sock->txw_spinlock);
-		if (!send_rdata (sock, skb)) {
+		if (!send_rdata (sock, skb, now)) {
 			pgm_free_skb (skb);
 			pgm_notify_send (&sock->rdata_notify);
 			return FALSE;
@@ -171,8 +274,7 @@ pgm_on_deferred_nak (
 		pgm_free_skb (skb);
 /* now remove sequence number from retransmit queue, re-enabling NAK processing for this sequence number */
 		pgm_txw_retransmit_remove_head (sock->window);
-	} else
-		pgm_spinlock_unlock (&sock->txw_spinlock);
+	}
 	return TRUE;
 }
 
@@ -261,6 +363,7 @@ on_opt_pgmcc_feedback (
 	if (0 == pgm_sockaddr_cmp ((const struct sockaddr*)&peer_nla, (const struct sockaddr*)&sock->acker_nla))
 	{
 		sock->acker_loss = peer_loss;
+		sock->acker_loss_rate = opt_loss_rate;
 		return TRUE;
 	}
 
@@ -302,18 +405,18 @@ pgm_on_nak (
 
 	const bool is_parity = skb->pgm_header->pgm_options & PGM_OPT_PARITY;
 	if (is_parity) {
-		sock->cumulative_stats[PGM_PC_SOURCE_PARITY_NAKS_RECEIVED]++;
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_PARITY_NAKS_RECEIVED);
 		if (!sock->use_ondemand_parity) {
 			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Parity NAK rejected as on-demand parity is not enabled."));
-			sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS]++;
+			pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_MALFORMED_NAKS);
 			return FALSE;
 		}
 	} else
-		sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED]++;
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED);
 
 	if (PGM_UNLIKELY(!pgm_verify_nak (skb))) {
 		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Malformed NAK rejected on verification."));
-		sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS]++;
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_MALFORMED_NAKS);
 		return FALSE;
 	}
 
@@ -327,7 +430,7 @@ pgm_on_nak (
 		char saddr[INET6_ADDRSTRLEN];
 		pgm_sockaddr_ntop ((struct sockaddr*)&nak_src_nla, saddr, sizeof(saddr));
 		pgm_trace (PGM_LOG_ROLE_NETWORK,_("NAK rejected for unmatched NLA: %s"), saddr);
-		sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS]++;
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_MALFORMED_NAKS);
 		return FALSE;
 	}
 
@@ -338,7 +441,7 @@ pgm_on_nak (
 		char sgroup[INET6_ADDRSTRLEN];
 		pgm_sockaddr_ntop ((struct sockaddr*)&nak_src_nla, sgroup, sizeof(sgroup));
 		pgm_trace (PGM_LOG_ROLE_NETWORK,_("NAK rejected as targeted for different multicast group: %s"), sgroup);
-		sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS]++;
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_MALFORMED_NAKS);
 		return FALSE;
 	}
 
@@ -359,12 +462,12 @@ pgm_on_nak (
 				(const struct pgm_opt_length*)(nak  + 1);
 		if (PGM_UNLIKELY(opt_len->opt_type != PGM_OPT_LENGTH)) {
 			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Malformed NAK rejected on unexpected primary PGM option type."));
-			sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS]++;
+			pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_MALFORMED_NAKS);
 			return FALSE;
 		}
 		if (PGM_UNLIKELY(opt_len->opt_length != sizeof(struct pgm_opt_length))) {
 			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Malformed NAK rejected on length of length option header."));
-			sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS]++;
+			pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_MALFORMED_NAKS);
 			return FALSE;
 		}
 /* TODO: check for > 16 options & past packet end */
@@ -407,6 +510,20 @@ pgm_on_nak (
 			pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Failed to push retransmit request for #%" PRIu32), sqn_list.sqn[i]);
 		}
 	}
+
+/* feed loss estimate for adaptive pro-active parity, parity NAKs carry the
+ * count of missing packets in the transmission group minus one.
+ */
+	if (sock->use_adaptive_parity) {
+		uint32_t lost = 0;
+		if (is_parity) {
+			const uint32_t tg_block_mask = 0xffffffff << (sock->tg_sqn_shift + sock->tg_depth_shift);
+			for (uint_fast8_t i = 0; i < sqn_list.len; i++)
+				lost += 1 + ((sqn_list.sqn[i] & ~tg_block_mask) >> sock->tg_depth_shift);
+		} else
+			lost = sqn_list.len;
+		pgm_atomic_add32 (&sock->parity_loss_count, lost);
+	}
 	return TRUE;
 }
 
@@ -434,10 +551,10 @@ pgm_on_nnak (
 	pgm_debug ("pgm_on_nnak (sock:%p skb:%p)",
 		(void*)sock, (void*)skb);
 
-	sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED]++;
+	pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED);
 
 	if (PGM_UNLIKELY(!pgm_verify_nnak (skb))) {
-		sock->cumulative_stats[PGM_PC_SOURCE_NNAK_ERRORS]++;
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_NNAK_ERRORS);
 		return FALSE;
 	}
 
@@ -449,7 +566,7 @@ pgm_on_nnak (
 
 	if (PGM_UNLIKELY(pgm_sockaddr_cmp ((struct sockaddr*)&nnak_src_nla, (struct sockaddr*)&sock->send_addr) != 0))
 	{
-		sock->cumulative_stats[PGM_PC_SOURCE_NNAK_ERRORS]++;
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_NNAK_ERRORS);
 		return FALSE;
 	}
 
@@ -457,7 +574,7 @@ pgm_on_nnak (
 	pgm_nla_to_sockaddr ((AF_INET6 == nnak_src_nla.ss_family) ? &nnak6->nak6_grp_nla_afi : &nnak->nak_grp_nla_afi, (struct sockaddr*)&nnak_grp_nla);
 	if (PGM_UNLIKELY(pgm_sockaddr_cmp ((struct sockaddr*)&nnak_grp_nla, (struct sockaddr*)&sock->send_gsr.gsr_group) != 0))
 	{
-		sock->cumulative_stats[PGM_PC_SOURCE_NNAK_ERRORS]++;
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_NNAK_ERRORS);
 		return FALSE;
 	}
 
@@ -468,11 +585,11 @@ pgm_on_nnak (
 							(const struct pgm_opt_length*)(nnak6 + 1) :
 							(const struct pgm_opt_length*)(nnak + 1);
 		if (PGM_UNLIKELY(opt_len->opt_type != PGM_OPT_LENGTH)) {
-			sock->cumulative_stats[PGM_PC_SOURCE_NNAK_ERRORS]++;
+			pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_NNAK_ERRORS);
 			return FALSE;
 		}
 		if (PGM_UNLIKELY(opt_len->opt_length != sizeof(struct pgm_opt_length))) {
-			sock->cumulative_stats[PGM_PC_SOURCE_NNAK_ERRORS]++;
+			pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_NNAK_ERRORS);
 			return FALSE;
 		}
 /* TODO: check for > 16 options & past packet end */
@@ -486,7 +603,7 @@ pgm_on_nnak (
 		} while (!(opt_header->opt_type & PGM_OPT_END));
 	}
 
-	sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED] += 1 + nnak_list_len;
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED, (uint32_t)(1 + nnak_list_len));
 	return TRUE;
 }
 
@@ -514,10 +631,10 @@ pgm_on_ack (
 	pgm_debug ("pgm_on_ack (sock:%p skb:%p)",
 		(const void*)sock, (const void*)skb);
 
-	sock->cumulative_stats[PGM_PC_SOURCE_ACK_PACKETS_RECEIVED]++;
+	pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_ACK_PACKETS_RECEIVED);
 
 	if (PGM_UNLIKELY(!pgm_verify_ack (skb))) {
-		sock->cumulative_stats[PGM_PC_SOURCE_ACK_ERRORS]++;
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_ACK_ERRORS);
 		return FALSE;
 	}
 
@@ -765,7 +882,8 @@ pgm_send_spm (
 			opt_header->opt_length	= sizeof(struct pgm_opt_header) + sizeof(struct pgm_opt_parity_prm);
 			opt_parity_prm = (struct pgm_opt_parity_prm*)(opt_header + 1);
 			opt_parity_prm->opt_reserved = (sock->use_proactive_parity ? PGM_PARITY_PRM_PRO : 0) |
-						       (sock->use_ondemand_parity ? PGM_PARITY_PRM_OND : 0);
+						       (sock->use_ondemand_parity ? PGM_PARITY_PRM_OND : 0) |
+						       ((sock->tg_depth_shift << PGM_PARITY_PRM_DEPTH_SHIFT) & PGM_PARITY_PRM_DEPTH_MASK);
 			opt_parity_prm->parity_prm_tgs = pgm_htonl (sock->rs_k);
 			last_opt_header = opt_header;
 			opt_header = (struct pgm_opt_header*)(opt_parity_prm + 1);
@@ -832,7 +950,7 @@ pgm_send_spm (
 
 /* advance SPM sequence only on successful transmission */
 	sock->spm_sqn++;
-	pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)tpdu_length);
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_BYTES_SENT, (uint32_t)tpdu_length);
 	return TRUE;
 }
 
@@ -917,7 +1035,7 @@ send_ncf (
 		return FALSE;
 /* fall through silently on other errors */
 			
-	pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)tpdu_length);
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_BYTES_SENT, (uint32_t)tpdu_length);
 	return TRUE;
 }
 
@@ -1032,11 +1150,14 @@ send_ncf_list (
 		return FALSE;
 /* fall through silently on other errors */
 
-	pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)tpdu_length);
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_RECEIVER, PGM_PC_SOURCE_BYTES_SENT, (uint32_t)tpdu_length);
 	return TRUE;
 }
 
-/* cancel any pending heartbeat SPM and schedule a new one
+/* record a data packet for the heartbeat SPM schedule, the timer dispatcher
+ * derives the heartbeat times from the last data time.  only the first data
+ * packet after the heartbeat is disarmed takes the timer lock and prods the
+ * timer, following packets cost one locked add.
  */
 
 static
@@ -1046,19 +1167,21 @@ reset_heartbeat_spm (
 	const pgm_time_t	now
 	)
 {
-	pgm_mutex_lock (&sock->timer_mutex);
-	const pgm_time_t next_poll = sock->next_poll;
-	const pgm_time_t spm_heartbeat_interval = sock->spm_heartbeat_interval[ sock->spm_heartbeat_state = 1 ];
-	sock->next_heartbeat_spm = now + spm_heartbeat_interval;
-	if (pgm_time_after( next_poll, sock->next_heartbeat_spm ))
+	pgm_atomic_write32 (&sock->spm_heartbeat_data_tstamp, (uint32_t)now);
+	if (PGM_LIKELY(0 != pgm_atomic_exchange_and_add32 (&sock->spm_heartbeat_data_count, 1)))
+		return;
+
+	const pgm_time_t next_heartbeat_spm = now + sock->spm_heartbeat_interval[ 1 ];
+	pgm_timer_lock (sock);
+	if (pgm_time_after( sock->next_poll, next_heartbeat_spm ))
 	{
-		sock->next_poll = sock->next_heartbeat_spm;
+		sock->next_poll = next_heartbeat_spm;
 		if (!sock->is_pending_read) {
 			pgm_notify_send (&sock->pending_notify);
 			sock->is_pending_read = TRUE;
 		}
 	}
-	pgm_mutex_unlock (&sock->timer_mutex);
+	pgm_timer_unlock (sock);
 }
 
 /* state helper for resuming sends
@@ -1157,9 +1280,7 @@ send_odata (
         STATE(skb)->pgm_header->pgm_checksum	= pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)pgm_header_len));
 
 /* add to transmit window, skb::data set to payload */
-	pgm_spinlock_lock (&sock->txw_spinlock);
 	pgm_txw_add (sock->window, STATE(skb));
-	pgm_spinlock_unlock (&sock->txw_spinlock);
 
 /* check rate limit at last moment */
 	STATE(is_rate_limited) = FALSE;
@@ -1168,7 +1289,8 @@ send_odata (
 		if (!pgm_rate_check2 (&sock->rate_control,		/* total rate limit */
 				      &sock->odata_rate_control,	/* original data limit */
 				      tpdu_length,			/* excludes IP header len */
-				      sock->is_nonblocking))
+				      sock->is_nonblocking,
+				      STATE(skb)->tstamp))
 		{
 			sock->is_apdu_eagain = TRUE;
 			sock->blocklen = tpdu_length + sock->iphdr_len;
@@ -1192,14 +1314,15 @@ retry_send:
 		return PGM_IO_STATUS_CONGESTION;	/* peer expiration to re-elect ACKer */
 	}
 
-	sent = pgm_sendto (sock,
+	sent = pgm_sendto_now (sock,
 			   !STATE(is_rate_limited),	/* rate limit on blocking */
 			   &sock->odata_rate_control,
 			   FALSE,			/* regular socket */
 			   STATE(skb)->head,
 			   tpdu_length,
 			   (struct sockaddr*)&sock->send_gsr.gsr_group,
-			   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+			   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group),
+			   STATE(skb)->tstamp);
 	if (sent < 0) {
 		const int save_errno = pgm_get_last_sock_error();
 		if (PGM_LIKELY(PGM_SOCK_EAGAIN == save_errno || PGM_SOCK_ENOBUFS == save_errno))
@@ -1228,16 +1351,16 @@ retry_send:
 	pgm_txw_set_unfolded_checksum (STATE(skb), STATE(unfolded_odata));
 /* increment socket statistics */
 	if (PGM_LIKELY((size_t)sent == tpdu_length)) {
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += tsdu_length;
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  ++;
-		pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)(tpdu_length + sock->iphdr_len));
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_BYTES_SENT, (uint32_t)tsdu_length);
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_MSGS_SENT);
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_BYTES_SENT, (uint32_t)(tpdu_length + sock->iphdr_len));
 	}
 /* check for end of transmission group for pro-active packets */
 	if (sock->use_proactive_parity) {
 		const uint32_t odata_sqn = pgm_ntohl (STATE(skb)->pgm_data->data_sqn);
-		const uint32_t tg_sqn_mask = 0xffffffff << sock->tg_sqn_shift;
+		const uint32_t tg_sqn_mask = 0xffffffff << (sock->tg_sqn_shift + sock->tg_depth_shift);
 		if (!((odata_sqn + 1) & ~tg_sqn_mask))
-			pgm_schedule_proactive_nak (sock, odata_sqn & tg_sqn_mask);
+			queue_proactive_nak (sock, odata_sqn + 1);
 	}
 /* remove applications reference to skbuff */
 	pgm_free_skb (STATE(skb));
@@ -1282,8 +1405,9 @@ send_odata_copy (
 		goto retry_send;
 	}
 
-	STATE(skb) = pgm_alloc_skb (sock->max_tpdu);
+	STATE(skb) = pgm_arena_alloc_skb (sock->tx_arena, sock->max_tpdu);
 	STATE(skb)->sock = sock;
+	STATE(skb)->single_threaded = sock->is_single_threaded;
 	STATE(skb)->tstamp = pgm_time_update_now();
 	pgm_skb_reserve (STATE(skb), (uint16_t)pgm_pkt_offset (FALSE, pgmcc_family));
 	pgm_skb_put (STATE(skb), (uint16_t)tsdu_length);
@@ -1334,9 +1458,7 @@ send_odata_copy (
 	STATE(skb)->pgm_header->pgm_checksum	= pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)pgm_header_len));
 
 /* add to transmit window, skb::data set to payload */
-	pgm_spinlock_lock (&sock->txw_spinlock);
 	pgm_txw_add (sock->window, STATE(skb));
-	pgm_spinlock_unlock (&sock->txw_spinlock);
 
 /* check rate limit at last moment */
 	STATE(is_rate_limited) = FALSE;
@@ -1345,7 +1467,8 @@ send_odata_copy (
 		if (!pgm_rate_check2 (&sock->rate_control,		/* total rate limit */
 				      &sock->odata_rate_control,	/* original data limit */
 				      tpdu_length,			/* excludes IP header len */
-				      sock->is_nonblocking))
+				      sock->is_nonblocking,
+				      STATE(skb)->tstamp))
 		{
 			sock->is_apdu_eagain = TRUE;
 			sock->blocklen = tpdu_length + sock->iphdr_len;
@@ -1365,14 +1488,15 @@ retry_send:
 		return PGM_IO_STATUS_CONGESTION;
 	}
 
-	sent = pgm_sendto (sock,
+	sent = pgm_sendto_now (sock,
 			   !STATE(is_rate_limited),	/* rate limit on blocking */
 			   &sock->odata_rate_control,
 			   FALSE,			/* regular socket */
 			   STATE(skb)->head,
 			   tpdu_length,
 			   (struct sockaddr*)&sock->send_gsr.gsr_group,
-			   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+			   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group),
+			   STATE(skb)->tstamp);
 	if (sent < 0) {
 		const int save_errno = pgm_get_last_sock_error();
 		if (PGM_LIKELY(PGM_SOCK_EAGAIN == save_errno || PGM_SOCK_ENOBUFS == save_errno))
@@ -1403,16 +1527,16 @@ retry_send:
 	pgm_txw_set_unfolded_checksum (STATE(skb), STATE(unfolded_odata));
 /* increment socket statistics */
 	if (PGM_LIKELY((size_t)sent == tpdu_length)) {
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += tsdu_length;
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  ++;
-		pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)(tpdu_length + sock->iphdr_len));
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_BYTES_SENT, (uint32_t)tsdu_length);
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_MSGS_SENT);
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_BYTES_SENT, (uint32_t)(tpdu_length + sock->iphdr_len));
 	}
 /* check for end of transmission group for pro-active packets */
 	if (sock->use_proactive_parity) {
 		const uint32_t odata_sqn = pgm_ntohl (STATE(skb)->pgm_data->data_sqn);
-		const uint32_t tg_sqn_mask = 0xffffffff << sock->tg_sqn_shift;
+		const uint32_t tg_sqn_mask = 0xffffffff << (sock->tg_sqn_shift + sock->tg_depth_shift);
 		if (!((odata_sqn + 1) & ~tg_sqn_mask))
-			pgm_schedule_proactive_nak (sock, odata_sqn & tg_sqn_mask);
+			queue_proactive_nak (sock, odata_sqn + 1);
 	}
 
 /* return data payload length sent */
@@ -1475,8 +1599,9 @@ send_odatav (
 	}
 	pgm_return_val_if_fail (STATE(tsdu_length) <= sock->max_tsdu, PGM_IO_STATUS_ERROR);
 
-	STATE(skb) = pgm_alloc_skb (sock->max_tpdu);
+	STATE(skb) = pgm_arena_alloc_skb (sock->tx_arena, sock->max_tpdu);
 	STATE(skb)->sock = sock;
+	STATE(skb)->single_threaded = sock->is_single_threaded;
 	STATE(skb)->tstamp = pgm_time_update_now();
 	const sa_family_t pgmcc_family = sock->use_pgmcc ? sock->family : 0;
 	pgm_skb_reserve (STATE(skb), (uint16_t)pgm_pkt_offset (FALSE, pgmcc_family));
@@ -1513,9 +1638,7 @@ send_odatav (
 	STATE(skb)->pgm_header->pgm_checksum	= pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)pgm_header_len));
 
 /* add to transmit window, skb::data set to payload */
-	pgm_spinlock_lock (&sock->txw_spinlock);
 	pgm_txw_add (sock->window, STATE(skb));
-	pgm_spinlock_unlock (&sock->txw_spinlock);
 
 	pgm_assert ((char*)STATE(skb)->tail > (char*)STATE(skb)->head);
 	tpdu_length = (char*)STATE(skb)->tail - (char*)STATE(skb)->head;
@@ -1527,7 +1650,8 @@ send_odatav (
 		if (!pgm_rate_check2 (&sock->rate_control,		/* total rate limit */
 				      &sock->odata_rate_control,	/* original data limit */
 				      tpdu_length,			/* excludes IP header len */
-				      sock->is_nonblocking))
+				      sock->is_nonblocking,
+				      STATE(skb)->tstamp))
 		{
 			sock->is_apdu_eagain = TRUE;
 			sock->blocklen = tpdu_length + sock->iphdr_len;
@@ -1537,14 +1661,15 @@ send_odatav (
 	}
 
 retry_send:
-	sent = pgm_sendto (sock,
+	sent = pgm_sendto_now (sock,
 			   !STATE(is_rate_limited),	/* rate limit on blocking */
 			   &sock->odata_rate_control,
 			   FALSE,			/* regular socket */
 			   STATE(skb)->head,
 			   tpdu_length,
 			   (struct sockaddr*)&sock->send_gsr.gsr_group,
-			   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+			   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group),
+			   STATE(skb)->tstamp);
 	if (sent < 0) {
 		const int save_errno = pgm_get_last_sock_error();
 		if (PGM_LIKELY(PGM_SOCK_EAGAIN == save_errno || PGM_SOCK_ENOBUFS == save_errno))
@@ -1568,16 +1693,16 @@ retry_send:
 	pgm_txw_set_unfolded_checksum (STATE(skb), STATE(unfolded_odata));
 /* increment socket statistics */
 	if (PGM_LIKELY((size_t)sent == STATE(skb)->len)) {
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += STATE(tsdu_length);
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  ++;
-		pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)(tpdu_length + sock->iphdr_len));
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_BYTES_SENT, (uint32_t)STATE(tsdu_length));
+		pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_MSGS_SENT);
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_BYTES_SENT, (uint32_t)(tpdu_length + sock->iphdr_len));
 	}
 /* check for end of transmission group */
 	if (sock->use_proactive_parity) {
 		const uint32_t odata_sqn   = pgm_ntohl (STATE(skb)->pgm_data->data_sqn);
-		const uint32_t tg_sqn_mask = 0xffffffff << sock->tg_sqn_shift;
+		const uint32_t tg_sqn_mask = 0xffffffff << (sock->tg_sqn_shift + sock->tg_depth_shift);
 		if (!((odata_sqn + 1) & ~tg_sqn_mask))
-			pgm_schedule_proactive_nak (sock, odata_sqn & tg_sqn_mask);
+			queue_proactive_nak (sock, odata_sqn + 1);
 	}
 
 /* return data payload length sent */
@@ -1612,6 +1737,8 @@ send_apdu (
 	pgm_assert (NULL != apdu);
 
 	const sa_family_t pgmcc_family = sock->use_pgmcc ? sock->family : 0;
+/* one clock read for all packets of this call */
+	const pgm_time_t now = pgm_time_update_now();
 
 /* continue if blocked mid-apdu */
 	if (sock->is_apdu_eagain)
@@ -1634,7 +1761,8 @@ send_apdu (
 		if (!pgm_rate_check2 (&sock->rate_control,
 				      &sock->odata_rate_control,
 				      tpdu_length - sock->iphdr_len,	/* includes 1 × IP header len */
-				      sock->is_nonblocking))
+				      sock->is_nonblocking,
+				      now))
 		{
 			sock->blocklen = tpdu_length;
 			return PGM_IO_STATUS_RATE_LIMITED;
@@ -1655,9 +1783,10 @@ send_apdu (
 		header_length = pgm_pkt_offset (TRUE, pgmcc_family);
 		STATE(tsdu_length) = MIN( source_max_tsdu (sock, TRUE), apdu_length - STATE(data_bytes_offset) );
 
-		STATE(skb) = pgm_alloc_skb (sock->max_tpdu);
+		STATE(skb) = pgm_arena_alloc_skb (sock->tx_arena, sock->max_tpdu);
 		STATE(skb)->sock = sock;
-		STATE(skb)->tstamp = pgm_time_update_now();
+		STATE(skb)->single_threaded = sock->is_single_threaded;
+		STATE(skb)->tstamp = now;
 		pgm_skb_reserve (STATE(skb), (uint16_t)header_length);
 		pgm_skb_put (STATE(skb), (uint16_t)STATE(tsdu_length));
 
@@ -1700,21 +1829,20 @@ send_apdu (
 		STATE(skb)->pgm_header->pgm_checksum	= pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)pgm_header_len));
 
 /* add to transmit window, skb::data set to payload */
-		pgm_spinlock_lock (&sock->txw_spinlock);
 		pgm_txw_add (sock->window, STATE(skb));
-		pgm_spinlock_unlock (&sock->txw_spinlock);
 
 retry_send:
 		pgm_assert ((char*)STATE(skb)->tail > (char*)STATE(skb)->head);
 		tpdu_length = (char*)STATE(skb)->tail - (char*)STATE(skb)->head;
-		sent = pgm_sendto (sock,
+		sent = pgm_sendto_now (sock,
 				   !STATE(is_rate_limited),	/* rate limit on blocking */
 			   	   &sock->odata_rate_control,
 				   FALSE,			/* regular socket */
 				   STATE(skb)->head,
 				   tpdu_length,
 				   (struct sockaddr*)&sock->send_gsr.gsr_group,
-				   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+				   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group),
+				   now);
 		if (sent < 0) {
 			save_errno = pgm_get_last_sock_error();
 			if (PGM_LIKELY(PGM_SOCK_EAGAIN == save_errno || PGM_SOCK_ENOBUFS == save_errno))
@@ -1740,9 +1868,9 @@ retry_send:
 /* check for end of transmission group */
 		if (sock->use_proactive_parity) {
 			const uint32_t odata_sqn = pgm_ntohl (STATE(skb)->pgm_data->data_sqn);
-			const uint32_t tg_sqn_mask = 0xffffffff << sock->tg_sqn_shift;
+			const uint32_t tg_sqn_mask = 0xffffffff << (sock->tg_sqn_shift + sock->tg_depth_shift);
 			if (!((odata_sqn + 1) & ~tg_sqn_mask))
-				pgm_schedule_proactive_nak (sock, odata_sqn & tg_sqn_mask);
+				queue_proactive_nak (sock, odata_sqn + 1);
 		}
 
 	} while ( STATE(data_bytes_offset)  < apdu_length);
@@ -1753,9 +1881,9 @@ retry_send:
 /* SPM heartbeats decay from last sent data packet */
 	reset_heartbeat_spm (sock, STATE(skb)->tstamp);
 /* increment socket statistics */
-	pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)bytes_sent);
-	sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  += packets_sent;
-	sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += data_bytes_sent;
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_BYTES_SENT, (uint32_t)bytes_sent);
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_MSGS_SENT, (uint32_t)packets_sent);
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_BYTES_SENT, (uint32_t)data_bytes_sent);
 	if (bytes_written)
 		*bytes_written = apdu_length;
 	return PGM_IO_STATUS_NORMAL;
@@ -1763,9 +1891,9 @@ retry_send:
 blocked:
 	if (bytes_sent) {
 		reset_heartbeat_spm (sock, STATE(skb)->tstamp);
-		pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)bytes_sent);
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  += packets_sent;
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += data_bytes_sent;
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_BYTES_SENT, (uint32_t)bytes_sent);
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_MSGS_SENT, (uint32_t)packets_sent);
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_BYTES_SENT, (uint32_t)data_bytes_sent);
 	}
 	if (PGM_SOCK_ENOBUFS == save_errno)
 		return PGM_IO_STATUS_RATE_LIMITED;
@@ -1797,7 +1925,7 @@ pgm_send (
 	if (PGM_LIKELY(apdu_length)) pgm_return_val_if_fail (NULL != apdu, PGM_IO_STATUS_ERROR);
 
 /* shutdown */
-	if (PGM_UNLIKELY(!pgm_rwlock_reader_trylock (&sock->lock)))
+	if (PGM_UNLIKELY(!pgm_sock_reader_trylock (sock, &sock->lock)))
 		pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
 
 /* state */
@@ -1805,26 +1933,30 @@ pgm_send (
 	    sock->is_destroyed ||
 	    apdu_length > sock->max_apdu))
 	{
-		pgm_rwlock_reader_unlock (&sock->lock);
+		pgm_sock_reader_unlock (sock, &sock->lock);
 		pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
 	}
 
 /* source */
-	pgm_mutex_lock (&sock->source_mutex);
+	const int lock_status = lock_direct_send (sock);
+	if (PGM_UNLIKELY(PGM_IO_STATUS_NORMAL != lock_status)) {
+		pgm_sock_reader_unlock (sock, &sock->lock);
+		return lock_status;
+	}
 
 /* pass on non-fragment calls */
 	if (apdu_length <= sock->max_tsdu)
 	{
 		const int status = send_odata_copy (sock, apdu, (uint16_t)apdu_length, bytes_written);
-		pgm_mutex_unlock (&sock->source_mutex);
-		pgm_rwlock_reader_unlock (&sock->lock);
+		pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+		pgm_sock_reader_unlock (sock, &sock->lock);
 		return status;
 	}
 	else
 	{
 		const int status = send_apdu (sock, apdu, (uint16_t)apdu_length, bytes_written);
-		pgm_mutex_unlock (&sock->source_mutex);
-		pgm_rwlock_reader_unlock (&sock->lock);
+		pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+		pgm_sock_reader_unlock (sock, &sock->lock);
 		return status;
 	}
 }
@@ -1873,27 +2005,33 @@ pgm_sendv (
 	pgm_return_val_if_fail (NULL != sock, PGM_IO_STATUS_ERROR);
 	pgm_return_val_if_fail (count <= PGM_MAX_FRAGMENTS, PGM_IO_STATUS_ERROR);
 	if (PGM_LIKELY(count)) pgm_return_val_if_fail (NULL != vector, PGM_IO_STATUS_ERROR);
-	if (PGM_UNLIKELY(!pgm_rwlock_reader_trylock (&sock->lock)))
+	if (PGM_UNLIKELY(!pgm_sock_reader_trylock (sock, &sock->lock)))
 		pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
 	if (PGM_UNLIKELY(!sock->is_bound ||
 	    sock->is_destroyed))
 	{
-		pgm_rwlock_reader_unlock (&sock->lock);
+		pgm_sock_reader_unlock (sock, &sock->lock);
 		pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
 	}
 
-	pgm_mutex_lock (&sock->source_mutex);
+	const int lock_status = lock_direct_send (sock);
+	if (PGM_UNLIKELY(PGM_IO_STATUS_NORMAL != lock_status)) {
+		pgm_sock_reader_unlock (sock, &sock->lock);
+		return lock_status;
+	}
 
 /* pass on zero length as cannot count vector lengths */
 	if (PGM_UNLIKELY(0 == count))
 	{
 		const int status = send_odata_copy (sock, NULL, 0, bytes_written);
-		pgm_mutex_unlock (&sock->source_mutex);
-		pgm_rwlock_reader_unlock (&sock->lock);
+		pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+		pgm_sock_reader_unlock (sock, &sock->lock);
 		return status;
 	}
 
 	const sa_family_t pgmcc_family = sock->use_pgmcc ? sock->family : 0;
+/* one clock read for all packets of this call */
+	const pgm_time_t now = pgm_time_update_now();
 
 /* continue if blocked mid-apdu */
 	if (sock->is_apdu_eagain) {
@@ -1901,8 +2039,8 @@ pgm_sendv (
 			if (STATE(apdu_length) <= sock->max_tsdu)
 			{
 				const int status = send_odatav (sock, vector, count, bytes_written);
-				pgm_mutex_unlock (&sock->source_mutex);
-				pgm_rwlock_reader_unlock (&sock->lock);
+				pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+				pgm_sock_reader_unlock (sock, &sock->lock);
 				return status;
 			}
 			else
@@ -1924,8 +2062,8 @@ pgm_sendv (
 		if (!is_one_apdu &&
 		    vector[i].iov_len > sock->max_apdu)
 		{
-			pgm_mutex_unlock (&sock->source_mutex);
-			pgm_rwlock_reader_unlock (&sock->lock);
+			pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+			pgm_sock_reader_unlock (sock, &sock->lock);
 			pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
 		}
 		STATE(apdu_length) += vector[i].iov_len;
@@ -1935,12 +2073,12 @@ pgm_sendv (
 	if (is_one_apdu) {
 		if (STATE(apdu_length) <= sock->max_tsdu) {
 			const int status = send_odatav (sock, vector, count, bytes_written);
-			pgm_mutex_unlock (&sock->source_mutex);
-			pgm_rwlock_reader_unlock (&sock->lock);
+			pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+			pgm_sock_reader_unlock (sock, &sock->lock);
 			return status;
 		} else if (STATE(apdu_length) > sock->max_apdu) {
-			pgm_mutex_unlock (&sock->source_mutex);
-			pgm_rwlock_reader_unlock (&sock->lock);
+			pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+			pgm_sock_reader_unlock (sock, &sock->lock);
 			pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
 		}
 	}
@@ -1963,12 +2101,12 @@ retry_send:
 			case PGM_IO_STATUS_WOULD_BLOCK:
 			case PGM_IO_STATUS_RATE_LIMITED:
 				sock->is_apdu_eagain = TRUE;
-				pgm_mutex_unlock (&sock->source_mutex);
-				pgm_rwlock_reader_unlock (&sock->lock);
+				pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+				pgm_sock_reader_unlock (sock, &sock->lock);
 				return status;
 			case PGM_IO_STATUS_ERROR:
-				pgm_mutex_unlock (&sock->source_mutex);
-				pgm_rwlock_reader_unlock (&sock->lock);
+				pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+				pgm_sock_reader_unlock (sock, &sock->lock);
 				return status;
 			default:
 				pgm_assert_not_reached();
@@ -1979,8 +2117,8 @@ retry_send:
 		sock->is_apdu_eagain = FALSE;
 		if (bytes_written)
 			*bytes_written = data_bytes_sent;
-		pgm_mutex_unlock (&sock->source_mutex);
-		pgm_rwlock_reader_unlock (&sock->lock);
+		pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+		pgm_sock_reader_unlock (sock, &sock->lock);
 		return PGM_IO_STATUS_NORMAL;
 	}
 
@@ -2001,11 +2139,12 @@ retry_send:
                 if (!pgm_rate_check2 (&sock->rate_control,
 				      &sock->odata_rate_control,
 				      tpdu_length - sock->iphdr_len,	/* includes 1 × IP header len */
-				      sock->is_nonblocking))
+				      sock->is_nonblocking,
+				      now))
 		{
 			sock->blocklen = tpdu_length;
-			pgm_mutex_unlock (&sock->source_mutex);
-			pgm_rwlock_reader_unlock (&sock->lock);
+			pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+			pgm_sock_reader_unlock (sock, &sock->lock);
 			return PGM_IO_STATUS_RATE_LIMITED;
 		}
 		STATE(is_rate_limited) = TRUE;
@@ -2029,9 +2168,10 @@ retry_send:
 /* retrieve packet storage from transmit window */
 		header_length = pgm_pkt_offset (TRUE, pgmcc_family);
 		STATE(tsdu_length) = MIN( source_max_tsdu (sock, TRUE), STATE(apdu_length) - STATE(data_bytes_offset) );
-		STATE(skb) = pgm_alloc_skb (sock->max_tpdu);
+		STATE(skb) = pgm_arena_alloc_skb (sock->tx_arena, sock->max_tpdu);
 		STATE(skb)->sock = sock;
-		STATE(skb)->tstamp = pgm_time_update_now();
+		STATE(skb)->single_threaded = sock->is_single_threaded;
+		STATE(skb)->tstamp = now;
 		pgm_skb_reserve (STATE(skb), (uint16_t)header_length);
 		pgm_skb_put (STATE(skb), (uint16_t)STATE(tsdu_length));
 
@@ -2112,20 +2252,19 @@ retry_send:
 		STATE(skb)->pgm_header->pgm_checksum = pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)pgm_header_len));
 
 /* add to transmit window, skb::data set to payload */
-		pgm_spinlock_lock (&sock->txw_spinlock);
 		pgm_txw_add (sock->window, STATE(skb));
-		pgm_spinlock_unlock (&sock->txw_spinlock);
 
 retry_one_apdu_send:
 		tpdu_length = (char*)STATE(skb)->tail - (char*)STATE(skb)->head;
-		sent = pgm_sendto (sock,
+		sent = pgm_sendto_now (sock,
 				   !STATE(is_rate_limited),	/* rate limited on blocking */
 			   	   &sock->odata_rate_control,
 				   FALSE,			/* regular socket */
 				   STATE(skb)->head,
 				   tpdu_length,
 				   (struct sockaddr*)&sock->send_gsr.gsr_group,
-				   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+				   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group),
+				   now);
 		if (sent < 0) {
 			save_errno = pgm_get_last_sock_error();
 			if (PGM_LIKELY(PGM_SOCK_EAGAIN == save_errno || PGM_SOCK_ENOBUFS == save_errno))
@@ -2151,9 +2290,9 @@ retry_one_apdu_send:
 /* check for end of transmission group */
 		if (sock->use_proactive_parity) {
 			const uint32_t odata_sqn = pgm_ntohl (STATE(skb)->pgm_data->data_sqn);
-			const uint32_t tg_sqn_mask = 0xffffffff << sock->tg_sqn_shift;
+			const uint32_t tg_sqn_mask = 0xffffffff << (sock->tg_sqn_shift + sock->tg_depth_shift);
 			if (!((odata_sqn + 1) & ~tg_sqn_mask))
-				pgm_schedule_proactive_nak (sock, odata_sqn & tg_sqn_mask);
+				queue_proactive_nak (sock, odata_sqn + 1);
 		}
 
 	} while ( STATE(data_bytes_offset)  < STATE(apdu_length) );
@@ -2164,24 +2303,24 @@ retry_one_apdu_send:
 /* SPM heartbeats decay from last sent data packet */
 	reset_heartbeat_spm (sock, STATE(skb)->tstamp);
 /* increment socket statistics */
-	pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)bytes_sent);
-	sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  += packets_sent;
-	sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += data_bytes_sent;
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_BYTES_SENT, (uint32_t)bytes_sent);
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_MSGS_SENT, (uint32_t)packets_sent);
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_BYTES_SENT, (uint32_t)data_bytes_sent);
 	if (bytes_written)
 		*bytes_written = STATE(apdu_length);
-	pgm_mutex_unlock (&sock->source_mutex);
-	pgm_rwlock_reader_unlock (&sock->lock);
+	pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+	pgm_sock_reader_unlock (sock, &sock->lock);
 	return PGM_IO_STATUS_NORMAL;
 
 blocked:
 	if (bytes_sent) {
 		reset_heartbeat_spm (sock, STATE(skb)->tstamp);
-		pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)bytes_sent);
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  += packets_sent;
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += data_bytes_sent;
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_BYTES_SENT, (uint32_t)bytes_sent);
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_MSGS_SENT, (uint32_t)packets_sent);
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_BYTES_SENT, (uint32_t)data_bytes_sent);
 	}
-	pgm_mutex_unlock (&sock->source_mutex);
-	pgm_rwlock_reader_unlock (&sock->lock);
+	pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+	pgm_sock_reader_unlock (sock, &sock->lock);
 	if (PGM_SOCK_ENOBUFS == save_errno)
 		return PGM_IO_STATUS_RATE_LIMITED;
 	if (sock->use_pgmcc)
@@ -2224,34 +2363,40 @@ pgm_send_skbv (
 	pgm_return_val_if_fail (NULL != sock, PGM_IO_STATUS_ERROR);
 	pgm_return_val_if_fail (count <= PGM_MAX_FRAGMENTS, PGM_IO_STATUS_ERROR);
 	if (PGM_LIKELY(count)) pgm_return_val_if_fail (NULL != vector, PGM_IO_STATUS_ERROR);
-	if (PGM_UNLIKELY(!pgm_rwlock_reader_trylock (&sock->lock)))
+	if (PGM_UNLIKELY(!pgm_sock_reader_trylock (sock, &sock->lock)))
 		pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
 	if (PGM_UNLIKELY(!sock->is_bound ||
 	    sock->is_destroyed))
 	{
-		pgm_rwlock_reader_unlock (&sock->lock);
+		pgm_sock_reader_unlock (sock, &sock->lock);
 		pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
 	}
 
-	pgm_mutex_lock (&sock->source_mutex);
+	const int lock_status = lock_direct_send (sock);
+	if (PGM_UNLIKELY(PGM_IO_STATUS_NORMAL != lock_status)) {
+		pgm_sock_reader_unlock (sock, &sock->lock);
+		return lock_status;
+	}
 
 /* pass on zero length as cannot count vector lengths */
 	if (PGM_UNLIKELY(0 == count))
 	{
 		const int status = send_odata_copy (sock, NULL, 0, bytes_written);
-		pgm_mutex_unlock (&sock->source_mutex);
-		pgm_rwlock_reader_unlock (&sock->lock);
+		pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+		pgm_sock_reader_unlock (sock, &sock->lock);
 		return status;
 	}
 	else if (1 == count)
 	{
 		const int status = send_odata (sock, vector[0], bytes_written);
-		pgm_mutex_unlock (&sock->source_mutex);
-		pgm_rwlock_reader_unlock (&sock->lock);
+		pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+		pgm_sock_reader_unlock (sock, &sock->lock);
 		return status;
 	}
 
 	const sa_family_t pgmcc_family = sock->use_pgmcc ? sock->family : 0;
+/* one clock read for all packets of this call */
+	const pgm_time_t now = pgm_time_update_now();
 
 /* continue if blocked mid-apdu */
 	if (sock->is_apdu_eagain)
@@ -2268,11 +2413,12 @@ pgm_send_skbv (
 		if (!pgm_rate_check2 (&sock->rate_control,
 				      &sock->odata_rate_control,
 				      total_tpdu_length - sock->iphdr_len,	/* includes 1 × IP header len */
-				      sock->is_nonblocking))
+				      sock->is_nonblocking,
+				      now))
 		{
 			sock->blocklen = total_tpdu_length;
-			pgm_mutex_unlock (&sock->source_mutex);
-			pgm_rwlock_reader_unlock (&sock->lock);
+			pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+			pgm_sock_reader_unlock (sock, &sock->lock);
 			return PGM_IO_STATUS_RATE_LIMITED;
 		}
 		STATE(is_rate_limited) = TRUE;
@@ -2285,15 +2431,15 @@ pgm_send_skbv (
 		for (unsigned i = 0; i < count; i++)
 		{
 			if (PGM_UNLIKELY(vector[i]->len > sock->max_tsdu_fragment)) {
-				pgm_mutex_unlock (&sock->source_mutex);
-				pgm_rwlock_reader_unlock (&sock->lock);
+				pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+				pgm_sock_reader_unlock (sock, &sock->lock);
 				return PGM_IO_STATUS_ERROR;
 			}
 			STATE(apdu_length) += vector[i]->len;
 		}
 		if (PGM_UNLIKELY(STATE(apdu_length) > sock->max_apdu)) {
-			pgm_mutex_unlock (&sock->source_mutex);
-			pgm_rwlock_reader_unlock (&sock->lock);
+			pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+			pgm_sock_reader_unlock (sock, &sock->lock);
 			return PGM_IO_STATUS_ERROR;
 		}
 	}
@@ -2307,7 +2453,7 @@ pgm_send_skbv (
 		
 		STATE(skb) = pgm_skb_get(vector[STATE(vector_index)]);
 		STATE(skb)->sock = sock;
-		STATE(skb)->tstamp = pgm_time_update_now();
+		STATE(skb)->tstamp = now;
 
 		STATE(skb)->pgm_header = (struct pgm_header*)STATE(skb)->head;
 		STATE(skb)->pgm_data   = (struct pgm_data*)(STATE(skb)->pgm_header + 1);
@@ -2361,20 +2507,19 @@ pgm_send_skbv (
 		STATE(skb)->pgm_header->pgm_checksum	= pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)header_length));
 
 /* add to transmit window, skb::data set to payload */
-		pgm_spinlock_lock (&sock->txw_spinlock);
 		pgm_txw_add (sock->window, STATE(skb));
-		pgm_spinlock_unlock (&sock->txw_spinlock);
 retry_send:
 		pgm_assert ((char*)STATE(skb)->tail > (char*)STATE(skb)->head);
 		tpdu_length = (char*)STATE(skb)->tail - (char*)STATE(skb)->head;
-		sent = pgm_sendto (sock,
+		sent = pgm_sendto_now (sock,
 				   !STATE(is_rate_limited),	/* rate limited on blocking */
 			   	   &sock->odata_rate_control,
 				   FALSE,			/* regular socket */
 				   STATE(skb)->head,
 				   tpdu_length,
 				   (struct sockaddr*)&sock->send_gsr.gsr_group,
-				   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+				   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group),
+				   now);
 		if (sent < 0) {
 			save_errno = pgm_get_last_sock_error();
 			if (PGM_LIKELY(PGM_SOCK_EAGAIN == save_errno || PGM_SOCK_ENOBUFS == save_errno))
@@ -2401,9 +2546,9 @@ retry_send:
 /* check for end of transmission group */
 		if (sock->use_proactive_parity) {
 			const uint32_t odata_sqn   = pgm_ntohl (STATE(skb)->pgm_data->data_sqn);
-			const uint32_t tg_sqn_mask = 0xffffffff << sock->tg_sqn_shift;
+			const uint32_t tg_sqn_mask = 0xffffffff << (sock->tg_sqn_shift + sock->tg_depth_shift);
 			if (!((odata_sqn + 1) & ~tg_sqn_mask))
-				pgm_schedule_proactive_nak (sock, odata_sqn & tg_sqn_mask);
+				queue_proactive_nak (sock, odata_sqn + 1);
 		}
 
 	}
@@ -2419,24 +2564,24 @@ retry_send:
 /* SPM heartbeats decay from last sent data packet */
 	reset_heartbeat_spm (sock, STATE(skb)->tstamp);
 /* increment socket statistics */
-	pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)bytes_sent);
-	sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  += packets_sent;
-	sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += data_bytes_sent;
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_BYTES_SENT, (uint32_t)bytes_sent);
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_MSGS_SENT, (uint32_t)packets_sent);
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_BYTES_SENT, (uint32_t)data_bytes_sent);
 	if (bytes_written)
 		*bytes_written = data_bytes_sent;
-	pgm_mutex_unlock (&sock->source_mutex);
-	pgm_rwlock_reader_unlock (&sock->lock);
+	pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+	pgm_sock_reader_unlock (sock, &sock->lock);
 	return PGM_IO_STATUS_NORMAL;
 
 blocked:
 	if (bytes_sent) {
 		reset_heartbeat_spm (sock, STATE(skb)->tstamp);
-		pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)bytes_sent);
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  += packets_sent;
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += data_bytes_sent;
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_BYTES_SENT, (uint32_t)bytes_sent);
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_MSGS_SENT, (uint32_t)packets_sent);
+		pgm_stats_add (&sock->stats, PGM_STATS_ROLE_SOURCE, PGM_PC_SOURCE_DATA_BYTES_SENT, (uint32_t)data_bytes_sent);
 	}
-	pgm_mutex_unlock (&sock->source_mutex);
-	pgm_rwlock_reader_unlock (&sock->lock);
+	pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+	pgm_sock_reader_unlock (sock, &sock->lock);
 	if (PGM_SOCK_ENOBUFS == save_errno)
 		return PGM_IO_STATUS_RATE_LIMITED;
 	if (sock->use_pgmcc)
@@ -2444,6 +2589,261 @@ blocked:
 	return PGM_IO_STATUS_WOULD_BLOCK;
 }
 
+/* drain the submission queue as the elected consumer, transmit window sequence
+ * numbers are assigned in dequeue order.  one acquisition of the source mutex
+ * covers each batch.  a packet that would block is parked in the resume state
+ * and sent first by the next drain.
+ *
+ * on success, returns PGM_IO_STATUS_NORMAL, if another thread is draining also
+ * returns PGM_IO_STATUS_NORMAL.  on block for non-blocking sockets returns
+ * PGM_IO_STATUS_WOULD_BLOCK, PGM_IO_STATUS_RATE_LIMITED, or
+ * PGM_IO_STATUS_CONGESTION with data remaining queued.
+ */
+
+static
+int
+drain_send_queue (
+	pgm_sock_t* const restrict sock,
+	size_t*		  restrict bytes_written
+	)
+{
+	size_t	data_bytes_sent = 0;
+	int	status = PGM_IO_STATUS_NORMAL;
+
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (NULL != sock->sendq);
+
+	while (pgm_sendq_try_acquire (sock->sendq))
+	{
+		pgm_sock_mutex_lock (sock, &sock->source_mutex);
+/* an APDU of pgm_send() blocked mid-flight owns the resume state */
+		if (PGM_UNLIKELY(sock->is_apdu_eagain && !sock->is_sendq_eagain)) {
+			status = PGM_IO_STATUS_WOULD_BLOCK;
+		} else {
+			size_t bytes;
+			if (sock->is_sendq_eagain) {
+				status = send_odata (sock, STATE(skb), &bytes);
+				if (PGM_IO_STATUS_NORMAL == status) {
+					sock->is_sendq_eagain = FALSE;
+					data_bytes_sent += bytes;
+				}
+			}
+			while (!sock->is_sendq_eagain) {
+				struct pgm_sk_buff_t* skb = pgm_sendq_pop (sock->sendq);
+				if (NULL == skb)
+					break;
+/* reference passes to the transmit window */
+				status = send_odata (sock, skb, &bytes);
+				if (PGM_UNLIKELY(PGM_IO_STATUS_NORMAL != status)) {
+					sock->is_sendq_eagain = TRUE;
+					break;
+				}
+				data_bytes_sent += bytes;
+			}
+		}
+		pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+/* re-elect if a producer published whilst draining and lost the election */
+		if (!pgm_sendq_release (sock->sendq) ||
+		    PGM_IO_STATUS_NORMAL != status)
+			break;
+	}
+	if (bytes_written)
+		*bytes_written = data_bytes_sent;
+	return status;
+}
+
+/* push skb onto the submission queue and drain if elected.  blocking sockets
+ * wait on a full queue for the consumer to progress.
+ *
+ * returns PGM_IO_STATUS_NORMAL if queued, returns PGM_IO_STATUS_WOULD_BLOCK on
+ * a full queue for non-blocking sockets.
+ */
+
+static
+int
+push_send_queue (
+	pgm_sock_t*	      const restrict sock,
+	struct pgm_sk_buff_t* const restrict skb
+	)
+{
+	while (!pgm_sendq_push (sock->sendq, skb))
+	{
+		if (sock->is_nonblocking)
+			return PGM_IO_STATUS_WOULD_BLOCK;
+/* drain if elected, otherwise let the consumer progress */
+		(void)drain_send_queue (sock, NULL);
+		pgm_thread_yield ();
+	}
+	(void)drain_send_queue (sock, NULL);
+	return PGM_IO_STATUS_NORMAL;
+}
+
+/* take the source mutex for pgm_send(), pgm_sendv(), or pgm_send_skbv().  a
+ * drain of the submission queue blocked mid-packet owns the resume state, so
+ * the queue is drained first to keep its data ahead of the direct send.
+ *
+ * returns PGM_IO_STATUS_NORMAL with the source mutex held, otherwise returns
+ * the blocked drain status, or PGM_IO_STATUS_WOULD_BLOCK whilst another thread
+ * drains, with the mutex released.
+ */
+
+static
+int
+lock_direct_send (
+	pgm_sock_t* const sock
+	)
+{
+	pgm_sock_mutex_lock (sock, &sock->source_mutex);
+	if (PGM_LIKELY(!sock->is_sendq_eagain))
+		return PGM_IO_STATUS_NORMAL;
+	pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+
+	const int status = drain_send_queue (sock, NULL);
+	if (PGM_IO_STATUS_NORMAL != status)
+		return status;
+
+	pgm_sock_mutex_lock (sock, &sock->source_mutex);
+	if (PGM_LIKELY(!sock->is_sendq_eagain))
+		return PGM_IO_STATUS_NORMAL;
+	pgm_sock_mutex_unlock (sock, &sock->source_mutex);
+	return PGM_IO_STATUS_WOULD_BLOCK;
+}
+
+/* submit one PGM data packet to the lock-free submission queue, safe from any
+ * number of threads.  the APDU is copied into a transmit window skbuff outside
+ * of any lock, and then the caller drains the queue if no other thread is.
+ * APDUs must not exceed one TSDU, the queue is enabled by PGM_SEND_QUEUE.
+ *
+ * on success, returns PGM_IO_STATUS_NORMAL and apdu_length is saved into
+ * bytes_written.  on a full queue for non-blocking sockets returns
+ * PGM_IO_STATUS_WOULD_BLOCK and the APDU is not queued.  queued data blocked
+ * by rate or congestion control is sent by pgm_send_flush() or a later
+ * submission.
+ */
+
+int
+pgm_send_enqueue (
+	pgm_sock_t* 	 const restrict sock,
+	const void*	       restrict	apdu,
+	const size_t			apdu_length,
+	size_t*	       	       restrict	bytes_written
+	)
+{
+	struct pgm_sk_buff_t* skb;
+
+	pgm_debug ("pgm_send_enqueue (sock:%p apdu:%p apdu-length:%" PRIzu " bytes-written:%p)",
+		(void*)sock, apdu, apdu_length, (void*)bytes_written);
+
+/* parameters */
+	pgm_return_val_if_fail (NULL != sock, PGM_IO_STATUS_ERROR);
+	if (PGM_LIKELY(apdu_length)) pgm_return_val_if_fail (NULL != apdu, PGM_IO_STATUS_ERROR);
+
+/* shutdown */
+	if (PGM_UNLIKELY(!pgm_sock_reader_trylock (sock, &sock->lock)))
+		pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
+
+/* state */
+	if (PGM_UNLIKELY(!sock->is_bound ||
+	    sock->is_destroyed ||
+	    NULL == sock->sendq ||
+	    apdu_length > sock->max_tsdu))
+	{
+		pgm_sock_reader_unlock (sock, &sock->lock);
+		pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
+	}
+
+	const sa_family_t pgmcc_family = sock->use_pgmcc ? sock->family : 0;
+	skb = pgm_arena_alloc_skb (sock->tx_arena, sock->max_tpdu);
+	skb->sock = sock;
+	skb->single_threaded = sock->is_single_threaded;
+	pgm_skb_reserve (skb, (uint16_t)pgm_pkt_offset (FALSE, pgmcc_family));
+	pgm_skb_put (skb, (uint16_t)apdu_length);
+	if (PGM_LIKELY(apdu_length))
+		memcpy (skb->data, apdu, apdu_length);
+
+	const int status = push_send_queue (sock, skb);
+	if (PGM_UNLIKELY(PGM_IO_STATUS_NORMAL != status))
+		pgm_free_skb (skb);
+	else if (bytes_written)
+		*bytes_written = apdu_length;
+	pgm_sock_reader_unlock (sock, &sock->lock);
+	return status;
+}
+
+/* submit one PGM data packet to the lock-free submission queue, transmit window
+ * owned memory, safe from any number of threads.  the skbuff is prepared as per
+ * pgm_send_skbv() and the queue takes ownership of the callers reference, on
+ * PGM_IO_STATUS_WOULD_BLOCK ownership remains with the caller.
+ *
+ * returns as per pgm_send_enqueue().
+ */
+
+int
+pgm_send_skb_enqueue (
+	pgm_sock_t*	      const restrict sock,
+	struct pgm_sk_buff_t* const restrict skb,
+	size_t*			    restrict bytes_written
+	)
+{
+	pgm_debug ("pgm_send_skb_enqueue (sock:%p skb:%p bytes-written:%p)",
+		(const void*)sock, (const void*)skb, (const void*)bytes_written);
+
+	pgm_return_val_if_fail (NULL != sock, PGM_IO_STATUS_ERROR);
+	pgm_return_val_if_fail (NULL != skb, PGM_IO_STATUS_ERROR);
+	if (PGM_UNLIKELY(!pgm_sock_reader_trylock (sock, &sock->lock)))
+		pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
+	if (PGM_UNLIKELY(!sock->is_bound ||
+	    sock->is_destroyed ||
+	    NULL == sock->sendq ||
+	    skb->len > sock->max_tsdu))
+	{
+		pgm_sock_reader_unlock (sock, &sock->lock);
+		pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
+	}
+
+	const size_t tsdu_length = skb->len;
+	const int status = push_send_queue (sock, skb);
+	if (PGM_LIKELY(PGM_IO_STATUS_NORMAL == status) && bytes_written)
+		*bytes_written = tsdu_length;
+	pgm_sock_reader_unlock (sock, &sock->lock);
+	return status;
+}
+
+/* drain the submission queue from the calling thread, e.g. after a non-blocking
+ * submission was blocked by rate or congestion control.
+ *
+ * on success, returns PGM_IO_STATUS_NORMAL and the data bytes sent by this call
+ * are saved into bytes_written.  on block for non-blocking sockets returns
+ * PGM_IO_STATUS_WOULD_BLOCK, returns PGM_IO_STATUS_RATE_LIMITED if the
+ * packet size exceeds the current rate limit, or PGM_IO_STATUS_CONGESTION.
+ */
+
+int
+pgm_send_flush (
+	pgm_sock_t* const restrict sock,
+	size_t*		  restrict bytes_written
+	)
+{
+	pgm_debug ("pgm_send_flush (sock:%p bytes-written:%p)",
+		(const void*)sock, (const void*)bytes_written);
+
+	pgm_return_val_if_fail (NULL != sock, PGM_IO_STATUS_ERROR);
+	if (PGM_UNLIKELY(!pgm_sock_reader_trylock (sock, &sock->lock)))
+		pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
+	if (PGM_UNLIKELY(!sock->is_bound ||
+	    sock->is_destroyed ||
+	    NULL == sock->sendq))
+	{
+		pgm_sock_reader_unlock (sock, &sock->lock);
+		pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
+	}
+
+	const int status = drain_send_queue (sock, bytes_written);
+	pgm_sock_reader_unlock (sock, &sock->lock);
+	return status;
+}
+
 /* cleanup resuming send state helper 
  */
 #undef STATE
@@ -2457,7 +2857,8 @@ static
 bool
 send_rdata (
 	pgm_sock_t*	      restrict sock,
-	struct pgm_sk_buff_t* restrict skb
+	struct pgm_sk_buff_t* restrict skb,
+	const pgm_time_t	       now
 	)
 {
 	size_t			 tpdu_length;
@@ -2477,7 +2878,8 @@ send_rdata (
 	    !pgm_rate_check2 (&sock->rate_control,		/* total rate limit */
 			      &sock->rdata_rate_control,	/* repair data limit */
 			      tpdu_length,			/* excludes IP header len */
-			      sock->is_nonblocking))
+			      sock->is_nonblocking,
+				      now))
 	{
 		sock->blocklen = tpdu_length + sock->iphdr_len;
 		return FALSE;
@@ -2523,24 +2925,21 @@ send_rdata (
 /* fall through silently on other errors */
 	}
 
-	const pgm_time_t now = pgm_time_update_now();
-
 	if (sock->use_pgmcc) {
 		sock->tokens -= pgm_fp8 (1);
 		sock->ack_expiry = now + sock->ack_expiry_ivl;
 	}
 
 /* re-set spm timer: we are already in the timer thread, no need to prod timers
+ * and heartbeat state is private to the timer.
  */
-	pgm_mutex_lock (&sock->timer_mutex);
 	sock->spm_heartbeat_state = 1;
 	sock->next_heartbeat_spm = now + sock->spm_heartbeat_interval[sock->spm_heartbeat_state++];
-	pgm_mutex_unlock (&sock->timer_mutex);
 
 	pgm_txw_inc_retransmit_count (skb);
-	sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED] += pgm_ntohs(header->pgm_tsdu_length);
-	sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED]++;	/* impossible to determine APDU count */
-	pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)(tpdu_length + sock->iphdr_len));
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_REPAIR, PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED, pgm_ntohs(header->pgm_tsdu_length));
+	pgm_stats_inc (&sock->stats, PGM_STATS_ROLE_REPAIR, PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED);	/* impossible to determine APDU count */
+	pgm_stats_add (&sock->stats, PGM_STATS_ROLE_REPAIR, PGM_PC_SOURCE_BYTES_SENT, (uint32_t)(tpdu_length + sock->iphdr_len));
 	return TRUE;
 }
 
@@ -63,6 +63,9 @@ static gboolean mock_is_valid_spmr = TRUE;
 static gboolean mock_is_valid_ack = TRUE;
 static gboolean mock_is_valid_nak = TRUE;
 static gboolean mock_is_valid_nnak = TRUE;
+static guint mock_txw_add_count = 0;
+static guint mock_retransmit_push_count = 0;
+static uint32_t mock_retransmit_push_sqn = 0;
 
 
 #define pgm_txw_get_unfolded_checksum	mock_pgm_txw_get_unfolded_checksum
@@ -122,7 +125,6 @@ generate_sock (void)
 	sock->iphdr_len = sizeof(struct pgm_ip);
 	sock->spm_heartbeat_interval = g_malloc0 (sizeof(guint) * (2+2));
 	sock->spm_heartbeat_interval[0] = pgm_secs(1);
-	pgm_spinlock_init (&sock->txw_spinlock);
 	pgm_mutex_init (&sock->source_mutex);
 	pgm_mutex_init (&sock->timer_mutex);
 	pgm_rwlock_init (&sock->lock);
@@ -298,6 +300,7 @@ mock_pgm_txw_add (
 {
 	g_debug ("mock_pgm_txw_add (window:%p skb:%p)",
 		(gpointer)window, (gpointer)skb);
+	mock_txw_add_count++;
 }
 
 struct pgm_sk_buff_t*
@@ -324,6 +327,8 @@ mock_pgm_txw_retransmit_push (
 		sequence,
 		is_parity ? "YES" : "NO",
 		tg_sqn_shift);
+	mock_retransmit_push_count++;
+	mock_retransmit_push_sqn = sequence;
 	return TRUE;
 }
 
@@ -387,7 +392,8 @@ bool
 mock_pgm_rate_check (
 	pgm_rate_t*			bucket,
 	const size_t			data_size,
-	const bool			is_nonblocking
+	const bool			is_nonblocking,
+	pgm_time_t			now
 	)
 {
 	g_debug ("mock_pgm_rate_check (bucket:%p data-size:%u is-nonblocking:%s)",
@@ -477,7 +483,8 @@ mock_pgm_sendto_hops (
 	const void*			buf,
 	size_t				len,
 	const struct sockaddr*		to,
-	socklen_t			tolen
+	socklen_t			tolen,
+	pgm_time_t			now
 	)
 {
 	char saddr[INET6_ADDRSTRLEN];
@@ -583,6 +590,40 @@ START_TEST (test_send_pass_002)
 }
 END_TEST
 
+/* direct send after a blocked drain of the submission queue */
+START_TEST (test_send_pass_003)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->is_bound = TRUE;
+	sock->is_nonblocking = TRUE;
+	sock->sendq = pgm_sendq_create (4);
+	fail_if (NULL == sock->sendq, "sendq_create failed");
+/* empty congestion window blocks the queued packet */
+	sock->use_pgmcc = TRUE;
+	sock->tokens = 0;
+	mock_txw_add_count = 0;
+	struct pgm_sk_buff_t* skb = generate_skb ();
+	gsize bytes_written;
+	fail_unless (PGM_IO_STATUS_NORMAL == pgm_send_skb_enqueue (sock, skb, &bytes_written), "enqueue not normal");
+	fail_unless (sock->is_sendq_eagain, "drain not blocked");
+	fail_unless (1 == mock_txw_add_count, "txw_add count");
+	const gsize apdu_length = 100;
+	guint8 buffer[ apdu_length ];
+	fail_unless (PGM_IO_STATUS_CONGESTION == pgm_send (sock, buffer, apdu_length, &bytes_written), "send not congestion");
+	fail_unless (1 == mock_txw_add_count, "txw_add count");
+/* queued packet is sent once and ahead of the direct send */
+	sock->tokens = pgm_fp8 (8);
+	bytes_written = 0;
+	fail_unless (PGM_IO_STATUS_NORMAL == pgm_send (sock, buffer, apdu_length, &bytes_written), "send not normal");
+	fail_unless ((gssize)apdu_length == bytes_written, "send underrun");
+	fail_unless (!sock->is_sendq_eagain, "drain still blocked");
+	fail_unless (2 == mock_txw_add_count, "txw_add count");
+	fail_unless (PGM_IO_STATUS_NORMAL == pgm_send_flush (sock, NULL), "flush not normal");
+	fail_unless (2 == mock_txw_add_count, "txw_add count");
+}
+END_TEST
+
 START_TEST (test_send_fail_001)
 {
 	guint8 buffer[ TEST_TXW_SQNS * TEST_MAX_TPDU ];
@@ -778,7 +819,8 @@ END_TEST
 /* target:
  *	void
  *	pgm_on_deferred_nak (
- *		pgm_sock_t*	sock
+ *		pgm_sock_t*	sock,
+ *		pgm_time_t	now
  *		)
  */
 
@@ -786,16 +828,89 @@ START_TEST (test_on_deferred_nak_pass_001)
 {
 	pgm_sock_t* sock = generate_sock ();
 	fail_if (NULL == sock, "generate_sock failed");
-	pgm_on_deferred_nak (sock);
+	pgm_on_deferred_nak (sock, pgm_time_update_now());
 }
 END_TEST
 	
 START_TEST (test_on_deferred_nak_fail_001)
 {
-	pgm_on_deferred_nak (NULL);
+	pgm_on_deferred_nak (NULL, pgm_time_update_now());
 	fail ("reached");
 }
 END_TEST
+
+/* target:
+ *	void
+ *	pgm_on_proactive_nak (
+ *		pgm_sock_t*		sock
+ *		)
+ */
+
+/* parity of a block completed by the send path is only queued by the repair side */
+START_TEST (test_on_proactive_nak_pass_001)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->is_bound = TRUE;
+	sock->use_proactive_parity = TRUE;
+	sock->rs_k = 4;
+	sock->rs_proactive_h = 1;
+	sock->tg_sqn_shift = 2;
+	fail_unless (0 == pgm_notify_init (&sock->rdata_notify), "notify_init failed");
+/* next sequence #3 completes the first transmission group */
+	sock->window->lead = 2;
+	mock_retransmit_push_count = 0;
+	const gsize apdu_length = 100;
+	guint8 buffer[ apdu_length ];
+	gsize bytes_written;
+	fail_unless (PGM_IO_STATUS_NORMAL == pgm_send (sock, buffer, apdu_length, &bytes_written), "send not normal");
+	fail_unless (0 == mock_retransmit_push_count, "retransmit queue changed by send");
+	fail_unless (4 == pgm_atomic_read32 (&sock->proactive_lead), "proactive_lead failed");
+	pgm_on_proactive_nak (sock);
+	fail_unless (1 == mock_retransmit_push_count, "retransmit_push count");
+	fail_unless (0 == mock_retransmit_push_sqn, "retransmit_push sequence");
+	fail_unless (4 == sock->proactive_trail, "proactive_trail failed");
+/* nothing further completed */
+	pgm_on_proactive_nak (sock);
+	fail_unless (1 == mock_retransmit_push_count, "retransmit_push count");
+	pgm_notify_destroy (&sock->rdata_notify);
+}
+END_TEST
+
+/* adaptive parity re-calculated on the receive path */
+START_TEST (test_on_proactive_nak_pass_002)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->is_bound = TRUE;
+	sock->use_proactive_parity = TRUE;
+	sock->use_adaptive_parity = TRUE;
+	sock->rs_k = 4;
+	sock->rs_proactive_h = 1;
+	sock->rs_proactive_h_min = 1;
+	sock->rs_proactive_h_max = 4;
+	sock->tg_sqn_shift = 2;
+	fail_unless (0 == pgm_notify_init (&sock->rdata_notify), "notify_init failed");
+/* entire block lost */
+	sock->parity_loss_count = 4;
+	sock->parity_loss_rate = 65536;
+	sock->window->lead = 2;
+	mock_retransmit_push_count = 0;
+	const gsize apdu_length = 100;
+	guint8 buffer[ apdu_length ];
+	gsize bytes_written;
+	fail_unless (PGM_IO_STATUS_NORMAL == pgm_send (sock, buffer, apdu_length, &bytes_written), "send not normal");
+	fail_unless (1 == sock->rs_proactive_h, "adapted on send");
+	pgm_on_proactive_nak (sock);
+	fail_unless (4 == sock->rs_proactive_h, "rs_proactive_h failed");
+	fail_unless (1 == mock_retransmit_push_count, "retransmit_push count");
+	fail_unless (3 == mock_retransmit_push_sqn, "retransmit_push sequence");
+	fail_unless (4 == sock->stats.block[PGM_STATS_ROLE_RECEIVER].counters[PGM_PC_SOURCE_PROACTIVE_PARITY_PACKETS], "parity packets counter");
+	fail_unless (1 == sock->stats.block[PGM_STATS_ROLE_RECEIVER].counters[PGM_PC_SOURCE_PROACTIVE_PARITY_CHANGES], "parity changes counter");
+	fail_unless (0 == sock->stats.block[PGM_STATS_ROLE_SOURCE].counters[PGM_PC_SOURCE_PROACTIVE_PARITY_CHANGES], "source role written");
+	pgm_notify_destroy (&sock->rdata_notify);
+}
+END_TEST
 	
 /* target:
  *	gboolean
@@ -1158,6 +1273,7 @@ make_test_suite (void)
 	tcase_add_checked_fixture (tc_send, mock_setup, NULL);
 	tcase_add_test (tc_send, test_send_pass_001);
 	tcase_add_test (tc_send, test_send_pass_002);
+	tcase_add_test (tc_send, test_send_pass_003);
 	tcase_add_test (tc_send, test_send_fail_001);
 
 	TCase* tc_sendv = tcase_create ("sendv");
@@ -1192,6 +1308,12 @@ make_test_suite (void)
 	tcase_add_test_raise_signal (tc_on_deferred_nak, test_on_deferred_nak_fail_001, SIGABRT);
 #endif
 
+	TCase* tc_on_proactive_nak = tcase_create ("on-proactive-nak");
+	suite_add_tcase (s, tc_on_proactive_nak);
+	tcase_add_checked_fixture (tc_on_proactive_nak, mock_setup, NULL);
+	tcase_add_test (tc_on_proactive_nak, test_on_proactive_nak_pass_001);
+	tcase_add_test (tc_on_proactive_nak, test_on_proactive_nak_pass_002);
+
 	TCase* tc_on_spmr = tcase_create ("on-spmr");
 	suite_add_tcase (s, tc_on_spmr);
 	tcase_add_checked_fixture (tc_on_spmr, mock_setup, NULL);
@@ -0,0 +1,107 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * Performance counters sharded by writer role.
+ *
+ * Each role owns a cache line padded block of counters that only its own
+ * thread of control updates, so the hot path is a plain increment with no
+ * bus locking and no false sharing.  Readers merge the blocks on demand.
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#include <impl/framework.h>
+
+
+//#define STATS_DEBUG
+
+#ifndef STATS_DEBUG
+#	define PGM_DISABLE_ASSERT
+#endif
+
+
+/* set a gauge, such as the current proactive parity count.  a gauge must
+ * only ever be written by one role so the merged value is the gauge itself.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_stats_set (
+	pgm_stats_t*const	stats,
+	const unsigned		role,
+	const unsigned		counter,
+	const uint32_t		value
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != stats);
+	pgm_assert_cmpuint (role, <, PGM_STATS_ROLE_MAX);
+	pgm_assert_cmpuint (counter, <, PGM_STATS_MAX_COUNTERS);
+
+	stats->block[role].counters[counter] = value;
+}
+
+/* merge one counter across all roles, safe from any thread.  the result may
+ * lag concurrent writers but each block value is read whole.
+ *
+ * returns sum of counter.
+ */
+
+PGM_GNUC_INTERNAL
+uint32_t
+pgm_stats_read (
+	const pgm_stats_t*const	stats,
+	const unsigned		counter
+	)
+{
+	uint32_t sum = 0;
+
+/* pre-conditions */
+	pgm_assert (NULL != stats);
+	pgm_assert_cmpuint (counter, <, PGM_STATS_MAX_COUNTERS);
+
+	for (unsigned i = 0; i < PGM_STATS_ROLE_MAX; i++)
+		sum += pgm_atomic_read32 (&stats->block[i].counters[counter]);
+	return sum;
+}
+
+/* merge the first count counters across all roles into counters.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_stats_snapshot (
+	const pgm_stats_t* const restrict stats,
+	uint32_t*	   restrict	  counters,
+	const unsigned			  count
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != stats);
+	pgm_assert (NULL != counters);
+	pgm_assert_cmpuint (count, <=, PGM_STATS_MAX_COUNTERS);
+
+	for (unsigned j = 0; j < count; j++)
+		counters[j] = 0;
+	for (unsigned i = 0; i < PGM_STATS_ROLE_MAX; i++)
+		for (unsigned j = 0; j < count; j++)
+			counters[j] += pgm_atomic_read32 (&stats->block[i].counters[j]);
+}
+
+/* eof */
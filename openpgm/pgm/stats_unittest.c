@@ -0,0 +1,237 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for sharded performance counters.
+ *
+ * Copyright (c) 2009 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <glib.h>
+#include <check.h>
+
+#ifdef _WIN32
+#	define PGM_CHECK_NOFORK		1
+#endif
+
+
+/* mock state */
+
+#define STATS_DEBUG
+#include "stats.c"
+
+
+/* mock functions for external references */
+
+size_t
+pgm_pkt_offset (
+        const bool                      can_fragment,
+        const sa_family_t		pgmcc_family	/* 0 = disable */
+        )
+{
+        return 0;
+}
+
+
+/* target:
+ *	void
+ *	pgm_stats_add (
+ *		pgm_stats_t*const	stats,
+ *		const unsigned		role,
+ *		const unsigned		counter,
+ *		const uint32_t		value
+ *	)
+ */
+
+START_TEST (test_add_pass_001)
+{
+	pgm_stats_t stats;
+	memset (&stats, 0, sizeof(stats));
+	pgm_stats_add (&stats, PGM_STATS_ROLE_SOURCE, 2, 1000);
+	pgm_stats_add (&stats, PGM_STATS_ROLE_SOURCE, 2, 500);
+	pgm_stats_inc (&stats, PGM_STATS_ROLE_SOURCE, 3);
+	fail_unless (1500 == stats.block[PGM_STATS_ROLE_SOURCE].counters[2], "add failed");
+	fail_unless (1 == stats.block[PGM_STATS_ROLE_SOURCE].counters[3], "inc failed");
+	fail_unless (0 == stats.block[PGM_STATS_ROLE_RECEIVER].counters[2], "add leaked across roles");
+}
+END_TEST
+
+/* blocks never share a cache line */
+START_TEST (test_add_pass_002)
+{
+	pgm_stats_t stats;
+	for (unsigned i = 1; i < PGM_STATS_ROLE_MAX; i++) {
+		const uintptr_t a = (uintptr_t)&stats.block[i - 1].counters[PGM_STATS_MAX_COUNTERS - 1];
+		const uintptr_t b = (uintptr_t)&stats.block[i].counters[0];
+		fail_unless (b - a > PGM_STATS_CACHELINE, "blocks share a cache line");
+	}
+}
+END_TEST
+
+/* target:
+ *	uint32_t
+ *	pgm_stats_read (
+ *		const pgm_stats_t*const	stats,
+ *		const unsigned		counter
+ *	)
+ */
+
+START_TEST (test_read_pass_001)
+{
+	pgm_stats_t stats;
+	memset (&stats, 0, sizeof(stats));
+	pgm_stats_add (&stats, PGM_STATS_ROLE_SOURCE,   0, 100);
+	pgm_stats_add (&stats, PGM_STATS_ROLE_RECEIVER, 0, 20);
+	pgm_stats_add (&stats, PGM_STATS_ROLE_REPAIR,   0, 3);
+	fail_unless (123 == pgm_stats_read (&stats, 0), "read failed");
+	fail_unless (0 == pgm_stats_read (&stats, 1), "read failed");
+}
+END_TEST
+
+START_TEST (test_read_fail_001)
+{
+	pgm_stats_t stats;
+	memset (&stats, 0, sizeof(stats));
+	const uint32_t value = pgm_stats_read (&stats, PGM_STATS_MAX_COUNTERS);
+	fail ("reached, value %u", (unsigned)value);
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_stats_set (
+ *		pgm_stats_t*const	stats,
+ *		const unsigned		role,
+ *		const unsigned		counter,
+ *		const uint32_t		value
+ *	)
+ */
+
+START_TEST (test_set_pass_001)
+{
+	pgm_stats_t stats;
+	memset (&stats, 0, sizeof(stats));
+	pgm_stats_set (&stats, PGM_STATS_ROLE_RECEIVER, 5, 8);
+	pgm_stats_set (&stats, PGM_STATS_ROLE_RECEIVER, 5, 4);
+	fail_unless (4 == pgm_stats_read (&stats, 5), "set failed");
+}
+END_TEST
+
+START_TEST (test_set_fail_001)
+{
+	pgm_stats_t stats;
+	pgm_stats_set (&stats, PGM_STATS_ROLE_MAX, 0, 1);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_stats_snapshot (
+ *		const pgm_stats_t* const restrict stats,
+ *		uint32_t*	   restrict	  counters,
+ *		const unsigned			  count
+ *	)
+ */
+
+START_TEST (test_snapshot_pass_001)
+{
+	pgm_stats_t stats;
+	uint32_t counters[4];
+	memset (&stats, 0, sizeof(stats));
+	memset (counters, 0xff, sizeof(counters));
+	pgm_stats_inc (&stats, PGM_STATS_ROLE_SOURCE,   0);
+	pgm_stats_inc (&stats, PGM_STATS_ROLE_RECEIVER, 0);
+	pgm_stats_add (&stats, PGM_STATS_ROLE_REPAIR,   2, 7);
+	pgm_stats_add (&stats, PGM_STATS_ROLE_SOURCE,   3, 9);
+	pgm_stats_snapshot (&stats, counters, 3);
+	fail_unless (2 == counters[0], "snapshot failed");
+	fail_unless (0 == counters[1], "snapshot failed");
+	fail_unless (7 == counters[2], "snapshot failed");
+	fail_unless (0xffffffff == counters[3], "snapshot overran count");
+}
+END_TEST
+
+START_TEST (test_snapshot_fail_001)
+{
+	uint32_t counters[4];
+	pgm_stats_snapshot (NULL, counters, 4);
+	fail ("reached");
+}
+END_TEST
+
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_add = tcase_create ("add");
+	suite_add_tcase (s, tc_add);
+	tcase_add_test (tc_add, test_add_pass_001);
+	tcase_add_test (tc_add, test_add_pass_002);
+
+	TCase* tc_read = tcase_create ("read");
+	suite_add_tcase (s, tc_read);
+	tcase_add_test (tc_read, test_read_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_read, test_read_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_set = tcase_create ("set");
+	suite_add_tcase (s, tc_set);
+	tcase_add_test (tc_set, test_set_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_set, test_set_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_snapshot = tcase_create ("snapshot");
+	suite_add_tcase (s, tc_snapshot);
+	tcase_add_test (tc_snapshot, test_snapshot_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_snapshot, test_snapshot_fail_001, SIGABRT);
+#endif
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
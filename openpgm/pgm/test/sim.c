@@ -430,11 +430,11 @@ on_io_data (
 
 /* parse packet to maintain peer database */
 	if (sock->udp_encap_ucast_port) {
-		if (!pgm_parse_udp_encap (skb, NULL))
+		if (!pgm_parse_udp_encap (skb, 0, NULL))
 			goto out;
         } else {
 		struct sockaddr_storage addr;
-                if (!pgm_parse_raw (skb, (struct sockaddr*)&addr, NULL))
+                if (!pgm_parse_raw (skb, (struct sockaddr*)&addr, 0, NULL))
                         goto out;
         }
 
@@ -1253,9 +1253,7 @@ brokn_send_apdu_unlocked (
                 skb->pgm_header->pgm_checksum    = pgm_csum_fold (pgm_csum_block_add (unfolded_header, unfolded_odata, pgm_header_len));
 
 /* add to transmit window */
-		pgm_spinlock_lock (&sock->txw_spinlock);
                 pgm_txw_add (sock->window, skb);
-		pgm_spinlock_unlock (&sock->txw_spinlock);
 
 /* do not send send packet */
 		if (packets != 1)
@@ -170,11 +170,30 @@ static pgm_time_t		pgm_rtc_update (void);
 #	elif defined(_MSC_VER)
 #		include <intrin.h>
 #	endif
-#	define TSC_NS_SCALE	10 /* 2^10, carefully chosen */
-#	define TSC_US_SCALE	20
+#	ifdef HAVE_PERF_EVENT_OPEN
+#		include <linux/perf_event.h>
+#		include <sys/mman.h>
+#		include <sys/syscall.h>
+#		include <unistd.h>
+#	endif
+#	ifdef __SIZEOF_INT128__
+/* 128-bit products keep conversion error well below the frequency accuracy */
+#		define TSC_NS_SCALE	32
+#		define TSC_US_SCALE	32
+typedef unsigned __int128	tsc_product_t;
+#	else
+#		define TSC_NS_SCALE	10 /* 2^10, carefully chosen */
+#		define TSC_US_SCALE	20
+typedef uint64_t		tsc_product_t;
+#	endif
+#	define TSC_CALIBRATION_NS	5000000 /* 5ms */
+/* accuracy of a frequency reported with megahertz resolution */
+#	define TSC_MHZ_PPM(khz)	((khz) ? UINT32_C(1000000000) / (khz) : 0)
 static uint_fast32_t		tsc_khz PGM_GNUC_READ_MOSTLY = 0;
-static uint_fast32_t		tsc_ns_mul PGM_GNUC_READ_MOSTLY = 0;
-static uint_fast32_t		tsc_us_mul PGM_GNUC_READ_MOSTLY = 0;
+static const char*		tsc_source = NULL;
+static uint_fast32_t		tsc_ppm = 0;		/* estimated accuracy of tsc_khz */
+static uint64_t			tsc_ns_mul PGM_GNUC_READ_MOSTLY = 0;
+static uint64_t			tsc_us_mul PGM_GNUC_READ_MOSTLY = 0;
 
 static inline
 void
@@ -182,8 +201,8 @@ set_tsc_mul (
 	const unsigned		khz
 	)
 {
-	tsc_ns_mul = (1000000 << TSC_NS_SCALE) / khz;
-	tsc_us_mul = (1000 << TSC_US_SCALE) / khz;
+	tsc_ns_mul = (UINT64_C(1000000) << TSC_NS_SCALE) / khz;
+	tsc_us_mul = (UINT64_C(1000) << TSC_US_SCALE) / khz;
 }
 
 static inline
@@ -192,7 +211,7 @@ tsc_to_ns (
 	const uint64_t		tsc
 	)
 {
-	return (tsc * tsc_ns_mul) >> TSC_NS_SCALE;
+	return (uint64_t)(((tsc_product_t)tsc * tsc_ns_mul) >> TSC_NS_SCALE);
 }
 
 static inline
@@ -201,7 +220,7 @@ ns_to_tsc (
 	const uint64_t		ns
 	)
 {
-	return (ns << TSC_NS_SCALE) / tsc_ns_mul;
+	return (uint64_t)(((tsc_product_t)ns << TSC_NS_SCALE) / tsc_ns_mul);
 }
 
 static inline
@@ -210,7 +229,7 @@ tsc_to_us (
 	const uint64_t		tsc
 	)
 {
-	return (tsc * tsc_us_mul) >> TSC_US_SCALE;
+	return (uint64_t)(((tsc_product_t)tsc * tsc_us_mul) >> TSC_US_SCALE);
 }
 
 static inline
@@ -219,11 +238,15 @@ us_to_tsc (
 	const uint64_t		us
 	)
 {
-	return (us << TSC_US_SCALE) / tsc_us_mul;
+	return (uint64_t)(((tsc_product_t)us << TSC_US_SCALE) / tsc_us_mul);
 }
 
 #	ifndef _WIN32
 static bool			pgm_tsc_init (pgm_error_t**);
+static bool			pgm_tsc_calibrate (uint_fast32_t*restrict, uint_fast32_t*restrict);
+#		ifdef HAVE_PERF_EVENT_OPEN
+static bool			pgm_tsc_perf_khz (uint_fast32_t*);
+#		endif
 #	endif
 static pgm_time_t		pgm_tsc_update (void);
 #endif
@@ -330,6 +353,25 @@ pgm_time_init (
 /* clean environment copy */
 	pgm_free (pgm_timer);
 
+#if defined(HAVE_RDTSC) && !defined(HAVE_PROC_CPUINFO)
+/* without kernel flags to consult the processor must report a TSC that runs
+ * at a constant rate through power state changes.
+ */
+	if (pgm_time_update_now == pgm_tsc_update)
+	{
+		pgm_cpu_t cpu;
+		pgm_cpuid (&cpu);
+		if (!cpu.has_invariant_tsc) {
+			pgm_warn (_("Processor reports no invariant Time Stamp Counter (TSC)."));
+#	ifdef _WIN32
+			pgm_time_update_now = pgm_queryperformancecounter_update;
+#	else
+			pgm_time_update_now = pgm_gettimeofday_update;
+#	endif
+		}
+	}
+#endif
+
 #ifdef HAVE_DEV_RTC
 	if (pgm_time_update_now == pgm_rtc_update)
 	{
@@ -372,24 +414,10 @@ pgm_time_init (
 	{
 		char	*rdtsc_frequency;
 
-#ifdef HAVE_PROC_CPUINFO
-/* attempt to parse clock ticks from kernel
+/* nb: Linux "cpu MHz" from /proc/cpuinfo is the current core clock, not the
+ * TSC rate, the kernel calibration is queried in pgm_tsc_init() instead.
  */
-		FILE	*fp = fopen ("/proc/cpuinfo", "r");
-		if (fp)
-		{
-			char buffer[1024];
-			while (!feof(fp) && fgets (buffer, sizeof(buffer), fp))
-			{
-				if (strstr (buffer, "cpu MHz")) {
-					const char *p = strchr (buffer, ':');
-					if (p) tsc_khz = atoi (p + 1) * 1000;
-					break;
-				}
-			}
-			fclose (fp);
-		}
-#elif defined(_WIN32)
+#if defined(_WIN32)
 /* core frequency HKLM/Hardware/Description/System/CentralProcessor/0/~Mhz
  */
 		HKEY hKey;
@@ -409,6 +437,8 @@ pgm_time_init (
 						&dwDataSize))
 			{
 				tsc_khz = dwData * 1000;
+				tsc_source = "registry";
+				tsc_ppm = TSC_MHZ_PPM (tsc_khz);
 				pgm_minor (_("Registry reports central processor frequency %u MHz"),
 					(unsigned)dwData);
 /* dump processor name for comparison aid of obtained frequency */
@@ -440,6 +470,8 @@ pgm_time_init (
 		len = sizeof (cpufrequency);
 		if (0 == sysctlbyname ("hw.cpufrequency", &cpufrequency, &len, NULL, 0)) {
 			tsc_khz = (uint_fast32_t)(cpufrequency / 1000);
+			tsc_source = "hw.cpufrequency";
+			tsc_ppm = 1;
 		}
 #elif defined(__FreeBSD__)
 /* frequency in Mhz */
@@ -448,6 +480,8 @@ pgm_time_init (
 		len = sizeof (clockrate);
 		if (0 == sysctlbyname ("hw.clockrate", &clockrate, &len, NULL, 0)) {
 			tsc_khz = (uint_fast32_t)(clockrate * 1000);
+			tsc_source = "hw.clockrate";
+			tsc_ppm = TSC_MHZ_PPM (tsc_khz);
 		}
 #elif defined(__NetBSD__)
 		uint64_t clockrate;
@@ -455,6 +489,8 @@ pgm_time_init (
 		len = sizeof (clockrate);
 		if (0 == sysctlbyname ("machdep.tsc_freq", &clockrate, &len, NULL, 0)) {
 			tsc_khz = (uint_fast32_t)(clockrate / 1000);
+			tsc_source = "machdep.tsc_freq";
+			tsc_ppm = 1;
 		}
 #elif defined(KSTAT_DATA_INT32)
 /* ref: http://developers.sun.com/solaris/articles/kstatc.html */
@@ -469,6 +505,8 @@ pgm_time_init (
 			KSTAT_DATA_INT32 == kdata->data_type)
 		{
 			tsc_khz = (uint_fast32_t)(kdata->value.i32 * 1000);
+			tsc_source = "kstat cpu_info";
+			tsc_ppm = TSC_MHZ_PPM (tsc_khz);
 			kstat_close (kc);
 		}
 #endif /* !_WIN32 */
@@ -480,6 +518,8 @@ pgm_time_init (
 		err = pgm_dupenv_s (&rdtsc_frequency, &envlen, "RDTSC_FREQUENCY");
 		if (0 == err && envlen > 0) {
 			tsc_khz = atoi (rdtsc_frequency) * 1000;
+			tsc_source = "RDTSC_FREQUENCY";
+			tsc_ppm = TSC_MHZ_PPM (tsc_khz);
 			pgm_free (rdtsc_frequency);
 		}
 
@@ -493,8 +533,11 @@ pgm_time_init (
 			}
 		}
 #endif
-		pgm_minor (_("TSC frequency set at %u KHz"), (unsigned)(tsc_khz));
-		set_tsc_mul (tsc_khz);
+		if (pgm_time_update_now == pgm_tsc_update) {
+			pgm_minor (_("TSC frequency set at %u KHz from %s, accuracy %u ppm."),
+				(unsigned)(tsc_khz), tsc_source, (unsigned)(tsc_ppm));
+			set_tsc_mul (tsc_khz);
+		}
 	}
 #endif /* HAVE_RDTSC */
 
@@ -800,8 +843,10 @@ pgm_rdtsc (void)
 }
 
 #	ifndef _WIN32
-/* determine ratio of ticks to nano-seconds, use /dev/rtc for high accuracy
- * millisecond timer and convert.
+/* determine ratio of ticks to nano-seconds without stalling startup, in order
+ * of preference: the kernel's own calibration, the processor enumerated
+ * crystal or hypervisor frequency, and finally a short measurement against
+ * the system monotonic clock.
  *
  * WARNING: time is relative to start of timer.
  */
@@ -812,21 +857,18 @@ pgm_tsc_init (
 	PGM_GNUC_UNUSED pgm_error_t**	error
 	)
 {
+	pgm_cpu_t	cpu;
+
 #		ifdef HAVE_PROC_CPUINFO
 /* Test for constant TSC from kernel
  */
 	FILE	*fp = fopen ("/proc/cpuinfo", "r");
 	char	buffer[1024], *flags = NULL;
-	int	tmp_tsc_mhz = 0;
-	bool	ret = FALSE;
 	if (fp)
 	{
 		while (!feof(fp) && fgets (buffer, sizeof(buffer), fp))
 		{
-			if (strstr (buffer, "cpu MHz")) {
-				const char *p = strchr (buffer, ':');
-				if (p) tmp_tsc_mhz = atoi (p + 1) * 1000;
-			} else if (strstr (buffer, "flags")) {
+			if (strstr (buffer, "flags")) {
 				flags = strchr (buffer, ':');
 				break;
 			}
@@ -837,61 +879,206 @@ pgm_tsc_init (
 		pgm_warn (_("Linux kernel reports no Time Stamp Counter (TSC)."));
 /* force both to stable clocks even though one might be OK */
 		pgm_time_update_now	= pgm_gettimeofday_update;
-		ret = TRUE;
+		return TRUE;
 	} else if (!strstr (flags, " constant_tsc")) {
 		pgm_warn (_("Linux kernel reports non-constant Time Stamp Counter (TSC)."));
 /* force both to stable clocks even though one might be OK */
 		pgm_time_update_now	= pgm_gettimeofday_update;
-		ret = TRUE;
-	}
-
-/* Only return in case the kernel doesn't report 0 as cpu MHz */
-	if ((tmp_tsc_mhz != 0) && ret)
 		return TRUE;
-
+	}
 #		endif /* HAVE_PROC_CPUINFO */
 
-	pgm_time_t		start, stop, elapsed;
-	const pgm_time_t	calibration_usec = secs_to_usecs (4);
-	struct timespec		req = {
-					.tv_sec  = 4,
-					.tv_nsec = 0
-				};
-
-	pgm_info (_("Running a benchmark to measure system clock frequency..."));
+#		ifdef HAVE_PERF_EVENT_OPEN
+	if (pgm_tsc_perf_khz (&tsc_khz)) {
+		tsc_source = "kernel perf_event";
+		tsc_ppm = 1;
+		return TRUE;
+	}
+#		endif
+
+#		ifdef __linux__
+/* exported by some kernels and the tsc_freq_khz module */
+	FILE	*sysfs_fp = fopen ("/sys/devices/system/cpu/cpu0/tsc_freq_khz", "r");
+	if (sysfs_fp) {
+		unsigned long khz = 0;
+		if (1 == fscanf (sysfs_fp, "%lu", &khz) && khz > 0) {
+			tsc_khz = (uint_fast32_t)khz;
+			tsc_source = "sysfs tsc_freq_khz";
+			tsc_ppm = 1;
+		}
+		fclose (sysfs_fp);
+		if (tsc_khz > 0)
+			return TRUE;
+	}
+#		endif
 
-	start = pgm_rdtsc();
-	while (-1 == nanosleep (&req, &req) && EINTR == errno);
-	stop = pgm_rdtsc();
+	pgm_cpuid (&cpu);
+	if (cpu.tsc_khz > 0) {
+		tsc_khz = cpu.tsc_khz;
+		tsc_source = "CPUID";
+		tsc_ppm = 1;
+		return TRUE;
+	}
 
-	if (stop < start)
-	{
-		pgm_warn (_("Finished RDTSC test.  Unstable TSC detected.  The benchmark resulted in a "
-			   "non-monotonic time response rendering the TSC unsuitable for high resolution "
-			   "timing.  To prevent the start delay from this benchmark and use a stable clock "
-			   "source set the environment variable PGM_TIMER to GTOD."));
-/* force both to stable clocks even though one might be OK */
-		pgm_time_update_now = pgm_gettimeofday_update;
+	if (pgm_tsc_calibrate (&tsc_khz, &tsc_ppm)) {
+		tsc_source = "calibration";
 		return TRUE;
 	}
 
-/* TODO: this math needs to be scaled to reduce rounding errors */
-	elapsed = stop - start;
-	if (elapsed > calibration_usec) {
-/* cpu > 1 Ghz */
-		tsc_khz = (elapsed * 1000) / calibration_usec;
-	} else {
-/* cpu < 1 Ghz */
-		tsc_khz = -( (calibration_usec * 1000) / elapsed );
+/* nominal base frequency as a last resort */
+	if (cpu.base_mhz > 0) {
+		tsc_khz = cpu.base_mhz * 1000;
+		tsc_source = "CPUID base frequency";
+		tsc_ppm = TSC_MHZ_PPM (tsc_khz);
+		return TRUE;
 	}
 
-	pgm_info (_("Finished RDTSC test. To prevent the startup delay from this benchmark, "
-		   "set the environment variable RDTSC_FREQUENCY to %" PRIuFAST32 " on this "
-		   "system. This value is dependent upon the CPU clock speed and "
-		   "architecture and should be determined separately for each server."),
-		   tsc_khz);
+	pgm_warn (_("Unstable TSC detected.  Calibration resulted in a non-monotonic time "
+		   "response rendering the TSC unsuitable for high resolution timing.  To use a "
+		   "stable clock source set the environment variable PGM_TIMER to GTOD."));
+/* force both to stable clocks even though one might be OK */
+	pgm_time_update_now = pgm_gettimeofday_update;
 	return TRUE;
 }
+
+/* reference clock in nanoseconds, unslewed where available.
+ */
+
+static inline
+uint64_t
+pgm_tsc_reference_ns (void)
+{
+#		if defined(HAVE_CLOCK_GETTIME)
+	struct timespec ts;
+#			ifdef CLOCK_MONOTONIC_RAW
+	clock_gettime (CLOCK_MONOTONIC_RAW, &ts);
+#			else
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+#			endif
+	return secs_to_nsecs (ts.tv_sec) + ts.tv_nsec;
+#		else
+	struct timeval tv;
+	gettimeofday (&tv, NULL);
+	return secs_to_nsecs (tv.tv_sec) + usecs_to_nsecs (tv.tv_usec);
+#		endif
+}
+
+/* read the reference clock bracketed by the TSC, keeping the tightest of a
+ * few attempts to discard preemption.  returns the bracket width in ticks.
+ */
+
+static
+pgm_time_t
+pgm_tsc_sample (
+	uint64_t*   restrict	ns,
+	pgm_time_t* restrict	tsc
+	)
+{
+	pgm_time_t best = (pgm_time_t)-1;
+
+	for (unsigned i = 0; i < 5; i++) {
+		const pgm_time_t t0 = pgm_rdtsc();
+		const uint64_t	 t  = pgm_tsc_reference_ns();
+		const pgm_time_t t1 = pgm_rdtsc();
+		if (t1 >= t0 && t1 - t0 < best) {
+			best = t1 - t0;
+			*ns  = t;
+			*tsc = t0 + best / 2;
+		}
+	}
+	return best;
+}
+
+/* measure TSC frequency over TSC_CALIBRATION_NS.  accuracy is bounded by the
+ * sample brackets and reference clock resolution.
+ *
+ * returns TRUE on success, returns FALSE if the TSC is not monotonic.
+ */
+
+static
+bool
+pgm_tsc_calibrate (
+	uint_fast32_t* restrict	khz,
+	uint_fast32_t* restrict	ppm
+	)
+{
+#		ifdef HAVE_CLOCK_GETTIME
+	const uint64_t		resolution_ns = 1;
+#		else
+	const uint64_t		resolution_ns = 1000;
+#		endif
+	const struct timespec	req = {
+					.tv_sec  = 0,
+					.tv_nsec = TSC_CALIBRATION_NS / 4
+				};
+	uint64_t		start_ns, stop_ns;
+	pgm_time_t		start, stop, start_width, stop_width;
+
+	start_width = pgm_tsc_sample (&start_ns, &start);
+	if ((pgm_time_t)-1 == start_width)
+		return FALSE;
+	do {
+		nanosleep (&req, NULL);
+		stop_width = pgm_tsc_sample (&stop_ns, &stop);
+		if ((pgm_time_t)-1 == stop_width || stop <= start || stop_ns < start_ns)
+			return FALSE;
+	} while (stop_ns - start_ns < TSC_CALIBRATION_NS);
+
+	const uint64_t elapsed_ns = stop_ns - start_ns;
+	const pgm_time_t elapsed = stop - start;
+	*khz = (uint_fast32_t)((elapsed * 1000000) / elapsed_ns);
+	*ppm = (uint_fast32_t)(((start_width + stop_width) * 1000000) / elapsed +
+			       (2 * resolution_ns * 1000000) / elapsed_ns + 1);
+	return *khz > 0;
+}
+
+#		ifdef HAVE_PERF_EVENT_OPEN
+/* the kernel publishes its TSC to nanosecond conversion on perf_event mmap
+ * pages for user space time stamping: ns = (tsc * time_mult) >> time_shift.
+ */
+
+static
+bool
+pgm_tsc_perf_khz (
+	uint_fast32_t*	khz
+	)
+{
+	struct perf_event_attr attr;
+	volatile struct perf_event_mmap_page* pc;
+	const long page_size = sysconf (_SC_PAGESIZE);
+	uint32_t seq, time_mult;
+	uint16_t time_shift;
+	bool cap_user_time;
+	int fd;
+
+	memset (&attr, 0, sizeof (attr));
+	attr.size		= sizeof (attr);
+	attr.type		= PERF_TYPE_SOFTWARE;
+	attr.config		= PERF_COUNT_SW_DUMMY;
+	attr.exclude_kernel	= 1;
+	attr.exclude_hv		= 1;
+	fd = (int)syscall (SYS_perf_event_open, &attr, 0, -1, -1, 0);
+	if (fd < 0)
+		return FALSE;
+	pc = mmap (NULL, page_size, PROT_READ, MAP_SHARED, fd, 0);
+	close (fd);
+	if (MAP_FAILED == pc)
+		return FALSE;
+	do {
+		seq = pc->lock;
+		__sync_synchronize();
+		cap_user_time	= pc->cap_user_time;
+		time_mult	= pc->time_mult;
+		time_shift	= pc->time_shift;
+		__sync_synchronize();
+	} while (pc->lock != seq);
+	munmap ((void*)pc, page_size);
+	if (!cap_user_time || 0 == time_mult)
+		return FALSE;
+	*khz = (uint_fast32_t)((UINT64_C(1000000) << time_shift) / time_mult);
+	return *khz > 0;
+}
+#		endif /* HAVE_PERF_EVENT_OPEN */
 #	endif
 
 /* TSC is monotonic on the same core but we do neither force the same core or save the count
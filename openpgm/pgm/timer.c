@@ -22,6 +22,10 @@
 #ifdef HAVE_CONFIG_H
 #	include <config.h>
 #endif
+#ifdef HAVE_TIMERFD_CREATE
+#	include <sys/timerfd.h>
+#	include <unistd.h>
+#endif
 #include <impl/i18n.h>
 #include <impl/framework.h>
 #include <impl/timer.h>
@@ -72,13 +76,16 @@ pgm_timer_prepare (
 	return (msec == 0);
 }
 
+/* check whether the next timer is due at the caller's loop time.
+ */
+
 PGM_GNUC_INTERNAL
 bool
 pgm_timer_check (
-	pgm_sock_t* const	sock
+	pgm_sock_t* const	sock,
+	const pgm_time_t	now
 	)
 {
-	const pgm_time_t now = pgm_time_update_now();
 	bool expired;
 
 /* pre-conditions */
@@ -111,8 +118,124 @@ pgm_timer_expiration (
 	return expiration;
 }
 
-/* call all timers, assume that time_now has been updated by either pgm_timer_prepare
- * or pgm_timer_check and no other method calls here.
+#ifdef HAVE_TIMERFD_CREATE
+/* create a timer socket that becomes readable at the next timer expiration,
+ * allowing event loops to wake with microsecond precision instead of rounding
+ * PGM_TIME_REMAIN to a millisecond poll timeout.
+ *
+ * returns TRUE on success, returns FALSE and sets errno on failure.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_timer_sock_init (
+	pgm_sock_t* const	sock
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+
+	sock->timer_sock = timerfd_create (CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (SOCKET_ERROR == sock->timer_sock)
+		return FALSE;
+	sock->timer_sock_expiry = 0;
+	return TRUE;
+}
+
+/* arm the timer socket at next_poll.  re-arming clears any readiness left
+ * from a previous expiration, so unchanged future deadlines are skipped.
+ *
+ * called with receiver mutex held.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_timer_sock_arm (
+	pgm_sock_t* const	sock
+	)
+{
+	const pgm_time_t now = pgm_time_update_now();
+	struct itimerspec its;
+	pgm_time_t next_poll;
+
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (sock->use_timer_sock);
+
+	pgm_timer_lock (sock);
+	next_poll = sock->next_poll;
+	pgm_timer_unlock (sock);
+
+	if (next_poll == sock->timer_sock_expiry && pgm_time_after (next_poll, now))
+		return;
+	sock->timer_sock_expiry = next_poll;
+
+/* a zero value disarms, expired timers fire immediately instead */
+	const pgm_time_t expiration = pgm_time_after (next_poll, now) ? pgm_to_usecs (next_poll - now) : 0;
+	memset (&its, 0, sizeof (its));
+	its.it_value.tv_sec  = (time_t)(expiration / 1000000UL);
+	its.it_value.tv_nsec = (long)(expiration % 1000000UL) * 1000L;
+	if (0 == expiration)
+		its.it_value.tv_nsec = 1;
+	timerfd_settime (sock->timer_sock, 0, &its, NULL);
+}
+
+/* disarm the timer socket clearing any pending expiration, the next call to
+ * pgm_timer_sock_arm() unconditionally re-arms.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_timer_sock_disarm (
+	pgm_sock_t* const	sock
+	)
+{
+	struct itimerspec its;
+
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (sock->use_timer_sock);
+
+	if (0 == sock->timer_sock_expiry)
+		return;
+	sock->timer_sock_expiry = 0;
+	memset (&its, 0, sizeof (its));
+	timerfd_settime (sock->timer_sock, 0, &its, NULL);
+}
+
+PGM_GNUC_INTERNAL
+void
+pgm_timer_sock_destroy (
+	pgm_sock_t* const	sock
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+
+	close (sock->timer_sock);
+	sock->timer_sock = SOCKET_ERROR;
+}
+#endif /* HAVE_TIMERFD_CREATE */
+
+/* restart the heartbeat SPM sequence from the last data packet, the sender
+ * only stores the low 32-bits of the time so extend it by the loop time.
+ */
+
+static
+void
+restart_heartbeat_spm (
+	pgm_sock_t* const	sock,
+	const pgm_time_t	now
+	)
+{
+	const uint32_t tstamp = pgm_atomic_read32 (&sock->spm_heartbeat_data_tstamp);
+	sock->spm_heartbeat_base  = now - (int32_t)((uint32_t)now - tstamp);
+	sock->spm_heartbeat_state = 1;
+	sock->next_heartbeat_spm  = sock->spm_heartbeat_base + sock->spm_heartbeat_interval[ 1 ];
+}
+
+/* call all timers at the loop time that was passed to pgm_timer_check, no other
+ * method reads the clock here.
  * 
  * returns TRUE on success, returns FALSE on blocked send-in-receive operation.
  */
@@ -120,10 +243,10 @@ pgm_timer_expiration (
 PGM_GNUC_INTERNAL
 bool
 pgm_timer_dispatch (
-	pgm_sock_t* const	sock
+	pgm_sock_t* const	sock,
+	const pgm_time_t	now
 	)
 {
-	const pgm_time_t now = pgm_time_update_now();
 	pgm_time_t next_expiration = 0;
 
 /* pre-conditions */
@@ -165,13 +288,19 @@ printf ("ACK timeout, T:%u W:%u\n", pgm_fp8tou(sock->tokens), pgm_fp8tou(sock->c
 			next_expiration = next_expiration > 0 ? MIN(next_expiration, sock->ack_expiry) : sock->ack_expiry;
 		}
 
-/* SPM broadcast */
-		pgm_mutex_lock (&sock->timer_mutex);
+/* fold in data sent since the last dispatch, heartbeats decay from the last
+ * data packet.  the locked read orders the data time after the sender's store.
+ */
+		const uint32_t data_count = pgm_atomic_exchange_and_add32 (&sock->spm_heartbeat_data_count, 0);
+		if (data_count &&
+		    (uint32_t)sock->spm_heartbeat_base != pgm_atomic_read32 (&sock->spm_heartbeat_data_tstamp))
+		{
+			restart_heartbeat_spm (sock, now);
+		}
+
+/* SPM broadcast, heartbeat state is private to the timer */
 		const unsigned spm_heartbeat_state = sock->spm_heartbeat_state;
 		const pgm_time_t next_heartbeat_spm = sock->next_heartbeat_spm;
-		pgm_mutex_unlock (&sock->timer_mutex);
-
-/* no lock needed on ambient */
 		const pgm_time_t next_ambient_spm = sock->next_ambient_spm;
 		pgm_time_t next_spm = spm_heartbeat_state ? MIN(next_heartbeat_spm, next_ambient_spm) : next_ambient_spm;
 
@@ -181,10 +310,7 @@ printf ("ACK timeout, T:%u W:%u\n", pgm_fp8tou(sock->tokens), pgm_fp8tou(sock->c
 
 /* ambient timing not so important so base next event off current time */
 		if (pgm_time_after_eq (now, next_ambient_spm))
-		{
 			sock->next_ambient_spm = now + sock->spm_ambient_interval;
-			next_spm = spm_heartbeat_state ? MIN(next_heartbeat_spm, sock->next_ambient_spm) : sock->next_ambient_spm;
-		}
 
 /* heartbeat timing is often high resolution so base times to last event */
 		if (spm_heartbeat_state && pgm_time_after_eq (now, next_heartbeat_spm))
@@ -199,25 +325,27 @@ printf ("ACK timeout, T:%u W:%u\n", pgm_fp8tou(sock->tokens), pgm_fp8tou(sock->c
 					break;
 				}
 			} while (pgm_time_after_eq (now, new_heartbeat_spm));
-/* check for reset heartbeat */
-			pgm_mutex_lock (&sock->timer_mutex);
-			if (next_heartbeat_spm == sock->next_heartbeat_spm) {
-				sock->spm_heartbeat_state = new_heartbeat_state;
-				sock->next_heartbeat_spm  = new_heartbeat_spm;
-				next_spm = MIN(sock->next_ambient_spm, new_heartbeat_spm);
-			} else
-				next_spm = MIN(sock->next_ambient_spm, sock->next_heartbeat_spm);
-			sock->next_poll = next_expiration > 0 ? MIN(next_expiration, next_spm) : next_spm;
-			pgm_mutex_unlock (&sock->timer_mutex);
-			return TRUE;
+			sock->spm_heartbeat_state = new_heartbeat_state;
+			sock->next_heartbeat_spm  = new_heartbeat_spm;
+
+/* past the first heartbeat new data must prod the timer again, data racing the
+ * disarm restarts the sequence here instead.
+ */
+			if (data_count &&
+			    1 != new_heartbeat_state &&
+			    data_count != pgm_atomic_exchange_and_add32 (&sock->spm_heartbeat_data_count, (uint32_t)-(int32_t)data_count))
+			{
+				restart_heartbeat_spm (sock, now);
+			}
 		}
 
+		next_spm = sock->spm_heartbeat_state ? MIN(sock->next_heartbeat_spm, sock->next_ambient_spm) : sock->next_ambient_spm;
 		next_expiration = next_expiration > 0 ? MIN(next_expiration, next_spm) : next_spm;
 
-/* check for reset */
-		pgm_mutex_lock (&sock->timer_mutex);
-		sock->next_poll = sock->next_poll > now ? MIN(sock->next_poll, next_expiration) : next_expiration;
-		pgm_mutex_unlock (&sock->timer_mutex);
+/* keep an earlier poll set by a sender prodding the timer */
+		pgm_timer_lock (sock);
+		sock->next_poll = pgm_time_after (sock->next_poll, now) ? MIN(sock->next_poll, next_expiration) : next_expiration;
+		pgm_timer_unlock (sock);
 	}
 	else
 		sock->next_poll = next_expiration;
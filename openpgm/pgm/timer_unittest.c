@@ -249,7 +249,8 @@ END_TEST
 /* target:
  *	bool
  *	pgm_timer_check (
- *		pgm_sock_t*	sock
+ *		pgm_sock_t*	sock,
+ *		pgm_time_t	now
  *	)
  */
 
@@ -257,13 +258,13 @@ START_TEST (test_check_pass_001)
 {
 	pgm_sock_t* sock = generate_sock ();
 	fail_if (NULL == sock, "generate_sock failed");
-	fail_unless (TRUE == pgm_timer_check (sock), "check failed");
+	fail_unless (TRUE == pgm_timer_check (sock, mock_pgm_time_now), "check failed");
 }
 END_TEST
 
 START_TEST (test_check_fail_001)
 {
-	gboolean expired = pgm_timer_check (NULL);
+	gboolean expired = pgm_timer_check (NULL, mock_pgm_time_now);
 	fail ("reached");
 }
 END_TEST
@@ -294,7 +295,8 @@ END_TEST
 /* target:
  *	void
  *	pgm_timer_dispatch (
- *		pgm_sock_t*	sock
+ *		pgm_sock_t*	sock,
+ *		pgm_time_t	now
  *	)
  */
 
@@ -302,13 +304,39 @@ START_TEST (test_dispatch_pass_001)
 {
 	pgm_sock_t* sock = generate_sock ();
 	fail_if (NULL == sock, "generate_sock failed");
-	pgm_timer_dispatch (sock);
+	pgm_timer_dispatch (sock, mock_pgm_time_now);
+}
+END_TEST
+
+/* heartbeat follows the last data time, disarming after the first heartbeat */
+START_TEST (test_dispatch_pass_002)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->can_send_data = TRUE;
+	pgm_mutex_init (&sock->timer_mutex);
+	sock->spm_heartbeat_interval = g_malloc0 (sizeof(guint) * (1+2+1));
+	sock->spm_heartbeat_interval[1] = pgm_msecs(100);
+	sock->spm_heartbeat_interval[2] = pgm_msecs(200);
+	sock->spm_heartbeat_len = 3;
+	sock->spm_ambient_interval = pgm_secs(30);
+	sock->next_ambient_spm = mock_pgm_time_now + pgm_secs(30);
+	sock->spm_heartbeat_data_tstamp = (guint32)mock_pgm_time_now;
+	sock->spm_heartbeat_data_count = 1;
+	fail_unless (TRUE == pgm_timer_dispatch (sock, mock_pgm_time_now), "dispatch failed");
+	fail_unless (1 == sock->spm_heartbeat_state, "state mismatch");
+	fail_unless (mock_pgm_time_now + pgm_msecs(100) == sock->next_poll, "next_poll mismatch");
+	fail_unless (1 == sock->spm_heartbeat_data_count, "heartbeat disarmed");
+	fail_unless (TRUE == pgm_timer_dispatch (sock, mock_pgm_time_now + pgm_msecs(100)), "dispatch failed");
+	fail_unless (2 == sock->spm_heartbeat_state, "state mismatch");
+	fail_unless (mock_pgm_time_now + pgm_msecs(200) == sock->next_poll, "next_poll mismatch");
+	fail_unless (0 == sock->spm_heartbeat_data_count, "heartbeat armed");
 }
 END_TEST
 
 START_TEST (test_dispatch_fail_001)
 {
-	pgm_timer_dispatch (NULL);
+	pgm_timer_dispatch (NULL, mock_pgm_time_now);
 	fail ("reached");
 }
 END_TEST
@@ -346,6 +374,7 @@ make_test_suite (void)
 	TCase* tc_dispatch = tcase_create ("dispatch");
 	suite_add_tcase (s, tc_dispatch);
 	tcase_add_test (tc_dispatch, test_dispatch_pass_001);
+	tcase_add_test (tc_dispatch, test_dispatch_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_dispatch, test_dispatch_fail_001, SIGABRT);
 #endif
@@ -58,6 +58,9 @@ pgm_tsi_is_null (
 
 /* returns the pointer at the given index of the window.  responsibility
  * is with the caller to verify a single user ownership.
+ *
+ * the repair side must hold a pin, the slot may be recycled by the producer
+ * between reading the trail and the slot so the sequence is re-validated.
  */
 
 static inline
@@ -72,14 +75,19 @@ _pgm_txw_peek (
 /* pre-conditions */
 	pgm_assert (NULL != window);
 
-	if (pgm_txw_is_empty (window))
+/* lead acquires the producer's store of the slot */
+	const uint32_t lead  = pgm_atomic_read32_acquire (&window->lead);
+	const uint32_t trail = pgm_atomic_read32_acquire (&window->trail);
+
+	if (0 == (uint32_t)((1 + lead) - trail))
 		return NULL;
 
-	if (pgm_uint32_gte (sequence, window->trail) && pgm_uint32_lte (sequence, window->lead))
+	if (pgm_uint32_gte (sequence, trail) && pgm_uint32_lte (sequence, lead))
 	{
-		const uint_fast32_t index_ = sequence % pgm_txw_max_length (window);
+		const uint_fast32_t index_ = sequence & window->mask;
 		skb = window->pdata[index_];
-		pgm_assert (NULL != skb);
+		if (PGM_UNLIKELY(NULL == skb || skb->sequence != sequence))
+			return NULL;
 		pgm_assert (pgm_skb_is_valid (skb));
 		pgm_assert (pgm_tsi_is_null (&skb->tsi));
 	}
@@ -89,6 +97,69 @@ _pgm_txw_peek (
 	return skb;
 }
 
+/* repair side pin on window contents, the producer defers freeing evicted
+ * skbuffs whilst any pin is held.  both are full barriers ordering the pin
+ * against the producer's trail advance.
+ */
+
+static inline
+void
+pgm_txw_repair_pin (
+	pgm_txw_t*const		window
+	)
+{
+	pgm_atomic_inc32 (&window->repair_pins);
+}
+
+static inline
+void
+pgm_txw_repair_unpin (
+	pgm_txw_t*const		window
+	)
+{
+	pgm_atomic_dec32 (&window->repair_pins);
+}
+
+/* repair side private FIFO of sequence numbers, one spare slot to
+ * distinguish full from empty.
+ */
+
+static inline
+uint32_t
+pgm_txw_retransmit_next (
+	const pgm_txw_t*const	window,
+	const uint32_t		index_
+	)
+{
+	return (index_ == window->alloc) ? 0 : (index_ + 1);
+}
+
+static inline
+bool
+pgm_txw_retransmit_is_full (
+	const pgm_txw_t*const	window
+	)
+{
+	return (pgm_txw_retransmit_next (window, window->retransmit_head) == window->retransmit_tail);
+}
+
+/* free skbuffs evicted whilst the repair side held a pin.
+ */
+
+static inline
+void
+pgm_txw_free_deferred (
+	pgm_txw_t*const		window
+	)
+{
+	while (window->deferred) {
+		struct pgm_sk_buff_t* skb = window->deferred;
+		window->deferred = (struct pgm_sk_buff_t*)skb->link_.next;
+		skb->link_.next = NULL;
+		pgm_free_skb (skb);
+	}
+}
+
 /* testing function: can a request be peeked from the retransmit queue.
  *
  * returns TRUE if request is available, returns FALSE if not available.
@@ -100,8 +171,14 @@ pgm_txw_retransmit_can_peek (
 	pgm_txw_t*const		window
 	)
 {
+	struct pgm_sk_buff_t* skb;
+
 	pgm_return_val_if_fail (NULL != window, FALSE);
-	return (NULL != pgm_txw_retransmit_try_peek (window));
+	skb = pgm_txw_retransmit_try_peek (window);
+	if (NULL == skb)
+		return FALSE;
+	pgm_free_skb (skb);
+	return TRUE;
 }
 
 /* sequence state must be smaller than PGM skbuff control buffer */
@@ -145,7 +222,7 @@ pgm_txw_retransmit_is_empty (
 	)
 {
 	pgm_assert (NULL != window);
-	return pgm_queue_is_empty (&window->retransmit_queue);
+	return (window->retransmit_head == window->retransmit_tail);
 }
 
 
@@ -154,6 +231,7 @@ pgm_txw_retransmit_is_empty (
 static void pgm_txw_remove_tail (pgm_txw_t*const);
 static bool pgm_txw_retransmit_push_parity (pgm_txw_t*const, const uint32_t, const uint8_t);
 static bool pgm_txw_retransmit_push_selective (pgm_txw_t*const, const uint32_t);
+static void pgm_txw_retransmit_push_sqn (pgm_txw_t*const, const uint32_t);
 
 
 /* constructor for transmit window.  zero-length windows are not permitted.
@@ -171,7 +249,10 @@ pgm_txw_create (
 	const ssize_t		max_rte,	/* max bandwidth */
 	const bool		use_fec,
 	const uint8_t		rs_n,
-	const uint8_t		rs_k
+	const uint8_t		rs_k,
+	const uint8_t		tg_depth,	/* interleave depth, 1 = none */
+	const pgm_arena_t*const	arena,		/* maybe NULL */
+	pgm_heap_t*const	heap		/* maybe NULL */
 	)
 {
 	pgm_txw_t* window;
@@ -192,19 +273,25 @@ pgm_txw_create (
 	if (use_fec) {
 		pgm_assert_cmpuint (rs_n, >, 0);
 		pgm_assert_cmpuint (rs_k, >, 0);
+		pgm_assert_cmpuint (tg_depth, >, 0);
 	}
 
-	pgm_debug ("create (tsi:%s max-tpdu:%" PRIu16 " sqns:%" PRIu32  " secs %u max-rte %" PRIzd " use-fec:%s rs(n):%u rs(k):%u)",
+	pgm_debug ("create (tsi:%s max-tpdu:%" PRIu16 " sqns:%" PRIu32  " secs %u max-rte %" PRIzd " use-fec:%s rs(n):%u rs(k):%u depth:%u)",
 		pgm_tsi_print (tsi),
 		tpdu_size, sqns, secs, max_rte,
 		use_fec ? "YES" : "NO",
-		rs_n, rs_k);
+		rs_n, rs_k, tg_depth);
 
 /* calculate transmit window parameters */
 	pgm_assert (sqns || (tpdu_size && secs && max_rte));
 	const unsigned alloc_sqns = sqns ? sqns : (unsigned)( (secs * max_rte) / tpdu_size );
-	window = pgm_malloc0 (sizeof(pgm_txw_t) + ( alloc_sqns * sizeof(struct pgm_sk_buff_t*) ));
+/* index by mask, slots beyond alloc_sqns are never simultaneously occupied */
+	const unsigned slots = (unsigned)pgm_nearest_power (1, alloc_sqns);
+	window = pgm_arena_alloc_array (arena, heap, sizeof(pgm_txw_t) + ( slots * sizeof(struct pgm_sk_buff_t*) ) + ( (alloc_sqns + 1) * sizeof(uint32_t) ));
 	window->tsi = tsi;
+	window->heap = heap;
+	window->mask = slots - 1;
+	window->retransmit_queue = (uint32_t*)&window->pdata[ slots ];
 
 /* empty state for transmission group boundaries to align.
  *
@@ -217,6 +304,7 @@ pgm_txw_create (
 	if (use_fec) {
 		window->parity_buffer = pgm_alloc_skb (tpdu_size);
 		window->tg_sqn_shift = pgm_power2_log2 (rs_k);
+		window->tg_depth_shift = pgm_power2_log2 (tg_depth);
 		pgm_rs_create (&window->rs, rs_n, rs_k);
 		window->is_fec_enabled = 1;
 	}
@@ -254,6 +342,7 @@ pgm_txw_shutdown (
 	while (!pgm_txw_is_empty (window)) {
 		pgm_txw_remove_tail (window);
 	}
+	pgm_txw_free_deferred (window);
 
 /* window must now be empty */
 	pgm_assert_cmpuint (pgm_txw_length (window), ==, 0);
@@ -271,7 +360,7 @@ pgm_txw_shutdown (
 	}
 
 /* window */
-	pgm_free (window);
+	pgm_arena_free_array (window->heap, window);
 }
 
 /* add skb to transmit window, taking ownership.  window does not grow.
@@ -316,12 +405,12 @@ pgm_txw_add (
 	}
 
 /* generate new sequence number */
-	pgm_atomic_inc32 (&window->lead);
-	skb->sequence = window->lead;
+	skb->sequence = pgm_txw_next_lead (window);
 
-/* add skb to window */
-	const uint_fast32_t index_ = skb->sequence % pgm_txw_max_length (window);
+/* add skb to window, then publish to the repair side */
+	const uint_fast32_t index_ = skb->sequence & window->mask;
 	window->pdata[index_] = skb;
+	pgm_atomic_write32_release (&window->lead, skb->sequence);
 
 /* statistics */
 	window->size += skb->len;
@@ -372,10 +461,6 @@ pgm_txw_remove_tail (
 	pgm_assert (pgm_tsi_is_null (&skb->tsi));
 
 	state = (pgm_txw_state_t*)&skb->cb;
-	if (state->waiting_retransmit) {
-		pgm_queue_unlink (&window->retransmit_queue, (pgm_list_t*)skb);
-		state->waiting_retransmit = 0;
-	}
 
 /* statistics */
 	window->size -= skb->len;
@@ -388,14 +473,24 @@ pgm_txw_remove_tail (
 
 /* remove reference to skb */
 	if (PGM_UNLIKELY(pgm_mem_gc_friendly)) {
-		const uint_fast32_t index_ = skb->sequence % pgm_txw_max_length (window);
+		const uint_fast32_t index_ = skb->sequence & window->mask;
 		window->pdata[index_] = NULL;
 	}
-	pgm_free_skb (skb);
 
-/* advance trailing pointer */
+/* advance trailing pointer, a retransmit request for this sequence is
+ * discarded by the repair side.
+ */
 	pgm_atomic_inc32 (&window->trail);
 
+/* defer free whilst the repair side may hold a reference to the skbuff */
+	if (PGM_LIKELY(0 == pgm_atomic_read32 (&window->repair_pins))) {
+		pgm_txw_free_deferred (window);
+		pgm_free_skb (skb);
+	} else {
+		skb->link_.next = (pgm_list_t*)window->deferred;
+		window->deferred = skb;
+	}
+
 /* post-conditions */
 	pgm_assert (!pgm_txw_is_full (window));
 }
@@ -433,14 +528,49 @@ pgm_txw_retransmit_push (
 	if (pgm_txw_is_empty (window))
 		return FALSE;
 
+	bool is_pushed;
+	pgm_txw_repair_pin (window);
 	if (is_parity)
 	{
-		return pgm_txw_retransmit_push_parity (window, sequence, tg_sqn_shift);
+		is_pushed = pgm_txw_retransmit_push_parity (window, sequence, tg_sqn_shift);
 	}
 	else
 	{
-		return pgm_txw_retransmit_push_selective (window, sequence);
+		is_pushed = pgm_txw_retransmit_push_selective (window, sequence);
+	}
+	pgm_txw_repair_unpin (window);
+	return is_pushed;
+}
+
+/* append a sequence number to the retransmit queue, compacting out requests
+ * for sequences since evicted when full.  live requests are unique and never
+ * exceed the window length.
+ */
+
+static
+void
+pgm_txw_retransmit_push_sqn (
+	pgm_txw_t* const	window,
+	const uint32_t		sequence
+	)
+{
+	if (PGM_UNLIKELY(pgm_txw_retransmit_is_full (window)))
+	{
+		uint32_t head = window->retransmit_tail;
+		for (uint32_t i = window->retransmit_tail;
+		     i != window->retransmit_head;
+		     i = pgm_txw_retransmit_next (window, i))
+		{
+			if (NULL == _pgm_txw_peek (window, window->retransmit_queue[ i ]))
+				continue;
+			window->retransmit_queue[ head ] = window->retransmit_queue[ i ];
+			head = pgm_txw_retransmit_next (window, head);
+		}
+		window->retransmit_head = head;
+		pgm_assert (!pgm_txw_retransmit_is_full (window));
 	}
+	window->retransmit_queue[ window->retransmit_head ] = sequence;
+	window->retransmit_head = pgm_txw_retransmit_next (window, window->retransmit_head);
 }
 
 static
@@ -458,9 +588,13 @@ pgm_txw_retransmit_push_parity (
 	pgm_assert (NULL != window);
 	pgm_assert_cmpuint (tg_sqn_shift, <, 8 * sizeof(uint32_t));
 
-	const uint32_t tg_sqn_mask = 0xffffffff << tg_sqn_shift;
-	const uint32_t nak_tg_sqn  = sequence &  tg_sqn_mask;	/* left unshifted */
-	const uint32_t nak_pkt_cnt = sequence & ~tg_sqn_mask;
+/* interleaved groups are identified by their first member, the packet count
+ * is scaled by the interleave depth.
+ */
+	const uint32_t tg_block_mask  = 0xffffffff << (tg_sqn_shift + window->tg_depth_shift);
+	const uint32_t tg_stripe_mask = ~(0xffffffff << window->tg_depth_shift);
+	const uint32_t nak_tg_sqn  = (sequence & tg_block_mask) | (sequence & tg_stripe_mask);	/* left unshifted */
+	const uint32_t nak_pkt_cnt = (sequence & ~tg_block_mask) >> window->tg_depth_shift;
 	skb = _pgm_txw_peek (window, nak_tg_sqn);
 
 	if (NULL == skb) {
@@ -475,25 +609,19 @@ pgm_txw_retransmit_push_parity (
 /* check if request can be eliminated */
 	if (state->waiting_retransmit)
 	{
-		pgm_assert (NULL != ((const pgm_list_t*)skb)->next);
-		pgm_assert (NULL != ((const pgm_list_t*)skb)->prev);
-		if (state->pkt_cnt_requested < nak_pkt_cnt) {
+		pgm_assert (!pgm_txw_retransmit_is_empty (window));
+		if (state->pkt_cnt_requested < (nak_pkt_cnt + 1)) {
 /* more parity packets requested than currently scheduled, simply bump up the count */
-			state->pkt_cnt_requested = nak_pkt_cnt;
+			state->pkt_cnt_requested = nak_pkt_cnt + 1;
 		}
 		state->nak_elimination_count++;
 		return FALSE;
 	}
-	else
-	{
-		pgm_assert (((const pgm_list_t*)skb)->next == NULL);
-		pgm_assert (((const pgm_list_t*)skb)->prev == NULL);
-	}
 
-/* new request */
-	state->pkt_cnt_requested++;
-	pgm_queue_push_head_link (&window->retransmit_queue, (pgm_list_t*)skb);
-	pgm_assert (!pgm_queue_is_empty (&window->retransmit_queue));
+/* new request, packet count is sent minus one */
+	state->pkt_cnt_requested = nak_pkt_cnt + 1;
+	pgm_txw_retransmit_push_sqn (window, skb->sequence);
+	pgm_assert (!pgm_txw_retransmit_is_empty (window));
 	state->waiting_retransmit = 1;
 	return TRUE;
 }
@@ -523,24 +651,23 @@ pgm_txw_retransmit_push_selective (
 
 /* check if request can be eliminated */
 	if (state->waiting_retransmit) {
-		pgm_assert (!pgm_queue_is_empty (&window->retransmit_queue));
+		pgm_assert (!pgm_txw_retransmit_is_empty (window));
 		state->nak_elimination_count++;
 		return FALSE;
 	}
 
-	pgm_assert (((const pgm_list_t*)skb)->next == NULL);
-	pgm_assert (((const pgm_list_t*)skb)->prev == NULL);
-
 /* new request */
-	pgm_queue_push_head_link (&window->retransmit_queue, (pgm_list_t*)skb);
-	pgm_assert (!pgm_queue_is_empty (&window->retransmit_queue));
+	pgm_txw_retransmit_push_sqn (window, sequence);
+	pgm_assert (!pgm_txw_retransmit_is_empty (window));
 	state->waiting_retransmit = 1;
 	return TRUE;
 }
 
-/* try to peek a request from the retransmit queue
+/* try to peek a request from the retransmit queue, discarding requests for
+ * sequences evicted from the window.
  *
- * return pointer of first skb in queue, or return NULL if the queue is empty.
+ * return pointer of first skb in queue with a reference taken for the caller,
+ * or return NULL if the queue is empty.
  */
 
 PGM_GNUC_INTERNAL
@@ -555,45 +682,70 @@ pgm_txw_retransmit_try_peek (
 	bool			  is_op_encoded = FALSE;
 	uint16_t		  parity_length = 0;
 	const pgm_gf8_t		**src;
+	struct pgm_sk_buff_t	**odata;
 	void			 *data;
 
 /* pre-conditions */
 	pgm_assert (NULL != window);
 
 	src = pgm_newa (const pgm_gf8_t*, window->rs.k);
+	odata = pgm_newa (struct pgm_sk_buff_t*, window->rs.k);
 
 	pgm_debug ("retransmit_try_peek (window:%p)", (const void*)window);
 
-/* no lock required to detect presence of a request */
-	skb = (struct pgm_sk_buff_t*)pgm_queue_peek_tail_link (&window->retransmit_queue);
-	if (PGM_UNLIKELY(NULL == skb)) {
-		pgm_debug ("retransmit queue empty on peek.");
-		return NULL;
-	}
+	pgm_txw_repair_pin (window);
+	for (;;)
+	{
+		if (pgm_txw_retransmit_is_empty (window)) {
+			pgm_debug ("retransmit queue empty on peek.");
+			pgm_txw_repair_unpin (window);
+			return NULL;
+		}
+		const uint32_t sequence = window->retransmit_queue[ window->retransmit_tail ];
+		skb = _pgm_txw_peek (window, sequence);
+		if (PGM_UNLIKELY(NULL == skb)) {
+			pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Retransmit sqn #%" PRIu32 " evicted from transmit window."), sequence);
+			window->retransmit_tail = pgm_txw_retransmit_next (window, window->retransmit_tail);
+			continue;
+		}
 
-	pgm_assert (pgm_skb_is_valid (skb));
-	state = (pgm_txw_state_t*)&skb->cb;
+		pgm_assert (pgm_skb_is_valid (skb));
+		state = (pgm_txw_state_t*)&skb->cb;
+		pgm_assert (state->waiting_retransmit);
 
-	if (!state->waiting_retransmit) {
-		pgm_assert (((const pgm_list_t*)skb)->next == NULL);
-		pgm_assert (((const pgm_list_t*)skb)->prev == NULL);
-	}
 /* packet payload still in transit */
-	if (PGM_UNLIKELY(1 != pgm_atomic_read32 (&skb->users))) {
-		pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Retransmit sqn #%" PRIu32 " is still in transit in transmit thread."), skb->sequence);
-		return NULL;
-	}
-	if (!state->pkt_cnt_requested) {
-		return skb;
+		if (PGM_UNLIKELY(1 != pgm_atomic_read32 (&skb->users))) {
+			pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Retransmit sqn #%" PRIu32 " is still in transit in transmit thread."), skb->sequence);
+			pgm_txw_repair_unpin (window);
+			return NULL;
+		}
+		if (!state->pkt_cnt_requested) {
+/* reference held by caller outlives the pin */
+			skb = pgm_skb_get (skb);
+			pgm_txw_repair_unpin (window);
+			return skb;
+		}
+
+/* parity requires the entire transmission group */
+		unsigned i;
+		for (i = 0; i < window->rs.k; i++) {
+			odata[i] = _pgm_txw_peek (window, sequence + (i << window->tg_depth_shift));
+			if (NULL == odata[i])
+				break;
+		}
+		if (PGM_LIKELY(i == window->rs.k))
+			break;
+		pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Transmission group #%" PRIu32 " incomplete in transmit window."), sequence);
+		state->waiting_retransmit = 0;
+		window->retransmit_tail = pgm_txw_retransmit_next (window, window->retransmit_tail);
 	}
 
 /* generate parity packet to satisify request */	
 	const uint8_t rs_h = state->pkt_cnt_sent % (window->rs.n - window->rs.k);
-	const uint32_t tg_sqn_mask = 0xffffffff << window->tg_sqn_shift;
-	const uint32_t tg_sqn = skb->sequence & tg_sqn_mask;
+	const uint32_t tg_sqn = skb->sequence;		/* first member of group */
 	for (uint_fast8_t i = 0; i < window->rs.k; i++)
 	{
-		const struct pgm_sk_buff_t* odata_skb = pgm_txw_peek (window, tg_sqn + i);
+		const struct pgm_sk_buff_t* odata_skb = odata[i];
 		const uint16_t odata_tsdu_length = pgm_ntohs (odata_skb->pgm_header->pgm_tsdu_length);
 		if (!parity_length)
 		{
@@ -632,7 +784,7 @@ pgm_txw_retransmit_try_peek (
 
 		for (uint_fast8_t i = 0; i < window->rs.k; i++)
 		{
-			struct pgm_sk_buff_t* odata_skb = pgm_txw_peek (window, tg_sqn + i);
+			struct pgm_sk_buff_t* odata_skb = odata[i];
 			const uint16_t odata_tsdu_length = pgm_ntohs (odata_skb->pgm_header->pgm_tsdu_length);
 
 			pgm_assert (odata_tsdu_length == odata_skb->len);
@@ -652,7 +804,7 @@ pgm_txw_retransmit_try_peek (
 /* space for DATA */
 	pgm_skb_put (skb, sizeof(struct pgm_data) + parity_length);
 
-	skb->pgm_data->data_sqn	= pgm_htonl ( tg_sqn | rs_h );
+	skb->pgm_data->data_sqn	= pgm_htonl ( tg_sqn + (rs_h << window->tg_depth_shift) );
 
 	data = skb->pgm_data + 1;
 
@@ -681,7 +833,7 @@ pgm_txw_retransmit_try_peek (
 
 		for (uint_fast8_t i = 0; i < window->rs.k; i++)
 		{
-			const struct pgm_sk_buff_t* odata_skb = pgm_txw_peek (window, tg_sqn + i);
+			const struct pgm_sk_buff_t* odata_skb = odata[i];
 
 			if (odata_skb->pgm_opt_fragment)
 			{
@@ -737,6 +889,8 @@ pgm_txw_retransmit_try_peek (
 /* calculate partial checksum */
 	const uint16_t tsdu_length = pgm_ntohs (skb->pgm_header->pgm_tsdu_length);
 	state->unfolded_checksum = pgm_csum_partial ((char*)skb->tail - tsdu_length, tsdu_length, 0);
+	skb = pgm_skb_get (skb);
+	pgm_txw_repair_unpin (window);
 	return skb;
 }
 
@@ -758,31 +912,36 @@ pgm_txw_retransmit_remove_head (
 	pgm_debug ("retransmit_remove_head (window:%p)",
 		(const void*)window);
 
-/* tail link is valid without lock */
-	skb = (struct pgm_sk_buff_t*)pgm_queue_peek_tail_link (&window->retransmit_queue);
+	pgm_assert (!pgm_txw_retransmit_is_empty (window));
+
+	pgm_txw_repair_pin (window);
+	skb = _pgm_txw_peek (window, window->retransmit_queue[ window->retransmit_tail ]);
+/* evicted since peek */
+	if (PGM_UNLIKELY(NULL == skb)) {
+		window->retransmit_tail = pgm_txw_retransmit_next (window, window->retransmit_tail);
+		pgm_txw_repair_unpin (window);
+		return;
+	}
 	pgm_assert (pgm_skb_is_valid (skb));
 	pgm_assert (pgm_tsi_is_null (&skb->tsi));
 	state = (pgm_txw_state_t*)&skb->cb;
-	if (!state->waiting_retransmit)
-	{
-		pgm_assert (((const pgm_list_t*)skb)->next == NULL);
-		pgm_assert (((const pgm_list_t*)skb)->prev == NULL);
-	}
+	pgm_assert (state->waiting_retransmit);
 	if (state->pkt_cnt_requested)
 	{
 		state->pkt_cnt_sent++;
 
 /* remove if all requested parity packets have been sent */
 		if (state->pkt_cnt_sent == state->pkt_cnt_requested) {
-			pgm_queue_pop_tail_link (&window->retransmit_queue);
+			window->retransmit_tail = pgm_txw_retransmit_next (window, window->retransmit_tail);
 			state->waiting_retransmit = 0;
 		}
 	}
 	else	/* selective request */
 	{
-		pgm_queue_pop_tail_link (&window->retransmit_queue);
+		window->retransmit_tail = pgm_txw_retransmit_next (window, window->retransmit_tail);
 		state->waiting_retransmit = 0;
 	}
+	pgm_txw_repair_unpin (window);
 }
 
 /* eof */
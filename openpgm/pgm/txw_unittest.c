@@ -52,6 +52,8 @@ mock_pgm_rs_create (
 	uint8_t			k
 	)
 {
+	rs->n = n;
+	rs->k = k;
 }
 
 void
@@ -151,7 +153,10 @@ generate_valid_skb (void)
  *		const guint		max_rte,
  *		const gboolean		use_fec,
  *		const guint		rs_n,
- *		const guint		rs_k
+ *		const guint		rs_k,
+ *		const guint		tg_depth,
+ *		const pgm_arena_t* const arena,
+ *		pgm_heap_t* const	heap
  *		)
  */
 
@@ -159,7 +164,7 @@ generate_valid_skb (void)
 START_TEST (test_create_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	fail_if (NULL == pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0), "create failed");
+	fail_if (NULL == pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL), "create failed");
 }
 END_TEST
 
@@ -167,7 +172,7 @@ END_TEST
 START_TEST (test_create_pass_002)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	fail_if (NULL == pgm_txw_create (&tsi, 1500, 0, 60, 800000, FALSE, 0, 0), "create failed");
+	fail_if (NULL == pgm_txw_create (&tsi, 1500, 0, 60, 800000, FALSE, 0, 0, 1, NULL, NULL), "create failed");
 }
 END_TEST
 
@@ -175,7 +180,7 @@ END_TEST
 START_TEST (test_create_pass_003)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	fail_if (NULL == pgm_txw_create (&tsi, 9000, 0, 60, 800000, FALSE, 0, 0), "create failed");
+	fail_if (NULL == pgm_txw_create (&tsi, 9000, 0, 60, 800000, FALSE, 0, 0, 1, NULL, NULL), "create failed");
 }
 END_TEST
 
@@ -183,7 +188,7 @@ END_TEST
 START_TEST (test_create_pass_004)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	fail_if (NULL == pgm_txw_create (&tsi, UINT16_MAX, 0, 60, 800000, FALSE, 0, 0), "create failed");
+	fail_if (NULL == pgm_txw_create (&tsi, UINT16_MAX, 0, 60, 800000, FALSE, 0, 0, 1, NULL, NULL), "create failed");
 }
 END_TEST
 
@@ -191,7 +196,7 @@ END_TEST
 START_TEST (test_create_fail_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	const pgm_txw_t* window = pgm_txw_create (&tsi, 0, 0, 60, 800000, FALSE, 0, 0);
+	const pgm_txw_t* window = pgm_txw_create (&tsi, 0, 0, 60, 800000, FALSE, 0, 0, 1, NULL, NULL);
 	fail ("reached");
 }
 END_TEST
@@ -200,7 +205,7 @@ END_TEST
 START_TEST (test_create_fail_002)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	const pgm_txw_t* window = pgm_txw_create (&tsi, 0, 0, 0, 800000, FALSE, 0, 0);
+	const pgm_txw_t* window = pgm_txw_create (&tsi, 0, 0, 0, 800000, FALSE, 0, 0, 1, NULL, NULL);
 	fail ("reached");
 }
 END_TEST
@@ -209,7 +214,7 @@ END_TEST
 START_TEST (test_create_fail_003)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	const pgm_txw_t* window = pgm_txw_create (&tsi, 0, 0, 60, 0, FALSE, 0, 0);
+	const pgm_txw_t* window = pgm_txw_create (&tsi, 0, 0, 60, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail ("reached");
 }
 END_TEST
@@ -218,7 +223,7 @@ END_TEST
 START_TEST (test_create_fail_004)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	const pgm_txw_t* window = pgm_txw_create (NULL, 0, 0, 0, 0, FALSE, 0, 0);
+	const pgm_txw_t* window = pgm_txw_create (NULL, 0, 0, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail ("reached");
 }
 END_TEST
@@ -233,7 +238,7 @@ END_TEST
 START_TEST (test_shutdown_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	pgm_txw_shutdown (window);
 }
@@ -258,7 +263,7 @@ END_TEST
 START_TEST (test_add_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
 	fail_if (NULL == skb, "generate_valid_skb failed");
@@ -267,11 +272,34 @@ START_TEST (test_add_pass_001)
 }
 END_TEST
 
+/* eviction whilst the repair side holds a pin is deferred */
+START_TEST (test_add_pass_002)
+{
+	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 1, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
+	fail_if (NULL == window, "create failed");
+	struct pgm_sk_buff_t* skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	pgm_skb_get (skb);
+	pgm_txw_add (window, skb);
+	pgm_txw_repair_pin (window);
+	pgm_txw_add (window, generate_valid_skb ());
+	fail_unless (skb == window->deferred, "deferred failed");
+	fail_unless (2 == skb->users, "users mismatch");
+	pgm_txw_repair_unpin (window);
+	pgm_txw_add (window, generate_valid_skb ());
+	fail_unless (NULL == window->deferred, "deferred failed");
+	fail_unless (1 == skb->users, "users mismatch");
+	pgm_free_skb (skb);
+	pgm_txw_shutdown (window);
+}
+END_TEST
+
 /* null skb */
 START_TEST (test_add_fail_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	pgm_txw_add (window, NULL);
 	fail ("reached");
@@ -292,7 +320,7 @@ END_TEST
 START_TEST (test_add_fail_003)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	char buffer[1500];
 	memset (buffer, 0, sizeof(buffer));
@@ -312,7 +340,7 @@ END_TEST
 START_TEST (test_peek_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
 	fail_if (NULL == skb, "generate_valid_skb failed");
@@ -334,7 +362,7 @@ END_TEST
 START_TEST (test_peek_fail_002)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	fail_unless (NULL == pgm_txw_peek (window, window->trail), "peek failed");
 	pgm_txw_shutdown (window);
@@ -348,7 +376,7 @@ START_TEST (test_max_length_pass_001)
 {
 	const guint window_length = 100;
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, window_length, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, window_length, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	fail_unless (window_length == pgm_txw_max_length (window), "max_length failed");
 	pgm_txw_shutdown (window);
@@ -367,7 +395,7 @@ END_TEST
 START_TEST (test_length_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	fail_unless (0 == pgm_txw_length (window), "length failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -390,7 +418,7 @@ END_TEST
 START_TEST (test_size_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	fail_unless (0 == pgm_txw_size (window), "size failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -413,7 +441,7 @@ END_TEST
 START_TEST (test_is_empty_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	fail_unless (pgm_txw_is_empty (window), "is_empty failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -436,7 +464,7 @@ END_TEST
 START_TEST (test_is_full_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 1, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 1, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	fail_if (pgm_txw_is_full (window), "is_full failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -459,7 +487,7 @@ END_TEST
 START_TEST (test_lead_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	guint32 lead = pgm_txw_lead (window);
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -483,7 +511,7 @@ START_TEST (test_next_lead_pass_001)
 {
 	const guint window_length = 100;
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, window_length, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, window_length, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	guint32 next_lead = pgm_txw_next_lead (window);
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
@@ -506,7 +534,7 @@ END_TEST
 START_TEST (test_trail_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 1, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 1, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 /* does not advance with adding skb */
 	guint32 trail = pgm_txw_trail (window);
@@ -543,7 +571,7 @@ END_TEST
 START_TEST (test_retransmit_push_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 /* empty window invalidates all requests */
 	fail_unless (FALSE == pgm_txw_retransmit_push (window, window->trail, FALSE, 0), "retransmit_push failed");
@@ -558,6 +586,29 @@ START_TEST (test_retransmit_push_pass_001)
 }
 END_TEST
 
+/* parity request carries the transmission group and the packet count minus one */
+START_TEST (test_retransmit_push_pass_002)
+{
+	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_txw_t* window = pgm_txw_create (&tsi, 1500, 0, 60, 800000, TRUE, 255, 4, 1, NULL, NULL);
+	fail_if (NULL == window, "create failed");
+	for (unsigned i = 0; i < 8; i++)
+		pgm_txw_add (window, generate_valid_skb ());
+	const pgm_txw_state_t* state = (const pgm_txw_state_t*)&pgm_txw_peek (window, 4)->cb;
+/* two packets for group #4 */
+	fail_unless (TRUE == pgm_txw_retransmit_push (window, 4 | 1, TRUE, window->tg_sqn_shift), "retransmit_push failed");
+	fail_unless (2 == state->pkt_cnt_requested, "pkt_cnt_requested failed");
+/* more packets raise the count */
+	fail_unless (FALSE == pgm_txw_retransmit_push (window, 4 | 2, TRUE, window->tg_sqn_shift), "retransmit_push failed");
+	fail_unless (3 == state->pkt_cnt_requested, "pkt_cnt_requested failed");
+/* fewer packets are eliminated */
+	fail_unless (FALSE == pgm_txw_retransmit_push (window, 4 | 0, TRUE, window->tg_sqn_shift), "retransmit_push failed");
+	fail_unless (3 == state->pkt_cnt_requested, "pkt_cnt_requested failed");
+	fail_unless (2 == state->nak_elimination_count, "nak_elimination_count failed");
+	pgm_txw_shutdown (window);
+}
+END_TEST
+
 START_TEST (test_retransmit_push_fail_001)
 {
 	const bool answer = pgm_txw_retransmit_push (NULL, 0, FALSE, 0);
@@ -575,13 +626,54 @@ END_TEST
 START_TEST (test_retransmit_try_peek_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
 	fail_if (NULL == skb, "generate_valid_skb failed");
 	pgm_txw_add (window, skb);
 	fail_unless (1 == pgm_txw_retransmit_push (window, window->trail, FALSE, 0), "retransmit_push failed");
-	fail_unless (NULL != pgm_txw_retransmit_try_peek (window), "retransmit_try_peek failed");
+	skb = pgm_txw_retransmit_try_peek (window);
+	fail_unless (NULL != skb, "retransmit_try_peek failed");
+	pgm_free_skb (skb);
+	pgm_txw_shutdown (window);
+}
+END_TEST
+
+/* request for a sequence since evicted is discarded */
+START_TEST (test_retransmit_try_peek_pass_002)
+{
+	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 2, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
+	fail_if (NULL == window, "create failed");
+	pgm_txw_add (window, generate_valid_skb ());
+	fail_unless (1 == pgm_txw_retransmit_push (window, window->trail, FALSE, 0), "retransmit_push failed");
+	pgm_txw_add (window, generate_valid_skb ());
+	pgm_txw_add (window, generate_valid_skb ());
+	fail_unless (FALSE == pgm_txw_retransmit_is_empty (window), "retransmit_is_empty failed");
+	fail_unless (NULL == pgm_txw_retransmit_try_peek (window), "retransmit_try_peek failed");
+	fail_unless (TRUE == pgm_txw_retransmit_is_empty (window), "retransmit_is_empty failed");
+	pgm_txw_shutdown (window);
+}
+END_TEST
+
+/* each parity packet of a request takes the next parity index of the group */
+START_TEST (test_retransmit_try_peek_pass_003)
+{
+	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_txw_t* window = pgm_txw_create (&tsi, 1500, 0, 60, 800000, TRUE, 255, 4, 1, NULL, NULL);
+	fail_if (NULL == window, "create failed");
+	for (unsigned i = 0; i < 8; i++)
+		pgm_txw_add (window, generate_valid_skb ());
+	fail_unless (TRUE == pgm_txw_retransmit_push (window, 4 | 1, TRUE, window->tg_sqn_shift), "retransmit_push failed");
+	for (unsigned h = 0; h < 2; h++) {
+		struct pgm_sk_buff_t* skb = pgm_txw_retransmit_try_peek (window);
+		fail_unless (NULL != skb, "retransmit_try_peek failed");
+		fail_unless (PGM_OPT_PARITY & skb->pgm_header->pgm_options, "not parity");
+		fail_unless ((4 | h) == g_ntohl (skb->pgm_data->data_sqn), "data_sqn failed");
+		pgm_free_skb (skb);
+		pgm_txw_retransmit_remove_head (window);
+	}
+	fail_unless (TRUE == pgm_txw_retransmit_is_empty (window), "retransmit_is_empty failed");
 	pgm_txw_shutdown (window);
 }
 END_TEST
@@ -604,13 +696,15 @@ END_TEST
 START_TEST (test_retransmit_remove_head_pass_001)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	struct pgm_sk_buff_t* skb = generate_valid_skb ();
 	fail_if (NULL == skb, "generate_valid_skb failed");
 	pgm_txw_add (window, skb);
 	fail_unless (1 == pgm_txw_retransmit_push (window, window->trail, FALSE, 0), "retransmit_push failed");
-	fail_unless (NULL != pgm_txw_retransmit_try_peek (window), "retransmit_try_peek failed");
+	skb = pgm_txw_retransmit_try_peek (window);
+	fail_unless (NULL != skb, "retransmit_try_peek failed");
+	pgm_free_skb (skb);
 	pgm_txw_retransmit_remove_head (window);
 	pgm_txw_shutdown (window);
 }
@@ -628,7 +722,7 @@ END_TEST
 START_TEST (test_retransmit_remove_head_fail_002)
 {
 	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
-	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0, 1, NULL, NULL);
 	fail_if (NULL == window, "create failed");
 	pgm_txw_retransmit_remove_head (window);
 	fail ("reached");
@@ -666,6 +760,7 @@ make_test_suite (void)
 	TCase* tc_add = tcase_create ("add");
 	suite_add_tcase (s, tc_add);
 	tcase_add_test (tc_add, test_add_pass_001);
+	tcase_add_test (tc_add, test_add_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_add, test_add_fail_001, SIGABRT);
 	tcase_add_test_raise_signal (tc_add, test_add_fail_002, SIGABRT);
@@ -739,6 +834,7 @@ make_test_suite (void)
 	TCase* tc_retransmit_push = tcase_create ("retransmit-push");
 	suite_add_tcase (s, tc_retransmit_push);
 	tcase_add_test (tc_retransmit_push, test_retransmit_push_pass_001);
+	tcase_add_test (tc_retransmit_push, test_retransmit_push_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_retransmit_push, test_retransmit_push_fail_001, SIGABRT);
 #endif
@@ -746,6 +842,8 @@ make_test_suite (void)
 	TCase* tc_retransmit_try_peek = tcase_create ("retransmit-try-peek");
 	suite_add_tcase (s, tc_retransmit_try_peek);
 	tcase_add_test (tc_retransmit_try_peek, test_retransmit_try_peek_pass_001);
+	tcase_add_test (tc_retransmit_try_peek, test_retransmit_try_peek_pass_002);
+	tcase_add_test (tc_retransmit_try_peek, test_retransmit_try_peek_pass_003);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_retransmit_try_peek, test_retransmit_try_peek_fail_001, SIGABRT);
 #endif